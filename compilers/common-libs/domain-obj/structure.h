@@ -172,6 +172,7 @@ class LPU {
         bool valid;
 
         LPU() { id = 0; valid = false; }
+        virtual ~LPU() {}
         void setId(int id) { this->id = id; }
         void setValidBit(bool valid) { this->valid = valid; }
         bool isValid() { return valid; }
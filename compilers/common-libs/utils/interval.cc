@@ -721,6 +721,34 @@ vector<int> *SequenceIterator::getNextElement() {
 	return index;
 }
 
+vector<int> *SequenceIterator::getNextRun(long int maxLength, int *runLength) {
+
+	vector<int> *runStart = getNextElement();
+	if (runStart == NULL) {
+		*runLength = 0;
+		return NULL;
+	}
+
+	// determine how many elements follow the current one without a gap in the last dimension 
+	int lastDim = dimensionality - 1;
+	IntervalSeq *lastLinearSeq = sequence->getIntervalForDim(lastDim);
+	IntervalState *state = cursors.top();
+	int iteration = state->getIteration();
+	int position = state->getIndex();
+	long int followers = lastLinearSeq->length - 1 - position;
+	if (lastLinearSeq->period == lastLinearSeq->length) {
+		followers += (long int) (lastLinearSeq->count - 1 - iteration) * lastLinearSeq->length;
+	}
+	long int length = std::min(followers + 1, std::max(maxLength, 1l));
+
+	// move the cursor of the last dimension to the last element of the run
+	long int lastPosition = (long int) iteration * lastLinearSeq->length + position + length - 1;
+	state->moveTo(lastPosition / lastLinearSeq->length, lastPosition % lastLinearSeq->length);
+	currentElementNo += length - 1;
+	*runLength = length;
+	return runStart;
+}
+
 void SequenceIterator::reset() {
 	currentElementNo = 0;
 	initCursorsAndIndex();
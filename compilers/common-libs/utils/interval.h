@@ -180,6 +180,7 @@ class IntervalState {
 	inline int getIndex() { return index; }
 	inline void step() { index++; }
 	inline void reset() { iteration = 0; index = -1; }
+	inline void moveTo(int iteration, int index) { this->iteration = iteration; this->index = index; }
 };
 
 /* an iterator to traverse through a multidimensional interval sequence and get all the indexes included in the sequence
@@ -201,6 +202,11 @@ class SequenceIterator {
 	// returns the next index element in the sequence; it returns NULL if there are no more elements and reset its state
 	std::vector<int> *getNextElement();
 
+	// Returns the first index of the next run of elements that are consecutive along the last dimension and sets the 
+	// length of the run, which is not larger than the first argument, in the second. A run extends over consecutive 
+	// intervals of the last dimension if there is no gap between them. The iterator skips the rest of the run.
+	std::vector<int> *getNextRun(long int maxLength, int *runLength);
+
 	void reset();
 	void printNextElement(std::ostream &stream);
   private:
@@ -10,3 +10,10 @@ void StoreArray::generateCode(std::ostringstream &stream, int indentLevel, Space
 void BindInput::generateCode(std::ostringstream &stream, int indentLevel, Space *space) {}
 void BindOutput::generateCode(std::ostringstream &stream, int indentLevel, Space *space) {}
 
+
+void ArrayScanOperation::translatePartPointer(std::ostringstream &stream, Expr *arrayArg, int indentLevel, Space *space) {}
+void ArrayScanOperation::translatePartLength(std::ostringstream &stream, Expr *arrayArg) {}
+void ArrayScanOperation::translateCombiner(std::ostringstream &stream, Expr *outputArg, Space *space) {}
+void Scan::translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space) {}
+void ExclusiveScan::translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space) {}
+void Histogram::translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space) {}
@@ -21,7 +21,12 @@ void ReturnStmt::generateCode(std::ostringstream &stream, int indentLevel, Space
 
 void LoopStmt::declareVariablesInScope(std::ostringstream &stream, int indentLevel) {}
 void LoopStmt::generateIndexLoops(std::ostringstream &stream, int indentLevel,
-		Space *space, Stmt *body, List<LogicalExpr*> *indexRestrictions) {}
+		Space *space, Stmt *body, List<LogicalExpr*> *indexRestrictions, bool restructurable) {}
+bool LoopStmt::isTilable(Space *space, List<IndexArrayAssociation*> *associateList,
+		List<LogicalExpr*> *indexRestrictions) { return false; }
+void LoopStmt::generateTiledIndexLoops(std::ostringstream &stream, int indentLevel,
+		Space *space, Stmt *body, 
+		List<IndexArrayAssociation*> *associateList, int tileSize) {}
 List<LogicalExpr*> *LoopStmt::getApplicableExprs(Hashtable<const char*> *indexesInvisible,
 		List<LogicalExpr*> *currentExprList,
 		List<LogicalExpr*> *remainingExprList) { return NULL; }
@@ -264,6 +264,15 @@ class FlowStage {
 	
 	//-------------------------------------------------------------------------------------------------------------
 
+	// functions for determining scan requirements ----------------------------------------------------------------
+
+	// This function is used to recursively determine the arrays receiving the running totals of scan library
+	// functions invoked in the flow. The per-LPU results of such arrays must be combined after the LPUs of the
+	// top-level LPS enclosing the scans have been processed. 
+	virtual void retrieveScanOutputArrays(List<const char*> *arrayNames) {}
+	
+	//-------------------------------------------------------------------------------------------------------------
+
 	//------------------------------------------------------------------------------ Code Generation Hack Functions
         /**************************************************************************************************************
           The code generation related function definitions that are placed here are platform specific. So ideally 
@@ -358,6 +367,12 @@ class StageInstanciation : public FlowStage {
 	
 	//-------------------------------------------------------------------------------------------------------------
 
+	// functions for determining scan requirements ----------------------------------------------------------------
+	
+	void retrieveScanOutputArrays(List<const char*> *arrayNames);
+	
+	//-------------------------------------------------------------------------------------------------------------
+
 	//------------------------------------------------------------------------------ Code Generation Hack Functions
         /**************************************************************************************************************
           The code generation related function definitions that are placed here are platform specific. So ideally 
@@ -524,6 +539,12 @@ class CompositeStage : public FlowStage {
 	
 	//-------------------------------------------------------------------------------------------------------------
 
+	// functions for determining scan requirements ----------------------------------------------------------------
+	
+	void retrieveScanOutputArrays(List<const char*> *arrayNames);
+	
+	//-------------------------------------------------------------------------------------------------------------
+
 	//------------------------------------------------------------------------------ Code Generation Hack Functions
         /**************************************************************************************************************
           The code generation related function definitions that are placed here are platform specific. So ideally 
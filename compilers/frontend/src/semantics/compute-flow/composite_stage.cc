@@ -767,3 +767,10 @@ void CompositeStage::retriveExternCodeBlocksConfigs(IncludesAndLinksMap *externC
         }
 }
 
+void CompositeStage::retrieveScanOutputArrays(List<const char*> *arrayNames) {
+        for (int i = 0; i < stageList->NumElements(); i++) {
+                FlowStage *stage = stageList->Nth(i);
+                stage->retrieveScanOutputArrays(arrayNames);
+        }
+}
+
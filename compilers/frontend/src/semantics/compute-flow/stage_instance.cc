@@ -10,11 +10,13 @@
 #include "../../syntax/ast_expr.h"
 #include "../../syntax/ast_stmt.h"
 #include "../../syntax/ast_task.h"
+#include "../../syntax/ast_library_fn.h"
 #include "../../static-analysis/reduction_info.h"
 #include "../../static-analysis/data_dependency.h"
 #include "../../codegen-helper/extern_config.h"
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/hashtable.h"
+#include "../../../../common-libs/utils/string_utils.h"
 
 #include <iostream>
 #include <fstream>
@@ -114,3 +116,16 @@ bool StageInstanciation::hasNestedReductions() { return (nestedReductions->NumEl
 void StageInstanciation::retriveExternCodeBlocksConfigs(IncludesAndLinksMap *externConfigMap) {
 	code->retrieveExternHeaderAndLibraries(externConfigMap);
 }
+
+void StageInstanciation::retrieveScanOutputArrays(List<const char*> *arrayNames) {
+	List<Expr*> *libFnCalls = new List<Expr*>;
+	code->retrieveExprByType(libFnCalls, LIB_FN_CALL);
+	for (int i = 0; i < libFnCalls->NumElements(); i++) {
+		ArrayScanOperation *scan = dynamic_cast<ArrayScanOperation*>(libFnCalls->Nth(i));
+		if (scan == NULL) continue;
+		const char *arrayName = scan->getRunningTotalsArray();
+		if (arrayName == NULL || string_utils::contains(arrayNames, arrayName)) continue;
+		arrayNames->Append(arrayName);
+	}
+	delete libFnCalls;
+}
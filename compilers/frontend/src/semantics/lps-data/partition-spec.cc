@@ -83,6 +83,8 @@ PartitionFunctionConfig *PartitionFunctionConfig::generateConfig(yyltype *locati
 		config = new BlockSize(location);
 	} else if (strcmp(functionName, BlockCount::name) == 0) {
 		config = new BlockCount(location);
+	} else if (strcmp(functionName, NnzBalanced::name) == 0) {
+		config = new NnzBalanced(location);
 	} else if (strcmp(functionName, StridedBlock::name) == 0) {
 		config = new StridedBlock(location);
 	} else if (strcmp(functionName, Strided::name) == 0) {
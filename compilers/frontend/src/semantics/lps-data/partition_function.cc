@@ -102,6 +102,19 @@ List<int> *BlockCount::getBlockedDimensions(Type *structureType) {
 	return new List<int>;
 }
 
+//-------------------------------------------------- NNZ Balanced -----------------------------------------------/
+
+const char *NnzBalanced::name = "nnz_balanced";
+
+void NnzBalanced::processArguments(List<PartitionArg*> *dividingArgs, 
+		List<PartitionArg*> *paddingArgs, const char *argumentName) {
+	SingleArgumentPartitionFunction::processArguments(dividingArgs, paddingArgs, "block count");
+}
+
+List<int> *NnzBalanced::getBlockedDimensions(Type *structureType) {
+	return new List<int>;
+}
+
 //--------------------------------------------------- Strided Block ----------------------------------------------/
 
 const char *StridedBlock::name = "block_stride";
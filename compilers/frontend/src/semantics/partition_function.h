@@ -59,6 +59,26 @@ class BlockCount : public SingleArgumentPartitionFunction {
 	const char *getDimensionConfigClassName() { return "BlockCountConfig"; }
 };
 
+/*	Unlike the other functions of this header, nnz_balanced does not divide a dimension into parts of equal length.
+	It is meant for the row pointer array of compressed sparse row (CSR) structures and other arrays aligned with it. 
+	It generates 'count' parts with about the same number of non-zero entries in each by consulting the content of 
+	the row pointer array.  
+*/
+class NnzBalanced : public SingleArgumentPartitionFunction {
+  public:
+	static const char *name;
+	NnzBalanced(yyltype *location) : SingleArgumentPartitionFunction(location, name) {}
+	void processArguments(List<PartitionArg*> *dividingArgs, 
+			List<PartitionArg*> *paddingArgs, const char *argumentName);
+	List<int> *getBlockedDimensions(Type *structureType);
+	bool doesSupportGhostRegion() { return true; }
+	bool isDataDependent() { return true; }
+
+	//------------------------------------------------------------- Common helper functions for Code Generation
+
+	const char *getDimensionConfigClassName() { return "NnzBalancedConfig"; }
+};
+
 class StridedBlock : public SingleArgumentPartitionFunction {
   public:
 	static const char *name;
@@ -78,6 +78,10 @@ class PartitionFunctionConfig {
 
 	// function used to determine if padding arguments are applicable for the partition-function under concern
 	virtual bool doesSupportGhostRegion() { return false; }
+	// this function is used to determine if the split points of the partitions depend on the content of the data
+	// structure being partitioned, as opposed to just on the partition arguments and the dimension length; such split
+	// points can only be computed at task launch
+	virtual bool isDataDependent() { return false; }
 	// this function is used to determine if we need to transform/reverse-transform indexes that are generated
 	// by traversing the partitions created by applying this partition function
 	virtual bool doesReorderStoredData() { return false; }
@@ -324,6 +324,9 @@ class ArithmaticExpr : public Expr {
 	ArithmaticExpr(Expr *left, ArithmaticOperator op, Expr *right, yyltype loc);
 	const char *GetPrintNameForNode() { return "Arithmatic-Expr"; }
     	void PrintChildren(int indentLevel);
+	Expr *getLeft() { return left; }
+	ArithmaticOperator getOp() { return op; }
+	Expr *getRight() { return right; }
 
 	//------------------------------------------------------------------ Helper functions for Semantic Analysis
 
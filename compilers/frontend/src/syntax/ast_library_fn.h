@@ -220,4 +220,122 @@ class BindOutput : public BindOperation {
 	void generateCode(std::ostringstream &stream, int indentLevel, Space *space);	
 };
 
+/*------------------------------------------------------------------------------------------------------------- 
+	   	   Functions for prefix-sum and histogram computations over array parts
+-------------------------------------------------------------------------------------------------------------*/
+
+/* These functions operate on the parts of two one-dimensional arrays held by the LPU executing the enclosing
+   compute stage. The first argument is the array that receives the result and the second is the input; the 
+   result part must be at least as long as the input part. Each function returns the aggregate of its LPU's 
+   part (the total for a scan and the number of keys counted for a histogram). The running totals of a scan 
+   cover the whole array, not just the LPU's part, once all LPUs of the top-level LPS enclosing the scan have 
+   been processed; until then each part holds only its local running totals.
+*/
+class ArrayScanOperation : public LibraryFunction {
+  public:
+	ArrayScanOperation(Identifier *id, List<Expr*> *arguments, yyltype loc)
+                : LibraryFunction(2, id, arguments, loc) {}
+
+        //-------------------------------------------------------------- Helper functions for Semantic Analysis
+
+	virtual int resolveExprTypes(Scope *scope);
+	virtual int emitErrorsInArguments(Scope *scope);
+	
+	// the first argument of these functions is updated and the second is read
+	Hashtable<VariableAccess*> *getAccessedGlobalVariables(TaskGlobalReferences *globalRefs);
+
+        //---------------------------------------------------------------- Helper functions for Static Analysis
+
+	// returns the name of the array that receives the running totals of the scan; the running totals of the
+	// parts of different LPUs need to be combined after the LPUs have been processed
+	virtual const char *getRunningTotalsArray() { return arguments->Nth(0)->getBaseVarName(); }
+  protected:
+	// marks the content of the global array an argument refers to as accessed and returns its access log
+	VariableAccess *getContentAccessLog(Expr *arrayArg, 
+			Hashtable<VariableAccess*> *accessTable, 
+			TaskGlobalReferences *globalRefs);
+	// checks if the argument is a one-dimensional array of any of the element types listed in the type list
+	int emitErrorsInArrayArgument(Expr *arg, Scope *scope, List<Type*> *allowedElementTypes);
+
+        //-------------------------------------------------------------------------- Code Generation Hack Functions
+        /**********************************************************************************************************
+          The code generation related function definitions that are placed here are platform specific. So ideally 
+          they should not be included here and the frontend compiler should be oblivious of them. However, as we
+          ran out of time in overhauling the old compilers, instead of redesigning the code generation process, we 
+          decided to keep the union of old function definitions in the frontend and put their implementations in
+          relevent backend compilers.   
+        **********************************************************************************************************/
+
+	// generates a pointer to the beginning of the executing LPU's part of an array argument
+	void translatePartPointer(std::ostringstream &stream, Expr *arrayArg, int indentLevel, Space *space);
+	// generates the number of elements in the executing LPU's part of an array argument
+	void translatePartLength(std::ostringstream &stream, Expr *arrayArg);
+	// generates a reference to the combiner that adds the totals of the preceding parts to the output part
+	void translateCombiner(std::ostringstream &stream, Expr *outputArg, Space *space);
+};
+
+class Scan : public ArrayScanOperation {
+  public:
+	static const char *Name;	
+	Scan(Identifier *id, List<Expr*> *arguments, 
+			yyltype loc) : ArrayScanOperation(id, arguments, loc) {}
+
+        //-------------------------------------------------------------------------- Code Generation Hack Functions
+        /**********************************************************************************************************
+          The code generation related function definitions that are placed here are platform specific. So ideally 
+          they should not be included here and the frontend compiler should be oblivious of them. However, as we
+          ran out of time in overhauling the old compilers, instead of redesigning the code generation process, we 
+          decided to keep the union of old function definitions in the frontend and put their implementations in
+          relevent backend compilers.   
+        **********************************************************************************************************/
+
+	void translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space);
+};
+
+class ExclusiveScan : public ArrayScanOperation {
+  public:
+	static const char *Name;	
+	ExclusiveScan(Identifier *id, List<Expr*> *arguments, 
+			yyltype loc) : ArrayScanOperation(id, arguments, loc) {}
+
+        //-------------------------------------------------------------------------- Code Generation Hack Functions
+        /**********************************************************************************************************
+          The code generation related function definitions that are placed here are platform specific. So ideally 
+          they should not be included here and the frontend compiler should be oblivious of them. However, as we
+          ran out of time in overhauling the old compilers, instead of redesigning the code generation process, we 
+          decided to keep the union of old function definitions in the frontend and put their implementations in
+          relevent backend compilers.   
+        **********************************************************************************************************/
+
+	void translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space);
+};
+
+class Histogram : public ArrayScanOperation {
+  public:
+	static const char *Name;	
+	Histogram(Identifier *id, List<Expr*> *arguments, 
+			yyltype loc) : ArrayScanOperation(id, arguments, loc) {}
+
+        //-------------------------------------------------------------- Helper functions for Semantic Analysis
+
+	int resolveExprTypes(Scope *scope);
+	int emitErrorsInArguments(Scope *scope);
+
+        //---------------------------------------------------------------- Helper functions for Static Analysis
+
+	// the counts of different LPUs are accumulated in place; there are no running totals to combine
+	const char *getRunningTotalsArray() { return NULL; }
+
+        //-------------------------------------------------------------------------- Code Generation Hack Functions
+        /**********************************************************************************************************
+          The code generation related function definitions that are placed here are platform specific. So ideally 
+          they should not be included here and the frontend compiler should be oblivious of them. However, as we
+          ran out of time in overhauling the old compilers, instead of redesigning the code generation process, we 
+          decided to keep the union of old function definitions in the frontend and put their implementations in
+          relevent backend compilers.   
+        **********************************************************************************************************/
+
+	void translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space);
+};
+
 #endif
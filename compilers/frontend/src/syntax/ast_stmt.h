@@ -19,6 +19,7 @@ class Type;
 class ParamReplacementConfig;
 class TaskGlobalReferences;
 class IndexScope;
+class IndexArrayAssociation;
 class VariableAccess;
 class ReductionMetadata;
 class IncludesAndLinksMap;
@@ -107,6 +108,7 @@ class StmtBlock : public Stmt {
     	StmtBlock(List<Stmt*> *statements);
     	const char *GetPrintNameForNode() { return "Statement-Block"; }
     	void PrintChildren(int indentLevel);
+	List<Stmt*> *getStmtList() { return stmts; }
 
         //------------------------------------------------------------------ Helper functions for Semantic Analysis
 
@@ -297,8 +299,16 @@ class LoopStmt: public Stmt {
         **********************************************************************************************************/
 
         void declareVariablesInScope(std::ostringstream &stream, int indentLevel);
+        // the last argument is set for loops whose index traversal order is not significant; in that case the
+        // index loops are interchanged and tiled for better cache utilization whenever possible
         void generateIndexLoops(std::ostringstream &stream, int indentLevel,
-                        Space *space, Stmt *body, List<LogicalExpr*> *indexRestrictions = NULL);
+                        Space *space, Stmt *body, List<LogicalExpr*> *indexRestrictions = NULL, 
+                        bool restructurable = false);
+        bool isTilable(Space *space, List<IndexArrayAssociation*> *associateList, 
+                        List<LogicalExpr*> *indexRestrictions);
+        void generateTiledIndexLoops(std::ostringstream &stream, int indentLevel,
+                        Space *space, Stmt *body, 
+                        List<IndexArrayAssociation*> *associateList, int tileSize);
         List<LogicalExpr*> *getApplicableExprs(Hashtable<const char*> *indexesInvisible,
                         List<LogicalExpr*> *currentExprList,
                         List<LogicalExpr*> *remainingExprList);
@@ -472,6 +482,9 @@ class ReductionStmt: public Stmt {
         ReductionStmt(Identifier *left, char *opName, Expr *right, yyltype loc);
         const char *GetPrintNameForNode() { return "Reduction-Statement"; }
         void PrintChildren(int indentLevel);
+	ReductionOperator getOp() { return op; }
+	Expr *getRight() { return right; }
+	ReductionVar *getReductionVar() { return reductionVar; }
 
         //------------------------------------------------------------------ Helper functions for Semantic Analysis
 
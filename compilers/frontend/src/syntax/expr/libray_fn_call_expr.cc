@@ -20,6 +20,9 @@ const char *LoadArray::Name = "load_array";
 const char *StoreArray::Name = "store_array";
 const char *BindInput::Name = "bind_input";
 const char *BindOutput::Name = "bind_output";
+const char *Scan::Name = "scan";
+const char *ExclusiveScan::Name = "exclusive_scan";
+const char *Histogram::Name = "histogram";
 
 //-------------------------------------------------------- Library Function -----------------------------------------------------/
 
@@ -43,7 +46,10 @@ bool LibraryFunction::isLibraryFunction(Identifier *id) {
                 || strcmp(name, LoadArray::Name) == 0 
                 || strcmp(name, StoreArray::Name) == 0
                 || strcmp(name, BindInput::Name) == 0
-                || strcmp(name, BindOutput::Name) == 0);
+                || strcmp(name, BindOutput::Name) == 0
+                || strcmp(name, Scan::Name) == 0
+                || strcmp(name, ExclusiveScan::Name) == 0
+                || strcmp(name, Histogram::Name) == 0);
 }
 
 LibraryFunction *LibraryFunction::getFunctionExpr(Identifier *id, List<Expr*> *arguments, yyltype loc) {
@@ -65,6 +71,12 @@ LibraryFunction *LibraryFunction::getFunctionExpr(Identifier *id, List<Expr*> *a
                 function = new BindInput(id, arguments, loc);
         } else if (strcmp(name, BindOutput::Name) == 0) {
                 function = new BindOutput(id, arguments, loc);
+        } else if (strcmp(name, Scan::Name) == 0) {
+                function = new Scan(id, arguments, loc);
+        } else if (strcmp(name, ExclusiveScan::Name) == 0) {
+                function = new ExclusiveScan(id, arguments, loc);
+        } else if (strcmp(name, Histogram::Name) == 0) {
+                function = new Histogram(id, arguments, loc);
         }
 
         return function;
@@ -324,3 +336,137 @@ int BindOperation::emitErrorsInArguments(Scope *scope) {
 
 	return errors;
 }
+
+//------------------------------------------------------- Array Scan Operation --------------------------------------------------/
+
+int ArrayScanOperation::resolveExprTypes(Scope *scope) {
+
+	int resolvedExprs = 0;
+	Expr *arg1 = arguments->Nth(0);
+        resolvedExprs += arg1->resolveExprTypesAndScopes(scope);
+	Expr *arg2 = arguments->Nth(1);
+        resolvedExprs += arg2->resolveExprTypesAndScopes(scope);
+
+	// a scan returns the total of the input part; so its type is the element type of the input array
+	ArrayType *inputType = dynamic_cast<ArrayType*>(arg2->getType());
+	if (arg1->getType() != NULL && inputType != NULL) {
+		this->type = inputType->getTerminalElementType();
+		resolvedExprs++;
+	}
+	return resolvedExprs;
+}
+
+int ArrayScanOperation::emitErrorsInArguments(Scope *scope) {
+
+	List<Type*> *allowedTypes = new List<Type*>;
+	allowedTypes->Append(Type::intType);
+	allowedTypes->Append(Type::floatType);
+	allowedTypes->Append(Type::doubleType);
+
+	int errors = 0;
+	Expr *arg1 = arguments->Nth(0);
+	errors += emitErrorsInArrayArgument(arg1, scope, allowedTypes);
+	Expr *arg2 = arguments->Nth(1);
+	errors += emitErrorsInArrayArgument(arg2, scope, allowedTypes);
+	delete allowedTypes;
+	if (errors > 0) return errors;
+
+	Type *outputElemType = ((ArrayType*) arg1->getType())->getTerminalElementType();
+	Type *inputElemType = ((ArrayType*) arg2->getType())->getTerminalElementType();
+	if (outputElemType != inputElemType) {
+                ReportError::IncompatibleTypes(arg1->GetLocation(), 
+			outputElemType, inputElemType, false);
+		errors++;
+	}
+	return errors;
+}
+
+Hashtable<VariableAccess*> *ArrayScanOperation::getAccessedGlobalVariables(TaskGlobalReferences *globalReferences) {
+	
+	Hashtable<VariableAccess*> *table = LibraryFunction::getAccessedGlobalVariables(globalReferences);
+	
+	// array arguments are passed as whole; so accessing them only records metadata accesses and the content accesses
+	// should be recorded here: the content of the first argument is written and that of the second is read
+	VariableAccess *outputLog = getContentAccessLog(arguments->Nth(0), table, globalReferences);
+	if (outputLog != NULL) outputLog->getContentAccessFlags()->flagAsWritten();
+	VariableAccess *inputLog = getContentAccessLog(arguments->Nth(1), table, globalReferences);
+	if (inputLog != NULL) inputLog->getContentAccessFlags()->flagAsRead();
+	return table;
+}
+
+VariableAccess *ArrayScanOperation::getContentAccessLog(Expr *arrayArg, 
+		Hashtable<VariableAccess*> *accessTable, 
+		TaskGlobalReferences *globalReferences) {
+
+	const char *argName = arrayArg->getBaseVarName();
+	if (argName == NULL || !globalReferences->doesReferToGlobal(argName)) return NULL;
+	const char *globalName = globalReferences->getGlobalRoot(argName)->getName();
+	VariableAccess *accessLog = accessTable->Lookup(globalName);
+	if (accessLog == NULL) {
+		accessLog = new VariableAccess(globalName);
+		accessTable->Enter(globalName, accessLog, true);
+	}
+	accessLog->markContentAccess();
+	return accessLog;
+}
+
+int ArrayScanOperation::emitErrorsInArrayArgument(Expr *arg, Scope *scope, List<Type*> *allowedElementTypes) {
+	
+	int errors = arg->emitScopeAndTypeErrors(scope);
+	Type *argType = arg->getType();
+	if (argType == NULL || argType == Type::errorType) return errors;
+	
+	ArrayType *arrayType = dynamic_cast<ArrayType*>(argType);
+	if (arrayType == NULL) {
+		ReportError::InvalidArrayAccess(arg->GetLocation(), argType, false);
+		return errors + 1;
+	}
+	if (arrayType->getDimensions() != 1) {
+		ReportError::OptionalErrorReport(arg->GetLocation(), false, 
+				"function '%s' only supports one-dimensional arrays", functionName->getName());
+		errors++;
+	}
+	Type *elemType = arrayType->getTerminalElementType();
+	bool elemTypeAllowed = false;
+	for (int i = 0; i < allowedElementTypes->NumElements(); i++) {
+		if (allowedElementTypes->Nth(i) == elemType) {
+			elemTypeAllowed = true;
+			break;
+		}
+	}
+	if (!elemTypeAllowed) {
+		ReportError::UnsupportedOperand(arg, elemType, functionName->getName(), false);
+		errors++;
+	}
+	return errors;
+}
+
+//------------------------------------------------------------ Histogram --------------------------------------------------------/
+
+int Histogram::resolveExprTypes(Scope *scope) {
+
+	int resolvedExprs = 0;
+	Expr *arg1 = arguments->Nth(0);
+        resolvedExprs += arg1->resolveExprTypesAndScopes(scope);
+	Expr *arg2 = arguments->Nth(1);
+        resolvedExprs += arg2->resolveExprTypesAndScopes(scope);
+
+	// a histogram returns the number of keys that fell within the range of its counts array
+	if (arg1->getType() != NULL && arg2->getType() != NULL) {
+		this->type = Type::intType;
+		resolvedExprs++;
+	}
+	return resolvedExprs;
+}
+
+int Histogram::emitErrorsInArguments(Scope *scope) {
+
+	List<Type*> *allowedTypes = new List<Type*>;
+	allowedTypes->Append(Type::intType);
+
+	int errors = 0;
+	errors += emitErrorsInArrayArgument(arguments->Nth(0), scope, allowedTypes);
+	errors += emitErrorsInArrayArgument(arguments->Nth(1), scope, allowedTypes);
+	delete allowedTypes;
+	return errors;
+}
@@ -1,9 +1,12 @@
 #include "../../../utils/code_constant.h"
 #include "../../../utils/name_transformer.h"
+#include "../../../utils/lpu_generation.h"
 #include "../../../../../../common-libs/utils/list.h"
 #include "../../../../../../common-libs/utils/hashtable.h"
 #include "../../../../../../common-libs/domain-obj/constant.h"
 #include "../../../../../../frontend/src/syntax/ast_expr.h"
+#include "../../../../../../frontend/src/syntax/ast_task.h"
+#include "../../../../../../frontend/src/syntax/ast_type.h"
 #include "../../../../../../frontend/src/semantics/task_space.h"
 #include "../../../../../../frontend/src/semantics/computation_flow.h"
 
@@ -44,6 +47,56 @@ void EpochBoundaryBlock::genCodeForScalarVarEpochUpdates(std::ofstream &stream,
 	stream << indentStr << "} // scope ends for version updates of scalar variables\n";
 }
 
+// checks if the LPUs of the argument LPS have direct references to the data parts of all argument arrays
+static bool holdsAllEpochVersionedParts(Space *lps, List<const char*> *arrayVarList) {
+	for (int i = 0; i < arrayVarList->NumElements(); i++) {
+		DataStructure *structure = lps->getLocalStructure(arrayVarList->Nth(i));
+		ArrayDataStructure *array = dynamic_cast<ArrayDataStructure*>(structure);
+		if (array == NULL || !lpuHoldsEpochVersionedPart(lps, array)) return false;
+	}
+	return true;
+}
+
+// Advances the epoch versions of the data parts through the references held in the LPU. This avoids the part-ID 
+// generation and part search that the general update process needs for each array of each LPU. If the last
+// argument is true then the LPU's data pointers are updated too to reflect the version changes.
+static void genCodeForDirectArrayVarEpochUpdates(std::ofstream &stream,
+		Space *lps, 
+		const char *lpuRef,
+		int indentation,
+		List<const char*> *arrayVarList, 
+		bool refreshLpu) {
+
+	std::ostringstream indentStream;
+	for (int i = 0; i < indentation; i++) indentStream << indent;
+	std::string indentStr = indentStream.str();
+	const char *lpsName = lps->getName();
+
+	stream << indentStr << "{ // scope starts for version updates of LPU data from Space ";
+	stream << lpsName << "\n";
+
+	for (int i = 0; i < arrayVarList->NumElements(); i++) {
+		const char *varName = arrayVarList->Nth(i);
+		stream << indentStr << lpuRef << "->" << varName << "DataPart->advanceEpoch()" << stmtSeparator;
+		if (!refreshLpu) continue;
+
+		ArrayDataStructure *array = (ArrayDataStructure*) lps->getLocalStructure(varName);
+		ArrayType *arrayType = (ArrayType*) array->getType();
+		const char *elemType = arrayType->getTerminalElementType()->getCType();
+		stream << indentStr << lpuRef << "->" << varName << " = (" << elemType << "*) ";
+		stream << lpuRef << "->" << varName << "DataPart->getData()" << stmtSeparator;
+		int versionCount = array->getLocalVersionCount();
+		for (int j = 1; j <= versionCount; j++) {
+			stream << indentStr << lpuRef << "->" << varName << "_lag_" << j;
+			stream << " = (" << elemType << "*) ";
+			stream << lpuRef << "->" << varName << "DataPart->getData(" << j << ")" << stmtSeparator;
+		}
+	}
+
+	stream << indentStr << "} // scope ends for version updates of LPU data from Space ";
+	stream << lpsName << "\n";
+}
+
 void EpochBoundaryBlock::genCodeForArrayVarEpochUpdates(std::ofstream &stream,
 		const char *lpsName,
 		int indentation,
@@ -152,9 +205,19 @@ void EpochBoundaryBlock::generateInvocationCode(std::ofstream &stream, int inden
 		if (arrayVarList->NumElements() == 0) continue;
 		
 		if (strcmp(currLpsName, lpsName) == 0) {
-			// In this case, the current LPU's data parts' versions must be updated. Afterwards, we
-			// have to recreate the LPU object so that the internal pointers are updated properly.
+			// In this case, the current LPU's data parts' versions must be updated. Afterwards, the
+			// LPU's data pointers must be updated too. If the LPU holds references to its data parts
+			// then both can be done directly on the LPU; otherwise, we have to locate the parts then
+			// recreate the LPU object so that the internal pointers are updated properly.
 			
+			if (holdsAllEpochVersionedParts(space, arrayVarList)) {
+				std::ostringstream lpuRef;
+				lpuRef << "space" << lpsName << "Lpu";
+				genCodeForDirectArrayVarEpochUpdates(stream, space, lpuRef.str().c_str(), 
+						indentation, arrayVarList, true);
+				continue;
+			}
+
 			genCodeForArrayVarEpochUpdates(stream, lpsName, indentation, arrayVarList);
                 
 			stream << indentStr << "generateSpace" << lpsName << "Lpu(";
@@ -167,10 +230,20 @@ void EpochBoundaryBlock::generateInvocationCode(std::ofstream &stream, int inden
 		} else {
 			// In the other case, the LPS under concern must be a descendent LPS and epoch versions
 			// of all LPU data parts must be updated. So we iterate over the LPUs and do the epoch
-			// update on LPUs one by one.
+			// update on LPUs one by one. The LPU objects need not be updated here as they will be 
+			// regenerated when the flow of control enters the descendent LPS.
 			
+			PartitionHierarchy *lpsHierarchy = TaskDef::currentTask->getPartitionHierarchy();
+			Space *lps = lpsHierarchy->getSpace(lpsName[0]);
 			genLpuTraversalLoopBegin(stream, lpsName, indentation);
-			genCodeForArrayVarEpochUpdates(stream, lpsName, indentation + 1, arrayVarList);
+			if (lps != NULL && holdsAllEpochVersionedParts(lps, arrayVarList)) {
+				std::ostringstream lpuRef;
+				lpuRef << "((Space" << lpsName << "_LPU*) lpu)";
+				genCodeForDirectArrayVarEpochUpdates(stream, lps, lpuRef.str().c_str(), 
+						indentation + 1, arrayVarList, false);
+			} else {
+				genCodeForArrayVarEpochUpdates(stream, lpsName, indentation + 1, arrayVarList);
+			}
 			genLpuTraversalLoopEnd(stream, lpsName, indentation);
 		}
 	}
@@ -112,6 +112,18 @@ void LpsTransitionBlock::generateInvocationCode(std::ofstream &stream, int inden
 		stream << containerSpace->getName() << ')' << stmtSeparator;
 	}
 
+	// the scans done within the LPUs only cover individual parts; once all LPUs of a top-level LPS have been
+	// processed, the totals of the preceding parts should be added to each part
+	if (containerSpace->isRoot()) {
+		List<const char*> *scanOutputArrays = new List<const char*>;
+		retrieveScanOutputArrays(scanOutputArrays);
+		for (int i = 0; i < scanOutputArrays->NumElements(); i++) {
+			stream << indentStr << scanOutputArrays->Nth(i) << "ScanCombiner->combine()";
+			stream << stmtSeparator;
+		}
+		delete scanOutputArrays;
+	}
+
 	// exit from the scope
 	stream << indentStr << "} // scope exit for iterating LPUs of Space ";
 	stream << space->getName() << "\n";	
@@ -142,6 +142,10 @@ void StageInstanciation::generateInvocationCode(std::ofstream &stream, int inden
 	
 	// invoke the related method with current LPU parameter ...
 	stream << nextIndent.str() << "// invoking user computation\n";
+	stream << nextIndent.str() << "TRACE_TIMESTAMP(stage" << index << "TraceStart)" << stmtSeparator;
+	stream << nextIndent.str() << "PROFILE_TIMESTAMP(stage" << index << "ProfileStart)" << stmtSeparator;
+	stream << nextIndent.str() << "COUNTERS_BEGIN_STAGE(stage" << index << "Counters" << paramSeparator;
+	stream << "\"" << name << "\"" << paramSeparator << "\"" << space->getName() << "\")" << stmtSeparator;
 	stream << nextIndent.str();
 	stream << "int stage" << index << "Executed = ";
 	stream << name << "(space" << space->getName() << "Lpu" << paramSeparator;
@@ -154,6 +158,14 @@ void StageInstanciation::generateInvocationCode(std::ofstream &stream, int inden
 	}
 	stream << '\n' << nextIndent.str() << doubleIndent << "partition" << paramSeparator;
 	stream << '\n' << nextIndent.str() << doubleIndent << "threadState->threadLog)" << stmtSeparator;
+	stream << nextIndent.str() << "TRACE_RECORD(trace::STAGE_EXECUTION" << paramSeparator << "\"" << name << "\"";
+	stream << paramSeparator << "space" << space->getName() << "Lpu->id";
+	stream << paramSeparator << "stage" << index << "TraceStart)" << stmtSeparator;
+	stream << nextIndent.str() << "PROFILE_RECORD_STAGE(threadState->getThreadNo()";
+	stream << paramSeparator << "Space_" << space->getName();
+	stream << paramSeparator << "space" << space->getName() << "Lpu->id";
+	stream << paramSeparator << "stage" << index << "ProfileStart)" << stmtSeparator;
+	stream << nextIndent.str() << "COUNTERS_END_STAGE(stage" << index << "Counters)" << stmtSeparator;
 
 	// then update all synchronization counters that depend on the execution of this stage for their activation
 	List<SyncRequirement*> *syncList = synchronizationReqs->getAllSyncRequirements();
@@ -185,3 +185,97 @@ void BindOutput::generateCode(std::ostringstream &stream, int indentLevel, Space
 	arg3->translate(stream, indentLevel);
 	stream << ")" << stmtSeparator;
 }
+
+void ArrayScanOperation::translatePartPointer(std::ostringstream &stream, 
+		Expr *arrayArg, int indentLevel, Space *space) {
+	
+	// the local partition and storage dimension copies of the array created at the beginning of the compute stage
+	// give the offset of the LPU's part within the allocated memory 
+	const char *arrayName = arrayArg->getBaseVarName();
+	stream << "(";
+	arrayArg->translate(stream, indentLevel, 0, space);
+	stream << " + (" << arrayName << "PartDims[0].range.min - ";
+	stream << arrayName << "StoreDims[0].range.min))";
+}
+
+void ArrayScanOperation::translatePartLength(std::ostringstream &stream, Expr *arrayArg) {
+	const char *arrayName = arrayArg->getBaseVarName();
+	stream << arrayName << "PartDims[0].getLength()";
+}
+
+void ArrayScanOperation::translateCombiner(std::ostringstream &stream, Expr *outputArg, Space *space) {
+	
+	// the root LPS has a single LPU; so its scans are complete without any combination of part results
+	if (space->isRoot()) {
+		stream << "NULL";
+	} else {
+		stream << outputArg->getBaseVarName() << "ScanCombiner";
+	}
+}
+
+void Scan::translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space) {
+	
+	// argument 1 is the output array
+	Expr *arg1 = arguments->Nth(0);
+	// argument 2 is the input array
+	Expr *arg2 = arguments->Nth(1);
+	Type *elemType = ((ArrayType*) arg2->getType())->getTerminalElementType();
+
+	stream << "prefixscan::inclusiveScan<" << elemType->getName() << ">(";
+	translateCombiner(stream, arg1, space);
+	stream << paramSeparator;
+	translatePartPointer(stream, arg1, indentLevel, space);
+	stream << paramSeparator;
+	translatePartLength(stream, arg1);
+	stream << paramSeparator;
+	translatePartPointer(stream, arg2, indentLevel, space);
+	stream << paramSeparator;
+	translatePartLength(stream, arg2);
+	stream << paramSeparator;
+	stream << arg2->getBaseVarName() << "PartDims[0].range.min";
+	stream << ")";
+}
+
+void ExclusiveScan::translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space) {
+	
+	// argument 1 is the output array
+	Expr *arg1 = arguments->Nth(0);
+	// argument 2 is the input array
+	Expr *arg2 = arguments->Nth(1);
+	Type *elemType = ((ArrayType*) arg2->getType())->getTerminalElementType();
+
+	stream << "prefixscan::exclusiveScan<" << elemType->getName() << ">(";
+	translateCombiner(stream, arg1, space);
+	stream << paramSeparator;
+	translatePartPointer(stream, arg1, indentLevel, space);
+	stream << paramSeparator;
+	translatePartLength(stream, arg1);
+	stream << paramSeparator;
+	translatePartPointer(stream, arg2, indentLevel, space);
+	stream << paramSeparator;
+	translatePartLength(stream, arg2);
+	stream << paramSeparator;
+	stream << arg2->getBaseVarName() << "PartDims[0].range.min";
+	stream << ")";
+}
+
+void Histogram::translate(std::ostringstream &stream, int indentLevel, int currentLineLength, Space *space) {
+	
+	// argument 1 is the counts array
+	Expr *arg1 = arguments->Nth(0);
+	// argument 2 is the keys array
+	Expr *arg2 = arguments->Nth(1);
+
+	// the counts array part covers the keys from the beginning of its partition range
+	const char *countsName = arg1->getBaseVarName();
+	stream << "prefixscan::histogram(";
+	translatePartPointer(stream, arg1, indentLevel, space);
+	stream << paramSeparator;
+	stream << countsName << "PartDims[0].range.min" << paramSeparator;
+	translatePartLength(stream, arg1);
+	stream << paramSeparator;
+	translatePartPointer(stream, arg2, indentLevel, space);
+	stream << paramSeparator;
+	translatePartLength(stream, arg2);
+	stream << ")";
+}
@@ -1,4 +1,6 @@
 #include "../../../utils/name_transformer.h"
+#include "../../../utils/loop_transformation.h"
+#include "../../../utils/blas_kernels.h"
 #include "../../../../../../common-libs/utils/list.h"
 #include "../../../../../../frontend/src/syntax/ast_stmt.h"
 #include "../../../../../../frontend/src/syntax/ast_expr.h"
@@ -13,10 +15,39 @@ void LoopStmt::declareVariablesInScope(std::ostringstream &stream, int indentLev
 
 void LoopStmt::generateIndexLoops(std::ostringstream &stream, int indentLevel, 
 			Space *space, Stmt *body, 
-			List<LogicalExpr*> *indexRestrictions) {
+			List<LogicalExpr*> *indexRestrictions, 
+			bool restructurable) {
 	
 	IndexScope::currentScope->enterScope(indexScope);
 
+	// IT does not specify any index traversal order for parallel loops; so their index loops can be interchanged and
+	// tiled for a better utilization of the cache 
+	List<IndexArrayAssociation*> *associateList = indexScope->getAllPreferredAssociations();
+
+	// a parallel loop computing a recognized linear algebra operation is replaced with a call to the corresponding
+	// BLAS routine; the loops generated afterwards serve as the fallback for LPUs the routine cannot handle
+	bool kernelSubstituted = false;
+	if (restructurable && (indexRestrictions == NULL || indexRestrictions->NumElements() == 0)) {
+		kernelSubstituted = BlasKernelGenerator::generateKernelCall(stream, 
+				indentLevel, space, body, associateList);
+		if (kernelSubstituted) indentLevel++;
+	}
+
+	if (restructurable) {
+		associateList = LoopTransformer::reorderForUnitStride(associateList, indexScope, space);
+		if (isTilable(space, associateList, indexRestrictions)) {
+			int tileSize = LoopTransformer::getTileSize(associateList, indexScope, space);
+			if (tileSize > 0) {
+				generateTiledIndexLoops(stream, indentLevel, space, body, associateList, tileSize);
+				if (kernelSubstituted) {
+					BlasKernelGenerator::closeFallbackBlock(stream, indentLevel - 1);
+				}
+				IndexScope::currentScope->goBackToOldScope();
+				return;
+			}
+		}
+	}
+
 	// create two helper lists to keep track of the index restrictions that remains to be examined as we
 	// put different restrictions in appropriate index traversal loops
 	List<LogicalExpr*> *allRestrictions = indexRestrictions;
@@ -28,7 +59,6 @@ void LoopStmt::generateIndexLoops(std::ostringstream &stream, int indentLevel,
 	// create loops for them
 	List<const char*> *forbiddenIndexes = new List<const char*>;
 	
-	List<IndexArrayAssociation*> *associateList = indexScope->getAllPreferredAssociations();
 	int indentIncrease = 0;
 	for (int i = 0; i < associateList->NumElements(); i++) {
 		
@@ -149,10 +179,115 @@ void LoopStmt::generateIndexLoops(std::ostringstream &stream, int indentLevel,
 		for (int i = 0; i < newIndent; i++) stream << '\t';
 		stream << "}// scope exit for parallel loop on index " << association->getIndex() << "\n"; 
 	}	
+	if (kernelSubstituted) {
+		BlasKernelGenerator::closeFallbackBlock(stream, indentLevel - 1);
+	}
 
 	IndexScope::currentScope->goBackToOldScope();
 }
 
+bool LoopStmt::isTilable(Space *space, 
+		List<IndexArrayAssociation*> *associateList, 
+		List<LogicalExpr*> *indexRestrictions) {
+
+	// Index restrictions are used to tighten the loop boundaries and to skip iterations in the untiled translation;
+	// we do not attempt to distribute them over tile and point loops.
+	if (indexRestrictions != NULL && indexRestrictions->NumElements() > 0) return false;
+	if (associateList->NumElements() < 2) return false;
+
+	Space *rootSpace = space->getRoot();
+	for (int i = 0; i < associateList->NumElements(); i++) {
+		IndexArrayAssociation *association = associateList->Nth(i);
+		ArrayDataStructure *array = (ArrayDataStructure*) space->getLocalStructure(association->getArray());
+		int dimensionNo = association->getDimensionNo() + 1;
+		// single entry indexes do not result in any loop and reordered dimensions need index retransformation
+		// inside the loop; tiling is avoided in both cases
+		if (array->isSingleEntryInDimension(dimensionNo)) return false;
+		if (array->isDimensionReordered(dimensionNo, rootSpace)) return false;
+	}
+	return true;
+}
+
+void LoopStmt::generateTiledIndexLoops(std::ostringstream &stream, int indentLevel, 
+		Space *space, Stmt *body, 
+		List<IndexArrayAssociation*> *associateList, int tileSize) {
+
+	int loopCount = associateList->NumElements();
+	std::ostringstream indent;
+	for (int i = 0; i < indentLevel; i++) indent << '\t';
+
+	stream << indent.str() << "{// scope entrance for tiled parallel loops on indexes";
+	for (int i = 0; i < loopCount; i++) {
+		stream << ' ' << associateList->Nth(i)->getIndex();
+	}
+	stream << " with tile size " << tileSize << "\n";
+
+	// Determine the iteration bounds for each index. Note that since the traversal order of a parallel loop does
+	// not matter, we can always traverse the range from the lower to the upper bound regardless of the direction
+	// of the range. 
+	for (int i = 0; i < loopCount; i++) {
+		IndexArrayAssociation *association = associateList->Nth(i);
+		const char *index = association->getIndex();
+		DataStructure *structure = space->getLocalStructure(association->getArray());
+		RangeExpr *rangeExpr = association->convertToRangeExpr(structure->getType());
+		const char *rangeCond = rangeExpr->getRangeExpr(space);
+		stream << indent.str() << "int " << index << "TileLow = std::min(";
+		stream << rangeCond << ".min, " << rangeCond << ".max);\n";
+		stream << indent.str() << "int " << index << "TileHigh = std::max(";
+		stream << rangeCond << ".min, " << rangeCond << ".max);\n";
+	}
+
+	// generate the tile traversal loops
+	for (int i = 0; i < loopCount; i++) {
+		const char *index = associateList->Nth(i)->getIndex();
+		for (int j = 0; j < indentLevel + i; j++) stream << '\t';
+		stream << "for (int " << index << "Tile = " << index << "TileLow; ";
+		stream << index << "Tile <= " << index << "TileHigh; ";
+		stream << index << "Tile += " << tileSize << ") {\n";
+	}
+
+	// generate the point traversal loops within a tile
+	int pointLoopIndent = indentLevel + loopCount;
+	for (int i = 0; i < loopCount; i++) {
+		IndexArrayAssociation *association = associateList->Nth(i);
+		const char *index = association->getIndex();
+		std::ostringstream loopIndent;
+		for (int j = 0; j < pointLoopIndent + i; j++) loopIndent << '\t';
+		stream << loopIndent.str() << "{// scope entrance for parallel loop on index " << index << "\n";
+		stream << loopIndent.str() << "int " << index << ";\n";
+		stream << loopIndent.str() << "int " << index << "TileEnd = std::min(";
+		stream << index << "Tile + " << tileSize - 1 << ", " << index << "TileHigh);\n";
+		stream << loopIndent.str() << "for (" << index << " = " << index << "Tile; ";
+		stream << index << " <= " << index << "TileEnd; " << index << "++) {\n";
+
+		// generate auxiliary code for multi to unidimensional array indexing transformations
+		List<IndexArrayAssociation*> *list = indexScope->getAssociationsForIndex(index);
+		list = IndexArrayAssociation::filterList(list);
+		for (int j = 0; j < list->NumElements(); j++) {
+			list->Nth(j)->generateTransform(stream, pointLoopIndent + i + 1, space);
+		}
+	}
+
+	// translate the body of the innermost loop
+	body->generateCode(stream, pointLoopIndent + loopCount, space);
+
+	// close the point loops and their scopes
+	for (int i = loopCount - 1; i >= 0; i--) {
+		const char *index = associateList->Nth(i)->getIndex();
+		std::ostringstream loopIndent;
+		for (int j = 0; j < pointLoopIndent + i; j++) loopIndent << '\t';
+		stream << loopIndent.str() << "}\n";
+		stream << loopIndent.str() << "}// scope exit for parallel loop on index " << index << "\n";
+	}
+
+	// close the tile loops
+	for (int i = loopCount - 1; i >= 0; i--) {
+		for (int j = 0; j < indentLevel + i; j++) stream << '\t';
+		stream << "}\n";
+	}
+	stream << indent.str() << "}// scope exit for tiled parallel loops\n";
+}
+
 List<LogicalExpr*> *LoopStmt::getApplicableExprs(Hashtable<const char*> *indexesInvisible, 
                         List<LogicalExpr*> *currentExprList, 
                         List<LogicalExpr*> *remainingExprList) {
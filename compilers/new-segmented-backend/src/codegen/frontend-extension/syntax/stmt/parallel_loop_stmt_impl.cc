@@ -5,5 +5,5 @@
 
 void PLoopStmt::generateCode(std::ostringstream &stream, int indentLevel, Space *space) {
 	List<LogicalExpr*> *restrictions = getIndexRestrictions();
-        LoopStmt::generateIndexLoops(stream, indentLevel, space, body, restrictions);
+        LoopStmt::generateIndexLoops(stream, indentLevel, space, body, restrictions, true);
 }
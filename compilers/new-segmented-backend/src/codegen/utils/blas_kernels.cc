@@ -0,0 +1,497 @@
+#include "blas_kernels.h"
+#include "code_constant.h"
+
+#include "../../../../common-libs/utils/list.h"
+#include "../../../../common-libs/utils/properties.h"
+
+#include "../../../../frontend/src/common/constant.h"
+#include "../../../../frontend/src/syntax/ast_stmt.h"
+#include "../../../../frontend/src/syntax/ast_expr.h"
+#include "../../../../frontend/src/syntax/ast_type.h"
+#include "../../../../frontend/src/semantics/task_space.h"
+#include "../../../../frontend/src/semantics/loop_index.h"
+
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+bool BlasKernelGenerator::enabled = false;
+const char *BlasKernelGenerator::library = "cblas";
+
+//------------------------------------------------------------------------------------------------ Pattern Matching
+
+/* an array element access in the loop body that uses a loop index to access each dimension of the array */
+class ElementAccess {
+  public:
+	Expr *endpoint;
+	const char *arrayName;
+	List<const char*> *indexes;
+	Type *elementType;
+
+	ElementAccess(Expr *endpoint, List<const char*> *indexes, Type *elementType) {
+		this->endpoint = endpoint;
+		this->arrayName = endpoint->getBaseVarName();
+		this->indexes = indexes;
+		this->elementType = elementType;
+	}
+	int getDimensions() { return indexes->NumElements(); }
+	bool usesIndex(const char *index) {
+		for (int i = 0; i < indexes->NumElements(); i++) {
+			if (strcmp(indexes->Nth(i), index) == 0) return true;
+		}
+		return false;
+	}
+	bool isSameAccess(ElementAccess *other) {
+		if (strcmp(arrayName, other->arrayName) != 0) return false;
+		if (getDimensions() != other->getDimensions()) return false;
+		for (int i = 0; i < indexes->NumElements(); i++) {
+			if (strcmp(indexes->Nth(i), other->indexes->Nth(i)) != 0) return false;
+		}
+		return true;
+	}
+};
+
+/* description of a recognized BLAS operation; the operands are listed in the order the BLAS routine takes them */
+class BlasKernel {
+  public:
+	const char *routine;
+	Type *elementType;
+	// a NULL alpha expression means alpha is 1
+	Expr *alpha;
+	bool negated;
+	List<ElementAccess*> *operands;
+	// for level-2 and level-3 routines, tells which of the matrix operands are accessed in transposed order
+	List<bool> *transposed;
+	// the reduction result variable for the dot product
+	ReductionVar *result;
+
+	BlasKernel(const char *routine, Type *elementType) {
+		this->routine = routine;
+		this->elementType = elementType;
+		this->alpha = NULL;
+		this->negated = false;
+		this->operands = new List<ElementAccess*>;
+		this->transposed = new List<bool>;
+		this->result = NULL;
+	}
+};
+
+static bool contains(List<const char*> *list, const char *name) {
+	for (int i = 0; i < list->NumElements(); i++) {
+		if (strcmp(list->Nth(i), name) == 0) return true;
+	}
+	return false;
+}
+
+static ElementAccess *getElementAccess(Expr *expr, List<const char*> *loopIndexes) {
+
+	ArrayAccess *arrayAccess = dynamic_cast<ArrayAccess*>(expr);
+	if (arrayAccess == NULL) return NULL;
+
+	// collect the indexes from the last dimension to the first
+	List<const char*> *indexes = new List<const char*>;
+	Expr *current = arrayAccess;
+	while ((arrayAccess = dynamic_cast<ArrayAccess*>(current)) != NULL) {
+		FieldAccess *indexAccess = dynamic_cast<FieldAccess*>(arrayAccess->getIndex());
+		if (indexAccess == NULL || !indexAccess->isTerminalField()) return NULL;
+		const char *index = indexAccess->getField()->getName();
+		if (!contains(loopIndexes, index)) return NULL;
+		indexes->InsertAt(index, 0);
+		current = arrayAccess->getBase();
+	}
+
+	// only dynamic arrays are stored as dimensionally arranged memory blocks and all their dimensions must be
+	// accessed to get to an element
+	Type *type = current->getType();
+	ArrayType *arrayType = dynamic_cast<ArrayType*>(type);
+	if (arrayType == NULL || dynamic_cast<StaticArrayType*>(type) != NULL) return NULL;
+	if (arrayType->getDimensions() != indexes->NumElements()) return NULL;
+	if (indexes->NumElements() > 2) return NULL;
+	Type *elementType = arrayType->getTerminalElementType();
+	if (elementType != Type::floatType && elementType != Type::doubleType) return NULL;
+	if (current->getBaseVarName() == NULL) return NULL;
+
+	return new ElementAccess(current, indexes, elementType);
+}
+
+static bool isLoopInvariantScalar(Expr *expr, List<const char*> *loopIndexes) {
+
+	Type *type = expr->getType();
+	if (type != Type::intType && type != Type::floatType && type != Type::doubleType) return false;
+
+	// function calls are avoided as they cannot be proven side-effect free here
+	List<Expr*> *disallowedExprs = new List<Expr*>;
+	expr->retrieveExprByType(disallowedExprs, ARRAY_ACC);
+	expr->retrieveExprByType(disallowedExprs, FN_CALL);
+	expr->retrieveExprByType(disallowedExprs, LIB_FN_CALL);
+	expr->retrieveExprByType(disallowedExprs, ASSIGN_EXPR);
+	if (disallowedExprs->NumElements() > 0) return false;
+
+	List<FieldAccess*> *fieldAccesses = new List<FieldAccess*>;
+	expr->retrieveTerminalFieldAccesses(fieldAccesses);
+	for (int i = 0; i < fieldAccesses->NumElements(); i++) {
+		const char *fieldName = fieldAccesses->Nth(i)->getField()->getName();
+		if (contains(loopIndexes, fieldName)) return false;
+	}
+	return true;
+}
+
+static Stmt *getSingleStatement(Stmt *body) {
+	StmtBlock *block = dynamic_cast<StmtBlock*>(body);
+	if (block == NULL) return body;
+	List<Stmt*> *stmts = block->getStmtList();
+	if (stmts->NumElements() != 1) return NULL;
+	return getSingleStatement(stmts->Nth(0));
+}
+
+// splits a 'lhs = lhs + term' or 'lhs = lhs - term' update into the term and the sign; returns NULL if the
+// assignment is not an update of that form
+static Expr *getUpdateTerm(AssignmentExpr *assignment, ElementAccess *updated,
+		List<const char*> *loopIndexes, bool *negated) {
+
+	ArithmaticExpr *rhs = dynamic_cast<ArithmaticExpr*>(assignment->getRight());
+	if (rhs == NULL) return NULL;
+	ArithmaticOperator op = rhs->getOp();
+	if (op != ADD && op != SUBTRACT) return NULL;
+
+	ElementAccess *leftAccess = getElementAccess(rhs->getLeft(), loopIndexes);
+	if (leftAccess != NULL && leftAccess->isSameAccess(updated)) {
+		*negated = (op == SUBTRACT);
+		return rhs->getRight();
+	}
+	ElementAccess *rightAccess = getElementAccess(rhs->getRight(), loopIndexes);
+	if (op == ADD && rightAccess != NULL && rightAccess->isSameAccess(updated)) {
+		*negated = false;
+		return rhs->getLeft();
+	}
+	return NULL;
+}
+
+static BlasKernel *matchUpdatePattern(AssignmentExpr *assignment, List<const char*> *loopIndexes) {
+
+	ElementAccess *updated = getElementAccess(assignment->getLeft(), loopIndexes);
+	if (updated == NULL) return NULL;
+	bool negated = false;
+	Expr *term = getUpdateTerm(assignment, updated, loopIndexes, &negated);
+	if (term == NULL) return NULL;
+
+	// the term can be a single operand only for the AXPY pattern with unit scaling
+	Expr *firstFactor = term;
+	Expr *secondFactor = NULL;
+	ArithmaticExpr *product = dynamic_cast<ArithmaticExpr*>(term);
+	if (product != NULL) {
+		if (product->getOp() != MULTIPLY) return NULL;
+		firstFactor = product->getLeft();
+		secondFactor = product->getRight();
+	}
+	ElementAccess *first = getElementAccess(firstFactor, loopIndexes);
+	ElementAccess *second = (secondFactor != NULL) ? getElementAccess(secondFactor, loopIndexes) : NULL;
+
+	// operands of the product must be distinct from the updated array as BLAS routines do not allow aliasing
+	// between input and output
+	if (first != NULL && strcmp(first->arrayName, updated->arrayName) == 0) return NULL;
+	if (second != NULL && strcmp(second->arrayName, updated->arrayName) == 0) return NULL;
+	if (first != NULL && first->elementType != updated->elementType) return NULL;
+	if (second != NULL && second->elementType != updated->elementType) return NULL;
+
+	Type *elementType = updated->elementType;
+	int loopCount = loopIndexes->NumElements();
+	BlasKernel *kernel = NULL;
+
+	// AXPY: y[i] = y[i] +/- alpha * x[i]
+	if (loopCount == 1 && updated->getDimensions() == 1) {
+		ElementAccess *vector = NULL;
+		Expr *alpha = NULL;
+		if (secondFactor == NULL) {
+			vector = first;
+		} else if (first != NULL && second == NULL && isLoopInvariantScalar(secondFactor, loopIndexes)) {
+			vector = first;
+			alpha = secondFactor;
+		} else if (second != NULL && first == NULL && isLoopInvariantScalar(firstFactor, loopIndexes)) {
+			vector = second;
+			alpha = firstFactor;
+		}
+		if (vector == NULL || vector->getDimensions() != 1) return NULL;
+		if (!vector->usesIndex(updated->indexes->Nth(0))) return NULL;
+		kernel = new BlasKernel("axpy", elementType);
+		kernel->alpha = alpha;
+		kernel->operands->Append(vector);
+		kernel->operands->Append(updated);
+
+	// GEMV: y[i] = y[i] +/- A[i][j] * x[j]
+	} else if (loopCount == 2 && updated->getDimensions() == 1 && first != NULL && second != NULL) {
+		ElementAccess *matrix = (first->getDimensions() == 2) ? first : second;
+		ElementAccess *vector = (first->getDimensions() == 2) ? second : first;
+		if (matrix->getDimensions() != 2 || vector->getDimensions() != 1) return NULL;
+		const char *rowIndex = updated->indexes->Nth(0);
+		const char *columnIndex = vector->indexes->Nth(0);
+		if (strcmp(rowIndex, columnIndex) == 0) return NULL;
+		if (!matrix->usesIndex(rowIndex) || !matrix->usesIndex(columnIndex)) return NULL;
+		kernel = new BlasKernel("gemv", elementType);
+		kernel->operands->Append(matrix);
+		kernel->transposed->Append(strcmp(matrix->indexes->Nth(0), rowIndex) != 0);
+		kernel->operands->Append(vector);
+		kernel->operands->Append(updated);
+
+	// GEMM: c[i][j] = c[i][j] +/- a[i][k] * b[k][j]
+	} else if (loopCount == 3 && updated->getDimensions() == 2 && first != NULL && second != NULL) {
+		if (first->getDimensions() != 2 || second->getDimensions() != 2) return NULL;
+		const char *rowIndex = updated->indexes->Nth(0);
+		const char *columnIndex = updated->indexes->Nth(1);
+		if (strcmp(rowIndex, columnIndex) == 0) return NULL;
+		const char *commonIndex = NULL;
+		for (int i = 0; i < loopCount; i++) {
+			const char *index = loopIndexes->Nth(i);
+			if (!updated->usesIndex(index)) commonIndex = index;
+		}
+		if (commonIndex == NULL) return NULL;
+		ElementAccess *left = first->usesIndex(rowIndex) ? first : second;
+		ElementAccess *right = (left == first) ? second : first;
+		if (!left->usesIndex(rowIndex) || !left->usesIndex(commonIndex)) return NULL;
+		if (!right->usesIndex(commonIndex) || !right->usesIndex(columnIndex)) return NULL;
+		kernel = new BlasKernel("gemm", elementType);
+		kernel->operands->Append(left);
+		kernel->transposed->Append(strcmp(left->indexes->Nth(0), rowIndex) != 0);
+		kernel->operands->Append(right);
+		kernel->transposed->Append(strcmp(right->indexes->Nth(0), commonIndex) != 0);
+		kernel->operands->Append(updated);
+	}
+
+	if (kernel != NULL) kernel->negated = negated;
+	return kernel;
+}
+
+static BlasKernel *matchDotPattern(ReductionStmt *reduction, List<const char*> *loopIndexes, Space *space) {
+
+	if (reduction->getOp() != SUM || reduction->getReductionVar() == NULL) return NULL;
+	if (loopIndexes->NumElements() != 1) return NULL;
+	ArithmaticExpr *product = dynamic_cast<ArithmaticExpr*>(reduction->getRight());
+	if (product == NULL || product->getOp() != MULTIPLY) return NULL;
+	ElementAccess *first = getElementAccess(product->getLeft(), loopIndexes);
+	ElementAccess *second = getElementAccess(product->getRight(), loopIndexes);
+	if (first == NULL || second == NULL) return NULL;
+	if (first->getDimensions() != 1 || second->getDimensions() != 1) return NULL;
+	if (first->elementType != second->elementType) return NULL;
+
+	ReductionVar *result = reduction->getReductionVar();
+	DataStructure *resultStruct = space->getStructure(result->getName());
+	if (resultStruct == NULL || resultStruct->getType() != first->elementType) return NULL;
+
+	BlasKernel *kernel = new BlasKernel("dot", first->elementType);
+	kernel->operands->Append(first);
+	kernel->operands->Append(second);
+	kernel->result = result;
+	return kernel;
+}
+
+// verifies that the storage of the arrays in the kernel is compatible with the BLAS layout requirements
+static bool hasBlasCompatibleLayout(BlasKernel *kernel, Space *space) {
+	Space *rootSpace = space->getRoot();
+	for (int i = 0; i < kernel->operands->NumElements(); i++) {
+		ElementAccess *operand = kernel->operands->Nth(i);
+		DataStructure *structure = space->getStructure(operand->arrayName);
+		ArrayDataStructure *array = dynamic_cast<ArrayDataStructure*>(structure);
+		if (array == NULL) return false;
+		for (int d = 1; d <= operand->getDimensions(); d++) {
+			if (array->isDimensionReordered(d, rootSpace)) return false;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------- Code Generation
+
+static void writeOperandPointer(std::ostringstream &stream, ElementAccess *operand, int indentLevel, Space *space) {
+	const char *arrayName = operand->arrayName;
+	operand->endpoint->translate(stream, indentLevel, 0, space);
+	stream << " + ";
+	if (operand->getDimensions() == 2) {
+		stream << "((long) (" << operand->indexes->Nth(0) << "BlasLow - ";
+		stream << arrayName << "StoreDims[0].range.min))";
+		stream << " * ((long) (" << arrayName << "StoreDims[1].length)) + ";
+		stream << "(" << operand->indexes->Nth(1) << "BlasLow - ";
+		stream << arrayName << "StoreDims[1].range.min)";
+	} else {
+		stream << "(" << operand->indexes->Nth(0) << "BlasLow - ";
+		stream << arrayName << "StoreDims[0].range.min)";
+	}
+}
+
+static void writeLeadingDimension(std::ostringstream &stream, ElementAccess *operand) {
+	stream << operand->arrayName << "StoreDims[1].length";
+}
+
+static void writeAlpha(std::ostringstream &stream, BlasKernel *kernel, int indentLevel, Space *space) {
+	if (kernel->alpha == NULL) {
+		stream << (kernel->negated ? "-1.0" : "1.0");
+	} else {
+		stream << (kernel->negated ? "-(" : "(");
+		kernel->alpha->translate(stream, indentLevel, 0, space);
+		stream << ")";
+	}
+}
+
+static void writeKernelCall(std::ostringstream &stream, BlasKernel *kernel, int indentLevel, Space *space) {
+
+	std::ostringstream indents;
+	for (int i = 0; i < indentLevel; i++) indents << indent;
+	const char *precision = (kernel->elementType == Type::floatType) ? "s" : "d";
+	List<ElementAccess*> *operands = kernel->operands;
+
+	if (strcmp(kernel->routine, "dot") == 0) {
+		ReductionVar *result = kernel->result;
+		stream << indents.str() << result->getName() << "->data.";
+		stream << kernel->elementType->getCType() << "Value += ";
+		stream << "cblas_" << precision << "dot(";
+		stream << operands->Nth(0)->indexes->Nth(0) << "BlasCount" << paramSeparator;
+		writeOperandPointer(stream, operands->Nth(0), indentLevel, space);
+		stream << paramSeparator << 1 << paramSeparator;
+		writeOperandPointer(stream, operands->Nth(1), indentLevel, space);
+		stream << paramSeparator << 1 << ")" << stmtSeparator;
+
+	} else if (strcmp(kernel->routine, "axpy") == 0) {
+		stream << indents.str() << "cblas_" << precision << "axpy(";
+		stream << operands->Nth(1)->indexes->Nth(0) << "BlasCount" << paramSeparator;
+		writeAlpha(stream, kernel, indentLevel, space);
+		stream << paramSeparator;
+		writeOperandPointer(stream, operands->Nth(0), indentLevel, space);
+		stream << paramSeparator << 1 << paramSeparator;
+		writeOperandPointer(stream, operands->Nth(1), indentLevel, space);
+		stream << paramSeparator << 1 << ")" << stmtSeparator;
+
+	} else if (strcmp(kernel->routine, "gemv") == 0) {
+		ElementAccess *matrix = operands->Nth(0);
+		stream << indents.str() << "cblas_" << precision << "gemv(CblasRowMajor, ";
+		stream << (kernel->transposed->Nth(0) ? "CblasTrans" : "CblasNoTrans") << paramSeparator;
+		// the dimension lengths passed are those of the matrix as it is stored, regardless of transposition
+		stream << matrix->indexes->Nth(0) << "BlasCount" << paramSeparator;
+		stream << matrix->indexes->Nth(1) << "BlasCount" << paramSeparator;
+		writeAlpha(stream, kernel, indentLevel, space);
+		stream << paramSeparator << paramIndent << indents.str();
+		writeOperandPointer(stream, matrix, indentLevel, space);
+		stream << paramSeparator;
+		writeLeadingDimension(stream, matrix);
+		stream << paramSeparator << paramIndent << indents.str();
+		writeOperandPointer(stream, operands->Nth(1), indentLevel, space);
+		stream << paramSeparator << 1 << paramSeparator << "1.0" << paramSeparator;
+		stream << paramIndent << indents.str();
+		writeOperandPointer(stream, operands->Nth(2), indentLevel, space);
+		stream << paramSeparator << 1 << ")" << stmtSeparator;
+
+	} else if (strcmp(kernel->routine, "gemm") == 0) {
+		ElementAccess *left = operands->Nth(0);
+		ElementAccess *right = operands->Nth(1);
+		ElementAccess *updated = operands->Nth(2);
+		const char *commonIndex = (kernel->transposed->Nth(0)) ? left->indexes->Nth(0) : left->indexes->Nth(1);
+		stream << indents.str() << "cblas_" << precision << "gemm(CblasRowMajor, ";
+		stream << (kernel->transposed->Nth(0) ? "CblasTrans" : "CblasNoTrans") << paramSeparator;
+		stream << (kernel->transposed->Nth(1) ? "CblasTrans" : "CblasNoTrans") << paramSeparator;
+		stream << updated->indexes->Nth(0) << "BlasCount" << paramSeparator;
+		stream << updated->indexes->Nth(1) << "BlasCount" << paramSeparator;
+		stream << commonIndex << "BlasCount" << paramSeparator;
+		writeAlpha(stream, kernel, indentLevel, space);
+		stream << paramSeparator << paramIndent << indents.str();
+		writeOperandPointer(stream, left, indentLevel, space);
+		stream << paramSeparator;
+		writeLeadingDimension(stream, left);
+		stream << paramSeparator << paramIndent << indents.str();
+		writeOperandPointer(stream, right, indentLevel, space);
+		stream << paramSeparator;
+		writeLeadingDimension(stream, right);
+		stream << paramSeparator << "1.0" << paramSeparator << paramIndent << indents.str();
+		writeOperandPointer(stream, updated, indentLevel, space);
+		stream << paramSeparator;
+		writeLeadingDimension(stream, updated);
+		stream << ")" << stmtSeparator;
+	}
+}
+
+//------------------------------------------------------------------------------------------------ Public Interface
+
+void BlasKernelGenerator::configure() {
+
+	enabled = false;
+	library = "cblas";
+
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps == NULL) return;
+	const char *enableSetting = deploymentProps->getProperty("blas.kernels.enabled");
+	if (enableSetting != NULL && strcmp(enableSetting, "true") == 0) {
+		enabled = true;
+		const char *librarySetting = deploymentProps->getProperty("blas.library");
+		if (librarySetting != NULL && strlen(librarySetting) > 0) {
+			library = librarySetting;
+		}
+		std::cout << "Substituting recognized linear algebra loops with calls to " << library << "\n";
+	}
+}
+
+const char *BlasKernelGenerator::getLibraryLink() {
+	std::ostringstream link;
+	link << 'l' << library;
+	return strdup(link.str().c_str());
+}
+
+bool BlasKernelGenerator::generateKernelCall(std::ostringstream &stream, int indentLevel,
+		Space *space, Stmt *body,
+		List<IndexArrayAssociation*> *loopAssociations) {
+
+	if (!enabled) return false;
+
+	List<const char*> *loopIndexes = new List<const char*>;
+	for (int i = 0; i < loopAssociations->NumElements(); i++) {
+		IndexArrayAssociation *association = loopAssociations->Nth(i);
+		ArrayDataStructure *array = (ArrayDataStructure*) space->getLocalStructure(association->getArray());
+		// single entry indexes do not get any loop of their own so the BLAS dimension lengths cannot be derived
+		// from the index ranges
+		if (array->isSingleEntryInDimension(association->getDimensionNo() + 1)) return false;
+		loopIndexes->Append(association->getIndex());
+	}
+
+	Stmt *stmt = getSingleStatement(body);
+	if (stmt == NULL) return false;
+	BlasKernel *kernel = NULL;
+	AssignmentExpr *assignment = dynamic_cast<AssignmentExpr*>(stmt);
+	ReductionStmt *reduction = dynamic_cast<ReductionStmt*>(stmt);
+	if (assignment != NULL) {
+		kernel = matchUpdatePattern(assignment, loopIndexes);
+	} else if (reduction != NULL) {
+		kernel = matchDotPattern(reduction, loopIndexes, space);
+	}
+	if (kernel == NULL || !hasBlasCompatibleLayout(kernel, space)) return false;
+
+	// BLAS routines expect the elements to be in increasing address order; so the kernel is invoked only when the
+	// index ranges of the LPU are ascending
+	std::ostringstream indents;
+	for (int i = 0; i < indentLevel; i++) indents << indent;
+	List<const char*> *rangeConds = new List<const char*>;
+	for (int i = 0; i < loopAssociations->NumElements(); i++) {
+		IndexArrayAssociation *association = loopAssociations->Nth(i);
+		DataStructure *structure = space->getLocalStructure(association->getArray());
+		RangeExpr *rangeExpr = association->convertToRangeExpr(structure->getType());
+		rangeConds->Append(rangeExpr->getRangeExpr(space));
+	}
+	stream << indents.str() << "if (";
+	for (int i = 0; i < rangeConds->NumElements(); i++) {
+		if (i > 0) stream << paramIndent << indents.str() << "&& ";
+		stream << rangeConds->Nth(i) << ".min <= " << rangeConds->Nth(i) << ".max";
+	}
+	stream << ") {// BLAS " << kernel->routine << " substitution for the parallel loop\n";
+
+	for (int i = 0; i < loopAssociations->NumElements(); i++) {
+		const char *index = loopIndexes->Nth(i);
+		const char *rangeCond = rangeConds->Nth(i);
+		stream << indents.str() << indent << "int " << index << "BlasLow = " << rangeCond << ".min";
+		stream << stmtSeparator;
+		stream << indents.str() << indent << "int " << index << "BlasCount = " << rangeCond << ".max - ";
+		stream << index << "BlasLow + 1" << stmtSeparator;
+	}
+	writeKernelCall(stream, kernel, indentLevel + 1, space);
+	stream << indents.str() << "} else {\n";
+	return true;
+}
+
+void BlasKernelGenerator::closeFallbackBlock(std::ostringstream &stream, int indentLevel) {
+	for (int i = 0; i < indentLevel; i++) stream << indent;
+	stream << "}\n";
+}
@@ -0,0 +1,58 @@
+#ifndef _H_blas_kernels
+#define _H_blas_kernels
+
+#include "../../../../common-libs/utils/list.h"
+
+#include <sstream>
+
+class Space;
+class Stmt;
+class Expr;
+class Type;
+class IndexArrayAssociation;
+
+/* This is an utility class for substituting the index traversal loops of some IT parallel loops with calls to CBLAS
+   routines. Many compute stages of dense linear algebra programs (see the matrix-matrix multiplication, LU
+   factorization, and conjugate gradient sample programs) apply a single level-1, level-2, or level-3 BLAS operation
+   on the LPU-local parts of their arrays. Once IT partitioning and communication have put the data parts in place, a
+   vendor tuned BLAS implementation can compute those operations much faster than the generated loop nests.
+
+   Currently the following parallel loop patterns are recognized (the alternatives with transposed operands,
+   commuted factors, and subtraction in place of addition are recognized too).
+   1. GEMM: do { c[i][j] = c[i][j] + a[i][k] * b[k][j] } for i, j in c; k in a
+   2. GEMV: do { y[i] = y[i] + a[i][j] * x[j] } for i in y; j in x
+   3. AXPY: do { y[i] = y[i] + alpha * x[i] } for i in y
+   4. DOT : do { reduce(result, "sum", x[i] * y[i]) } for i in x
+
+   A pattern is substituted only when the loop has no index restriction, none of the accessed array dimensions is
+   reordered, all arrays have the same single or double precision real element type, and the updated array is not
+   read through any other operand. The generated code further checks at runtime that the index ranges of the LPU are
+   not in descending order and executes the regular loop nest otherwise.
+
+   The substitution is disabled by default as it requires a CBLAS library. It can be enabled by setting the
+   'blas.kernels.enabled' deployment property to true. Then the 'blas.library' property tells what library should be
+   linked with the generated program.
+*/
+class BlasKernelGenerator {
+  private:
+	static bool enabled;
+	static const char *library;
+  public:
+	// this function should be invoked once, after the deployment properties have been read
+	static void configure();
+
+	static bool isEnabled() { return enabled; }
+	// returns the library link annotation, in the format used for extern code blocks, for the CBLAS library
+	static const char *getLibraryLink();
+
+	// This function checks if the body of a parallel loop matches any of the supported BLAS patterns. If it does
+	// then it writes a BLAS routine invocation guarded by a runtime check followed by the beginning of an else
+	// block, and returns true. The caller should then generate the regular loop nest for the else block then call
+	// the close-fallback-block function.
+	static bool generateKernelCall(std::ostringstream &stream, int indentLevel,
+			Space *space, Stmt *body,
+			List<IndexArrayAssociation*> *loopAssociations);
+	static void closeFallbackBlock(std::ostringstream &stream, int indentLevel);
+};
+
+#endif
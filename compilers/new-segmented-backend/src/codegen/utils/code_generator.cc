@@ -3,6 +3,8 @@
 #include "name_transformer.h"
 #include "code_constant.h"
 #include "task_global.h"
+#include "blas_kernels.h"
+#include "lpu_generation.h"
 
 #include "../../../../frontend/src/syntax/ast_def.h"
 #include "../../../../frontend/src/syntax/ast_task.h"
@@ -79,6 +81,10 @@ void initializeOutputFiles(const char *headerFileName,
                                 = externConfig->getIncludesAndLinksForLanguage("C");
                 string_utils::combineLists(headerIncludes, cHeaderAndLinks->getHeaderIncludes());
 	}
+	if (BlasKernelGenerator::isEnabled()) {
+		programFile << "// header file for BLAS routines substituting linear algebra loops\n";
+		programFile << "#include <cblas.h>\n\n";
+	}
 	if (headerIncludes->NumElements() > 0) {
 		programFile << "// header files needed to execute external code blocks\n";
 		for (int i = 0; i < headerIncludes->NumElements(); i++) {
@@ -601,6 +607,10 @@ void generateLpuDataStructures(const char *outputFile,
 				programFile << "_lag_" << j;
 				programFile << stmtSeparator;
 			}
+			if (lpuHoldsEpochVersionedPart(lps, array)) {
+				programFile << indent << "DataPart *" << array->getName() << "DataPart";
+				programFile << stmtSeparator;
+			}
 			
 			int dimensions = array->getDimensionality();
 			programFile << indent << "PartDimension ";
@@ -1095,6 +1105,20 @@ void generateExternLibraryLinkInfo(const char *linkDescriptionFile) {
         	groupLibrayLinkInfo(languageLibraryMap, languageList, externConfig);
 	}
 
+	// the BLAS library is needed when some compute stage loops have been replaced with BLAS routine calls
+	if (BlasKernelGenerator::isEnabled()) {
+		const char *language = "C++";
+		List<const char*> *libraries = NULL;
+		if (string_utils::contains(languageList, language)) {
+			libraries = languageLibraryMap->Lookup(language);
+		} else {
+			libraries = new List<const char*>;
+			languageLibraryMap->Enter(language, libraries);
+			languageList->Append(language);
+		}
+		libraries->Append(BlasKernelGenerator::getLibraryLink());
+	}
+
         // write the libraries to be included by their language type on the library description file
         std::ofstream descriptionFile;
         descriptionFile.open (linkDescriptionFile, std::ofstream::out);
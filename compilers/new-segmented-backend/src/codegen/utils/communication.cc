@@ -2,11 +2,13 @@
 #include "space_mapping.h"
 #include "code_constant.h"
 #include "task_global.h"
+#include "memory_mgmt.h"
 
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/string_utils.h"
 #include "../../../../common-libs/utils/common_utils.h"
 #include "../../../../common-libs/utils/decorator_utils.h"
+#include "../../../../common-libs/utils/properties.h"
 
 #include "../../../../frontend/src/syntax/ast_def.h"
 #include "../../../../frontend/src/syntax/ast_task.h"
@@ -495,9 +497,6 @@ void generateScalarCommmunicatorFn(std::ofstream &headerFile,
 	fnHeader << '\n' << doubleIndent << "TaskGlobals *taskGlobals)";
 
 	fnBody << "{\n\n";
-	
-	// enlist an entry for this communicator in the communication-statistics collector
-	fnBody << indent << "commStat->enlistDependency(\"" << dependencyName << "\")" << stmtSeparator;
 
 	const char *varName = commCharacter->getVarName();
 	DataStructure *structure = rootLps->getStructure(varName);
@@ -554,6 +553,111 @@ void generateScalarCommmunicatorFn(std::ofstream &headerFile,
 	programFile << fnHeader.str() << " " << fnBody.str();
 }
 
+void generateTransferKernelFns(std::ofstream &headerFile,
+                std::ofstream &programFile,
+                const char *initials,
+                const char *dependencyName, 
+		const char *elementTypeName, bool contiguousRunsOnly) {
+
+	std::ostringstream packFnHeader, unpackFnHeader, copyFnHeader;
+	packFnHeader << "packFor_" << dependencyName << "(StridedRun *runs" << paramSeparator;
+	packFnHeader << "long int runCount" << paramSeparator << "char *buffer)";
+	unpackFnHeader << "unpackFor_" << dependencyName << "(char *buffer" << paramSeparator;
+	unpackFnHeader << "StridedRun *runs" << paramSeparator << "long int runCount)";
+	copyFnHeader << "copyFor_" << dependencyName << "(StridedRunPair *runs" << paramSeparator;
+	copyFnHeader << "long int runCount)";
+
+	headerFile << "void " << packFnHeader.str() << stmtSeparator;
+	headerFile << "void " << unpackFnHeader.str() << stmtSeparator;
+	headerFile << "void " << copyFnHeader.str() << stmtSeparator;
+
+	const char *type = elementTypeName;
+
+	// pack and unpack kernels differ only in the direction of the assignment between the operating memory and the 
+	// communication buffer; both walk the runs in the same way
+	for (int direction = 0; direction < 2; direction++) {
+		bool packing = (direction == 0);
+		programFile << "\nvoid " << initials << "::";
+		programFile << (packing ? packFnHeader.str() : unpackFnHeader.str()) << " {\n";
+		programFile << indent << type << " *typedBuffer = (" << type << "*) buffer" << stmtSeparator;
+		programFile << indent << "for (long int r = 0; r < runCount; r++) {\n";
+		programFile << doubleIndent << type << " *memory = (" << type << "*) runs[r].location" << stmtSeparator;
+		programFile << doubleIndent << type << " *bufferRun = typedBuffer + runs[r].bufferIndex" << stmtSeparator;
+		programFile << doubleIndent << "long int length = runs[r].length" << stmtSeparator;
+		const char *contiguousAssignment = packing ? "bufferRun[i] = memory[i]" : "memory[i] = bufferRun[i]";
+		const char *stridedAssignment = packing 
+				? "bufferRun[i] = memory[i * step]" : "memory[i * step] = bufferRun[i]";
+		if (contiguousRunsOnly) {
+			programFile << doubleIndent << "for (long int i = 0; i < length; i++) {\n";
+			programFile << tripleIndent << contiguousAssignment << stmtSeparator;
+			programFile << doubleIndent << "}\n";
+		} else {
+			programFile << doubleIndent << "long int step = runs[r].stride / (long int) sizeof(";
+			programFile << type << ")" << stmtSeparator;
+			programFile << doubleIndent << "if (step == 1) {\n";
+			programFile << tripleIndent << "for (long int i = 0; i < length; i++) {\n";
+			programFile << quadIndent << contiguousAssignment << stmtSeparator;
+			programFile << tripleIndent << "}\n";
+			programFile << doubleIndent << "} else {\n";
+			programFile << tripleIndent << "for (long int i = 0; i < length; i++) {\n";
+			programFile << quadIndent << stridedAssignment << stmtSeparator;
+			programFile << tripleIndent << "}\n";
+			programFile << doubleIndent << "}\n";
+		}
+		programFile << indent << "}\n";
+		programFile << "}\n";
+	}
+
+	programFile << "\nvoid " << initials << "::" << copyFnHeader.str() << " {\n";
+	programFile << indent << "for (long int r = 0; r < runCount; r++) {\n";
+	programFile << doubleIndent << type << " *source = (" << type << "*) runs[r].source" << stmtSeparator;
+	programFile << doubleIndent << type << " *destination = (" << type << "*) runs[r].destination" << stmtSeparator;
+	programFile << doubleIndent << "long int length = runs[r].length" << stmtSeparator;
+	if (contiguousRunsOnly) {
+		programFile << doubleIndent << "for (long int i = 0; i < length; i++) {\n";
+		programFile << tripleIndent << "destination[i] = source[i]" << stmtSeparator;
+		programFile << doubleIndent << "}\n";
+	} else {
+		programFile << doubleIndent << "long int sourceStep = runs[r].sourceStride / (long int) sizeof(";
+		programFile << type << ")" << stmtSeparator;
+		programFile << doubleIndent << "long int destinationStep = runs[r].destinationStride / (long int) sizeof(";
+		programFile << type << ")" << stmtSeparator;
+		programFile << doubleIndent << "if (sourceStep == 1 && destinationStep == 1) {\n";
+		programFile << tripleIndent << "for (long int i = 0; i < length; i++) {\n";
+		programFile << quadIndent << "destination[i] = source[i]" << stmtSeparator;
+		programFile << tripleIndent << "}\n";
+		programFile << doubleIndent << "} else {\n";
+		programFile << tripleIndent << "for (long int i = 0; i < length; i++) {\n";
+		programFile << quadIndent << "destination[i * destinationStep] = source[i * sourceStep]";
+		programFile << stmtSeparator;
+		programFile << tripleIndent << "}\n";
+		programFile << doubleIndent << "}\n";
+	}
+	programFile << indent << "}\n";
+	programFile << "}\n";
+}
+
+bool isCompressedTransferArray(const char *varName) {
+
+	// by default, communication buffers are transferred as they are
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps == NULL) return false;
+	const char *setting = deploymentProps->getProperty("comm.compression.arrays");
+	if (setting == NULL) return false;
+	std::string arrayNames = std::string(setting);
+	std::string delims = ",";
+	List<std::string> *arrayNameList = string_utils::tokenizeString(arrayNames, delims);
+	bool found = false;
+	for (int i = 0; i < arrayNameList->NumElements(); i++) {
+		if (arrayNameList->Nth(i).compare(varName) == 0) {
+			found = true;
+			break;
+		}
+	}
+	delete arrayNameList;
+	return found;
+}
+
 void generateArrayCommmunicatorFn(std::ofstream &headerFile,
                 std::ofstream &programFile,
                 const char *initials,
@@ -578,6 +682,21 @@ void generateArrayCommmunicatorFn(std::ofstream &headerFile,
 	decorator::writeSubsectionHeader(headerFile, dependencyName);
 	decorator::writeSubsectionHeader(programFile, dependencyName);
 
+	// determine if the data structure has multiple versions; this will tell if we can preprocessed buffers that keep track
+	// of operating memory addresses to populate (and vice versa) elements of the communication buffer for a data exchange
+	// note that the default version count is 0; generated transfer kernels work on such memory addresses; so they are
+	// only generated for data structures having a single version
+	int versionCount = structure->getVersionCount();
+	bool indexMappedBuffers = (versionCount > 0);
+	
+	// the parts of a one dimensional array hold their elements adjacently in any LPS; so data exchanges of such an array
+	// consist of contiguous runs only and need no strided transfer kernels
+	bool contiguousRunsOnly = (varType->getDimensions() == 1);
+	if (!indexMappedBuffers) {
+		generateTransferKernelFns(headerFile, programFile, 
+				initials, dependencyName, elementTypeName, contiguousRunsOnly);
+	}
+
 	std::ostringstream fnHeader;
 	std::ostringstream fnBody;
 
@@ -585,13 +704,12 @@ void generateArrayCommmunicatorFn(std::ofstream &headerFile,
 	fnHeader << '\n' << doubleIndent << "TaskData *taskData" << paramSeparator;
 	fnHeader << '\n' << doubleIndent << "Hashtable<DataPartitionConfig*> *partConfigMap" << paramSeparator;
 	fnHeader << '\n' << doubleIndent << "CommStatistics *commStat" << paramSeparator;
-	fnHeader << "\n" << doubleIndent << "PartDistributionMap *distributionMap)";
+	fnHeader << "\n" << doubleIndent << "PartDistributionMap *distributionMap" << paramSeparator;
+	fnHeader << "\n" << doubleIndent << "LaunchPlan *launchPlan" << paramSeparator;
+	fnHeader << "\n" << doubleIndent << "int setupThreads)";
 
 	fnBody << "{\n\n";
 
-	// enlist an entry for this communicator in the communication-statistics collector
-	fnBody << indent << "commStat->enlistDependency(\"" << dependencyName << "\")" << stmtSeparator;
-
 	// create confinement configuration object for the dependency first
 	fnBody << indent << "int localSegmentTag = localSegment->getPhysicalId()" << stmtSeparator;
 	fnBody << indent << "ConfinementConstructionConfig *ccConfig = getConfineConstrConfigFor_";
@@ -601,14 +719,22 @@ void generateArrayCommmunicatorFn(std::ofstream &headerFile,
 	fnBody << '\n' << tripleIndent << "distributionMap)" << stmtSeparator;
 	fnBody << indent << "ccConfig->configurePaddingInPartitionConfigsForReadWrite()" << stmtSeparator;
 	
-	// then retrieve all data exchanges applicable for the current segments for this dependency
-	fnBody << indent << "struct timeval start" << stmtSeparator;
-        fnBody << indent << "gettimeofday(&start, NULL)" << stmtSeparator;
-	fnBody << indent << "List<DataExchange*> *dataExchangeList = getDataExchangeListFor_";
+	// then retrieve all data exchanges applicable for the current segments for this dependency; the exchanges are only
+	// computed if the launch plan does not have them from an earlier invocation of the task
+	fnBody << indent << "int64_t start = timing::now()" << stmtSeparator;
+	fnBody << indent << "List<DataExchange*> *dataExchangeList = NULL" << stmtSeparator;
+	fnBody << indent << "if (launchPlan->hasDataExchangeList(\"" << dependencyName << "\")) {\n";
+	fnBody << doubleIndent << "dataExchangeList = launchPlan->getDataExchangeList(\"";
+	fnBody << dependencyName << "\")" << stmtSeparator;
+	fnBody << indent << "} else {\n";
+	fnBody << doubleIndent << "dataExchangeList = getDataExchangeListFor_";
 	fnBody << dependencyName << "(taskData" << paramSeparator;
-	fnBody << '\n' << tripleIndent << "partConfigMap" << paramSeparator;
-	fnBody << '\n' << tripleIndent << "localSegmentTag" << paramSeparator;
-	fnBody << '\n' << tripleIndent << "distributionMap)" << stmtSeparator;
+	fnBody << '\n' << quadIndent << "partConfigMap" << paramSeparator;
+	fnBody << '\n' << quadIndent << "localSegmentTag" << paramSeparator;
+	fnBody << '\n' << quadIndent << "distributionMap)" << stmtSeparator;
+	fnBody << doubleIndent << "launchPlan->setDataExchangeList(\"" << dependencyName << "\"" << paramSeparator;
+	fnBody << "dataExchangeList)" << stmtSeparator;
+	fnBody << indent << "}\n";
 
 	// if there is no data-exchanges in the list then the current segment will not participate in any communication involving 
 	// this data dependency
@@ -616,8 +742,7 @@ void generateArrayCommmunicatorFn(std::ofstream &headerFile,
 	fnBody << stmtSeparator << '\n';
 
 	// otherwise log the time spent on creating the data exchange list
-	fnBody << indent << "struct timeval middle" << stmtSeparator;
-        fnBody << indent << "gettimeofday(&middle, NULL)" << stmtSeparator;
+	fnBody << indent << "int64_t middle = timing::now()" << stmtSeparator;
 	fnBody << indent << "commStat->addConfinementConstrTime(\"" << dependencyName << "\"" << paramSeparator;
 	fnBody << "start" << paramSeparator << "middle)" << stmtSeparator;
 
@@ -646,20 +771,13 @@ void generateArrayCommmunicatorFn(std::ofstream &headerFile,
 	fnBody << indent << "int localReceiverPpus = localSegment->getPpuCountForLps(Space_";
 	fnBody << waitingLpsName << ")" << stmtSeparator << '\n';
 
-	// determine if the data structure has multiple versions; this will tell if we can preprocessed buffers that keep track
-	// of operating memory addresses to populate (and vice versa) elements of the communication buffer for a data exchange
-	// note that the default version count is 0 
-	int versionCount = structure->getVersionCount();
-	const char *bufferTypePrefix = (versionCount > 0) ? "SwiftIndexMapped" : "Preprocessed";
-
-	// instantiate a list of communication buffers to add virtual/physical communication buffers into it for data exchanges
-	// based on whether or not the exchange demands cross-segments communication 
-	fnBody << indent << "List<CommBuffer*> *bufferList = new List<CommBuffer*>" << stmtSeparator;
-	fnBody << indent << "Assert(bufferList != NULL)" << stmtSeparator;
-	// also instanciate a vector for tracking all segments that do communication for the current data dependency within the
-	// confinements that are relevant to the current segment
+	// instanciate a vector for tracking all segments that do communication for the current data dependency within the
+	// confinements that are relevant to the current segment and a list for the data exchanges the current segment takes
+	// part in
 	fnBody << indent << "std::vector<int> *participantTags = new std::vector<int>" << stmtSeparator;
 	fnBody << indent << "Assert(participantTags != NULL)" << stmtSeparator;
+	fnBody << indent << "List<DataExchange*> *localExchangeList = new List<DataExchange*>" << stmtSeparator;
+	fnBody << indent << "Assert(localExchangeList != NULL)" << stmtSeparator;
 	fnBody << indent << "for (int i = 0; i < dataExchangeList->NumElements(); i++) {\n\n";
 	fnBody << doubleIndent << "DataExchange *exchange = dataExchangeList->Nth(i)" << stmtSeparator;
 	// put the participant segments in the participants list and skip this data exchange if the local segment is not 
@@ -672,30 +790,34 @@ void generateArrayCommmunicatorFn(std::ofstream &headerFile,
 	fnBody << " = exchange->getReceiver()->getSegmentTags()" << stmtSeparator;
 	fnBody << doubleIndent << "binsearch::addThoseNotExist(participantTags" << paramSeparator;
 	fnBody << "&receiverTags)" << stmtSeparator;
-	fnBody << doubleIndent << "if (!exchange->involvesLocalSegment(localSegmentTag)) continue"; 
-	fnBody << stmtSeparator << "\n";
-	// otherwise continue and create an appropriate communication buffer for the exchange and add that in the list of buffers
-	fnBody << doubleIndent << "CommBuffer *buffer = NULL" << stmtSeparator;
-	fnBody << doubleIndent << "if (exchange->isIntraSegmentExchange(localSegmentTag)) {\n";
-	fnBody << tripleIndent << "buffer = new " << bufferTypePrefix << "VirtualCommBuffer(";
-	fnBody << "exchange" << paramSeparator;
-	fnBody << "syncConfig" << ")" << stmtSeparator;
-	fnBody << doubleIndent << "} else {\n";
-	fnBody << tripleIndent << "buffer = new " << bufferTypePrefix << "PhysicalCommBuffer(";
-	fnBody << "exchange" << paramSeparator;
-	fnBody << "syncConfig" << ")" << stmtSeparator;
+	fnBody << doubleIndent << "if (exchange->involvesLocalSegment(localSegmentTag)) {\n";
+	fnBody << tripleIndent << "localExchangeList->Append(exchange)" << stmtSeparator;
 	fnBody << doubleIndent << "}\n";
-	fnBody << doubleIndent << "Assert(buffer != NULL)" << stmtSeparator;
-	fnBody << doubleIndent << "bufferList->Append(buffer)" << stmtSeparator;
 	fnBody << indent << "}\n";
 
+	// then create virtual/physical communication buffers for the local data exchanges based on whether or not each exchange
+	// demands cross-segments communication; the buffers are constructed by multiple threads as locating the operating
+	// memory addresses of the buffer elements can take long for large exchanges
+	fnBody << indent << "CommBufferConstructor bufferConstructor(localExchangeList" << paramSeparator;
+	fnBody << "syncConfig" << paramSeparator << "localSegmentTag" << paramSeparator;
+	fnBody << (indexMappedBuffers ? "true" : "false") << ")" << stmtSeparator;
+	if (!indexMappedBuffers) {
+		fnBody << indent << "static TransferKernels transferKernels(packFor_" << dependencyName << paramSeparator;
+		fnBody << "unpackFor_" << dependencyName << paramSeparator;
+		fnBody << "copyFor_" << dependencyName << paramSeparator;
+		fnBody << (contiguousRunsOnly ? "true" : "false") << ")" << stmtSeparator;
+		fnBody << indent << "bufferConstructor.setTransferKernels(&transferKernels)" << stmtSeparator;
+	}
+	fnBody << indent << "List<CommBuffer*> *bufferList = bufferConstructor.constructBuffers(setupThreads)";
+	fnBody << stmtSeparator;
+	fnBody << indent << "delete localExchangeList" << stmtSeparator;
+
 	// if there is no buffer in the buffer list then this segment does not participate in dependency resolution at all; thus
 	// returns a NULL communicator in that case
 	fnBody << indent << "if (bufferList->NumElements() == 0) return NULL" << stmtSeparator;
 
 	// otherwise log the time spent on creating the communication buffers
-	fnBody << indent << "struct timeval end" << stmtSeparator;
-        fnBody << indent << "gettimeofday(&end, NULL)" << stmtSeparator;
+	fnBody << indent << "int64_t end = timing::now()" << stmtSeparator;
 	fnBody << indent << "commStat->addBufferSetupTime(\"" << dependencyName << "\"" << paramSeparator;
 	fnBody << "middle" << paramSeparator << "end)" << stmtSeparator;
 
@@ -718,6 +840,18 @@ void generateArrayCommmunicatorFn(std::ofstream &headerFile,
 	fnBody << "localSenderPpus" << paramSeparator << "localReceiverPpus" << paramSeparator;
 	fnBody << "bufferList)" << stmtSeparator;
 	fnBody << indent << "Assert(communicator != NULL)" << stmtSeparator;
+
+	// replicas held in node shared memory need to be synchronized only among the nodes
+	if (dynamic_cast<ReplicationSync*>(syncRequirement) != NULL && isNodeSharedReplica(varName)) {
+		fnBody << indent << "((ReplicationSyncCommunicator*) communicator)->setNodeSharedReplica(true)";
+		fnBody << stmtSeparator;
+	}
+	// up and down syncs of arrays configured for compression may compress their buffers on bandwidth-bound links
+	if ((dynamic_cast<UpPropagationSync*>(syncRequirement) != NULL
+			|| dynamic_cast<DownPropagationSync*>(syncRequirement) != NULL)
+			&& isCompressedTransferArray(varName)) {
+		fnBody << indent << "communicator->setCompressionEnabled(true)" << stmtSeparator;
+	}
 	fnBody << indent << "communicator->setParticipants(participantTags)" << stmtSeparator;
 	fnBody << indent << "communicator->setCommStat(commStat)" << stmtSeparator;
 
@@ -798,6 +932,81 @@ void generateCommunicatorMapFn(const char *headerFileName,
 	decorator::writeSubsectionHeader(headerFile, "communicator map");
 	decorator::writeSubsectionHeader(programFile, "communicator map");
 
+	// Array communicators are constructed in parallel as their construction involves heavy computations. The partition
+	// instructions of an array, however, are shared by all its partition configurations and their padding settings are 
+	// altered to suit individual dependencies. So the dependencies of the same array are put in a single group to be 
+	// processed one after another.
+	List<const char*> *arrayNames = new List<const char*>;
+	List<List<int>*> *communicatorGroups = new List<List<int>*>;
+	for (int i = 0; i < commCharacterList->NumElements(); i++) {
+		const char *varName = commCharacterList->Nth(i)->getVarName();
+		ArrayDataStructure *array = dynamic_cast<ArrayDataStructure*>(rootLps->getStructure(varName));
+		if (array == NULL) continue;
+		int groupNo = -1;
+		for (int j = 0; j < arrayNames->NumElements(); j++) {
+			if (strcmp(arrayNames->Nth(j), varName) == 0) {
+				groupNo = j;
+				break;
+			}
+		}
+		if (groupNo == -1) {
+			arrayNames->Append(varName);
+			communicatorGroups->Append(new List<int>);
+			groupNo = arrayNames->NumElements() - 1;
+		}
+		communicatorGroups->Nth(groupNo)->Append(i);
+	}
+	int groupCount = communicatorGroups->NumElements();
+
+	if (groupCount > 0) {
+		
+		// generate a class for holding the arguments needed for constructing array communicators 
+		programFile << "\nclass CommunicatorSetupArg {\n";
+		programFile << "  public:\n";
+		programFile << indent << "SegmentState *localSegment" << stmtSeparator;
+		programFile << indent << "TaskData *taskData" << stmtSeparator;
+		programFile << indent << "Hashtable<DataPartitionConfig*> *partConfigMap" << stmtSeparator;
+		programFile << indent << "CommStatistics *commStat" << stmtSeparator;
+		programFile << indent << "PartDistributionMap *distributionMap" << stmtSeparator;
+		programFile << indent << "LaunchPlan *launchPlan" << stmtSeparator;
+		programFile << indent << "int bufferSetupThreads" << stmtSeparator;
+		programFile << indent << "Communicator **communicators" << stmtSeparator;
+		programFile << "};\n";
+
+		// then generate a work function that constructs the communicators of one group
+		std::ostringstream groupFnHeader;
+		std::ostringstream groupFnBody;
+		groupFnHeader << "constructArrayCommunicators(int groupNo" << paramSeparator << "void *argument)";
+		groupFnBody << "{\n\n";
+		groupFnBody << indent << "CommunicatorSetupArg *setupArg = (CommunicatorSetupArg*) argument" << stmtSeparator;
+		for (int g = 0; g < groupCount; g++) {
+			List<int> *group = communicatorGroups->Nth(g);
+			groupFnBody << indent << ((g == 0) ? "if" : "} else if") << " (groupNo == " << g << ") {\n";
+			for (int j = 0; j < group->NumElements(); j++) {
+				int commNo = group->Nth(j);
+				CommunicationCharacteristics *commCharacter = commCharacterList->Nth(commNo);
+				const char *dependencyName 
+						= commCharacter->getSyncRequirement()->getDependencyArc()->getArcName();
+				groupFnBody << doubleIndent << "setupArg->communicators[" << commNo << "] = ";
+				groupFnBody << "getCommunicatorFor_" << dependencyName << "(";
+				groupFnBody << "setupArg->localSegment" << paramSeparator;
+				groupFnBody << '\n' << doubleIndent << doubleIndent;
+				groupFnBody << "setupArg->taskData" << paramSeparator;
+				groupFnBody << "setupArg->partConfigMap" << paramSeparator;
+				groupFnBody << "setupArg->commStat" << paramSeparator;
+				groupFnBody << '\n' << doubleIndent << doubleIndent;
+				groupFnBody << "setupArg->distributionMap" << paramSeparator;
+				groupFnBody << "setupArg->launchPlan" << paramSeparator;
+				groupFnBody << "setupArg->bufferSetupThreads)" << stmtSeparator;
+			}
+		}
+		groupFnBody << indent << "}\n";
+		groupFnBody << "}\n";
+
+		headerFile << "void " << groupFnHeader.str() << stmtSeparator;
+		programFile << "\nvoid " << initials << "::" << groupFnHeader.str() << " " << groupFnBody.str();
+	}
+
 	std::ostringstream fnHeader;
 	std::ostringstream fnBody;
 
@@ -808,6 +1017,7 @@ void generateCommunicatorMapFn(const char *headerFileName,
 	fnHeader << '\n' << doubleIndent << "TaskGlobals *taskGlobals" << paramSeparator;
 	fnHeader << '\n' << doubleIndent << "Hashtable<DataPartitionConfig*> *partConfigMap" << paramSeparator;
 	fnHeader << "\n" << doubleIndent << "PartDistributionMap *distributionMap" << paramSeparator;
+	fnHeader << "\n" << doubleIndent << "LaunchPlan *launchPlan" << paramSeparator;
 	fnHeader << "\n" << doubleIndent << "CommStatistics *commStat" << paramSeparator;
 	fnHeader << "\n" << doubleIndent << "std::ofstream &logFile)";
 
@@ -821,6 +1031,33 @@ void generateCommunicatorMapFn(const char *headerFileName,
 	// determine the number of segments in the machine to be used for setting up communication buffer tags
 	fnBody << indent << "int segmentCount = Total_Threads / Threads_Per_Segment" << stmtSeparator << "\n";
 
+	// enlist entries for all communicators in the communication-statistics collector in a fixed order
+	for (int i = 0; i < commCharacterList->NumElements(); i++) {
+		SyncRequirement *syncReq = commCharacterList->Nth(i)->getSyncRequirement();
+		const char *dependencyName = syncReq->getDependencyArc()->getArcName();
+		fnBody << indent << "commStat->enlistDependency(\"" << dependencyName << "\")" << stmtSeparator;
+	}
+
+	// construct the array communicators using the cores of the segment that are idle before the task's threads start; 
+	// the threads available for each group of communicators are used to construct the communication buffers
+	if (groupCount > 0) {
+		fnBody << '\n' << indent << "Communicator *arrayCommunicators[";
+		fnBody << commCharacterList->NumElements() << "]" << stmtSeparator;
+		fnBody << indent << "CommunicatorSetupArg setupArg" << stmtSeparator;
+		fnBody << indent << "setupArg.localSegment = localSegment" << stmtSeparator;
+		fnBody << indent << "setupArg.taskData = taskData" << stmtSeparator;
+		fnBody << indent << "setupArg.partConfigMap = partConfigMap" << stmtSeparator;
+		fnBody << indent << "setupArg.commStat = commStat" << stmtSeparator;
+		fnBody << indent << "setupArg.distributionMap = distributionMap" << stmtSeparator;
+		fnBody << indent << "setupArg.launchPlan = launchPlan" << stmtSeparator;
+		fnBody << indent << "setupArg.bufferSetupThreads = std::max(1" << paramSeparator;
+		fnBody << "Threads_Per_Segment / " << groupCount << ")" << stmtSeparator;
+		fnBody << indent << "setupArg.communicators = arrayCommunicators" << stmtSeparator;
+		fnBody << indent << "WorkQueue setupQueue(" << groupCount << paramSeparator;
+		fnBody << "constructArrayCommunicators" << paramSeparator << "&setupArg)" << stmtSeparator;
+		fnBody << indent << "setupQueue.process(Threads_Per_Segment)" << stmtSeparator << '\n';
+	}
+
 	// iterate over the list of communication characteristics and invoke appropriate function to create a communicator
 	// each entry in the list
 	for (int i = 0; i < commCharacterList->NumElements(); i++) {
@@ -833,28 +1070,30 @@ void generateCommunicatorMapFn(const char *headerFileName,
 		Type *varType = structure->getType();
 		ArrayDataStructure *array = dynamic_cast<ArrayDataStructure*>(structure);
 		
-		fnBody << indent << "Communicator *communicator" << i << " = getCommunicatorFor_";
-		fnBody << dependencyName << "(";
 		if (array == NULL) {
+			fnBody << indent << "Communicator *communicator" << i << " = getCommunicatorFor_";
+			fnBody << dependencyName << "(";
 			fnBody << "localSegment" << paramSeparator;
 			fnBody << '\n' << indent << doubleIndent;
 			fnBody << "segmentList" << paramSeparator;
 			fnBody << "taskData" << paramSeparator;
 			fnBody << "commStat" << paramSeparator;
-			fnBody << "taskGlobals";
+			fnBody << "taskGlobals)" << stmtSeparator;
 		} else {
-			fnBody << "localSegment" << paramSeparator;
-			fnBody << '\n' << indent << doubleIndent;
-			fnBody << "taskData" << paramSeparator;
-			fnBody << "partConfigMap" << paramSeparator;
-			fnBody << "commStat" << paramSeparator;
-			fnBody << "distributionMap";
+			fnBody << indent << "Communicator *communicator" << i << " = ";
+			fnBody << "arrayCommunicators[" << i << "]" << stmtSeparator;
 		}
-		fnBody << ")" << stmtSeparator;
 		fnBody << indent << "if (communicator" << i << " != NULL) {\n";
 		fnBody << doubleIndent << "communicator" << i <<  "->setLogFile(&logFile)" << stmtSeparator;
 		fnBody << doubleIndent << "communicator" << i << "->setupBufferTags(" << i + 1;
 		fnBody << paramSeparator << "segmentCount)" << stmtSeparator;
+		
+		// an array communicator adopts the segment group of the same dependency from the launch plan, if exists, to
+		// avoid repeating the collective group formation
+		if (array != NULL) {
+			fnBody << doubleIndent << "communicator" << i << "->setSegmentGroup(";
+			fnBody << "launchPlan->getSegmentGroup(\"" << dependencyName << "\"))" << stmtSeparator;
+		}
 		fnBody << doubleIndent << "communicator" << i;
 		if (array == NULL) {
 			// scalar communicator needs not to bother about segments that they do not directly interact with
@@ -871,14 +1110,23 @@ void generateCommunicatorMapFn(const char *headerFileName,
 			}
 		}
 		fnBody << stmtSeparator;
+		if (array != NULL) {
+			fnBody << doubleIndent << "launchPlan->setSegmentGroup(\"" << dependencyName << "\"" << paramSeparator;
+			fnBody << "communicator" << i << "->getSegmentGroup())" << stmtSeparator;
+		}
 		fnBody << doubleIndent << "communicatorMap->Enter(\"" << dependencyName << "\"" << paramSeparator;
 		fnBody << "communicator" << i << ")" << stmtSeparator;
 
 		// if the current segment does not participate in communication for the underlying dependency then exclude
 		// it from any communication resource setup that needs participation from all segments (both communicating
-		// and non communicating) by invoking a static function in the communicator class.
+		// and non communicating) by invoking a static function in the communicator class. When the launch plan has been
+		// reused, the interacting segments do not form the group again; so exclusion is not needed either.
 		if (commCharacter->shouldAllocateGroupResources()) {		
-			fnBody << indent << "} else {\n";
+			if (array != NULL) {
+				fnBody << indent << "} else if (!launchPlan->isReused()) {\n";
+			} else {
+				fnBody << indent << "} else {\n";
+			}
 			fnBody << doubleIndent << "Communicator::excludeOwnselfFromCommunication(";
 			fnBody << '"' << dependencyName << '"' << paramSeparator;
 			fnBody << '\n' << quadIndent;
@@ -899,6 +1147,12 @@ void generateCommunicatorMapFn(const char *headerFileName,
 	programFile << "\nHashtable<Communicator*> *" << initials << "::";
 	programFile << fnHeader.str() << " " << fnBody.str();
 
+	for (int g = 0; g < groupCount; g++) {
+		delete communicatorGroups->Nth(g);
+	}
+	delete communicatorGroups;
+	delete arrayNames;
+
 	programFile.close();
 	headerFile.close();
 }
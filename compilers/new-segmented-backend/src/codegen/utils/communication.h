@@ -69,6 +69,18 @@ void generateScalarCommmunicatorFn(std::ofstream &headerFile,
                 const char *initials,
                 Space *rootLps, CommunicationCharacteristics *commCharacter);	
 
+// This function generates typed pack, unpack, and copy kernels for moving runs of elements of an array to be synchronized
+// for a dependency between pre-identified operating memory locations and communication buffers; if contiguousRunsOnly is
+// set then the kernels only handle runs of adjacent elements, otherwise they handle strided runs 
+void generateTransferKernelFns(std::ofstream &headerFile,
+                std::ofstream &programFile,
+                const char *initials,
+                const char *dependencyName, 
+		const char *elementTypeName, bool contiguousRunsOnly);
+
+// This function tells if the deployment properties ask for compressing the communication buffers of an array
+bool isCompressedTransferArray(const char *varName);
+
 // This function generates a functions to instantiating a communicator for synchronizing an array update dependency
 void generateArrayCommmunicatorFn(std::ofstream &headerFile,
                 std::ofstream &programFile,
@@ -6,6 +6,7 @@
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/string_utils.h"
 #include "../../../../common-libs/utils/decorator_utils.h"
+#include "../../../../common-libs/utils/properties.h"
 
 #include "../../../../frontend/src/syntax/ast_task.h"
 #include "../../../../frontend/src/semantics/scope.h"
@@ -17,6 +18,7 @@
 #include <sstream>
 #include <stdio.h>
 #include <cstdlib>
+#include <string.h>
 #include <deque>	
 
 int parseComputation(FlowStage *currentStage, const char *initialsLower,
@@ -134,6 +136,17 @@ void generateFnsForComputation(TaskDef *taskDef, const char *headerFileName,
         programFile.close();
 }
 
+bool isLpuScheduleCacheEnabled() {
+
+	// by default, threads record their LPU traversals and replay them when the same traversals are repeated
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps != NULL) {
+		const char *setting = deploymentProps->getProperty("lpu.schedule.cache.enabled");
+		if (setting != NULL && strcmp(setting, "true") != 0) return false;
+	}
+	return true;
+}
+
 void generateThreadRunFunction(TaskDef *taskDef, const char *headerFileName,
                 const char *programFileName, 
 		const char *initials, 
@@ -188,6 +201,13 @@ void generateThreadRunFunction(TaskDef *taskDef, const char *headerFileName,
 	programFile << "\t\tthreadState->setRootLpu(arrayMetadata);\n";
 	programFile << "\t}\n";
 
+	// enable recording and replaying of LPU traversals if that is not disabled in the deployment
+	bool scheduleCacheEnabled = isLpuScheduleCacheEnabled();
+	if (scheduleCacheEnabled) {
+		programFile << "\n\t// enable reuse of LPUs generated in earlier traversals\n";
+		programFile << "\tthreadState->enableLpuScheduleCache();\n";
+	}
+
 	// if the task involves synchronization then initialize the data structure that will hold sync primitives
 	// correspond to synchronizations that this thread will participate into. 
 	if (involvesSynchronization) {
@@ -234,6 +254,12 @@ void generateThreadRunFunction(TaskDef *taskDef, const char *headerFileName,
 	programFile << "\n\t// logging iterators' efficiency\n";
 	programFile << "\tthreadState->logIteratorStatistics();\n";
 
+	// release the LPUs recorded for replaying traversals
+	if (scheduleCacheEnabled) {
+		programFile << "\n\t// release recorded LPU traversals\n";
+		programFile << "\tthreadState->releaseLpuScheduleCache();\n";
+	}
+
 	// close the thread log file
 	programFile << "\n\t// close thread's log file\n";
 	programFile << "\tthreadState->closeLogFile();\n";
@@ -23,6 +23,9 @@ int parseComputation(FlowStage *currentStage, const char *initialsLower,
 void generateFnsForComputation(TaskDef *taskDef, const char *headerFile, 
 		const char *programFile, const char *initials);
 
+/* determines if threads should record their LPU traversals to replay them when the traversals are repeated */
+bool isLpuScheduleCacheEnabled();
+
 /* function definition for generating the thread::run function */
 void generateThreadRunFunction(TaskDef *taskDef, const char *headerFile,
 		const char *programFile, 
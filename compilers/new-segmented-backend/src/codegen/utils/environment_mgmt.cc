@@ -44,6 +44,9 @@ void generateTaskEnvironmentClass(TaskDef *taskDef, const char *initials,
 	Space *rootLps = taskDef->getPartitionHierarchy()->getRootSpace();
 	// if the task environment contains non-array variables, they should be zero initialized in the constructor 
 	std::ostringstream constructorContents;
+	// their values are also saved in and restored from checkpoints as raw bytes
+	std::ostringstream scalarWriterContents;
+	std::ostringstream scalarReaderContents;
 	for (int i = 0; i < envLinkList->NumElements(); i++) {
 		EnvironmentLink *link = envLinkList->Nth(i);
 		const char *varName = link->getVariable()->getName();
@@ -61,6 +64,14 @@ void generateTaskEnvironmentClass(TaskDef *taskDef, const char *initials,
 		Type *type = structure->getType();
 		headerFile << indent << type->getCppDeclaration(varName) << stmtSeparator;
 
+		// a string property is a pointer; so its value cannot be carried from one run of the program to another
+		if (type != Type::stringType) {
+			scalarWriterContents << indent << "stream.write((char *) &" << varName << paramSeparator;
+			scalarWriterContents << "sizeof(" << varName << "))" << stmtSeparator;
+			scalarReaderContents << indent << "stream.read((char *) &" << varName << paramSeparator;
+			scalarReaderContents << "sizeof(" << varName << "))" << stmtSeparator;
+		}
+
 		// if the object is of a user defined type then call its constructor to initialize the property
 		NamedType *userDefinedType = dynamic_cast<NamedType*>(type);
 		if (userDefinedType != NULL) {
@@ -91,12 +102,31 @@ void generateTaskEnvironmentClass(TaskDef *taskDef, const char *initials,
 	programFile << indent << "resetEnvInstructions()" << stmtSeparator;
 	programFile << "}\n";
 
+	// generate the functions that save and restore the non-array variables in checkpoints
+	bool scalarCheckpointed = !scalarWriterContents.str().empty();
+	if (scalarCheckpointed) {
+		programFile << '\n';
+		programFile << "void " << initials << "::" << "TaskEnvironmentImpl::writeScalarProperties(";
+		programFile << "std::ostream &stream) {\n";
+		programFile << scalarWriterContents.str();
+		programFile << "}\n";
+		programFile << '\n';
+		programFile << "void " << initials << "::" << "TaskEnvironmentImpl::readScalarProperties(";
+		programFile << "std::istream &stream) {\n";
+		programFile << scalarReaderContents.str();
+		programFile << "}\n";
+	}
+
 	// definitions for the constructor and two functions each task environment subclass needs to provide 
 	// implementations for
 	headerFile << "  public:\n";
 	headerFile << indent << "TaskEnvironmentImpl()" << stmtSeparator;
 	headerFile << indent << "void prepareItemsMap()" << stmtSeparator;
 	headerFile << indent << "void setDefaultTaskCompletionInstrs()" << stmtSeparator;
+	if (scalarCheckpointed) {
+		headerFile << indent << "void writeScalarProperties(std::ostream &stream)" << stmtSeparator;
+		headerFile << indent << "void readScalarProperties(std::istream &stream)" << stmtSeparator;
+	}
 	headerFile << "}" << stmtSeparator;
 
 	// two functions need to be implemented by the task specific environment subclass; call other functions to
@@ -8,12 +8,14 @@
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/string_utils.h"
 #include "../../../../common-libs/utils/decorator_utils.h"
+#include "../../../../common-libs/utils/properties.h"
 
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <deque>
 #include <cstdlib>
+#include <string.h>
 
 void generatePartReaderForStructure(std::ofstream &headerFile, ArrayDataStructure *array) {
 
@@ -75,6 +77,17 @@ void generatePartReaderForStructure(std::ofstream &headerFile, ArrayDataStructur
 	headerFile << "}" << stmtSeparator;
 }
 
+bool isAsynchronousOutputEnabled() {
+	
+	// by default, the content of the data parts are written in files by a background thread from a snapshot
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps != NULL) {
+		const char *setting = deploymentProps->getProperty("output.async.enabled");
+		if (setting != NULL && strcmp(setting, "true") != 0) return false;
+	}
+	return true;
+}
+
 void generatePartWriterForStructure(std::ofstream &headerFile, ArrayDataStructure *array) {
 	
 	Space *lps = array->getSpace();
@@ -102,6 +115,10 @@ void generatePartWriterForStructure(std::ofstream &headerFile, ArrayDataStructur
 	if (array->doesGenerateOverlappingParts()) {
 		headerFile << doubleIndent << "setNeedToExcludePadding(true)" << stmtSeparator;
 	}
+	headerFile << doubleIndent << "setElementSize(sizeof(" << elementType->getCType() << "))" << stmtSeparator;
+	if (isAsynchronousOutputEnabled()) {
+		headerFile << doubleIndent << "setAsynchronous(true)" << stmtSeparator;
+	}
 	headerFile << indent << "}\n"; 
 
 	// write implementations for the four functions needed to do structure specific writing
@@ -14,6 +14,9 @@
 /* function to generate partition specific data reader subclass for a data structure within an LPS */
 void generatePartReaderForStructure(std::ofstream &headerFile, ArrayDataStructure *structure);
 
+/* determines if data parts should be written to files in the background from snapshots of their contents */
+bool isAsynchronousOutputEnabled();
+
 /* function to generate partition specific data writer subclass for a data structure within an LPS */
 void generatePartWriterForStructure(std::ofstream &headerFile, ArrayDataStructure *structure);
 
@@ -0,0 +1,190 @@
+#include "loop_transformation.h"
+#include "space_mapping.h"
+
+#include "../../../../common-libs/utils/list.h"
+#include "../../../../common-libs/utils/hashtable.h"
+#include "../../../../common-libs/utils/properties.h"
+
+#include "../../../../frontend/src/syntax/ast_type.h"
+#include "../../../../frontend/src/semantics/task_space.h"
+#include "../../../../frontend/src/semantics/loop_index.h"
+
+#include <iostream>
+#include <string.h>
+
+List<PPS_Definition*> *LoopTransformer::pcubesConfig = NULL;
+bool LoopTransformer::interchangeEnabled = true;
+bool LoopTransformer::tilingEnabled = true;
+
+// the smallest tile edge length that is worth the loop overhead of tiling; tile sizes are always multiple of this
+static const int Min_Tile_Size = 8;
+// only a fraction of the cache is targeted to leave room for other data and to reduce conflict misses
+static const int Cache_Usage_Divisor = 2;
+
+void LoopTransformer::configure(List<PPS_Definition*> *pcubesConfig) {
+
+	LoopTransformer::pcubesConfig = pcubesConfig;
+	interchangeEnabled = true;
+	tilingEnabled = true;
+
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps != NULL) {
+		const char *interchangeSetting = deploymentProps->getProperty("loop.interchange.enabled");
+		if (interchangeSetting != NULL && strcmp(interchangeSetting, "true") != 0) {
+			interchangeEnabled = false;
+			std::cout << "\tGenerating parallel loops without loop interchange\n";
+		}
+		const char *tilingSetting = deploymentProps->getProperty("loop.tiling.enabled");
+		if (tilingSetting != NULL && strcmp(tilingSetting, "true") != 0) {
+			tilingEnabled = false;
+			std::cout << "\tGenerating parallel loops without loop tiling\n";
+		}
+	}
+}
+
+long LoopTransformer::getCacheSizeForLps(Space *lps) {
+	if (pcubesConfig == NULL) return 0;
+	int ppsId = lps->getPpsId();
+
+	// PPS definitions are stored in top-down order; so the search starts from the mapped PPS and proceeds
+	// towards the lower PPSes
+	bool ppsFound = false;
+	for (int i = 0; i < pcubesConfig->NumElements(); i++) {
+		PPS_Definition *pps = pcubesConfig->Nth(i);
+		if (pps->id == ppsId) ppsFound = true;
+		if (ppsFound && pps->cacheSize > 0) return pps->cacheSize;
+	}
+	return 0;
+}
+
+List<IndexArrayAssociation*> *LoopTransformer::reorderForUnitStride(List<IndexArrayAssociation*> *loopAssociations,
+		IndexScope *indexScope, Space *space) {
+
+	if (!interchangeEnabled || loopAssociations->NumElements() < 2) return loopAssociations;
+
+	// score each index that results in a loop by the number of unit stride accesses minus the number of non-unit
+	// stride accesses it makes to different arrays
+	int bestIndex = -1;
+	int bestScore = 0;
+	int innermostIndex = -1;
+	int innermostScore = 0;
+	for (int i = 0; i < loopAssociations->NumElements(); i++) {
+		IndexArrayAssociation *association = loopAssociations->Nth(i);
+		ArrayDataStructure *array = (ArrayDataStructure*) space->getLocalStructure(association->getArray());
+		if (array->isSingleEntryInDimension(association->getDimensionNo() + 1)) continue;
+
+		List<IndexArrayAssociation*> *accessList = indexScope->getAssociationsForIndex(association->getIndex());
+		accessList = IndexArrayAssociation::filterList(accessList);
+		int score = 0;
+		for (int j = 0; j < accessList->NumElements(); j++) {
+			IndexArrayAssociation *access = accessList->Nth(j);
+			DataStructure *structure = space->getStructure(access->getArray());
+			ArrayDataStructure *accessedArray = dynamic_cast<ArrayDataStructure*>(structure);
+			if (accessedArray == NULL) continue;
+			if (access->getDimensionNo() == accessedArray->getDimensionality() - 1) score++;
+			else score--;
+		}
+		if (bestIndex == -1 || score > bestScore) {
+			bestIndex = i;
+			bestScore = score;
+		}
+		innermostIndex = i;
+		innermostScore = score;
+	}
+
+	// interchange only if the stride pattern of the best index is strictly better than that of the current innermost
+	if (bestIndex == -1 || bestIndex == innermostIndex || bestScore <= innermostScore) return loopAssociations;
+
+	List<IndexArrayAssociation*> *reorderedList = new List<IndexArrayAssociation*>;
+	for (int i = 0; i < loopAssociations->NumElements(); i++) {
+		if (i == bestIndex) continue;
+		reorderedList->Append(loopAssociations->Nth(i));
+		if (i == innermostIndex) reorderedList->Append(loopAssociations->Nth(bestIndex));
+	}
+	return reorderedList;
+}
+
+int LoopTransformer::getTileSize(List<IndexArrayAssociation*> *loopAssociations,
+		IndexScope *indexScope, Space *space) {
+
+	if (!tilingEnabled || loopAssociations->NumElements() < 2) return 0;
+	long cacheSize = getCacheSizeForLps(space);
+	if (cacheSize == 0) return 0;
+
+	// determine the arrays accessed using loop indexes and the number of loop indexes used to access each of them
+	List<const char*> *arrayList = new List<const char*>;
+	List<int> *indexedDimensionCounts = new List<int>;
+	for (int i = 0; i < loopAssociations->NumElements(); i++) {
+		const char *index = loopAssociations->Nth(i)->getIndex();
+		List<IndexArrayAssociation*> *accessList = indexScope->getAssociationsForIndex(index);
+		accessList = IndexArrayAssociation::filterList(accessList);
+		for (int j = 0; j < accessList->NumElements(); j++) {
+			const char *arrayName = accessList->Nth(j)->getArray();
+			int position = -1;
+			for (int k = 0; k < arrayList->NumElements(); k++) {
+				if (strcmp(arrayList->Nth(k), arrayName) == 0) {
+					position = k;
+					break;
+				}
+			}
+			if (position == -1) {
+				arrayList->Append(arrayName);
+				indexedDimensionCounts->Append(1);
+			} else {
+				int count = indexedDimensionCounts->Nth(position);
+				indexedDimensionCounts->RemoveAt(position);
+				indexedDimensionCounts->InsertAt(count + 1, position);
+			}
+		}
+	}
+
+	// check if there is any reuse carried by an outer loop; reuse carried by the innermost loop does not need tiling
+	bool outerReuse = false;
+	for (int i = 0; i < loopAssociations->NumElements() - 1 && !outerReuse; i++) {
+		const char *index = loopAssociations->Nth(i)->getIndex();
+		List<IndexArrayAssociation*> *accessList = indexScope->getAssociationsForIndex(index);
+		for (int k = 0; k < arrayList->NumElements(); k++) {
+			bool accessedByIndex = false;
+			for (int j = 0; j < accessList->NumElements(); j++) {
+				if (strcmp(accessList->Nth(j)->getArray(), arrayList->Nth(k)) == 0) {
+					accessedByIndex = true;
+					break;
+				}
+			}
+			if (!accessedByIndex) {
+				outerReuse = true;
+				break;
+			}
+		}
+	}
+	if (!outerReuse) return 0;
+
+	// find the largest tile edge length for which the working set of a tile fits in the targeted part of the cache
+	long cacheBudget = cacheSize / Cache_Usage_Divisor;
+	int tileSize = 0;
+	for (int candidate = Min_Tile_Size; ; candidate += Min_Tile_Size) {
+		long workingSet = 0;
+		for (int k = 0; k < arrayList->NumElements(); k++) {
+			long footprint = getElementSize(space, arrayList->Nth(k));
+			int indexedDimensions = indexedDimensionCounts->Nth(k);
+			for (int d = 0; d < indexedDimensions; d++) footprint *= candidate;
+			workingSet += footprint;
+		}
+		if (workingSet > cacheBudget) break;
+		tileSize = candidate;
+	}
+	return tileSize;
+}
+
+int LoopTransformer::getElementSize(Space *space, const char *arrayName) {
+	DataStructure *structure = space->getStructure(arrayName);
+	ArrayType *arrayType = dynamic_cast<ArrayType*>(structure->getType());
+	if (arrayType == NULL) return sizeof(double);
+	Type *elementType = arrayType->getTerminalElementType();
+	if (elementType == Type::charType || elementType == Type::boolType) return sizeof(char);
+	if (elementType == Type::intType) return sizeof(int);
+	if (elementType == Type::floatType) return sizeof(float);
+	if (elementType == Type::doubleType) return sizeof(double);
+	// user defined element types are assumed to be at least as large as the largest primitive type
+	return sizeof(double);
+}
@@ -0,0 +1,65 @@
+#ifndef _H_loop_transformation
+#define _H_loop_transformation
+
+#include "../../../../common-libs/utils/list.h"
+
+class Space;
+class IndexScope;
+class IndexArrayAssociation;
+class PPS_Definition;
+
+/* This is an utility class for restructuring the index traversal loops generated for IT parallel loops within compute
+   stages. By default, an IT parallel loop is translated into a nest of for loops that follows the order in which the
+   indexes appear in the source code and each loop walks the entire LPU-local range of the corresponding dimension.
+   That ordering and traversal strategy can be very cache-unfriendly. For example, the straightforward translation of
+   the matrix-matrix multiplication loop streams entire rows and columns of the argument matrices through the cache.
+
+   Two transformations are supported to remedy that.
+   1. Loop interchange: the index that traverses the largest number of arrays along their last, i.e., contiguous,
+      storage dimension is moved to the innermost loop.
+   2. Loop tiling: the index ranges are broken into tiles so that the working set of the arrays accessed inside
+      the loop body for a single tile fits in the cache of the PPS executing the LPUs of the loop's LPS. Cache sizes
+      are taken from the PCubeS description of the hardware.
+
+   Both transformations are enabled by default and can be disabled by setting the 'loop.interchange.enabled' and
+   'loop.tiling.enabled' deployment properties to false. Note that these transformations are only applicable for
+   parallel loops as IT semantics does not specify any ordering of index traversal for them.
+
+   This class is supposed to be configured at the beginning of code generation for a task and accessed later during
+   the translation of the compute stages.
+*/
+class LoopTransformer {
+  private:
+	static List<PPS_Definition*> *pcubesConfig;
+	static bool interchangeEnabled;
+	static bool tilingEnabled;
+  public:
+	// this function should be invoked before translating the compute stages of a task
+	static void configure(List<PPS_Definition*> *pcubesConfig);
+
+	static bool isInterchangeEnabled() { return interchangeEnabled; }
+	static bool isTilingEnabled() { return tilingEnabled; }
+
+	// This returns the capacity of the cache available to the PPUs of the PPS the argument LPS is mapped to. If
+	// that PPS does not have any cache description then the nearest descendent PPS with a cache description is
+	// used. If there is no such PPS then the function returns 0.
+	static long getCacheSizeForLps(Space *lps);
+
+	// This function reorders the list of index-array associations of a parallel loop so that the index having the
+	// best stride-1 access pattern becomes the last, i.e., the innermost one. Associations for indexes that do not
+	// result in any loop (as the LPS has a single entry along the corresponding array dimension) are not moved.
+	static List<IndexArrayAssociation*> *reorderForUnitStride(List<IndexArrayAssociation*> *loopAssociations,
+			IndexScope *indexScope, Space *space);
+
+	// This function determines the edge length of the tiles to be used for the index loops of the argument
+	// association list. The list should be in the order in which the loops will be nested. It returns 0 if tiling
+	// does not seem to be beneficial for the loop. Tiling is considered beneficial when some array accessed in the
+	// loop is not indexed by some outer loop index, i.e., there is a data reuse carried by an outer loop that
+	// would be lost without tiling if the index ranges are large.
+	static int getTileSize(List<IndexArrayAssociation*> *loopAssociations,
+			IndexScope *indexScope, Space *space);
+  private:
+	static int getElementSize(Space *space, const char *arrayName);
+};
+
+#endif
@@ -342,12 +342,24 @@ void generateLpuConstructionFunction(std::ofstream &headerFile,
 			programFile << "(" << elemType->getCType() << "*) ";
 			programFile << varName << "Part->getData(" << j << ")" << stmtSeparator;
 		}
+		if (lpuHoldsEpochVersionedPart(lps, array)) {
+			programFile << doubleIndent << "lpu->" << varName << "DataPart = ";
+			programFile << varName << "Part" << stmtSeparator;
+		}
 		programFile << indent << "}\n";
 	}
 	
 	programFile << "}\n";
 }
 
+bool lpuHoldsEpochVersionedPart(Space *lps, ArrayDataStructure *array) {
+	if (array->getLocalVersionCount() == 0) return false;
+	// a subpartition LPU just borrows data references from its parent LPU
+	if (array->getSpace() != lps && lps->isSubpartitionSpace()) return false;
+	LPSVarUsageStat *usageStat = array->getUsageStat();
+	return usageStat->isAccessed() || usageStat->isReduced();
+}
+
 void generateAllLpuConstructionFunctions(const char *headerFileName,
                 const char *programFileName, 
 		const char *initials, MappingNode *mappingRoot) {
@@ -32,6 +32,12 @@ void generateLpuConstructionFunction(std::ofstream &headerFile,
 		std::ofstream &programFile, 
 		const char *initials, Space *lps);
 
+/* This tells if the LPUs of the argument LPS keep a reference to the data part holding the epoch versions of the 
+   argument array. Such a reference lets the epoch boundary code advance the versions of an LPU's data directly, 
+   without identifying the part again from the LPU ID. 
+*/
+bool lpuHoldsEpochVersionedPart(Space *lps, ArrayDataStructure *array);
+
 /* function that calls the aforementioned function for all LPSes in the task */
 void generateAllLpuConstructionFunctions(const char *headerFile,
 		const char *programFile, const char *initials, MappingNode *mappingRoot);
@@ -0,0 +1,450 @@
+#include "mapping_advisor.h"
+#include "space_mapping.h"
+
+#include "../../../../common-libs/utils/list.h"
+#include "../../../../common-libs/utils/hashtable.h"
+#include "../../../../common-libs/utils/properties.h"
+
+#include "../../../../frontend/src/syntax/ast.h"
+#include "../../../../frontend/src/syntax/ast_task.h"
+#include "../../../../frontend/src/semantics/task_space.h"
+#include "../../../../frontend/src/semantics/partition_function.h"
+#include "../../../../frontend/src/static-analysis/sync_stat.h"
+#include "../../../../frontend/src/static-analysis/data_dependency.h"
+#include "../../../../frontend/src/codegen-helper/communication_stat.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string.h>
+#include <cstdlib>
+#include <math.h>
+#include <deque>
+
+// an LPS whose busiest thread took this much longer than the average thread in the calibration run is given twice as
+// many LPUs as PPUs in the suggested partition parameters so that the LPUs can be distributed more evenly
+static const double Imbalance_Threshold = 1.25;
+
+// the mapping in use is retained unless some other mapping is estimated to be faster by at least this fraction
+static const double Improvement_Threshold = 0.01;
+
+TaskCost::TaskCost() {
+	segments = 0;
+	threads = 0;
+	argumentNames = new List<const char*>;
+	argumentValues = new Hashtable<int*>;
+	lpsCosts = new Hashtable<LpsCost*>;
+	dependencyNames = new List<const char*>;
+	communicationTimes = new Hashtable<double*>;
+}
+
+const char *MappingAdvisor::profileFile = NULL;
+const char *MappingAdvisor::recommendationFile = NULL;
+
+void MappingAdvisor::configure(const char *outputDirectory) {
+
+	profileFile = NULL;
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps == NULL) return;
+	const char *profileSetting = deploymentProps->getProperty("mapping.profile.file");
+	if (profileSetting == NULL || strlen(profileSetting) == 0) return;
+	profileFile = profileSetting;
+
+	// start with an empty recommendation file as the recommendations of individual tasks are appended to it
+	std::ostringstream fileName;
+	fileName << outputDirectory << "recommended.map";
+	recommendationFile = strdup(fileName.str().c_str());
+	std::ofstream stream;
+	stream.open(recommendationFile, std::ofstream::out | std::ofstream::trunc);
+	if (!stream.is_open()) {
+		std::cout << "Unable to create the recommended mapping file: " << recommendationFile << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	stream << "// LPS to PPS mappings recommended by the mapping advisor from the profile " << profileFile << "\n";
+	stream.close();
+	std::cout << "Advising mappings from the calibration profile " << profileFile << "\n";
+}
+
+void MappingAdvisor::adviseMapping(TaskDef *taskDef,
+		MappingNode *mappingRoot,
+		List<PPS_Definition*> *pcubesConfig,
+		List<CommunicationCharacteristics*> *commCharacterList) {
+
+	if (!isEnabled()) return;
+	std::cout << "\tEvaluating alternative mappings of the task from the calibration profile\n";
+
+	const char *taskName = taskDef->getName();
+	TaskCost *taskCost = readTaskCost(taskName);
+	if (taskCost == NULL) {
+		std::cout << "\tThe calibration profile has no measurements for the task\n";
+		return;
+	}
+
+	// list the LPSes to be mapped in a top-down order so that a parent is always decided before its children;
+	// subpartitions are excluded as they are always mapped to the PPS of their parents
+	List<AdvisedLps*> *lpsList = new List<AdvisedLps*>;
+	Hashtable<int*> *lpsIndexMap = new Hashtable<int*>;
+	Space *rootLps = mappingRoot->mappingConfig->LPS;
+	std::deque<MappingNode*> nodeQueue;
+	for (int i = 0; i < mappingRoot->children->NumElements(); i++) {
+		nodeQueue.push_back(mappingRoot->children->Nth(i));
+	}
+	while (!nodeQueue.empty()) {
+		MappingNode *node = nodeQueue.front();
+		nodeQueue.pop_front();
+		for (int i = 0; i < node->children->NumElements(); i++) {
+			nodeQueue.push_back(node->children->Nth(i));
+		}
+		Space *lps = node->mappingConfig->LPS;
+		if (lps->isSubpartitionSpace()) {
+			lpsIndexMap->Enter(lps->getName(), lpsIndexMap->Lookup(lps->getParent()->getName()));
+			continue;
+		}
+		AdvisedLps *advised = new AdvisedLps();
+		advised->lps = lps;
+		Space *parent = lps->getParent();
+		advised->parentIndex = (parent == rootLps) ? -1 : *(lpsIndexMap->Lookup(parent->getName()));
+		advised->cost = taskCost->lpsCosts->Lookup(lps->getName());
+		advised->imbalance = 1.0;
+		int *index = new int;
+		*index = lpsList->NumElements();
+		lpsIndexMap->Enter(lps->getName(), index);
+		lpsList->Append(advised);
+	}
+	int lpsCount = lpsList->NumElements();
+	if (lpsCount == 0) return;
+
+	// determine the load imbalance of each LPS from the threads that could have participated in its computation
+	int *totalLpus = new int[lpsCount];
+	for (int i = 0; i < lpsCount; i++) {
+		AdvisedLps *advised = lpsList->Nth(i);
+		int parentLpus = (advised->parentIndex == -1) ? 1 : totalLpus[advised->parentIndex];
+		LpsCost *cost = advised->cost;
+		int lpusPerParent = (cost != NULL && cost->lpusPerParent > 0) ? cost->lpusPerParent : 1;
+		totalLpus[i] = parentLpus * lpusPerParent;
+		if (cost == NULL || cost->computeSum <= 0) continue;
+		int participants = getPpuCount(advised->lps->getPpsId(), pcubesConfig);
+		if (totalLpus[i] < participants) participants = totalLpus[i];
+		if (taskCost->threads < participants) participants = taskCost->threads;
+		double imbalance = cost->computeMax * participants / cost->computeSum;
+		advised->imbalance = (imbalance > 1.0) ? imbalance : 1.0;
+	}
+
+	// evaluate the mapping in use first so that it is retained unless some alternative is clearly better
+	int *currentMapping = new int[lpsCount];
+	for (int i = 0; i < lpsCount; i++) {
+		currentMapping[i] = lpsList->Nth(i)->lps->getPpsId();
+	}
+	double currentTime = estimateExecutionTime(lpsList, currentMapping,
+			lpsIndexMap, taskCost, commCharacterList, pcubesConfig);
+	int *bestMapping = new int[lpsCount];
+	for (int i = 0; i < lpsCount; i++) bestMapping[i] = currentMapping[i];
+	double bestTime = currentTime * (1.0 - Improvement_Threshold);
+	int *candidate = new int[lpsCount];
+	searchMappings(0, lpsList, candidate, bestMapping, &bestTime,
+			lpsIndexMap, taskCost, commCharacterList, pcubesConfig);
+	bestTime = estimateExecutionTime(lpsList, bestMapping,
+			lpsIndexMap, taskCost, commCharacterList, pcubesConfig);
+	Hashtable<int*> *suggestedArgs = suggestPartitionParameters(taskDef,
+			lpsList, bestMapping, taskCost, pcubesConfig);
+
+	// append the recommendation for the task in the same format the mapping configuration parser reads
+	std::ofstream stream;
+	stream.open(recommendationFile, std::ofstream::out | std::ofstream::app);
+	if (!stream.is_open()) {
+		std::cout << "Unable to open the recommended mapping file: " << recommendationFile << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	int totalPPSes = pcubesConfig->NumElements();
+	stream << "\n// estimated time of the mapping in use: " << currentTime << " Seconds";
+	stream << "; of the recommended mapping: " << bestTime << " Seconds\n";
+	stream << "\"" << taskName << "\" {\n";
+	for (int i = 0; i < lpsCount; i++) {
+		AdvisedLps *advised = lpsList->Nth(i);
+		PPS_Definition *pps = pcubesConfig->Nth(totalPPSes - bestMapping[i]);
+		stream << "\tSpace " << advised->lps->getName() << ": " << bestMapping[i];
+		stream << "\t// " << pps->name;
+		if (bestMapping[i] != currentMapping[i]) {
+			stream << " (currently mapped to Space " << currentMapping[i] << ")";
+		}
+		stream << "\n";
+	}
+	stream << "}\n";
+	List<Identifier*> *partitionArgs = taskDef->getPartitionArguments();
+	if (partitionArgs->NumElements() > 0) {
+		stream << "// suggested partition parameters:";
+		for (int i = 0; i < partitionArgs->NumElements(); i++) {
+			const char *argName = partitionArgs->Nth(i)->getName();
+			int *measuredValue = taskCost->argumentValues->Lookup(argName);
+			int *suggestedValue = suggestedArgs->Lookup(argName);
+			stream << ((i > 0) ? ", " : " ") << argName << " = ";
+			if (suggestedValue != NULL) {
+				stream << *suggestedValue;
+				if (measuredValue != NULL) stream << " (was " << *measuredValue << ")";
+			} else if (measuredValue != NULL) {
+				stream << *measuredValue;
+			} else {
+				stream << "unchanged";
+			}
+		}
+		stream << "\n";
+	}
+	stream.close();
+
+	std::cout << "\tEstimated time of the mapping in use: " << currentTime << " Seconds\n";
+	std::cout << "\tEstimated time of the recommended mapping: " << bestTime << " Seconds\n";
+}
+
+TaskCost *MappingAdvisor::readTaskCost(const char *taskName) {
+
+	std::ifstream stream(profileFile);
+	if (!stream.is_open()) {
+		std::cout << "could not open the calibration profile: " << profileFile << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	// each segment writes its own section for the task; the sections are combined here
+	TaskCost *taskCost = new TaskCost();
+	bool inTaskSection = false;
+	std::string line;
+	while (std::getline(stream, line)) {
+		std::istringstream tokens(line);
+		std::string keyword;
+		tokens >> keyword;
+		if (keyword.compare("task") == 0) {
+			int nameBegin = line.find('"');
+			int nameEnd = line.find('"', nameBegin + 1);
+			std::string name = line.substr(nameBegin + 1, nameEnd - nameBegin - 1);
+			inTaskSection = (name.compare(taskName) == 0);
+			if (!inTaskSection) continue;
+			std::istringstream attributes(line.substr(nameEnd + 1));
+			std::string label;
+			int segmentId, threads;
+			attributes >> label >> segmentId >> label >> threads;
+			taskCost->segments++;
+			taskCost->threads += threads;
+		} else if (!inTaskSection) {
+			continue;
+		} else if (keyword.compare("argument") == 0) {
+			std::string argName;
+			int *value = new int;
+			tokens >> argName >> *value;
+			if (taskCost->argumentValues->Lookup(argName.c_str()) == NULL) {
+				const char *name = strdup(argName.c_str());
+				taskCost->argumentNames->Append(name);
+				taskCost->argumentValues->Enter(name, value);
+			}
+		} else if (keyword.compare("lps") == 0) {
+			std::string lpsName, label;
+			LpsCost segmentCost;
+			tokens >> lpsName >> label >> segmentCost.ppsId >> label >> segmentCost.lpusPerParent;
+			tokens >> label >> segmentCost.computeSum >> label >> segmentCost.computeMax;
+			LpsCost *cost = taskCost->lpsCosts->Lookup(lpsName.c_str());
+			if (cost == NULL) {
+				cost = new LpsCost(segmentCost);
+				taskCost->lpsCosts->Enter(strdup(lpsName.c_str()), cost);
+			} else {
+				cost->computeSum += segmentCost.computeSum;
+				if (segmentCost.computeMax > cost->computeMax) cost->computeMax = segmentCost.computeMax;
+				if (segmentCost.lpusPerParent > cost->lpusPerParent) {
+					cost->lpusPerParent = segmentCost.lpusPerParent;
+				}
+			}
+		} else if (keyword.compare("dependency") == 0) {
+			// the segments communicate at the same time; so the communication time of the slowest segment is
+			// taken as the time of the dependency
+			std::string dependency, label;
+			double time;
+			tokens >> dependency >> label >> time;
+			double *recordedTime = taskCost->communicationTimes->Lookup(dependency.c_str());
+			if (recordedTime == NULL) {
+				const char *name = strdup(dependency.c_str());
+				recordedTime = new double;
+				*recordedTime = time;
+				taskCost->dependencyNames->Append(name);
+				taskCost->communicationTimes->Enter(name, recordedTime);
+			} else if (time > *recordedTime) {
+				*recordedTime = time;
+			}
+		} else if (keyword.compare("end") == 0) {
+			inTaskSection = false;
+		}
+	}
+	stream.close();
+
+	if (taskCost->segments == 0) {
+		delete taskCost;
+		return NULL;
+	}
+	return taskCost;
+}
+
+int MappingAdvisor::getPpuCount(int ppsId, List<PPS_Definition*> *pcubesConfig) {
+
+	// PPS definitions are stored in top-down order
+	int ppuCount = 1;
+	for (int i = 0; i < pcubesConfig->NumElements(); i++) {
+		PPS_Definition *pps = pcubesConfig->Nth(i);
+		if (pps->id < ppsId) break;
+		ppuCount *= pps->units;
+	}
+	return ppuCount;
+}
+
+int MappingAdvisor::getCandidatePps(Space *lps,
+		Hashtable<int*> *lpsIndexMap,
+		int *candidate, List<PPS_Definition*> *pcubesConfig) {
+	int *index = lpsIndexMap->Lookup(lps->getName());
+	if (index == NULL) return lps->getPpsId();
+	return candidate[*index];
+}
+
+double MappingAdvisor::estimateExecutionTime(List<AdvisedLps*> *lpsList,
+		int *candidate,
+		Hashtable<int*> *lpsIndexMap,
+		TaskCost *taskCost,
+		List<CommunicationCharacteristics*> *commCharacterList,
+		List<PPS_Definition*> *pcubesConfig) {
+
+	double time = 0.0;
+	for (int i = 0; i < lpsList->NumElements(); i++) {
+		AdvisedLps *advised = lpsList->Nth(i);
+		if (advised->cost == NULL) continue;
+		int ppuCount = getPpuCount(candidate[i], pcubesConfig);
+		time += advised->cost->computeSum / ppuCount * advised->imbalance;
+	}
+
+	for (int i = 0; i < commCharacterList->NumElements(); i++) {
+		CommunicationCharacteristics *commCharacter = commCharacterList->Nth(i);
+		const char *dependency = commCharacter->getSyncRequirement()->getDependencyArc()->getArcName();
+		double *measuredTime = taskCost->communicationTimes->Lookup(dependency);
+		if (measuredTime == NULL) continue;
+		Space *sender = commCharacter->getSenderSyncSpace();
+		Space *receiver = commCharacter->getReceiverSyncSpace();
+		int currentPps = std::min(sender->getPpsId(), receiver->getPpsId());
+		int candidatePps = std::min(getCandidatePps(sender, lpsIndexMap, candidate, pcubesConfig),
+				getCandidatePps(receiver, lpsIndexMap, candidate, pcubesConfig));
+		time += *measuredTime * getPpuCount(candidatePps, pcubesConfig)
+				/ getPpuCount(currentPps, pcubesConfig);
+	}
+	return time;
+}
+
+void MappingAdvisor::searchMappings(int lpsIndex,
+		List<AdvisedLps*> *lpsList,
+		int *candidate,
+		int *bestMapping, double *bestTime,
+		Hashtable<int*> *lpsIndexMap,
+		TaskCost *taskCost,
+		List<CommunicationCharacteristics*> *commCharacterList,
+		List<PPS_Definition*> *pcubesConfig) {
+
+	int lpsCount = lpsList->NumElements();
+	if (lpsIndex == lpsCount) {
+		double time = estimateExecutionTime(lpsList, candidate,
+				lpsIndexMap, taskCost, commCharacterList, pcubesConfig);
+		if (time < *bestTime) {
+			*bestTime = time;
+			for (int i = 0; i < lpsCount; i++) bestMapping[i] = candidate[i];
+		}
+		return;
+	}
+
+	// an LPS can be mapped to the PPS of its parent or any PPS below that
+	AdvisedLps *advised = lpsList->Nth(lpsIndex);
+	int parentPps = (advised->parentIndex == -1)
+			? advised->lps->getParent()->getPpsId() : candidate[advised->parentIndex];
+	for (int ppsId = parentPps; ppsId >= 1; ppsId--) {
+		candidate[lpsIndex] = ppsId;
+		searchMappings(lpsIndex + 1, lpsList, candidate, bestMapping, bestTime,
+				lpsIndexMap, taskCost, commCharacterList, pcubesConfig);
+	}
+}
+
+Hashtable<int*> *MappingAdvisor::suggestPartitionParameters(TaskDef *taskDef,
+		List<AdvisedLps*> *lpsList,
+		int *mapping,
+		TaskCost *taskCost,
+		List<PPS_Definition*> *pcubesConfig) {
+
+	Hashtable<int*> *suggestions = new Hashtable<int*>;
+	List<Identifier*> *partitionArgs = taskDef->getPartitionArguments();
+
+	// LPSes are processed top-down and a parameter shared by multiple LPSes is decided by the highest of them
+	for (int i = 0; i < lpsList->NumElements(); i++) {
+		AdvisedLps *advised = lpsList->Nth(i);
+		LpsCost *cost = advised->cost;
+		if (cost == NULL || cost->lpusPerParent <= 0) continue;
+		Space *lps = advised->lps;
+		int parentPps = (advised->parentIndex == -1)
+				? lps->getParent()->getPpsId() : mapping[advised->parentIndex];
+		int ppusPerParent = getPpuCount(mapping[i], pcubesConfig) / getPpuCount(parentPps, pcubesConfig);
+		int targetLpus = (ppusPerParent > 1) ? ppusPerParent : 1;
+		if (advised->imbalance > Imbalance_Threshold) targetLpus *= 2;
+		if (targetLpus == cost->lpusPerParent) continue;
+
+		// determine what partition parameters control the LPU count along the dimensions of the LPS; the array
+		// picked for each dimension is the same array the LPU count functions use
+		List<const char*> *countParams = new List<const char*>;
+		List<const char*> *sizeParams = new List<const char*>;
+		CoordinateSystem *coordSys = lps->getCoordinateSystem();
+		for (int d = 1; d <= lps->getDimensionCount(); d++) {
+			List<Token*> *tokenList = coordSys->getCoordinate(d)->getTokenList();
+			for (int j = 0; j < tokenList->NumElements(); j++) {
+				Token *token = tokenList->Nth(j);
+				if (token->isWildcard()) continue;
+				ArrayDataStructure *array = (ArrayDataStructure*) token->getData();
+				int arrayDim = token->getDimensionId();
+				PartitionFunctionConfig *config = array->getPartitionSpecForDimension(arrayDim);
+				if (config == NULL) break;
+				DataDimensionConfig *argConfig = config->getArgsForDimension(arrayDim);
+				if (argConfig == NULL) break;
+				Identifier *param = dynamic_cast<Identifier*>(argConfig->getDividingArg());
+				if (param == NULL) break;
+				bool partitionParam = false;
+				for (int k = 0; k < partitionArgs->NumElements(); k++) {
+					if (strcmp(partitionArgs->Nth(k)->getName(), param->getName()) == 0) {
+						partitionParam = true;
+						break;
+					}
+				}
+				if (!partitionParam) break;
+				const char *function = config->getName();
+				if (strcmp(function, BlockCount::name) == 0 || strcmp(function, NnzBalanced::name) == 0) {
+					countParams->Append(param->getName());
+				} else if (strcmp(function, BlockSize::name) == 0
+						|| strcmp(function, StridedBlock::name) == 0) {
+					sizeParams->Append(param->getName());
+				}
+				break;
+			}
+		}
+		int paramCount = countParams->NumElements() + sizeParams->NumElements();
+		if (paramCount == 0) continue;
+
+		// the change in the LPU count is distributed evenly among the parameterized dimensions
+		double factor = pow(((double) targetLpus) / cost->lpusPerParent, 1.0 / paramCount);
+		for (int j = 0; j < countParams->NumElements(); j++) {
+			const char *param = countParams->Nth(j);
+			int *measuredValue = taskCost->argumentValues->Lookup(param);
+			if (measuredValue == NULL || suggestions->Lookup(param) != NULL) continue;
+			int *value = new int;
+			*value = (int) floor(*measuredValue * factor + 0.5);
+			if (*value < 1) *value = 1;
+			suggestions->Enter(param, value);
+		}
+		for (int j = 0; j < sizeParams->NumElements(); j++) {
+			const char *param = sizeParams->Nth(j);
+			int *measuredValue = taskCost->argumentValues->Lookup(param);
+			if (measuredValue == NULL || suggestions->Lookup(param) != NULL) continue;
+			int *value = new int;
+			*value = (int) floor(*measuredValue / factor + 0.5);
+			if (*value < 1) *value = 1;
+			suggestions->Enter(param, value);
+		}
+		delete countParams;
+		delete sizeParams;
+	}
+	return suggestions;
+}
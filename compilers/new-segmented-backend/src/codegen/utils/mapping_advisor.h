@@ -0,0 +1,123 @@
+#ifndef _H_mapping_advisor
+#define _H_mapping_advisor
+
+/* This header provides the mapping advisor that recommends an LPS to PPS mapping and values for the partition
+   parameters of a task from the costs measured in a calibration run of the program. A calibration run is a short
+   run of the program compiled with the MAPPING_PROFILING macro defined; at its end the program writes the time its
+   PPU threads spent in the compute stages of each LPS and the time spent in each communication dependency in a
+   profile file (see runtime/common/mapping_profile.h). When the 'mapping.profile.file' deployment property points
+   to such a file, the compiler evaluates all valid mappings of the LPSes of each task to the PPSes of the PCubeS
+   description using the following cost model and writes the best mapping found in a recommended mapping file in
+   the build directory of the program.
+
+   1. The total compute time of an LPS is distributed evenly over the PPUs of the PPS it is mapped to, then scaled
+      by the load imbalance measured for the LPS in the calibration run.
+   2. The communication time of a dependency scales with the number of PPUs of the lower of the PPSes its sending
+      and receiving LPSes are mapped to, as more participants means more and smaller messages.
+   3. Compute stages of different LPSes and communications do not overlap; so the estimated time of a mapping is
+      the sum of the above.
+
+   The model assumes that the partition parameters will be adjusted to give each PPU of the new mapping its own
+   LPU. So alongside the mapping, the advisor suggests new values for the partition parameters that are used
+   directly as the arguments of block_count, block_size, block_stride, or nnz_balanced partition functions to
+   reach that many LPUs from the LPU counts observed in the calibration run.
+*/
+
+#include "../../../../common-libs/utils/list.h"
+#include "../../../../common-libs/utils/hashtable.h"
+
+#include <fstream>
+
+class TaskDef;
+class Space;
+class MappingNode;
+class PPS_Definition;
+class CommunicationCharacteristics;
+
+/* costs of an LPS measured in the calibration run aggregated over all segments */
+class LpsCost {
+  public:
+	int ppsId;
+	int lpusPerParent;
+	double computeSum;
+	double computeMax;
+};
+
+/* costs of a task measured in the calibration run aggregated over all segments */
+class TaskCost {
+  public:
+	int segments;
+	int threads;
+	List<const char*> *argumentNames;
+	Hashtable<int*> *argumentValues;
+	Hashtable<LpsCost*> *lpsCosts;
+	List<const char*> *dependencyNames;
+	Hashtable<double*> *communicationTimes;
+	TaskCost();
+};
+
+/* an LPS whose mapping the advisor decides along with the properties needed to evaluate its alternative mappings */
+class AdvisedLps {
+  public:
+	Space *lps;
+	// index of the parent LPS in the list of advised LPSes; this is -1 when the parent is the root LPS
+	int parentIndex;
+	LpsCost *cost;
+	// the load imbalance observed in the calibration run, i.e., the ratio of the compute time of the busiest
+	// thread to the average compute time of the threads that participated
+	double imbalance;
+};
+
+class MappingAdvisor {
+  private:
+	static const char *profileFile;
+	static const char *recommendationFile;
+  public:
+	// reads the deployment property for the profile file and prepares the recommendation file in the output
+	// directory; the advisor remains inactive if the property is not set
+	static void configure(const char *outputDirectory);
+	static bool isEnabled() { return profileFile != NULL; }
+
+	// evaluates the alternative mappings of the argument task and appends the recommended mapping of the task to
+	// the recommendation file
+	static void adviseMapping(TaskDef *taskDef,
+			MappingNode *mappingRoot,
+			List<PPS_Definition*> *pcubesConfig,
+			List<CommunicationCharacteristics*> *commCharacterList);
+  private:
+	static TaskCost *readTaskCost(const char *taskName);
+
+	// returns the total number of PPUs of a PPS in the hardware
+	static int getPpuCount(int ppsId, List<PPS_Definition*> *pcubesConfig);
+
+	// returns the PPS ID of the LPS in the mapping under evaluation; subpartitions follow their parent LPSes
+	static int getCandidatePps(Space *lps,
+			Hashtable<int*> *lpsIndexMap,
+			int *candidate, List<PPS_Definition*> *pcubesConfig);
+
+	static double estimateExecutionTime(List<AdvisedLps*> *lpsList,
+			int *candidate,
+			Hashtable<int*> *lpsIndexMap,
+			TaskCost *taskCost,
+			List<CommunicationCharacteristics*> *commCharacterList,
+			List<PPS_Definition*> *pcubesConfig);
+
+	// enumerates the mappings of LPSes from the argument index onward recursively and keeps the best one
+	static void searchMappings(int lpsIndex,
+			List<AdvisedLps*> *lpsList,
+			int *candidate,
+			int *bestMapping, double *bestTime,
+			Hashtable<int*> *lpsIndexMap,
+			TaskCost *taskCost,
+			List<CommunicationCharacteristics*> *commCharacterList,
+			List<PPS_Definition*> *pcubesConfig);
+
+	// determines the partition parameter values that give the recommended number of LPUs to the LPSes
+	static Hashtable<int*> *suggestPartitionParameters(TaskDef *taskDef,
+			List<AdvisedLps*> *lpsList,
+			int *mapping,
+			TaskCost *taskCost,
+			List<PPS_Definition*> *pcubesConfig);
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include "../../../../common-libs/utils/hashtable.h"
 #include "../../../../common-libs/utils/decorator_utils.h"
 #include "../../../../common-libs/utils/string_utils.h"
+#include "../../../../common-libs/utils/properties.h"
 
 #include "../../../../frontend/src/syntax/ast.h"
 #include "../../../../frontend/src/syntax/ast_task.h"
@@ -17,6 +18,41 @@
 #include <sstream>
 #include <cstdlib>
 #include <deque>
+#include <string>
+
+List<std::string> *getNodeSharedReplicas() {
+	
+	// by default, every segment holds its own copy of replicated data
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps == NULL) return NULL;
+	const char *setting = deploymentProps->getProperty("node.shared.replicas");
+	if (setting == NULL) return NULL;
+	std::string arrayNames = std::string(setting);
+	std::string delims = ",";
+	return string_utils::tokenizeString(arrayNames, delims);
+}
+
+bool isNodeSharedReplica(const char *varName) {
+	List<std::string> *arrayNames = getNodeSharedReplicas();
+	if (arrayNames == NULL) return false;
+	bool found = false;
+	for (int i = 0; i < arrayNames->NumElements(); i++) {
+		if (arrayNames->Nth(i).compare(varName) == 0) {
+			found = true;
+			break;
+		}
+	}
+	delete arrayNames;
+	return found;
+}
+
+bool hasNodeSharedReplicas() {
+	List<std::string> *arrayNames = getNodeSharedReplicas();
+	if (arrayNames == NULL) return false;
+	bool found = arrayNames->NumElements() > 0;
+	delete arrayNames;
+	return found;
+}
 
 void genRoutineForDataPartConfig(std::ofstream &headerFile,
                 std::ofstream &programFile,
@@ -102,18 +138,7 @@ void genRoutineForDataPartConfig(std::ofstream &headerFile,
 
 			// determines with what dimension of the LPS the current dimension of the array has
 			// been aligned to
-			CoordinateSystem *coordSys = lps->getCoordinateSystem();
-			int matchingDim = i;
-			int spaceDimensions = lps->getDimensionCount();
-			int j = 0;
-			for (; j < spaceDimensions; j++) {
-				Coordinate *coordinate = coordSys->getCoordinate(j + 1);
-				Token *token = coordinate->getTokenForDataStructure(array->getName());
-				if (token != NULL && !token->isWildcard()) {
-					if (token->getDimensionId() == i + 1) break;
-				}
-			}
-			matchingDim = j;
+			int matchingDim = getLpsAlignment(lps, array, i);
 			
 			// create the dimension configuration object with all information found and add it in
 			// the list
@@ -129,6 +154,12 @@ void genRoutineForDataPartConfig(std::ofstream &headerFile,
 				programFile << "dim" << i << "Paddings";
 				programFile << paramSeparator;
 			}
+			// the split points of a data dependent partition are computed at task launch and kept
+			// in a task level cache
+			if (partitionConfig->isDataDependent()) {
+				programFile << "nnzSplitCache.getSplit(\"" << lps->getName() << "\"";
+				programFile << paramSeparator << matchingDim << ")" << paramSeparator;
+			}
 			programFile << "ppuCount";
 			programFile << paramSeparator << matchingDim;
 			programFile << "))" << stmtSeparator;
@@ -173,6 +204,59 @@ void genRoutineForDataPartConfig(std::ofstream &headerFile,
 	programFile << "}\n";
 }
 
+int getLpsAlignment(Space *lps, ArrayDataStructure *array, int dimensionNo) {
+	CoordinateSystem *coordSys = lps->getCoordinateSystem();
+	int spaceDimensions = lps->getDimensionCount();
+	int j = 0;
+	for (; j < spaceDimensions; j++) {
+		Coordinate *coordinate = coordSys->getCoordinate(j + 1);
+		Token *token = coordinate->getTokenForDataStructure(array->getName());
+		if (token != NULL && !token->isWildcard()) {
+			if (token->getDimensionId() == dimensionNo + 1) break;
+		}
+	}
+	return j;
+}
+
+List<ArrayDataStructure*> *getArraysWithDataDependentPartitions(Space *lps) {
+	List<ArrayDataStructure*> *arrayList = new List<ArrayDataStructure*>;
+	List<const char*> *structureList = lps->getLocalDataStructureNames();
+	for (int i = 0; i < structureList->NumElements(); i++) {
+		DataStructure *structure = lps->getLocalStructure(structureList->Nth(i));
+		ArrayDataStructure *array = dynamic_cast<ArrayDataStructure*>(structure);
+		if (array == NULL) continue;
+		for (int d = 0; d < array->getDimensionality(); d++) {
+			PartitionFunctionConfig *partitionConfig = array->getPartitionSpecForDimension(d + 1);
+			if (partitionConfig != NULL && partitionConfig->isDataDependent()) {
+				arrayList->Append(array);
+				break;
+			}
+		}
+	}
+	return arrayList;
+}
+
+bool hasDataDependentPartitions(PartitionHierarchy *hierarchy) {
+	Space *root = hierarchy->getRootSpace();
+	std::deque<Space*> lpsQueue;
+	lpsQueue.push_back(root);
+	while (!lpsQueue.empty()) {
+		Space *lps = lpsQueue.front();
+		lpsQueue.pop_front();
+		List<Space*> *children = lps->getChildrenSpaces();
+		for (int i = 0; i < children->NumElements(); i++) {
+			lpsQueue.push_back(children->Nth(i));
+		}
+		if (lps->getSubpartition() != NULL) lpsQueue.push_back(lps->getSubpartition());
+		if (lps->isRoot()) continue;
+		List<ArrayDataStructure*> *arrayList = getArraysWithDataDependentPartitions(lps);
+		bool found = arrayList->NumElements() > 0;
+		delete arrayList;
+		if (found) return true;
+	}
+	return false;
+}
+
 void genRoutinesForTaskPartitionConfigs(const char *headerFileName,
                 const char *programFileName,
                 const char *initials,
@@ -191,6 +275,11 @@ void genRoutinesForTaskPartitionConfigs(const char *headerFileName,
 	decorator::writeSectionHeader(headerFile, header);
 	decorator::writeSectionHeader(programFile, header);
 
+	// the split points of data dependent partitions are retained across task invocations
+	if (hasDataDependentPartitions(hierarchy)) {
+		programFile << "\nstatic NnzSplitCache nnzSplitCache" << stmtSeparator;
+	}
+
 	// generate a header for the function that will create dimension configuration of data structures in
 	// different LPSes and store them in a map
 	std::ostringstream functionHeader;
@@ -423,6 +512,12 @@ void genRoutineForLpsContent(std::ofstream &headerFile, std::ofstream &programFi
 		programFile << varName << "Container" << paramSeparator;
 		programFile << "sizeof(" << cType << "))" << stmtSeparator;
 
+		// arrays configured to be held in node shared memory are identified by the task, LPS, and array names
+		if (isNodeSharedReplica(varName)) {
+			programFile << indent << varName << "Parts->shareOnNode(\"" << initials << '.';
+			programFile << lpsName << '.' << varName << "\")" << stmtSeparator;
+		}
+
 		// if the data structure is not part of the task environment then allocate memory for its data parts
 		if (!string_utils::contains(envArrayList, varName)) {
 			programFile << indent << varName << "Parts->allocateParts()" << stmtSeparator;
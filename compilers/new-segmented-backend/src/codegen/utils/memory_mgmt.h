@@ -14,6 +14,11 @@
 #include <fstream>
 #include <sstream>
 
+/* tells if the arrays of the argument name should be held in node shared memory; such arrays are listed in the
+   'node.shared.replicas' deployment property */
+bool isNodeSharedReplica(const char *varName);
+bool hasNodeSharedReplicas();
+
 /* generates a function that will return the data-partition-config for an array for a particular LPS  */
 void genRoutineForDataPartConfig(std::ofstream &headerFile,
 		std::ofstream &programFile,
@@ -21,6 +26,16 @@ void genRoutineForDataPartConfig(std::ofstream &headerFile,
 		Space *lps,
 		ArrayDataStructure *array);
 
+/* determines with what dimension of the LPS a dimension of an array has been aligned to */
+int getLpsAlignment(Space *lps, ArrayDataStructure *array, int dimensionNo);
+
+/* Returns the arrays of an LPS having a dimension divided by a data dependent partition function such as nnz_balanced, 
+   and tells if any LPS of a task has such an array. The split points of those partitions must be computed at task launch 
+   before data-partition-configs can be generated.
+*/
+List<ArrayDataStructure*> *getArraysWithDataDependentPartitions(Space *lps);
+bool hasDataDependentPartitions(PartitionHierarchy *hierarchy);
+
 /* generates data-partition-config generation functions for relevant structures in all LPSes of a task */
 void genRoutinesForTaskPartitionConfigs(const char *headerFile,
                 const char *programFile,
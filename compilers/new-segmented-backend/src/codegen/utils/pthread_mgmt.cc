@@ -66,12 +66,16 @@ void generatePThreadRunFn(const char *headerFileName, const char *programFileNam
 	
 	programFile << stmtIndent << "PThreadArg *pthreadArg = (PThreadArg *) argument" << stmtSeparator;
 	programFile << stmtIndent << "ThreadStateImpl *threadState = pthreadArg->threadState" << stmtSeparator;
+	programFile << stmtIndent << "TRACE_REGISTER_THREAD(threadState->getThreadNo())" << stmtSeparator;
+	programFile << stmtIndent << "COUNTERS_REGISTER_THREAD(threadState->getThreadNo())" << stmtSeparator;
+	programFile << stmtIndent << "timing::registerThread(threadState->getThreadNo())" << stmtSeparator;
 	programFile << stmtIndent << "run(pthreadArg->metadata, \n";
 	programFile << stmtIndent << stmtIndent << stmtIndent << "pthreadArg->taskGlobals, \n";		
 	programFile << stmtIndent << stmtIndent << stmtIndent << "pthreadArg->threadLocals, \n";		
 	programFile << stmtIndent << stmtIndent << stmtIndent << "pthreadArg->partition, \n";		
 	programFile << stmtIndent << stmtIndent << stmtIndent << "threadState)" << stmtSeparator;
 	
+	programFile << stmtIndent << "COUNTERS_UNREGISTER_THREAD()" << stmtSeparator;
 	programFile << stmtIndent << "pthread_exit(NULL)" << stmtSeparator;
 			
 	programFile << "}\n\n";
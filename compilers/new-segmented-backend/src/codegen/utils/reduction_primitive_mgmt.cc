@@ -5,6 +5,7 @@
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/domain-obj/constant.h"
 #include "../../../../common-libs/utils/decorator_utils.h"
+#include "../../../../common-libs/utils/properties.h"
 
 #include "../../../../frontend/src/syntax/ast_type.h"
 #include "../../../../frontend/src/semantics/task_space.h"
@@ -253,10 +254,25 @@ void generateIntermediateResultUpdateFnBody(std::ofstream &programFile, Type *va
 	}
 }
 
+bool isHierarchicalReductionEnabled() {
+	
+	// by default, segments sharing a node combine their results through shared memory before the inter-node step
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps != NULL) {
+		const char *setting = deploymentProps->getProperty("reduction.hierarchical.enabled");
+		if (setting != NULL && strcmp(setting, "true") != 0) return false;
+	}
+	return true;
+}
+
 void generateCodeForDataReduction(std::ofstream &programFile, ReductionOperator op, Type *varType) {
 	
-	programFile << indent << "MPI_Comm mpiComm = segmentGroup->getCommunicator()" << stmtSeparator;
-	programFile << indent << "int status = MPI_Allreduce(sendBuffer" << paramSeparator;
+	if (isHierarchicalReductionEnabled()) {
+		programFile << indent << "int status = crossSegmentReducer->allreduce(sendBuffer" << paramSeparator;
+	} else {
+		programFile << indent << "MPI_Comm mpiComm = segmentGroup->getCommunicator()" << stmtSeparator;
+		programFile << indent << "int status = MPI_Allreduce(sendBuffer" << paramSeparator;
+	}
 	programFile << paramIndent << indent;
 	programFile << "receiveBuffer" << paramSeparator;
 	programFile << paramIndent << indent;
@@ -267,11 +283,15 @@ void generateCodeForDataReduction(std::ofstream &programFile, ReductionOperator
 	programFile << mpiDataTypeName << paramSeparator;
 
 	const char *mpiReductionOp = getMpiReductionOp(op);
-	programFile << paramIndent << indent;
-	programFile << mpiReductionOp << paramSeparator;
-	
-	programFile << paramIndent << indent;
-	programFile << "mpiComm)" << stmtSeparator;
+	if (isHierarchicalReductionEnabled()) {
+		programFile << paramIndent << indent;
+		programFile << mpiReductionOp << ")" << stmtSeparator;
+	} else {
+		programFile << paramIndent << indent;
+		programFile << mpiReductionOp << paramSeparator;
+		programFile << paramIndent << indent;
+		programFile << "mpiComm)" << stmtSeparator;
+	}
 
 	programFile << indent << "if (status != MPI_SUCCESS) {\n";
 	programFile << doubleIndent << "std::cout << \"Reduction operation failed\\n\"" << stmtSeparator;
@@ -568,6 +588,12 @@ void generateReductionPrimitiveInitFn(const char *headerFileName,
 			programFile << indent << varName << "Reducer[0]->setLogFile(&logFile)";
 			programFile << stmtSeparator;
 
+			// set up shared memory and node level communicators for the cross-segment reduction
+			if (isHierarchicalReductionEnabled()) {
+				programFile << indent << varName << "Reducer[0]->setupHierarchicalReduction()";
+				programFile << stmtSeparator;
+			}
+
 		// otherwise, one or more intra-segment reduction primtives will be needed for the groups of PPUs
 		// rooted at the PPS the LPS has been mapped to.
 		} else {
@@ -598,6 +624,48 @@ void generateReductionPrimitiveInitFn(const char *headerFileName,
 	programFile.close();	
 }
 
+void generateReductionPrimitiveReleaseFn(const char *headerFileName, 
+                const char *programFileName, 
+                const char *initials, 
+                List<ReductionMetadata*> *reductionInfos) {
+	
+	if (reductionInfos->NumElements() == 0) return;
+
+	std::cout << "\tGenerating function for reduction primitive resource release" << std::endl;
+        std::ofstream programFile, headerFile;
+        headerFile.open (headerFileName, std::ofstream::out | std::ofstream::app);
+        programFile.open (programFileName, std::ofstream::out | std::ofstream::app);
+        if (!programFile.is_open() || !headerFile.is_open()) {
+                std::cout << "Unable to open program or header file";
+                std::exit(EXIT_FAILURE);
+        }
+	
+	const char *subHeader = "Reduction Primitive Resource Release";
+	decorator::writeSubsectionHeader(headerFile, subHeader);
+	decorator::writeSubsectionHeader(programFile, subHeader);
+	headerFile << std::endl;
+	programFile << std::endl;
+
+	headerFile << "void releaseReductionPrimitives()" << stmtSeparator;
+	programFile << "void " << initials << "::releaseReductionPrimitives() {\n";
+
+	// only the node-aware reducers of cross-segment reductions hold MPI communicators and shared memory windows; as
+	// they are set up on every task execution, they must be released at its end not to leak those resources
+	for (int i = 0; i < reductionInfos->NumElements(); i++) {
+		ReductionMetadata *reduction = reductionInfos->Nth(i);
+		Space *reductionRootLps = reduction->getReductionRootLps();
+		if (reductionRootLps->getPpsId() <= reductionRootLps->getSegmentedPPS()) continue;
+		if (!isHierarchicalReductionEnabled()) continue;
+		const char *varName = reduction->getResultVar();
+		programFile << indent << varName << "Reducer[0]->releaseHierarchicalReduction()" << stmtSeparator;
+	}
+	
+	programFile << "}\n";
+
+	headerFile.close();
+	programFile.close();	
+}
+
 void generateReductionPrimitiveMapCreateFnForThread(const char *headerFileName,
                 const char *programFileName,
                 const char *initials,
@@ -664,4 +732,116 @@ void generateReductionPrimitiveMapCreateFnForThread(const char *headerFileName,
 	programFile.close();	
 }
 
+const char *getScanElementType(Space *rootLps, const char *arrayName) {
+	DataStructure *structure = rootLps->getLocalStructure(arrayName);
+	ArrayType *arrayType = (ArrayType*) structure->getType();
+	return arrayType->getTerminalElementType()->getCType();
+}
+
+void generateScanCombinerDecls(const char *headerFileName, Space *rootLps, List<const char*> *scanOutputArrays) {
+
+	std::cout << "\tGenerating static pointers for scan combiners" << std::endl;
+        std::ofstream headerFile;
+        headerFile.open (headerFileName, std::ofstream::out | std::ofstream::app);
+        if (!headerFile.is_open()) {
+                std::cout << "header file";
+                std::exit(EXIT_FAILURE);
+        }
+
+	decorator::writeSubsectionHeader(headerFile, "Scan Combiner Instances");
+	headerFile << std::endl;
 
+	headerFile << "static SegmentGroup *scanSegmentGroup" << stmtSeparator;
+	for (int i = 0; i < scanOutputArrays->NumElements(); i++) {
+		const char *arrayName = scanOutputArrays->Nth(i);
+		const char *elementType = getScanElementType(rootLps, arrayName);
+		headerFile << "static prefixscan::ScanCombiner<" << elementType << "> *";
+		headerFile << arrayName << "ScanCombiner" << stmtSeparator;
+	}
+
+	headerFile.close();
+}
+
+void generateScanCombinerInitFn(const char *headerFileName,
+		const char *programFileName,
+		const char *initials,
+		Space *rootLps,
+		List<const char*> *scanOutputArrays) {
+
+	std::cout << "\tGenerating function for scan combiner initialization" << std::endl;
+        std::ofstream programFile, headerFile;
+        headerFile.open (headerFileName, std::ofstream::out | std::ofstream::app);
+        programFile.open (programFileName, std::ofstream::out | std::ofstream::app);
+        if (!programFile.is_open() || !headerFile.is_open()) {
+                std::cout << "Unable to open program or header file";
+                std::exit(EXIT_FAILURE);
+        }
+	
+	const char *subHeader = "Scan Combiner Initializer";
+	decorator::writeSubsectionHeader(headerFile, subHeader);
+	decorator::writeSubsectionHeader(programFile, subHeader);
+	headerFile << std::endl;
+	programFile << std::endl;
+
+	headerFile << "void setupScanCombiners(std::ofstream &logFile)" << stmtSeparator;
+	programFile << "void " << initials << "::setupScanCombiners(std::ofstream &logFile) {\n";
+
+	// all participating segments exchange the totals of their parts; non-participating segments exclude themselves
+	// from the group setup in the task executor
+	programFile << std::endl;
+	programFile << indent << "scanSegmentGroup = new SegmentGroup()" << stmtSeparator;
+	programFile << indent << "scanSegmentGroup->discoverGroupAndSetupCommunicator(logFile)" << stmtSeparator;
+
+	// all PPU controllers of the segment take part in combining the parts of a scan
+	for (int i = 0; i < scanOutputArrays->NumElements(); i++) {
+		const char *arrayName = scanOutputArrays->Nth(i);
+		const char *elementType = getScanElementType(rootLps, arrayName);
+		programFile << indent << arrayName << "ScanCombiner = new prefixscan::ScanCombiner<";
+		programFile << elementType << ">(" << paramIndent << indent;
+		programFile << "Threads_Per_Segment" << paramSeparator << "scanSegmentGroup)" << stmtSeparator;
+	}
+
+	programFile << "}\n";
+
+	headerFile.close();
+	programFile.close();	
+}
+
+void generateScanCombinerReleaseFn(const char *headerFileName,
+		const char *programFileName,
+		const char *initials,
+		List<const char*> *scanOutputArrays) {
+
+	std::cout << "\tGenerating function for scan combiner resource release" << std::endl;
+        std::ofstream programFile, headerFile;
+        headerFile.open (headerFileName, std::ofstream::out | std::ofstream::app);
+        programFile.open (programFileName, std::ofstream::out | std::ofstream::app);
+        if (!programFile.is_open() || !headerFile.is_open()) {
+                std::cout << "Unable to open program or header file";
+                std::exit(EXIT_FAILURE);
+        }
+	
+	const char *subHeader = "Scan Combiner Resource Release";
+	decorator::writeSubsectionHeader(headerFile, subHeader);
+	decorator::writeSubsectionHeader(programFile, subHeader);
+	headerFile << std::endl;
+	programFile << std::endl;
+
+	headerFile << "void releaseScanCombiners()" << stmtSeparator;
+	programFile << "void " << initials << "::releaseScanCombiners() {\n";
+
+	for (int i = 0; i < scanOutputArrays->NumElements(); i++) {
+		const char *arrayName = scanOutputArrays->Nth(i);
+		programFile << indent << "delete " << arrayName << "ScanCombiner" << stmtSeparator;
+	}
+
+	// the group communicator is created anew in every task execution
+	programFile << indent << "MPI_Comm scanCommunicator = scanSegmentGroup->getCommunicator()" << stmtSeparator;
+	programFile << indent << "MPI_Comm_free(&scanCommunicator)" << stmtSeparator;
+	programFile << indent << "delete scanSegmentGroup" << stmtSeparator;
+	
+	programFile << "}\n";
+
+	headerFile.close();
+	programFile.close();	
+}
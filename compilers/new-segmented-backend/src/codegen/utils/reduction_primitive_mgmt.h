@@ -57,6 +57,10 @@ void generateIntermediateResultUpdateFnBody(std::ofstream &programFile,
 				Generators for Perform Cross Segment Reduction Functions' body
 ***********************************************************************************************************************/
 
+// determines if cross-segment reductions should combine the results of segments sharing a node through shared 
+// memory before doing MPI communication among the nodes
+bool isHierarchicalReductionEnabled();
+
 void generateCodeForDataReduction(std::ofstream &programFile, 
 		ReductionOperator op, Type *varType);
 
@@ -97,6 +101,13 @@ void generateReductionPrimitiveInitFn(const char *headerFile,
 		const char *initials, 
 		List<ReductionMetadata*> *reductionInfos);
 
+/* this function generates a routine that releases the MPI resources the reduction primitives of a segment have
+   acquired during their initialization; it should be called at the end of each task execution */
+void generateReductionPrimitiveReleaseFn(const char *headerFile, 
+		const char *programFile, 
+		const char *initials, 
+		List<ReductionMetadata*> *reductionInfos);
+
 /* this function generates a routine that a PPU controller thread can use to receive the reduction primitives 
    relevant to it */
 void generateReductionPrimitiveMapCreateFnForThread(const char *headerFile,
@@ -104,4 +115,30 @@ void generateReductionPrimitiveMapCreateFnForThread(const char *headerFile,
                 const char *initials,
                 List<ReductionMetadata*> *reductionInfos);
 
+/**********************************************************************************************************************
+					Scan Combiner Management  
+***********************************************************************************************************************/
+
+/* returns the C type of the elements of an array receiving the running totals of a scan */
+const char *getScanElementType(Space *rootLps, const char *arrayName);
+
+/* scans are reductions that produce a running total per element; the parts of a scan done in different LPUs are
+   combined by a combiner per output array that is shared by all PPU controllers of a segment. This function declares
+   the static combiner instances in the header file. */
+void generateScanCombinerDecls(const char *headerFile, Space *rootLps, List<const char*> *scanOutputArrays);
+
+/* this function generates a routine that initializes the scan combiners of a segment along with the group of 
+   segments they exchange part totals within */
+void generateScanCombinerInitFn(const char *headerFile,
+		const char *programFile,
+		const char *initials,
+		Space *rootLps,
+		List<const char*> *scanOutputArrays);
+
+/* this function generates a routine that releases the scan combiners at the end of each task execution */
+void generateScanCombinerReleaseFn(const char *headerFile,
+		const char *programFile,
+		const char *initials,
+		List<const char*> *scanOutputArrays);
+
 #endif
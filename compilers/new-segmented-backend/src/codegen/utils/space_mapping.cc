@@ -10,6 +10,7 @@
 #include "../../../../frontend/src/static-analysis/usage_statistic.h"
 
 #include <cstdlib>
+#include <ctype.h>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -25,6 +26,49 @@ void PPS_Definition::print(int indentLevel) {
 	if (coreSpace) std::cout << indent.str() << "Computation Core\n";
 	if (segmented) std::cout << indent.str() << "Segmented Memory\n";	
 	if (physicalUnit) std::cout << indent.str() << "Physical Unit\n";
+	if (cacheSize > 0) {
+		std::cout << indent.str() << "L-" << cacheLevel << " Cache: " << cacheSize << " bytes\n";
+	}
+}
+
+void parseCacheDescription(std::string &comment, PPS_Definition *pps) {
+	
+	pps->cacheSize = 0;
+	pps->cacheLevel = 0;
+	
+	// the cache level is marked by an 'L-' or 'L' prefix followed by a digit (e.g., L-2 or L2)
+	size_t levelMarker = std::string::npos;
+	for (size_t i = 0; i + 1 < comment.length(); i++) {
+		if (comment[i] != 'L') continue;
+		size_t digitPos = (comment[i + 1] == '-') ? i + 2 : i + 1;
+		if (digitPos < comment.length() && isdigit(comment[digitPos])) {
+			levelMarker = i;
+			pps->cacheLevel = comment[digitPos] - '0';
+			break;
+		}
+	}
+	if (levelMarker == std::string::npos) return;
+
+	// the capacity should be a number followed by a KB, MB, or GB unit that appears before the level marker
+	std::string capacity = comment.substr(0, levelMarker);
+	size_t unitPos = std::string::npos;
+	long multiplier = 1;
+	if ((unitPos = capacity.rfind("KB")) != std::string::npos) multiplier = 1024l;
+	else if ((unitPos = capacity.rfind("MB")) != std::string::npos) multiplier = 1024l * 1024;
+	else if ((unitPos = capacity.rfind("GB")) != std::string::npos) multiplier = 1024l * 1024 * 1024;
+	if (unitPos == std::string::npos) {
+		pps->cacheLevel = 0;
+		return;
+	}
+	size_t numberEnd = unitPos;
+	while (numberEnd > 0 && capacity[numberEnd - 1] == ' ') numberEnd--;
+	size_t numberStart = numberEnd;
+	while (numberStart > 0 && isdigit(capacity[numberStart - 1])) numberStart--;
+	if (numberStart == numberEnd) {
+		pps->cacheLevel = 0;
+		return;
+	}
+	pps->cacheSize = atol(capacity.substr(numberStart, numberEnd - numberStart).c_str()) * multiplier;
 }
 
 List<PPS_Definition*> *parsePCubeSDescription(const char *filePath) {
@@ -82,6 +126,12 @@ List<PPS_Definition*> *parsePCubeSDescription(const char *filePath) {
 		spaceDefinition->coreSpace = coreSpace;
 		spaceDefinition->segmented = segmented;
 		spaceDefinition->physicalUnit = physicalUnit;
+
+		// if there is a comment about the cache of the PPS then retrieve the cache capacity from it
+		std::string ppsComment = "";
+		size_t commentStart = ppuCountStr.find("//");
+		if (commentStart != std::string::npos) ppsComment = ppuCountStr.substr(commentStart + 2);
+		parseCacheDescription(ppsComment, spaceDefinition);
 			
 		// store the space definition in the list in top-down order
 		int i = 0;	
@@ -8,6 +8,7 @@
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../frontend/src/semantics/task_space.h"
 #include <iostream>
+#include <string>
 
 /* object definition to keep track of the configuration of a PCubeS space (aka a PPS) */
 class PPS_Definition {
@@ -40,6 +41,14 @@ class PPS_Definition {
 	*/
 	bool physicalUnit;
 
+	/* Cache capacity of a PPU of the space in bytes and the level of that cache. This information is
+	   extracted from the comments of the PCubeS description, e.g., '// 6 MB L-3 Cache', and is used to
+	   decide the tile sizes of loops executing in LPSes mapped to or above the space. Both properties
+	   are zero when the description does not say anything about the cache of the space.
+	*/
+	long cacheSize;
+	int cacheLevel;
+
 	void print(int indentLevel);
 };
 
@@ -62,6 +71,10 @@ class MappingNode {
 /* function definition to read the PCubeS description of the hardware from a file */
 List<PPS_Definition*> *parsePCubeSDescription(const char *filePath);
 
+/* function definition to read the cache capacity and level of a PPS from the comment written beside its
+   description; the comment should contain a phrase like '16 KB L-1 Cache' to be recognized */
+void parseCacheDescription(std::string &comment, PPS_Definition *pps);
+
 /* function defintion to parse the mapping configuration file */
 MappingNode *parseMappingConfiguration(const char *taskName, 
 		const char *filePath, 
@@ -15,6 +15,8 @@
 #include "environment_mgmt.h"
 #include "code_constant.h"
 #include "task_global.h"
+#include "loop_transformation.h"
+#include "mapping_advisor.h"
 
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/hashtable.h"
@@ -68,6 +70,7 @@ TaskGenerator::TaskGenerator(TaskDef *taskDef,
 	mappingRoot = NULL;
 	segmentedPPS = 0;
 	involveReduction = false;
+	involveScan = false;
 }
 
 const char *TaskGenerator::getHeaderFileName(TaskDef *taskDef) {
@@ -132,6 +135,9 @@ void TaskGenerator::generate(List<PPS_Definition*> *pcubesConfig) {
 	List<ReductionMetadata*> *reductionInfos = new List<ReductionMetadata*>;
 	taskDef->getComputation()->extractAllReductionInfo(reductionInfos);
 	this->involveReduction = (reductionInfos->NumElements() > 0); 
+	List<const char*> *scanOutputArrays = new List<const char*>;
+	taskDef->getComputation()->retrieveScanOutputArrays(scanOutputArrays);
+	this->involveScan = (scanOutputArrays->NumElements() > 0);
         generateLpuDataStructures(headerFile, mappingConfig, reductionInfos);
 	generatePrintFnForLpuDataStructures(initials, 
 			programFile, mappingConfig, reductionInfos);
@@ -186,6 +192,11 @@ void TaskGenerator::generate(List<PPS_Definition*> *pcubesConfig) {
 				programFile, taskDef, commCharacterList);
 	}
 
+	// recommend a mapping for the task if the profile of a calibration run is available
+	if (MappingAdvisor::isEnabled()) {
+		MappingAdvisor::adviseMapping(taskDef, mappingConfig, pcubesConfig, commCharacterList);
+	}
+
 	// gnerate reduction related data structures and their management functions
 	if (involveReduction) {
 		std::cout << "Generating reduction related data structures and functions\n";
@@ -194,10 +205,22 @@ void TaskGenerator::generate(List<PPS_Definition*> *pcubesConfig) {
 		generateReductionPrimitiveDecls(headerFile, reductionInfos);
 		generateReductionPrimitiveInitFn(headerFile, 
 				programFile, initials, reductionInfos);
+		generateReductionPrimitiveReleaseFn(headerFile, 
+				programFile, initials, reductionInfos);
 		generateReductionPrimitiveMapCreateFnForThread(headerFile, 
 				programFile, initials, reductionInfos);
 	}
 
+	// generate the combiners that complete the scans done in individual LPUs and their management functions
+	if (involveScan) {
+		std::cout << "Generating scan related data structures and functions\n";
+		generateScanCombinerDecls(headerFile, rootLps, scanOutputArrays);
+		generateScanCombinerInitFn(headerFile, 
+				programFile, initials, rootLps, scanOutputArrays);
+		generateScanCombinerReleaseFn(headerFile, 
+				programFile, initials, scanOutputArrays);
+	}
+
 	// generate environment management data structures and functions
 	generateTaskEnvironmentClass(taskDef, initials, headerFile, programFile);
 	generateFnToInitEnvLinksFromEnvironment(taskDef, initials, headerFile, programFile);
@@ -211,6 +234,10 @@ void TaskGenerator::generate(List<PPS_Definition*> *pcubesConfig) {
 	// inside initialize and compute blocks
 	ntransform::NameTransformer::setTransformer(taskDef);	
 
+	// configure the loop restructuring library with the cache hierarchy of the hardware before translating
+	// compute stages
+	LoopTransformer::configure(pcubesConfig);
+
 	// translate the initialize block of the task into a function
 	generateInitializeFunction(headerFile, programFile, initials, 
         		envLinkList, taskDef, mappingConfig->mappingConfig->LPS);
@@ -464,6 +491,79 @@ void TaskGenerator::inovokeTaskInitializer(std::ofstream &stream,
 	stream << indent << "logFile.flush()" << stmtSeparator;
 }
 
+void TaskGenerator::prepareDataDependentSplits(std::ofstream &stream) {
+	
+	PartitionHierarchy *lpsHierarchy = taskDef->getPartitionHierarchy();
+	if (!hasDataDependentPartitions(lpsHierarchy)) return;
+
+	std::cout << "\tGenerating code for computing split points of data dependent partitions\n";
+	stream << std::endl << indent << "// computing split points of nnz-balanced partitions\n";
+	
+	std::deque<Space*> lpsQueue;
+	lpsQueue.push_back(lpsHierarchy->getRootSpace());
+	while (!lpsQueue.empty()) {
+		Space *lps = lpsQueue.front();
+		lpsQueue.pop_front();
+		List<Space*> *children = lps->getChildrenSpaces();
+		for (int i = 0; i < children->NumElements(); i++) {
+			lpsQueue.push_back(children->Nth(i));
+		}
+		if (lps->getSubpartition() != NULL) lpsQueue.push_back(lps->getSubpartition());
+		if (lps->isRoot()) continue;
+
+		// All arrays divided along the same LPS dimension share a single split. The row pointers of the split
+		// are taken from the first one-dimensional integer array divided by the function along that dimension;
+		// other arrays only serve to determine the dimension length and the partition argument if there is no 
+		// such array.
+		List<ArrayDataStructure*> *arrayList = getArraysWithDataDependentPartitions(lps);
+		for (int lpsDim = 0; lpsDim < lps->getDimensionCount(); lpsDim++) {
+			ArrayDataStructure *sourceArray = NULL;
+			int sourceDim = 0;
+			bool rowPointersFound = false;
+			for (int i = 0; i < arrayList->NumElements() && !rowPointersFound; i++) {
+				ArrayDataStructure *array = arrayList->Nth(i);
+				for (int d = 0; d < array->getDimensionality(); d++) {
+					PartitionFunctionConfig *config = array->getPartitionSpecForDimension(d + 1);
+					if (config == NULL || !config->isDataDependent()) continue;
+					if (getLpsAlignment(lps, array, d) != lpsDim) continue;
+					ArrayType *arrayType = (ArrayType*) array->getType();
+					bool rowPointers = (array->getDimensionality() == 1)
+							&& (arrayType->getTerminalElementType() == Type::intType);
+					if (sourceArray == NULL || rowPointers) {
+						sourceArray = array;
+						sourceDim = d;
+						rowPointersFound = rowPointers;
+					}
+					break;
+				}
+			}
+			if (sourceArray == NULL) continue;
+
+			const char *arrayName = sourceArray->getName();
+			PartitionFunctionConfig *config = sourceArray->getPartitionSpecForDimension(sourceDim + 1);
+			Node *dividingArg = config->getArgsForDimension(sourceDim + 1)->getDividingArg();
+			const char *argument = DataDimensionConfig::getArgumentString(dividingArg, "partition.");
+			std::ostringstream fileName;
+			if (rowPointersFound) {
+				stream << indent << "ReadFromFileInstruction *" << arrayName << "ReadInstr = ";
+				stream << "(ReadFromFileInstruction*) environment->getInstr(\"";
+				stream << arrayName << "\"" << paramSeparator << "2)" << stmtSeparator;
+				fileName << "(" << arrayName << "ReadInstr != NULL) ? ";
+				fileName << arrayName << "ReadInstr->getFileName() : NULL";
+			} else {
+				fileName << "NULL";
+			}
+			stream << indent << "nnzSplitCache.prepareSplit(\"" << lps->getName() << "\"";
+			stream << paramSeparator << lpsDim << paramSeparator;
+			stream << "metadata->" << arrayName << "Dims[" << sourceDim << "]";
+			stream << paramSeparator << argument << paramSeparator;
+			stream << '\n' << indent << doubleIndent << fileName.str();
+			stream << paramSeparator << "logFile)" << stmtSeparator;
+		}
+		delete arrayList;
+	}
+}
+
 void TaskGenerator::initiateThreadStates(std::ofstream &stream) {
 	
 	std::cout << "\tGenerating state variables for threads\n";
@@ -603,9 +703,38 @@ bool TaskGenerator::generateCommunicators(std::ofstream &stream) {
 	// create a communication statistics object to record time spent on different aspects of communication
 	stream << indent << "CommStatistics *commStat = new CommStatistics()" << stmtSeparator;
 	
-	// first generate a distribution map for data shared among multiple segments
-	stream << indent << "PartDistributionMap *distributionMap = generateDistributionMap(";
+	// construct the launch plan key from the partition arguments, the array dimensions, and the number of participating
+	// segments as these together determine the distribution of data parts and the data exchanges among segments
+	stream << indent << "LaunchPlanKey *planKey = new LaunchPlanKey()" << stmtSeparator;
+	stream << indent << "planKey->addComponent(activeSegments)" << stmtSeparator;
+	int partitionArgCount = taskDef->getPartitionArguments()->NumElements();
+	if (partitionArgCount > 0) {
+		stream << indent << "for (int i = 0; i < " << partitionArgCount << "; i++) {\n";
+		stream << doubleIndent << "planKey->addComponent(partitionArgs[i])" << stmtSeparator;
+		stream << indent << "}\n";
+	}
+	Space *rootLps = taskDef->getPartitionHierarchy()->getRootSpace();
+	List<const char*> *localArrays = rootLps->getLocallyUsedArrayNames();
+	for (int i = 0; i < localArrays->NumElements(); i++) {
+		ArrayDataStructure *array = (ArrayDataStructure*) rootLps->getLocalStructure(localArrays->Nth(i));
+		int dimensions = array->getDimensionality();
+		for (int d = 0; d < dimensions; d++) {
+			stream << indent << "planKey->addDimension(metadata->" << array->getName();
+			stream << "Dims[" << d << "])" << stmtSeparator;
+		}
+	}
+
+	// retrieve the launch plan; a plan from an earlier invocation can only be reused when all processes are active
+	stream << indent << "LaunchPlan *launchPlan = launchPlanCache.getPlan(planKey" << paramSeparator;
+	stream << "mpiProcessCount == activeSegments" << paramSeparator << "logFile)" << stmtSeparator;
+
+	// then generate a distribution map for data shared among multiple segments unless the plan already has one
+	stream << indent << "PartDistributionMap *distributionMap = launchPlan->getDistributionMap()" << stmtSeparator;
+	stream << indent << "if (distributionMap == NULL) {\n";
+	stream << doubleIndent << "distributionMap = generateDistributionMap(";
 	stream << "segmentList" << paramSeparator << "configMap)" << stmtSeparator;
+	stream << doubleIndent << "launchPlan->setDistributionMap(distributionMap)" << stmtSeparator;
+	stream << indent << "}\n";
 
 	// then use that map to create communicators for shared arrays; the same function creates communicator for scalars
 	stream << indent << "Hashtable<Communicator*> *communicatorMap = generateCommunicators(";
@@ -613,6 +742,7 @@ bool TaskGenerator::generateCommunicators(std::ofstream &stream) {
 	stream << '\n' << indent << doubleIndent;
 	stream << "segmentList" << paramSeparator << "taskData" << paramSeparator << "&taskGlobals";
 	stream << paramSeparator << "configMap" << paramSeparator << "distributionMap"; 
+	stream << paramSeparator << "launchPlan";
 	stream << paramSeparator << '\n' << indent << doubleIndent;
 	stream << "commStat" << paramSeparator << "logFile)" << stmtSeparator;
 
@@ -655,13 +785,19 @@ void TaskGenerator::startThreads(std::ofstream &stream) {
 	stream << indent << "cpu_set_t cpus" << stmtSeparator;
 	stream << indent << "pthread_attr_init(&attr)" << stmtSeparator;
 
+	// log how the topology discovered at runtime compares with the PCubeS description
+	stream << indent << "ProcessorTopology::describe(logFile, Processors_Per_Phy_Unit, Threads_Per_Core)";
+	stream << stmtSeparator;
+
 	// then create the threads one by one
 	stream << indent << "int state" << stmtSeparator;
 	stream << indent << "for (int i = participantStart; i <= participantEnd; i++) {\n";
-	// determine the cpu-id for the thread
-	stream << indent << indent << "int cpuId = (i * Core_Jump / Threads_Per_Core) % Processors_Per_Phy_Unit";
-	stream << stmtSeparator;
-	stream << indent << indent << "int physicalId = Processor_Order[cpuId]" << stmtSeparator;
+	// determine the cpu-id for the thread from the processor topology of the node the segment is running on; the
+	// processor order array generated from the processor description file is used only if that is unavailable
+	stream << indent << indent << "int physicalId = ProcessorTopology::getProcessorForThread(i" << paramSeparator;
+	stream << "Core_Jump" << paramSeparator << "Threads_Per_Core" << paramSeparator;
+	stream << "Processors_Per_Phy_Unit" << paramSeparator;
+	stream << "Processor_Order" << paramSeparator << "sizeof(Processor_Order) / sizeof(int))" << stmtSeparator;
 
 	// check if thread affinity is disabled in the deployment; by default threads are pinned to specific cores
         bool affinityEnabled = true;
@@ -772,3 +908,37 @@ void TaskGenerator::writeResults(std::ofstream &stream) {
 		}
 	}	
 }
+
+void TaskGenerator::beginMappingProfile(std::ofstream &stream) {
+
+	stream << std::endl << indent << "// registering the task with the LPS cost profiler\n";
+	stream << indent << "PROFILE_BEGIN_TASK(\"" << taskDef->getName() << "\"" << paramSeparator;
+	stream << "Space_Count" << paramSeparator << "Total_Threads)" << stmtSeparator;
+
+	// the LPS IDs are assigned by a breadth first traversal of the mapping hierarchy
+	std::deque<MappingNode*> nodeQueue;
+	nodeQueue.push_back(mappingRoot);
+	while (!nodeQueue.empty()) {
+		MappingNode *node = nodeQueue.front();
+		nodeQueue.pop_front();
+		for (int i = 0; i < node->children->NumElements(); i++) {
+			nodeQueue.push_back(node->children->Nth(i));
+		}
+		Space *lps = node->mappingConfig->LPS;
+		stream << indent << "PROFILE_DESCRIBE_LPS(Space_" << lps->getName() << paramSeparator;
+		stream << "\"" << lps->getName() << "\"" << paramSeparator;
+		stream << node->mappingConfig->PPS->id << ")" << stmtSeparator;
+	}
+}
+
+void TaskGenerator::endMappingProfile(std::ofstream &stream, bool communicatorsGenerated) {
+	
+	List<Identifier*> *partitionArgs = taskDef->getPartitionArguments();
+	for (int i = 0; i < partitionArgs->NumElements(); i++) {
+		const char *argName = partitionArgs->Nth(i)->getName();
+		stream << indent << "PROFILE_RECORD_ARGUMENT(\"" << argName << "\"" << paramSeparator;
+		stream << "partition." << argName << ")" << stmtSeparator;
+	}
+	stream << indent << "PROFILE_END_TASK(" << (communicatorsGenerated ? "commStat" : "NULL") << ")";
+	stream << stmtSeparator;
+}
@@ -32,6 +32,7 @@ class TaskGenerator {
 	SyncManager *syncManager;
 	int segmentedPPS;
 	bool involveReduction;
+	bool involveScan;
   public:
 	TaskGenerator(TaskDef *taskDef, 
 		const char *outputDirectory, 
@@ -48,6 +49,7 @@ class TaskGenerator {
 	SyncManager *getSyncManager() { return syncManager; }
 	bool hasCommunicators();
 	bool hasReductions() { return involveReduction; }
+	bool hasScans() { return involveScan; }
 
 	// function to generate all data structures and methods that are relevant to this task 
 	// including a thread run function to run the task as a parallel program in multiple threads
@@ -70,6 +72,10 @@ class TaskGenerator {
 	void inovokeTaskInitializer(std::ofstream &stream, 
 			List<const char*> *externalEnvLinks, 
 			bool skipArgInitialization = false);
+	// a supporting function that computes the split points of data dependent partitions, such as 
+	// nnz_balanced, once the array dimensions are known but before partition configurations are
+	// generated
+	void prepareDataDependentSplits(std::ofstream &stream);
 	// a supporting function for generating an array of thread-state objects, one for each thread,
 	// then initializing them	
 	void initiateThreadStates(std::ofstream &stream);
@@ -89,6 +95,11 @@ class TaskGenerator {
 	// a supporting function that generates prompts and codes for writing results of computations
 	// to external files 
 	void writeResults(std::ofstream &stream); 		
+	// supporting functions that register the task and its LPSes with the profiler measuring the costs
+	// of individual LPSes at the beginning of the task execution and record the partition parameters
+	// and communication costs at the end; the generated code has effect only in a profiling build
+	void beginMappingProfile(std::ofstream &stream);
+	void endMappingProfile(std::ofstream &stream, bool communicatorsGenerated);
 };
 
 #endif
@@ -4,6 +4,7 @@
 #include "sync_mgmt.h"
 #include "code_constant.h"
 #include "name_transformer.h"
+#include "memory_mgmt.h"
 
 #include "../../../../frontend/src/syntax/ast_def.h"
 #include "../../../../frontend/src/syntax/ast_type.h"
@@ -15,6 +16,7 @@
 #include "../../../../common-libs/utils/string_utils.h"
 #include "../../../../common-libs/utils/common_utils.h"
 #include "../../../../common-libs/utils/decorator_utils.h"
+#include "../../../../common-libs/utils/properties.h"
 #include "../../../../common-libs/domain-obj/constant.h"
 
 #include <sstream>
@@ -194,6 +196,13 @@ void generateRoutineToReadProgramArgs(TupleDef *programArg,  const char *headerF
 	programFile << doubleIndent << "std::string value = keyValue.substr(separator + 1)" << stmtSeparator;
 	programFile << "\n";
 
+	// the restart request is not a program argument; it is handed over to the checkpoint manager
+	programFile << doubleIndent << "if (strcmp(\"checkpoint.restart\"" << paramSeparator << "key.c_str()) == 0) {\n";
+	programFile << tripleIndent << "if (strcmp(\"true\"" << paramSeparator << "value.c_str()) == 0) ";
+	programFile << "CheckpointManager::requestRestart()" << stmtSeparator;
+	programFile << tripleIndent << "continue" << stmtSeparator;
+	programFile << doubleIndent << "}\n";
+
 	// identify the argument type by comparing the key with property names of the program argument tuple and
 	// assign the value to the matching property
 	List<VariableDef*> *propertyList = programArg->getComponents();
@@ -283,6 +292,12 @@ void generateTaskExecutor(TaskGenerator *taskGenerator) {
 	fnHeader << "std::ofstream &logFile";
 	fnHeader << ")";
 
+	// a task involving communications keeps a launch plan cache across its invocations to avoid recomputing data
+	// distribution and exchange information when the partition and array dimensions do not change 
+	if (taskGenerator->hasCommunicators()) {
+		programFile << "static LaunchPlanCache launchPlanCache" << stmtSeparator << std::endl;
+	}
+
 	// write function signature in header and program files
 	headerFile << "void " << fnHeader.str() << stmtSeparator;
 	programFile << "void " << taskGenerator->getInitials() << "::" << fnHeader.str();
@@ -298,10 +313,22 @@ void generateTaskExecutor(TaskGenerator *taskGenerator) {
 	programFile << indent << "if (segmentId >= Max_Segments_Count) {\n";
 	programFile << doubleIndent << "logFile << \"Current segment does not participate in: ";
 	programFile << taskGenerator->getTaskName() << "\\n\"" << stmtSeparator;
+	// participating segments form the group exchanging the totals of scanned parts before the data exchange 
+	// communicators; so the exclusions must follow the same order
+	if (taskGenerator->hasScans()) {
+		programFile << doubleIndent << "SegmentGroup::excludeSegmentFromGroupSetup(";
+		programFile << "segmentId" << paramSeparator << "logFile)" << stmtSeparator;
+	}
 	if (taskGenerator->hasCommunicators()) {
 		programFile << doubleIndent << "excludeFromAllCommunication(";
 		programFile << "segmentId" << paramSeparator << "logFile)" << stmtSeparator;
 	}	
+	// the removal of node shared memory object names needs all segments of the node, participating or not
+	if (hasNodeSharedReplicas()) {
+		programFile << doubleIndent << "NodeSharedMemory::unlinkCreatedObjects()" << stmtSeparator;
+	}
+	programFile << doubleIndent << "CheckpointManager::completeInvocation(environment" << paramSeparator;
+	programFile << "logFile)" << stmtSeparator;
 	programFile << doubleIndent << "return" << stmtSeparator;
 	programFile << indent << "}\n\n";
 
@@ -330,8 +357,9 @@ void generateTaskExecutor(TaskGenerator *taskGenerator) {
 	// create a start timer to record running time of different parts of the task
 	programFile << std::endl;
 	programFile << indent << "// declaring and initiating segment execution timer\n";
-	programFile << indent << "struct timeval start" << stmtSeparator;
-	programFile << indent << "gettimeofday(&start, NULL)" << stmtSeparator;
+	programFile << indent << "int64_t start = timing::now()" << stmtSeparator;
+	programFile << indent << "TRACE_TIMESTAMP(taskTraceStart)" << stmtSeparator;
+	taskGenerator->beginMappingProfile(programFile);
 
 	// copy partition parameters into an array to later make them accessible for thread-state management
 	taskGenerator->copyPartitionParameters(programFile); 
@@ -349,6 +377,12 @@ void generateTaskExecutor(TaskGenerator *taskGenerator) {
                 programFile << indent << "setupReductionPrimitives(logFile)" << stmtSeparator;
 	}
 
+	// similarly initialize the combiners if the task has some scans
+	if (taskGenerator->hasScans()) {
+                programFile << std::endl << indent << "// initializing scan combiners\n";
+                programFile << indent << "setupScanCombiners(logFile)" << stmtSeparator;
+	}
+
 	// get the list of external environment-links then invoke the task initializer function
 	List<EnvironmentLink*> *envLinks = taskDef->getEnvironmentLinks();
 	List<const char*> *externalEnvLinks = new List<const char*>;
@@ -361,6 +395,9 @@ void generateTaskExecutor(TaskGenerator *taskGenerator) {
 	}
 	taskGenerator->inovokeTaskInitializer(programFile, externalEnvLinks, true);
 
+	// compute the split points of data dependent partitions before the partition configurations are generated
+	taskGenerator->prepareDataDependentSplits(programFile);
+
 	// generate thread-state objects for the intended number of threads and initialize their root LPUs
         taskGenerator->initiateThreadStates(programFile);
 
@@ -376,14 +413,18 @@ void generateTaskExecutor(TaskGenerator *taskGenerator) {
         taskGenerator->performSegmentGrouping(programFile, true);
         taskGenerator->initializeSegmentMemory(programFile);
 
+	// all co-located segments have opened the node shared allocations of the task by now; so their names can go
+	if (hasNodeSharedReplicas()) {
+		programFile << std::endl << indent << "// removing the names of node shared allocations\n";
+		programFile << indent << "NodeSharedMemory::unlinkCreatedObjects()" << stmtSeparator;
+	}
+
 	// log time spent on memory allocation
 	programFile << std::endl;
 	programFile << indent << "// calculating memory and threads preparation time\n";
-	programFile << indent << "struct timeval end" << stmtSeparator;
-	programFile << indent << "gettimeofday(&end, NULL)" << stmtSeparator;
-        programFile << indent << "double allocationTime = ((end.tv_sec + end.tv_usec / 1000000.0)";
-        programFile << std::endl << indent << indent << indent;
-        programFile << "- (start.tv_sec + start.tv_usec / 1000000.0))" << stmtSeparator;
+	programFile << indent << "int64_t end = timing::now()" << stmtSeparator;
+        programFile << indent << "double allocationTime = timing::elapsedSeconds(start" << paramSeparator;
+        programFile << "end)" << stmtSeparator;
         programFile << indent << "logFile << \"Memory preparation time: \" << allocationTime";
 	programFile << " << \" Seconds\" << std::endl" << stmtSeparator;
 	programFile << indent << "double timeConsumedSoFar = allocationTime" << stmtSeparator;
@@ -395,30 +436,51 @@ void generateTaskExecutor(TaskGenerator *taskGenerator) {
 		// log time spent on communicator setup
 		programFile << std::endl;
 		programFile << indent << "// calculating communicators setup time\n";
-		programFile << indent << "gettimeofday(&end, NULL)" << stmtSeparator;
-        	programFile << indent << "double communicatorTime = ((end.tv_sec + end.tv_usec / 1000000.0)";
-        	programFile << std::endl << indent << indent << indent;
-        	programFile << "- (start.tv_sec + start.tv_usec / 1000000.0)) - timeConsumedSoFar" << stmtSeparator;
+		programFile << indent << "end = timing::now()" << stmtSeparator;
+        	programFile << indent << "double communicatorTime = timing::elapsedSeconds(start" << paramSeparator;
+        	programFile << "end) - timeConsumedSoFar" << stmtSeparator;
         	programFile << indent << "logFile << \"Communicators setup time: \" << communicatorTime";
 		programFile << " << \" Seconds\" << std::endl" << stmtSeparator;
 		programFile << indent << "timeConsumedSoFar += communicatorTime" << stmtSeparator;
 		programFile << indent << "logFile.flush()" << stmtSeparator << std::endl;
 	}
 
+	// a task invocation covered by the checkpoint a restarted program resumes from is not executed again; only 
+	// its environment processing is redone
+	programFile << indent << "if (CheckpointManager::isReplaying(environment->getTaskId())) {\n";
+	programFile << doubleIndent << "logFile << \"\\tskipping execution as restored from checkpoint\\n\"";
+	programFile << stmtSeparator;
+	programFile << doubleIndent << "environment->executeTaskCompletionInstructions()" << stmtSeparator;
+	programFile << doubleIndent << "CheckpointManager::completeInvocation(environment" << paramSeparator;
+	programFile << "logFile)" << stmtSeparator;
+	if (taskGenerator->hasReductions()) {
+		programFile << doubleIndent << "releaseReductionPrimitives()" << stmtSeparator;
+	}
+	if (taskGenerator->hasScans()) {
+		programFile << doubleIndent << "releaseScanCombiners()" << stmtSeparator;
+	}
+	programFile << doubleIndent << "delete taskData" << stmtSeparator;
+	programFile << doubleIndent << "return" << stmtSeparator;
+	programFile << indent << "}\n";
+
 	// start threads and wait for them to finish execution of the task 
         taskGenerator->startThreads(programFile);
 
 	// log time spent on task's computation
 	programFile << std::endl;
 	programFile << indent << "// calculating computation time\n";
-	programFile << indent << "gettimeofday(&end, NULL)" << stmtSeparator;
-        programFile << indent << "double computationTime = ((end.tv_sec + end.tv_usec / 1000000.0)";
-        programFile << std::endl << indent << indent << indent;
-        programFile << "- (start.tv_sec + start.tv_usec / 1000000.0)) - timeConsumedSoFar" << stmtSeparator;
+	programFile << indent << "end = timing::now()" << stmtSeparator;
+        programFile << indent << "double computationTime = timing::elapsedSeconds(start" << paramSeparator;
+        programFile << "end) - timeConsumedSoFar" << stmtSeparator;
 	programFile << indent << "logFile << \"Computation time: \" << computationTime";
 	programFile << " << \" Seconds\" << std::endl" << stmtSeparator;
 	programFile << indent << "timeConsumedSoFar += computationTime" << stmtSeparator;
-	programFile << indent << "logFile.flush()" << stmtSeparator << std::endl;
+	programFile << indent << "logFile.flush()" << stmtSeparator;
+	programFile << indent << "TRACE_RECORD(trace::TASK_EXECUTION" << paramSeparator;
+	programFile << "\"" << taskGenerator->getTaskName() << "\"" << paramSeparator;
+	programFile << "-1" << paramSeparator << "taskTraceStart)" << stmtSeparator;
+	taskGenerator->endMappingProfile(programFile, communicatorsGenerated);
+	programFile << std::endl;
 	
 	// communicator setup time should be included in the actual computation time as for a hand-written code those 
 	// overheads should be insignifant -- the same is not true for file I/0, which should be proportionally costly;
@@ -447,6 +509,14 @@ void generateTaskExecutor(TaskGenerator *taskGenerator) {
 	programFile << indent << "copyBackNonArrayEnvVariables(environment" << paramSeparator;
 	programFile << "&taskGlobals)" << stmtSeparator;
 	programFile << indent << "environment->executeTaskCompletionInstructions()" << stmtSeparator;
+	programFile << indent << "CheckpointManager::completeInvocation(environment" << paramSeparator;
+	programFile << "logFile)" << stmtSeparator;
+	if (taskGenerator->hasReductions()) {
+		programFile << indent << "releaseReductionPrimitives()" << stmtSeparator;
+	}
+	if (taskGenerator->hasScans()) {
+		programFile << indent << "releaseScanCombiners()" << stmtSeparator;
+	}
 	programFile << indent << "delete taskData" << stmtSeparator;
 	
 	// close function definition
@@ -488,12 +558,23 @@ void generateMain(ProgramDef *programDef, const char *programFile) {
 	// retrieve the segment id for the current process
         stream << std::endl << indent << "// retreiving segmentation identifier\n";
 	stream << indent << "int segmentId = 0" << stmtSeparator;
-        stream << indent << "MPI_Comm_rank(MPI_COMM_WORLD, &segmentId)" << stmtSeparator << std::endl;
+        stream << indent << "MPI_Comm_rank(MPI_COMM_WORLD, &segmentId)" << stmtSeparator;
+	// initialize the tracer; this has any effect only when the program is compiled with tracing enabled
+	stream << indent << "TRACE_INITIALIZE(segmentId)" << stmtSeparator;
+	// similarly, initialize the profiler that measures the costs of LPSes for the mapping advisor
+	stream << indent << "PROFILE_INITIALIZE(segmentId)" << stmtSeparator;
+	// and the hardware performance counter measurements of stages and communications
+	stream << indent << "COUNTERS_INITIALIZE(segmentId)" << stmtSeparator << std::endl;
+
+	// segments sharing the memory of replicated arrays need to agree on the names of the shared allocations
+	if (hasNodeSharedReplicas()) {
+		stream << indent << "// agreeing on the names of node shared allocations\n";
+		stream << indent << "NodeSharedMemory::initialize()" << stmtSeparator << std::endl;
+	}
 
 	// start execution time monitoring timer
         stream << indent << "// starting execution timer clock\n";
-        stream << indent << "struct timeval start" << stmtSeparator;
-        stream << indent << "gettimeofday(&start, NULL)" << stmtSeparator;
+        stream << indent << "int64_t start = timing::now()" << stmtSeparator;
 
 	// create a log file for overall program log printing
         stream << std::endl << indent << "// creating a program log file\n";
@@ -509,6 +590,22 @@ void generateMain(ProgramDef *programDef, const char *programFile) {
 	stream << indent << argName << " = readProgramArgs(argc" << paramSeparator;
 	stream << "argv)" << stmtSeparator; 
 
+	// set up checkpointing of the program environment and determine the checkpoint to resume from if this is a
+	// restart; checkpointing is disabled unless a checkpoint interval is set in the deployment properties
+	int checkpointInterval = 0;
+	const char *checkpointDirectory = "checkpoints";
+	Properties *deploymentProps = PropertyReader::propertiesGroups->Lookup("deployment");
+	if (deploymentProps != NULL) {
+		const char *intervalSetting = deploymentProps->getProperty("checkpoint.interval");
+		if (intervalSetting != NULL) checkpointInterval = atoi(intervalSetting);
+		const char *directorySetting = deploymentProps->getProperty("checkpoint.directory");
+		if (directorySetting != NULL) checkpointDirectory = directorySetting;
+	}
+	stream << std::endl << indent << "// setting up checkpointing\n";
+	stream << indent << "CheckpointManager::configure(segmentId" << paramSeparator;
+	stream << checkpointInterval << paramSeparator << "\"" << checkpointDirectory << "\")" << stmtSeparator;
+	stream << indent << "CheckpointManager::prepareRestart(logFile)" << stmtSeparator;
+
 	// declare all local variables found in scope
 	stream << std::endl << indent << "// declaring local variables\n";
 	std::ostringstream declStream;
@@ -523,13 +620,13 @@ void generateMain(ProgramDef *programDef, const char *programFile) {
 	coordDef->generateCode(codeStream, programDef->getScope());
 	stream << codeStream.str() << std::endl;
 
+	// wait for the background writing of output files to finish
+	stream << indent << "AsyncPartWriteQueue::flush()" << stmtSeparator << std::endl;
+
 	// calculate running time
         stream << indent << "// calculating task running time\n";
-        stream << indent << "struct timeval end" << stmtSeparator;
-        stream << indent << "gettimeofday(&end, NULL)" << stmtSeparator;
-        stream << indent << "double runningTime = ((end.tv_sec + end.tv_usec / 1000000.0)";
-        stream << std::endl << indent << indent << indent;
-        stream << "- (start.tv_sec + start.tv_usec / 1000000.0))" << stmtSeparator;
+        stream << indent << "double runningTime = timing::elapsedSeconds(start" << paramSeparator;
+        stream << "timing::now())" << stmtSeparator;
         stream << indent << "logFile << \"Execution Time: \" << runningTime << \" Seconds\" << std::endl";
         stream << stmtSeparator;
 	stream << indent << "logFile.flush()" << stmtSeparator << std::endl;
@@ -539,6 +636,12 @@ void generateMain(ProgramDef *programDef, const char *programFile) {
         // display the running time on console
         stream << indent << "std::cout << \"Parallel Execution Time: \" << runningTime <<";
         stream << " \" Seconds\" << std::endl" << stmtSeparator;
+	// merge the timelines of all segments into a single trace file if tracing is enabled
+	stream << indent << "TRACE_EXPORT_TIMELINE(\"timeline.json\")" << stmtSeparator;
+	// write the costs of the LPSes of all tasks in a profile file if mapping profiling is enabled
+	stream << indent << "PROFILE_EXPORT(\"mapping-profile.txt\")" << stmtSeparator;
+	// write the hardware counter report of each segment if counter measurement is enabled
+	stream << indent << "COUNTERS_EXPORT(\"hw_counters\")" << stmtSeparator;
 	// release MPI resources
 	stream << indent << "MPI_Finalize()" << stmtSeparator;
 	// then exit the function
@@ -322,6 +322,85 @@ void generateComputeNextLpuRoutine(std::ofstream &programFile, MappingNode *mapp
 	programFile << std::endl << functionHeader.str() << " " << functionBody.str();
 }
 
+void generateLpuCopyRoutines(std::ofstream &programFile, MappingNode *mappingRoot) {
+
+	std::cout << "\tGenerating LPU copy and restore functions" << std::endl;
+
+	const char *header = "LPU Copy and Restore Functions";
+	decorator::writeSubsectionHeader(programFile, header);
+
+	std::ostringstream cloneFnBody;
+	cloneFnBody << "{\n";
+	std::ostringstream restoreFnBody;
+	restoreFnBody << "{\n";
+
+	// as in the compute-next-LPU function, the root LPS is skipped as its LPU never changes
+	std::deque<MappingNode*> nodeQueue;
+        for (int i = 0; i < mappingRoot->children->NumElements(); i++) {
+       		nodeQueue.push_back(mappingRoot->children->Nth(i));
+        }
+        while (!nodeQueue.empty()) {
+                MappingNode *node = nodeQueue.front();
+                nodeQueue.pop_front();
+                for (int i = 0; i < node->children->NumElements(); i++) {
+                        nodeQueue.push_back(node->children->Nth(i));
+                }
+		Space *lps = node->mappingConfig->LPS;
+		const char *lpsName = lps->getName();
+		
+		// an LPU object has only plain data fields; so the copy constructor is sufficient to copy it
+		cloneFnBody << indent << "if (lpsId == Space_" << lpsName << ") {\n";
+		cloneFnBody << doubleIndent << "Space" << lpsName << "_LPU *currentLpu";
+		cloneFnBody << " = (Space" << lpsName << "_LPU*) ";
+		cloneFnBody << "lpsStates[Space_" << lpsName << "]->lpu" << stmtSeparator;
+		cloneFnBody << doubleIndent << "return new Space" << lpsName << "_LPU(*currentLpu)" << stmtSeparator;
+		cloneFnBody << indent << "}\n";
+
+		restoreFnBody << indent << "if (lpsId == Space_" << lpsName << ") {\n";
+		restoreFnBody << doubleIndent << "Space" << lpsName << "_LPU *currentLpu";
+		restoreFnBody << " = (Space" << lpsName << "_LPU*) ";
+		restoreFnBody << "lpsStates[Space_" << lpsName << "]->lpu" << stmtSeparator;
+		restoreFnBody << doubleIndent << "*currentLpu = *((Space" << lpsName << "_LPU*) snapshot)";
+		restoreFnBody << stmtSeparator;
+
+		// data references of the copy may point to stale epoch versions; so they should be refreshed from the 
+		// data parts or, for a subpartition LPU, from the parent LPU that has been restored already
+		List<const char*> *localArrays = lps->getLocallyUsedArrayNames();
+		for (int i = 0; i < localArrays->NumElements(); i++) {
+			ArrayDataStructure *array = (ArrayDataStructure*) lps->getLocalStructure(localArrays->Nth(i));
+			const char *varName = array->getName();
+			ArrayType *arrayType = (ArrayType*) array->getType();
+			const char *elemType = arrayType->getTerminalElementType()->getCType();
+			if (array->getSpace() != lps && lps->isSubpartitionSpace()) {
+				const char *parentLpsName = array->getSpace()->getName();
+				restoreFnBody << doubleIndent << "currentLpu->" << varName << " = ((Space";
+				restoreFnBody << parentLpsName << "_LPU*) lpsStates[Space_" << parentLpsName;
+				restoreFnBody << "]->lpu)->" << varName << stmtSeparator;
+			} else if (lpuHoldsEpochVersionedPart(lps, array)) {
+				restoreFnBody << doubleIndent << "currentLpu->" << varName << " = (" << elemType << "*) ";
+				restoreFnBody << "currentLpu->" << varName << "DataPart->getData()" << stmtSeparator;
+				int versionCount = array->getLocalVersionCount();
+				for (int j = 1; j <= versionCount; j++) {
+					restoreFnBody << doubleIndent << "currentLpu->" << varName << "_lag_" << j;
+					restoreFnBody << " = (" << elemType << "*) ";
+					restoreFnBody << "currentLpu->" << varName << "DataPart->getData(" << j << ")";
+					restoreFnBody << stmtSeparator;
+				}
+			}
+		}
+		restoreFnBody << doubleIndent << "return" << stmtSeparator;
+		restoreFnBody << indent << "}\n";
+	}
+
+	cloneFnBody << indent << "return NULL" << stmtSeparator;
+	cloneFnBody << "}\n";
+	restoreFnBody << "}\n";
+
+	programFile << std::endl << "LPU *ThreadStateImpl::cloneLpu(int lpsId) " << cloneFnBody.str();
+	programFile << std::endl << "void ThreadStateImpl::restoreLpu(int lpsId, LPU *snapshot) ";
+	programFile << restoreFnBody.str();
+}
+
 void generateReductionResultMapCreateFn(std::ofstream &programFile, 
 		MappingNode *mappingRoot,  
 		List<ReductionMetadata*> *reductionInfos) {
@@ -403,6 +482,8 @@ void generateThreadStateImpl(const char *headerFileName,
 	generateComputeLpuCountRoutine(programFile, mappingRoot, countFunctionsArgsConfig);
 	// then call the compute-Next-LPU function generator method for class specific implementation
 	generateComputeNextLpuRoutine(programFile, mappingRoot);
+	// generate the functions for copying and restoring LPUs to replay recorded LPU traversals
+	generateLpuCopyRoutines(programFile, mappingRoot);
 	// generate the function to initialize of a map of reduction result variables
 	generateReductionResultMapCreateFn(programFile, mappingRoot, reductionInfos);	
 	//-------------------------------------------------------------------------------------------------------
@@ -41,6 +41,10 @@ void generateComputeLpuCountRoutine(std::ofstream &programFile, MappingNode *map
 /* function definition to generate task specific implementation of compute-next-LPU routine */
 void generateComputeNextLpuRoutine(std::ofstream &programFile, MappingNode *mappingRoot);
 
+/* function definition to generate task specific implementations of the routines for copying LPUs and restoring
+   them from copies that are needed to replay recorded LPU traversals */
+void generateLpuCopyRoutines(std::ofstream &programFile, MappingNode *mappingRoot);
+
 /* function definition to generate a task specific implementation of the initializer of the map 
    of reduction result variables that keeps track of a PPU's partial result for individual reductions	
 */
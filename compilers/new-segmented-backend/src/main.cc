@@ -10,6 +10,8 @@
 #include "codegen/utils/code_generator.h"
 #include "codegen/utils/task_invocation.h"
 #include "codegen/utils/fn_generator.h"
+#include "codegen/utils/blas_kernels.h"
+#include "codegen/utils/mapping_advisor.h"
 
 #include "../../common-libs/utils/list.h"
 #include "../../common-libs/utils/properties.h"
@@ -119,6 +121,10 @@ int main(int argc, const char *argv[]) {
 	//********************************************************************* Back End Compiler
 	// parse PCubeS description of the multicore hardware
         List<PPS_Definition*> *pcubesConfig = parsePCubeSDescription(pcubesFile);
+	// determine if linear algebra loops should be replaced with BLAS routine calls in the generated code
+	BlasKernelGenerator::configure();
+	// determine if LPS to PPS mappings should be evaluated against the profile of a calibration run
+	MappingAdvisor::configure(outputDir);
 	// iterate over list of tasks and generate code for each of them in separate files
 	List<Definition*> *taskDefs = ProgramDef::program->getComponentsByType(TASK_DEF);
         for (int i = 0; i < taskDefs->NumElements(); i++) {
@@ -0,0 +1,349 @@
+#include "hw_counters.h"
+#include "timing.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+using namespace hwcounters;
+
+// IDs assigned to threads that never register themselves start from here to keep them apart from PPU thread numbers
+static const int Unnamed_Thread_Id_Base = 1000;
+
+const char *hwcounters::getCategoryName(RegionCategory category) {
+	switch (category) {
+		case STAGE_EXECUTION: return "stage";
+		case BUFFER_READ: return "buffer-read";
+		case COMMUNICATION: return "communication";
+		case BUFFER_WRITE: return "buffer-write";
+	}
+	return "unknown";
+}
+
+const char *hwcounters::getCounterName(CounterType type) {
+	switch (type) {
+		case CYCLES: return "cycles";
+		case INSTRUCTIONS: return "instructions";
+		case LLC_MISSES: return "llc-misses";
+		case STALLED_CYCLES: return "stalled-cycles";
+	}
+	return "unknown";
+}
+
+//----------------------------------------------------------- Counter Record ------------------------------------------------------------/
+
+CounterRecord::CounterRecord(RegionCategory category, const char *name, const char *lpsName) {
+	this->category = category;
+	this->name = name;
+	this->lpsName = lpsName;
+	this->invocations = 0;
+	this->sampledInvocations = 0;
+	this->nanoseconds = 0;
+	for (int i = 0; i < Counter_Types; i++) counts[i] = 0;
+}
+
+void CounterRecord::add(CounterRecord *other) {
+	invocations += other->invocations;
+	sampledInvocations += other->sampledInvocations;
+	nanoseconds += other->nanoseconds;
+	for (int i = 0; i < Counter_Types; i++) counts[i] += other->counts[i];
+}
+
+void CounterRecord::describe(std::ostream &stream, bool countersAvailable) {
+
+	stream << "invocations " << invocations;
+	if (sampledInvocations == 0) {
+		stream << " not-sampled\n";
+		return;
+	}
+
+	// extrapolate the sampled measurements to all invocations
+	double scale = ((double) invocations) / sampledInvocations;
+	stream << " seconds " << (nanoseconds * scale / 1000000000.0);
+	if (!countersAvailable) {
+		stream << "\n";
+		return;
+	}
+	double estimates[Counter_Types];
+	for (int i = 0; i < Counter_Types; i++) {
+		estimates[i] = counts[i] * scale;
+		stream << ' ' << getCounterName((CounterType) i) << ' ' << (uint64_t) estimates[i];
+	}
+
+	// instructions per cycle, cache misses per thousand instructions, and the fraction of cycles the backend stalled
+	if (estimates[CYCLES] > 0) {
+		stream << " ipc " << estimates[INSTRUCTIONS] / estimates[CYCLES];
+		stream << " stall-ratio " << estimates[STALLED_CYCLES] / estimates[CYCLES];
+	}
+	if (estimates[INSTRUCTIONS] > 0) {
+		stream << " llc-mpki " << estimates[LLC_MISSES] * 1000 / estimates[INSTRUCTIONS];
+	}
+	stream << "\n";
+}
+
+//----------------------------------------------------------- Thread Counters -----------------------------------------------------------/
+
+ThreadCounters::ThreadCounters(int threadId) {
+	this->threadId = threadId;
+	this->groupFd = -1;
+	this->memberCount = 0;
+	for (int i = 0; i < Counter_Types; i++) memberFds[i] = -1;
+	this->lastRecord = 0;
+}
+
+ThreadCounters::~ThreadCounters() {
+	closeEvents();
+	for (unsigned int i = 0; i < records.size(); i++) delete records[i];
+}
+
+static int openEvent(int eventType, int groupFd) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	switch (eventType) {
+		case CYCLES: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+		case INSTRUCTIONS: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+		case LLC_MISSES: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+		case STALLED_CYCLES: attr.config = PERF_COUNT_HW_STALLED_CYCLES_BACKEND; break;
+	}
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	// counting only in user mode keeps the events available under the default kernel paranoia level
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+void ThreadCounters::openEvents() {
+	if (groupFd != -1) return;
+
+	// the cycles counter leads the group; the group is useless without it
+	groupFd = openEvent(CYCLES, -1);
+	if (groupFd == -1) return;
+	memberFds[0] = groupFd;
+	memberTypes[0] = CYCLES;
+	memberCount = 1;
+
+	// other events are optional; an event the processor does not support just stays zero in the measurements
+	for (int type = INSTRUCTIONS; type < Counter_Types; type++) {
+		int fd = openEvent(type, groupFd);
+		if (fd == -1) continue;
+		memberFds[memberCount] = fd;
+		memberTypes[memberCount] = type;
+		memberCount++;
+	}
+}
+
+void ThreadCounters::closeEvents() {
+	for (int i = memberCount - 1; i >= 0; i--) {
+		close(memberFds[i]);
+		memberFds[i] = -1;
+	}
+	memberCount = 0;
+	groupFd = -1;
+}
+
+CounterRecord *ThreadCounters::getRecord(RegionCategory category, const char *name, const char *lpsName) {
+	int recordCount = records.size();
+	for (int i = 0; i < recordCount; i++) {
+		int index = (lastRecord + i) % recordCount;
+		if (records[index]->matches(category, name, lpsName)) {
+			lastRecord = index;
+			return records[index];
+		}
+	}
+	CounterRecord *record = new CounterRecord(category, name, lpsName);
+	records.push_back(record);
+	lastRecord = recordCount;
+	return record;
+}
+
+void ThreadCounters::readSnapshot(CounterSnapshot *snapshot) {
+	for (int i = 0; i < Counter_Types; i++) snapshot->counts[i] = 0;
+	snapshot->timeEnabled = 0;
+	snapshot->timeRunning = 0;
+	if (groupFd != -1) {
+		// a group read returns the number of events, the enabled and running times, then the event values
+		uint64_t values[3 + Counter_Types];
+		ssize_t expected = (3 + memberCount) * sizeof(uint64_t);
+		if (read(groupFd, values, expected) == expected) {
+			snapshot->timeEnabled = values[1];
+			snapshot->timeRunning = values[2];
+			for (int i = 0; i < memberCount; i++) {
+				snapshot->counts[memberTypes[i]] = values[3 + i];
+			}
+		}
+	}
+	snapshot->time = timing::now();
+}
+
+//---------------------------------------------------------- Hardware Counters ----------------------------------------------------------/
+
+int HardwareCounters::segmentId = 0;
+int HardwareCounters::samplingInterval = 1;
+bool HardwareCounters::countersAvailable = false;
+pthread_mutex_t HardwareCounters::registryLock = PTHREAD_MUTEX_INITIALIZER;
+std::vector<ThreadCounters*> HardwareCounters::registry;
+int HardwareCounters::nextUnnamedThreadId = Unnamed_Thread_Id_Base;
+__thread ThreadCounters *HardwareCounters::threadCounters = NULL;
+
+void HardwareCounters::initialize(int segmentId, int samplingInterval) {
+	HardwareCounters::segmentId = segmentId;
+	HardwareCounters::samplingInterval = (samplingInterval > 0) ? samplingInterval : 1;
+}
+
+void HardwareCounters::registerThread(int threadNo) {
+	if (threadCounters == NULL) {
+		createThreadCounters(threadNo);
+	} else {
+		threadCounters->setThreadId(threadNo);
+	}
+}
+
+void HardwareCounters::unregisterThread() {
+	if (threadCounters == NULL) return;
+	threadCounters->closeEvents();
+	threadCounters = NULL;
+}
+
+void HardwareCounters::begin(CounterProbe *probe, RegionCategory category, const char *name, const char *lpsName) {
+	if (threadCounters == NULL) createThreadCounters(-1);
+	CounterRecord *record = threadCounters->getRecord(category, name, lpsName);
+	probe->record = record;
+	probe->sampled = (record->invocations % samplingInterval == 0);
+	record->invocations++;
+	if (probe->sampled) threadCounters->readSnapshot(&probe->start);
+}
+
+void HardwareCounters::end(CounterProbe *probe) {
+	if (!probe->sampled) return;
+	CounterSnapshot end;
+	threadCounters->readSnapshot(&end);
+
+	// scale the counts up for the part of the interval the group did not get to count when it has been multiplexed
+	double scale = 1.0;
+	uint64_t enabled = end.timeEnabled - probe->start.timeEnabled;
+	uint64_t running = end.timeRunning - probe->start.timeRunning;
+	if (running > 0 && running < enabled) scale = ((double) enabled) / running;
+
+	CounterRecord *record = probe->record;
+	record->sampledInvocations++;
+	record->nanoseconds += end.time - probe->start.time;
+	for (int i = 0; i < Counter_Types; i++) {
+		record->counts[i] += (uint64_t) ((end.counts[i] - probe->start.counts[i]) * scale);
+	}
+}
+
+ThreadCounters *HardwareCounters::createThreadCounters(int threadId) {
+	pthread_mutex_lock(&registryLock);
+	threadCounters = NULL;
+	if (threadId < 0) {
+		threadId = nextUnnamedThreadId++;
+	} else {
+		// PPU controller threads are recreated for each task; the records of the thread with the same number from
+		// an earlier task are reused as that thread must have finished already
+		for (unsigned int i = 0; i < registry.size(); i++) {
+			if (registry[i]->getThreadId() == threadId) {
+				threadCounters = registry[i];
+				break;
+			}
+		}
+	}
+	if (threadCounters == NULL) {
+		threadCounters = new ThreadCounters(threadId);
+		registry.push_back(threadCounters);
+	}
+	threadCounters->openEvents();
+	if (threadCounters->isCounting()) countersAvailable = true;
+	pthread_mutex_unlock(&registryLock);
+	return threadCounters;
+}
+
+void HardwareCounters::describeTotals(std::ostream &stream, const char *heading, std::vector<CounterRecord*> &totals) {
+	if (totals.empty()) return;
+	stream << heading << ":\n";
+	for (unsigned int i = 0; i < totals.size(); i++) {
+		CounterRecord *record = totals[i];
+		stream << '\t';
+		if (record->category == STAGE_EXECUTION) {
+			if (record->name != NULL) stream << "stage \"" << record->name << "\" ";
+			stream << "lps " << record->lpsName << ": ";
+		} else {
+			stream << getCategoryName(record->category) << " \"" << record->name << "\": ";
+		}
+		record->describe(stream, countersAvailable);
+		delete record;
+	}
+	totals.clear();
+}
+
+// adds the argument record to the matching total in the list, comparing names by content as the same name may come
+// from different places of the program; the name of the total is cleared if it should be ignored
+static void addToTotals(std::vector<CounterRecord*> &totals, CounterRecord *record, bool ignoreName) {
+	const char *name = ignoreName ? NULL : record->name;
+	for (unsigned int i = 0; i < totals.size(); i++) {
+		CounterRecord *total = totals[i];
+		if (total->category != record->category) continue;
+		if (name != NULL && strcmp(total->name, name) != 0) continue;
+		if (strcmp(total->lpsName, record->lpsName) != 0) continue;
+		total->add(record);
+		return;
+	}
+	CounterRecord *total = new CounterRecord(record->category, name, record->lpsName);
+	total->add(record);
+	totals.push_back(total);
+}
+
+void HardwareCounters::exportReport(const char *fileNamePrefix) {
+
+	std::ostringstream fileName;
+	fileName << fileNamePrefix << "_" << segmentId << ".log";
+	std::ofstream report;
+	report.open(fileName.str().c_str(), std::ofstream::out);
+	if (!report.is_open()) {
+		std::cout << "Segment " << segmentId << ": could not open the hardware counter report file\n";
+		return;
+	}
+
+	report << "Hardware counters of segment " << segmentId;
+	report << " (one in " << samplingInterval << " executions measured";
+	if (!countersAvailable) report << "; performance events are unavailable, only times are reported";
+	report << ")\n";
+
+	std::vector<CounterRecord*> stageTotals;
+	std::vector<CounterRecord*> lpsTotals;
+	std::vector<CounterRecord*> dependencyTotals;
+
+	pthread_mutex_lock(&registryLock);
+	for (unsigned int i = 0; i < registry.size(); i++) {
+		ThreadCounters *counters = registry[i];
+		std::vector<CounterRecord*> &records = counters->getRecords();
+		report << "Thread " << counters->getThreadId() << ":\n";
+		for (unsigned int j = 0; j < records.size(); j++) {
+			CounterRecord *record = records[j];
+			report << '\t' << getCategoryName(record->category) << " \"" << record->name << "\"";
+			if (record->category == STAGE_EXECUTION) report << " lps " << record->lpsName;
+			report << ": ";
+			record->describe(report, countersAvailable);
+			if (record->category == STAGE_EXECUTION) {
+				addToTotals(stageTotals, record, false);
+				addToTotals(lpsTotals, record, true);
+			} else {
+				addToTotals(dependencyTotals, record, false);
+			}
+		}
+	}
+	pthread_mutex_unlock(&registryLock);
+
+	describeTotals(report, "Per stage", stageTotals);
+	describeTotals(report, "Per LPS", lpsTotals);
+	describeTotals(report, "Per communication dependency", dependencyTotals);
+	report.close();
+}
@@ -0,0 +1,184 @@
+#ifndef _H_hw_counters
+#define _H_hw_counters
+
+/* This header provides the instrumentation for measuring the compute stages and the communication phases of a program
+   with the hardware performance counters of the processor. The wall clock totals of the communication statistics and
+   the mapping profile tell how long an activity took, but not why. The counters tell that: a stage that retires few
+   instructions per cycle and misses the last level cache often is memory-bound, while a communication phase that runs
+   many cycles but retires few instructions spends its time polling on synchronization.
+
+   Each thread opens a group of Linux perf events counting CPU cycles, retired instructions, last level cache misses,
+   and backend stalled cycles of the thread itself, in user mode only. Measurements are accumulated per thread in
+   records identified by the activity and the LPS it runs in; so recording needs no locking. At the end of the program
+   each segment writes a report with the per thread records, and the totals per stage, per LPS, and per communication
+   dependency, next to the log files of the threads. If the events cannot be opened, e.g., because the kernel forbids
+   unprivileged access, only the wall clock time of the activities is reported.
+
+   Reading the counters takes a system call at the beginning and at the end of each measured activity. For programs
+   that run short stages many times, a sampling interval can be set with the HARDWARE_COUNTER_SAMPLING compile time
+   macro; then only one in that many executions of each activity is measured and the report extrapolates the totals.
+
+   Measurement is switched on or off at compile time. Unless the generated program is compiled with the HARDWARE_COUNTERS
+   macro defined (for example, by adding -DHARDWARE_COUNTERS to the 'c.optimization.flags' deployment property), all the
+   instrumentation macros defined at the end of this header expand to nothing.
+*/
+
+#include <pthread.h>
+#include <stdint.h>
+#include <ostream>
+#include <vector>
+
+namespace hwcounters {
+
+	// categories of measured activities
+	enum RegionCategory {	STAGE_EXECUTION,
+				BUFFER_READ,
+				COMMUNICATION,
+				BUFFER_WRITE };
+
+	const char *getCategoryName(RegionCategory category);
+
+	// the counted events; not all processors support all of them
+	enum CounterType { CYCLES, INSTRUCTIONS, LLC_MISSES, STALLED_CYCLES };
+	const int Counter_Types = 4;
+	const char *getCounterName(CounterType type);
+
+	/* The accumulated measurements of an activity. The name of the activity and of its LPS are not copied; so they
+	   should be string literals or strings that live till the end of the program such as dependency names. */
+	class CounterRecord {
+	  public:
+		RegionCategory category;
+		const char *name;
+		const char *lpsName;
+		int64_t invocations;
+		int64_t sampledInvocations;
+		int64_t nanoseconds;
+		uint64_t counts[Counter_Types];
+
+		CounterRecord(RegionCategory category, const char *name, const char *lpsName);
+		bool matches(RegionCategory category, const char *name, const char *lpsName) {
+			return this->category == category && this->name == name && this->lpsName == lpsName;
+		}
+		void add(CounterRecord *other);
+		// writes the measurements extrapolated to all invocations and the metrics derived from them
+		void describe(std::ostream &stream, bool countersAvailable);
+	};
+
+	// a reading of the counters of a thread along with a timestamp
+	class CounterSnapshot {
+	  public:
+		int64_t time;
+		uint64_t counts[Counter_Types];
+		// the time the counter group was enabled and actually counting; they differ when the kernel multiplexes
+		// counters among event groups, and then counts should be scaled
+		uint64_t timeEnabled;
+		uint64_t timeRunning;
+	};
+
+	// the state of an activity being measured between its beginning and its end
+	class CounterProbe {
+	  public:
+		CounterRecord *record;
+		bool sampled;
+		CounterSnapshot start;
+	};
+
+	/* The counter group and the measurement records of a single thread. Only the owner thread uses the group and
+	   updates the records. */
+	class ThreadCounters {
+	  private:
+		int threadId;
+		// file descriptor of the group leader event, or -1 if the events could not be opened
+		int groupFd;
+		int memberFds[Counter_Types];
+		// the counter types in the order the kernel returns their values in a group read
+		int memberTypes[Counter_Types];
+		int memberCount;
+		std::vector<CounterRecord*> records;
+		// index of the record found by the last lookup; consecutive lookups often hit the same record
+		int lastRecord;
+	  public:
+		ThreadCounters(int threadId);
+		~ThreadCounters();
+		int getThreadId() { return threadId; }
+		void setThreadId(int threadId) { this->threadId = threadId; }
+		bool isCounting() { return groupFd != -1; }
+
+		// the events count only for the thread that opened them; so they must be opened by the owner thread
+		void openEvents();
+		void closeEvents();
+
+		CounterRecord *getRecord(RegionCategory category, const char *name, const char *lpsName);
+		void readSnapshot(CounterSnapshot *snapshot);
+		std::vector<CounterRecord*> &getRecords() { return records; }
+	};
+
+	/* The static class that manages the counters of all threads of a segment and writes the report. */
+	class HardwareCounters {
+	  private:
+		static int segmentId;
+		static int samplingInterval;
+		static bool countersAvailable;
+		static pthread_mutex_t registryLock;
+		static std::vector<ThreadCounters*> registry;
+		static int nextUnnamedThreadId;
+		static __thread ThreadCounters *threadCounters;
+	  public:
+		static void initialize(int segmentId, int samplingInterval);
+
+		// PPU controller threads should call this function when they start to record their measurements under their
+		// thread numbers and the next function before they finish to release their counters. Threads that never
+		// register get their counters on their first measurement and are reported under IDs that do not conflict
+		// with thread numbers.
+		static void registerThread(int threadNo);
+		static void unregisterThread();
+
+		static void begin(CounterProbe *probe, RegionCategory category, const char *name, const char *lpsName);
+		static void end(CounterProbe *probe);
+
+		// writes the report of the segment in a file named with the argument prefix and the segment ID; this should
+		// be called after all PPU controller threads have finished
+		static void exportReport(const char *fileNamePrefix);
+	  private:
+		static ThreadCounters *createThreadCounters(int threadId);
+		static void describeTotals(std::ostream &stream, const char *heading, std::vector<CounterRecord*> &totals);
+	};
+
+	// a utility class to measure an entire code block
+	class CounterScope {
+	  private:
+		CounterProbe probe;
+	  public:
+		CounterScope(RegionCategory category, const char *name, const char *lpsName) {
+			HardwareCounters::begin(&probe, category, name, lpsName);
+		}
+		~CounterScope() { HardwareCounters::end(&probe); }
+	};
+}
+
+// one in this many executions of each activity is measured
+#ifndef HARDWARE_COUNTER_SAMPLING
+#define HARDWARE_COUNTER_SAMPLING 1
+#endif
+
+// Macros to be used for instrumentation. Each COUNTERS_SCOPE should be in its own code block as it declares a variable.
+#ifdef HARDWARE_COUNTERS
+#define COUNTERS_INITIALIZE(segmentId) hwcounters::HardwareCounters::initialize(segmentId, HARDWARE_COUNTER_SAMPLING)
+#define COUNTERS_REGISTER_THREAD(threadNo) hwcounters::HardwareCounters::registerThread(threadNo)
+#define COUNTERS_UNREGISTER_THREAD() hwcounters::HardwareCounters::unregisterThread()
+#define COUNTERS_SCOPE(category, name, lpsName) hwcounters::CounterScope counterScope(category, name, lpsName)
+#define COUNTERS_BEGIN_STAGE(probeVariable, stageName, lpsName) hwcounters::CounterProbe probeVariable; \
+		hwcounters::HardwareCounters::begin(&probeVariable, hwcounters::STAGE_EXECUTION, stageName, lpsName)
+#define COUNTERS_END_STAGE(probeVariable) hwcounters::HardwareCounters::end(&probeVariable)
+#define COUNTERS_EXPORT(fileNamePrefix) hwcounters::HardwareCounters::exportReport(fileNamePrefix)
+#else
+#define COUNTERS_INITIALIZE(segmentId)
+#define COUNTERS_REGISTER_THREAD(threadNo)
+#define COUNTERS_UNREGISTER_THREAD()
+#define COUNTERS_SCOPE(category, name, lpsName)
+#define COUNTERS_BEGIN_STAGE(probeVariable, stageName, lpsName)
+#define COUNTERS_END_STAGE(probeVariable)
+#define COUNTERS_EXPORT(fileNamePrefix)
+#endif
+
+#endif
@@ -4,6 +4,9 @@
 #include <sstream>
 #include <pthread.h>
 #include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include "lpu_management.h"
 #include "../memory-management/allocation.h"
@@ -196,8 +199,23 @@ LPU *LpsState::getCurrentLpu(bool allowInvalid) {
 }
 
 
+/*************************************************  LPU Schedule  ***************************************************/
+
+int LpuSchedule::clear() {
+	int lpuCount = entries.size();
+	for (int i = 0; i < lpuCount; i++) {
+		delete entries[i].snapshot;
+	}
+	entries.clear();
+	stepEnds.clear();
+	return lpuCount;
+}
+
 /************************************************  Thread State  ****************************************************/
 
+// the maximum number of LPUs a thread keeps in its LPU schedule cache
+static const int Lpu_Schedule_Cache_Limit = 1 << 16;
+
 ThreadState::ThreadState(int lpsCount, int *lpsDimensions, int *partitionArgs, ThreadIds *threadIds) {
 	this->lpsCount = lpsCount;
 	lpsStates = new LpsState*[lpsCount];
@@ -212,6 +230,13 @@ ThreadState::ThreadState(int lpsCount, int *lpsDimensions, int *partitionArgs, T
 	this->partConfigMap = NULL;
 	this->partIteratorMap = NULL;
 	this->loggingEnabled = false;
+	this->scheduleCacheEnabled = false;
+	this->scheduleCache = NULL;
+	this->cachedLpuCount = 0;
+	this->activeSchedules = NULL;
+	this->replayingSchedules = NULL;
+	this->replayedSteps = NULL;
+	this->recordingSchedule = NULL;
 }
 
 PartIterator *ThreadState::getIterator(int lpsId, const char *varName) {
@@ -231,6 +256,164 @@ PartIterator *ThreadState::getIterator(int lpsId, const char *varName) {
 }
 
 LPU *ThreadState::getNextLpu(int lpsId, int containerLpsId, int currentLpuId) {
+
+	if (!scheduleCacheEnabled) return generateNextLpu(lpsId, containerLpsId, currentLpuId);
+
+	// at the beginning of a traversal, check if the same traversal has been recorded before
+	if (currentLpuId == INVALID_ID) {
+		activeSchedules[lpsId] = NULL;
+		std::string key = getScheduleKey(lpsId, containerLpsId);
+		LpuSchedule *schedule = scheduleCache->Lookup(key.c_str());
+		if (schedule == NULL) {
+			schedule = new LpuSchedule();
+			scheduleCache->Enter(strdup(key.c_str()), schedule);
+		}
+		if (schedule->complete) {
+			lpsStates[containerLpsId]->markAsIterationBound();
+			activeSchedules[lpsId] = schedule;
+			replayingSchedules[lpsId] = true;
+			replayedSteps[lpsId] = 0;
+			return replayNextLpu(lpsId, containerLpsId);
+		} else if (!schedule->discarded) {
+			// an incomplete schedule is left by an earlier traversal that did not run till the end
+			cachedLpuCount -= schedule->clear();
+			activeSchedules[lpsId] = schedule;
+			replayingSchedules[lpsId] = false;
+		}
+	}
+
+	LpuSchedule *schedule = activeSchedules[lpsId];
+	if (schedule != NULL && replayingSchedules[lpsId]) {
+		// replay continues as long as the caller advances from the LPU returned last; otherwise, the LPS 
+		// states restored for that LPU are good for resuming the traversal in the usual way
+		if (currentLpuId == lpsStates[lpsId]->lpu->id) {
+			return replayNextLpu(lpsId, containerLpsId);
+		}
+		activeSchedules[lpsId] = NULL;
+		schedule = NULL;
+	}
+
+	recordingSchedule = schedule;
+	LPU *lpu = generateNextLpu(lpsId, containerLpsId, currentLpuId);
+	recordingSchedule = NULL;
+	if (schedule != NULL) {
+		if (schedule->discarded) {
+			activeSchedules[lpsId] = NULL;
+		} else if (lpu == NULL) {
+			schedule->complete = true;
+			activeSchedules[lpsId] = NULL;
+		} else {
+			schedule->stepEnds.push_back(schedule->entries.size());
+		}
+	}
+	return lpu;
+}
+
+void ThreadState::enableLpuScheduleCache() {
+	scheduleCache = new Hashtable<LpuSchedule*>;
+	cachedLpuCount = 0;
+	activeSchedules = new LpuSchedule*[lpsCount];
+	replayingSchedules = new bool[lpsCount];
+	replayedSteps = new int[lpsCount];
+	for (int i = 0; i < lpsCount; i++) {
+		activeSchedules[i] = NULL;
+		replayingSchedules[i] = false;
+		replayedSteps[i] = 0;
+	}
+	scheduleCacheEnabled = true;
+}
+
+void ThreadState::releaseLpuScheduleCache() {
+	if (!scheduleCacheEnabled) return;
+	scheduleCacheEnabled = false;
+	Iterator<LpuSchedule*> iterator = scheduleCache->GetIterator();
+	LpuSchedule *schedule = NULL;
+	while ((schedule = iterator.GetNextValue()) != NULL) {
+		delete schedule;
+	}
+	delete scheduleCache;
+	scheduleCache = NULL;
+	cachedLpuCount = 0;
+	delete[] activeSchedules;
+	delete[] replayingSchedules;
+	delete[] replayedSteps;
+}
+
+std::string ThreadState::getScheduleKey(int lpsId, int containerLpsId) {
+	std::ostringstream key;
+	key << "Space_" << lpsId << "_Container_" << containerLpsId;
+	// the LPUs of the container LPS and its ancestors determine the LPUs of the traversal
+	int currentLpsId = containerLpsId;
+	while (lpsParentIndexMap[currentLpsId] != INVALID_ID) {
+		key << '_' << lpsStates[currentLpsId]->getCounter()->getCurrentLpuId();
+		currentLpsId = lpsParentIndexMap[currentLpsId];
+	}
+	return key.str();
+}
+
+void ThreadState::recordLpu(int lpsId) {
+	LpuSchedule *schedule = recordingSchedule;
+	if (schedule->discarded) return;
+	LPU *snapshot = NULL;
+	if (cachedLpuCount >= Lpu_Schedule_Cache_Limit || (snapshot = cloneLpu(lpsId)) == NULL) {
+		discardSchedule(schedule);
+		return;
+	}
+	LpuCounter *counter = lpsStates[lpsId]->getCounter();
+	ScheduledLpu entry;
+	entry.lpsId = lpsId;
+	entry.linearLpuId = counter->getCurrentLpuId();
+	int *lpuCounts = counter->getLpuCounts();
+	if (lpuCounts != NULL) {
+		entry.lpuCounts.assign(lpuCounts, lpuCounts + counter->getLpsDimensions());
+	}
+	entry.snapshot = snapshot;
+	schedule->entries.push_back(entry);
+	cachedLpuCount++;
+}
+
+void ThreadState::discardSchedule(LpuSchedule *schedule) {
+	cachedLpuCount -= schedule->clear();
+	schedule->discarded = true;
+}
+
+LPU *ThreadState::replayNextLpu(int lpsId, int containerLpsId) {
+	
+	LpuSchedule *schedule = activeSchedules[lpsId];
+	int step = replayedSteps[lpsId];
+	
+	// at the end of the schedule, reset the states of the LPSes from the current LPS up to the container LPS
+	// just like the recursive procedure does when it exhausts the LPUs
+	if (step == (int) schedule->stepEnds.size()) {
+		int currentLpsId = lpsId;
+		while (currentLpsId != containerLpsId && currentLpsId != INVALID_ID) {
+			LpsState *state = lpsStates[currentLpsId];
+			state->getCounter()->resetCounter();
+			state->invalidateCurrentLpu();
+			currentLpsId = lpsParentIndexMap[currentLpsId];
+		}
+		activeSchedules[lpsId] = NULL;
+		return NULL;
+	}
+
+	// otherwise, restore the counters and LPUs of all LPSes that were updated to reach the next LPU
+	int firstEntry = (step == 0) ? 0 : schedule->stepEnds[step - 1];
+	int lastEntry = schedule->stepEnds[step];
+	for (int i = firstEntry; i < lastEntry; i++) {
+		ScheduledLpu &entry = schedule->entries[i];
+		LpuCounter *counter = lpsStates[entry.lpsId]->getCounter();
+		if (!entry.lpuCounts.empty()) {
+			counter->setLpuCounts(&entry.lpuCounts[0]);
+			counter->setCurrentRange(threadIds->ppuIds[entry.lpsId]);
+		}
+		counter->setCurrentCompositeLpuId(entry.linearLpuId);
+		restoreLpu(entry.lpsId, entry.snapshot);
+	}
+	replayedSteps[lpsId] = step + 1;
+	return lpsStates[lpsId]->lpu;
+}
+
+LPU *ThreadState::generateNextLpu(int lpsId, int containerLpsId, int currentLpuId) {
 	
 	// this is not the first call to get next LPU when current Id is valid
 	if (currentLpuId != INVALID_ID) {
@@ -255,6 +438,7 @@ LPU *ThreadState::getNextLpu(int lpsId, int containerLpsId, int currentLpuId) {
 		
 			// set the LPU Id so that recursion can advance to the next LPU in next call 
 			lpu->setId(nextLpuId);	
+			if (recordingSchedule != NULL) recordLpu(lpsId);
 			return lpu;
 
 		// otherwise there is a possible need for recursively going up in the LPS hierarchy and 
@@ -280,7 +464,7 @@ LPU *ThreadState::getNextLpu(int lpsId, int containerLpsId, int currentLpuId) {
 
 					// recursively call the same routine in the parent LPS to update the 
 					// parent LPU if possible
-					LPU *parentLpu = getNextLpu(parentLpsId, containerLpsId, parentLpuId);
+					LPU *parentLpu = generateNextLpu(parentLpsId, containerLpsId, parentLpuId);
 				
 					// If parent LPU is NULL then it means all parent LPUs have been executed 
 					// too. So there is nothing more to do in current LPS either 
@@ -321,6 +505,7 @@ LPU *ThreadState::getNextLpu(int lpsId, int containerLpsId, int currentLpuId) {
 	
 				// set the LPU Id so that recursion can advance to the next LPU in next call 
 				lpu->setId(nextLpuId);	
+				if (recordingSchedule != NULL) recordLpu(lpsId);
 				return lpu;	
 			}
 		}
@@ -336,7 +521,7 @@ LPU *ThreadState::getNextLpu(int lpsId, int containerLpsId, int currentLpuId) {
 	LpsState *parentState = lpsStates[parentLpsId];
 	// if they are not the same then do a recursive get-Next_LPU call on the parent to initiate parent's counter
 	if (containerLpsId != parentLpsId && parentLpsId != INVALID_ID) {
-		LPU *parentLpu = getNextLpu(parentLpsId, containerLpsId, INVALID_ID);
+		LPU *parentLpu = generateNextLpu(parentLpsId, containerLpsId, INVALID_ID);
 		if (parentLpu == NULL) return NULL;
 	}
 
@@ -369,7 +554,7 @@ LPU *ThreadState::getNextLpu(int lpsId, int containerLpsId, int currentLpuId) {
 
 		// recursively call the same routine in the parent LPS to update the 
 		// parent LPU if possible
-		LPU *parentLpu = getNextLpu(parentLpsId, containerLpsId, parentLpuId);
+		LPU *parentLpu = generateNextLpu(parentLpsId, containerLpsId, parentLpuId);
 	
 		// If parent LPU is NULL then it means all parent LPUs have been executed 
 		// too. So there is nothing more to do in current LPS either 
@@ -408,6 +593,7 @@ LPU *ThreadState::getNextLpu(int lpsId, int containerLpsId, int currentLpuId) {
 	
 	// set the LPU Id so that recursion can advance to the next LPU in next call 
 	lpu->setId(nextLpuId);	
+	if (recordingSchedule != NULL) recordLpu(lpsId);
 	return lpu;
 }
 
@@ -12,6 +12,8 @@
 #include "../../../../common-libs/domain-obj/structure.h"
 
 #include <fstream>
+#include <vector>
+#include <string>
 
 /* Remember that there is a partial ordering of logical processing spaces (LPS). Thereby, the number of
    LPUs for a child LPS at a particular point of computation depends on the size of the data structure
@@ -59,6 +61,7 @@ class LpuCounter {
 	virtual int *copyCompositeLpuId();
 	virtual int *setCurrentCompositeLpuId(int linearId);
 	int getCurrentLpuId() { return currentLinearLpuId; }
+	int getLpsDimensions() { return lpsDimensions; }
 	virtual int getNextLpuId(int previousLpuId);
 	virtual void resetCounter();
 	virtual void logLpuRange(std::ofstream &log, int indent);
@@ -115,6 +118,43 @@ class LpsState {
 	LpuCounter *getCounter() { return counter; }
 };
 
+/* Within a task, the sequence of LPUs the get-Next-LPU routine returns for a traversal of an LPS depends only on
+   the LPUs of the LPSes above the container LPS of the traversal. So when the same traversal is repeated, e.g.,
+   within a repeat loop, the LPU counts, part Ids, and data parts of its LPUs are the same as before. Instead of 
+   running the recursive procedure again, a thread can record the LPUs it generates during the first traversal and
+   replay them in subsequent traversals. The only thing that changes between two traversals is the current epoch
+   version of epoch dependent data parts; so data references of replayed LPUs are refreshed from their parts.
+*/
+
+/* state of an LPS right after an LPU has been generated for it during a recorded traversal */
+class ScheduledLpu {
+  public:
+	int lpsId;
+	int linearLpuId;
+	// LPU counts of the LPS counter; this is empty for unpartitioned LPSes
+	std::vector<int> lpuCounts;
+	// a copy of the generated LPU
+	LPU *snapshot;
+};
+
+/* the recorded sequence of LPU generations of a traversal */
+class LpuSchedule {
+  public:
+	// LPUs generated for the traversed LPS and the LPSes between it and the container LPS in generation order
+	std::vector<ScheduledLpu> entries;
+	// for each LPU the traversal returned, the index of the entry next to the last entry generated to reach it
+	std::vector<int> stepEnds;
+	// a schedule can only be replayed after the traversal it records has run till the end 
+	bool complete;
+	// a schedule that grew too large is discarded, but retained in the cache to prevent recording it again
+	bool discarded;
+  public:
+	LpuSchedule() { complete = false; discarded = false; }
+	~LpuSchedule() { clear(); }
+	// deletes the recorded LPUs and returns their count
+	int clear();
+};
+
 /* This class represents the complete state of a thread for a particular task.  Task specific functions for 
    computing LPU counts and next LPU are plugged into the execution logic by the generated sub-class that 
    implements designated virtual functions. 
@@ -145,6 +185,18 @@ class ThreadState {
 	// a map property to keep track of the partial results of ongoing reductions computed by the composite
 	// PPU controller thread holding the current Thread-State variable.
 	Hashtable<reduction::Result*> *localReductionResultMap;
+	// recorded LPU traversals of the thread; traversals are recorded and replayed only if the cache is enabled
+	bool scheduleCacheEnabled;
+	Hashtable<LpuSchedule*> *scheduleCache;
+	// total number of LPUs held in the schedule cache
+	int cachedLpuCount;
+	// the schedule being recorded or replayed for the ongoing traversal of each LPS, if there is any, and the 
+	// number of LPUs already replayed from it
+	LpuSchedule **activeSchedules;
+	bool *replayingSchedules;
+	int *replayedSteps;
+	// the schedule LPUs generated by the ongoing get-Next-LPU call should be recorded in
+	LpuSchedule *recordingSchedule;
   public:
 	ThreadState(int lpsCount, int *lpsDimensions, int *partitionArgs, ThreadIds *threadIds);
 
@@ -172,6 +224,12 @@ class ThreadState {
 	virtual int *computeLpuCounts(int lpsId) = 0;
 	virtual LPU *computeNextLpu(int lpsId) = 0;
 	virtual void initializeReductionResultMap() = 0;
+	
+	// Task specific functions needed for replaying recorded LPU traversals: the first returns a copy of the 
+	// current LPU of an LPS and the second makes an earlier copy the current LPU again. The LPU schedule cache
+	// remains inactive if the first function returns NULL.
+	virtual LPU *cloneLpu(int lpsId) { return NULL; }
+	virtual void restoreLpu(int lpsId, LPU *snapshot) {}
 
 	// The get-Next-Lpu management routine is at the heart of recursive LPU management for threads by
 	// the runtime library. It takes as input the ID of the LPS on which the thread is attempting to
@@ -183,6 +241,11 @@ class ThreadState {
 	// LPUs after LPUs. It returns NULL when the recursive process has no more LPUs to return.	
 	LPU *getNextLpu(int lpsId, int containerLpsId, int currentLpuId);
 
+	// LPU traversals are recorded and replayed only between these two calls; a thread should enable the cache
+	// after it starts executing the task as LPU generation in the task setup phase is done without task data
+	void enableLpuScheduleCache();
+	void releaseLpuScheduleCache();
+
 	// The following routine is added to aid memory management in segmented memory system. The idea here 
 	// is to get the Ids of all LPUs that are multiplexed to a thread before it begin executions. A 
 	// segmented-PPU controller then accumulates all these Ids and passes them as a part of initialization 
@@ -229,6 +292,14 @@ class ThreadState {
 	void enableLogging() { loggingEnabled = true; }
 	void initiateLogFile(const char *fileNamePrefix);
 	void logIteratorStatistics();
+  protected:
+	// the recursive procedure behind get-Next-LPU that computes LPUs afresh
+	LPU *generateNextLpu(int lpsId, int containerLpsId, int currentLpuId);
+	// functions for recording and replaying LPU traversals
+	std::string getScheduleKey(int lpsId, int containerLpsId);
+	void recordLpu(int lpsId);
+	void discardSchedule(LpuSchedule *schedule);
+	LPU *replayNextLpu(int lpsId, int containerLpsId);
 };
 
 /* This is the class to hold the PPU execution controllers (here threads) that shares a single memory segment */
@@ -0,0 +1,216 @@
+#include "mapping_profile.h"
+#include "timing.h"
+#include "../communication/comm_statistics.h"
+#include "../../../../common-libs/utils/list.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <string.h>
+#include <time.h>
+#include <mpi.h>
+
+// rows of per-thread measurements are padded to a multiple of this many entries to put them in separate cache lines
+static const int Row_Padding = 16;
+
+//----------------------------------------------------------- Task Cost Profile ---------------------------------------------------------/
+
+TaskCostProfile::TaskCostProfile(const char *taskName, int lpsCount, int threadCount) {
+	this->taskName = taskName;
+	this->lpsCount = lpsCount;
+	this->threadCount = 0;
+	this->executions = 0;
+	this->lpsNames = new const char*[lpsCount];
+	this->ppsIds = new int[lpsCount];
+	for (int i = 0; i < lpsCount; i++) {
+		lpsNames[i] = NULL;
+		ppsIds[i] = 0;
+	}
+	this->rowLength = ((lpsCount + Row_Padding - 1) / Row_Padding) * Row_Padding;
+	this->computeTimes = NULL;
+	this->maxLpuIds = NULL;
+	this->argumentNames = new List<const char*>;
+	this->argumentValues = new List<int>;
+	this->dependencyNames = new List<const char*>;
+	this->communicationTimes = new List<double>;
+	prepareForExecution(threadCount);
+}
+
+void TaskCostProfile::prepareForExecution(int threadCount) {
+	if (threadCount <= this->threadCount) return;
+
+	int64_t *newComputeTimes = new int64_t[threadCount * rowLength];
+	int *newMaxLpuIds = new int[threadCount * rowLength];
+	for (int i = 0; i < threadCount * rowLength; i++) {
+		newComputeTimes[i] = 0;
+		newMaxLpuIds[i] = -1;
+	}
+	for (int i = 0; i < this->threadCount * rowLength; i++) {
+		newComputeTimes[i] = computeTimes[i];
+		newMaxLpuIds[i] = maxLpuIds[i];
+	}
+	delete[] computeTimes;
+	delete[] maxLpuIds;
+	computeTimes = newComputeTimes;
+	maxLpuIds = newMaxLpuIds;
+	this->threadCount = threadCount;
+}
+
+void TaskCostProfile::describeLps(int lpsId, const char *lpsName, int ppsId) {
+	lpsNames[lpsId] = lpsName;
+	ppsIds[lpsId] = ppsId;
+}
+
+void TaskCostProfile::recordArgument(const char *argName, int value) {
+	for (int i = 0; i < argumentNames->NumElements(); i++) {
+		if (strcmp(argumentNames->Nth(i), argName) == 0) {
+			argumentValues->RemoveAt(i);
+			argumentValues->InsertAt(value, i);
+			return;
+		}
+	}
+	argumentNames->Append(argName);
+	argumentValues->Append(value);
+}
+
+void TaskCostProfile::recordCommunication(CommStatistics *commStat) {
+
+	// a new statistics object is created for each invocation of a task; so the times of individual invocations are
+	// added together here
+	List<const char*> *commDependencies = commStat->getDependencyNames();
+	for (int i = 0; i < commDependencies->NumElements(); i++) {
+		const char *dependency = commDependencies->Nth(i);
+		double time = commStat->getCommunicationTime(dependency);
+		bool found = false;
+		for (int j = 0; j < dependencyNames->NumElements(); j++) {
+			if (strcmp(dependencyNames->Nth(j), dependency) == 0) {
+				double accumulated = communicationTimes->Nth(j) + time;
+				communicationTimes->RemoveAt(j);
+				communicationTimes->InsertAt(accumulated, j);
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			dependencyNames->Append(dependency);
+			communicationTimes->Append(time);
+		}
+	}
+}
+
+void TaskCostProfile::serialize(std::ostream &stream, int segmentId) {
+
+	stream << "task \"" << taskName << "\" segment " << segmentId;
+	stream << " threads " << threadCount << " executions " << executions << "\n";
+	for (int i = 0; i < argumentNames->NumElements(); i++) {
+		stream << "argument " << argumentNames->Nth(i) << " " << argumentValues->Nth(i) << "\n";
+	}
+	for (int lpsId = 0; lpsId < lpsCount; lpsId++) {
+		if (lpsNames[lpsId] == NULL) continue;
+		int64_t computeSum = 0;
+		int64_t computeMax = 0;
+		int maxLpuId = -1;
+		for (int thread = 0; thread < threadCount; thread++) {
+			int64_t threadTime = computeTimes[thread * rowLength + lpsId];
+			computeSum += threadTime;
+			if (threadTime > computeMax) computeMax = threadTime;
+			int threadMaxLpuId = maxLpuIds[thread * rowLength + lpsId];
+			if (threadMaxLpuId > maxLpuId) maxLpuId = threadMaxLpuId;
+		}
+		stream << "lps " << lpsNames[lpsId] << " pps " << ppsIds[lpsId];
+		stream << " lpus " << maxLpuId + 1;
+		stream << " compute-sum " << computeSum / 1000000000.0;
+		stream << " compute-max " << computeMax / 1000000000.0 << "\n";
+	}
+	for (int i = 0; i < dependencyNames->NumElements(); i++) {
+		stream << "dependency " << dependencyNames->Nth(i);
+		stream << " communication " << communicationTimes->Nth(i) << "\n";
+	}
+	stream << "end\n";
+}
+
+//----------------------------------------------------------- Mapping Profiler ----------------------------------------------------------/
+
+int MappingProfiler::segmentId = 0;
+List<TaskCostProfile*> *MappingProfiler::taskProfiles = NULL;
+TaskCostProfile *MappingProfiler::currentTask = NULL;
+
+void MappingProfiler::initialize(int segmentId) {
+	MappingProfiler::segmentId = segmentId;
+	taskProfiles = new List<TaskCostProfile*>;
+}
+
+void MappingProfiler::beginTask(const char *taskName, int lpsCount, int threadCount) {
+	for (int i = 0; i < taskProfiles->NumElements(); i++) {
+		TaskCostProfile *profile = taskProfiles->Nth(i);
+		if (strcmp(profile->getTaskName(), taskName) == 0) {
+			profile->prepareForExecution(threadCount);
+			currentTask = profile;
+			return;
+		}
+	}
+	currentTask = new TaskCostProfile(taskName, lpsCount, threadCount);
+	taskProfiles->Append(currentTask);
+}
+
+int64_t MappingProfiler::now() {
+	return timing::now();
+}
+
+void MappingProfiler::endTask(CommStatistics *commStat) {
+	if (commStat != NULL) {
+		currentTask->recordCommunication(commStat);
+	}
+	currentTask->completeExecution();
+	currentTask = NULL;
+}
+
+void MappingProfiler::exportProfile(const char *fileName) {
+
+	int segmentCount;
+	MPI_Comm_size(MPI_COMM_WORLD, &segmentCount);
+
+	std::ostringstream stream;
+	for (int i = 0; i < taskProfiles->NumElements(); i++) {
+		taskProfiles->Nth(i)->serialize(stream, segmentId);
+	}
+	std::string content = stream.str();
+	int length = content.length();
+
+	// gather the sizes of the serialized profiles of the segments first then the profiles themselves in segment 0
+	int *lengths = NULL;
+	int *displacements = NULL;
+	char *gathered = NULL;
+	if (segmentId == 0) {
+		lengths = new int[segmentCount];
+	}
+	MPI_Gather(&length, 1, MPI_INT, lengths, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	if (segmentId == 0) {
+		displacements = new int[segmentCount];
+		int totalLength = 0;
+		for (int i = 0; i < segmentCount; i++) {
+			displacements[i] = totalLength;
+			totalLength += lengths[i];
+		}
+		gathered = new char[totalLength + 1];
+	}
+	MPI_Gatherv((void*) content.c_str(), length, MPI_CHAR,
+			gathered, lengths, displacements, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+	if (segmentId == 0) {
+		std::ofstream profileFile;
+		profileFile.open(fileName, std::ofstream::out);
+		if (!profileFile.is_open()) {
+			std::cout << "could not open the mapping profile file: " << fileName << "\n";
+		} else {
+			for (int i = 0; i < segmentCount; i++) {
+				profileFile.write(gathered + displacements[i], lengths[i]);
+			}
+			profileFile.close();
+		}
+		delete[] lengths;
+		delete[] displacements;
+		delete[] gathered;
+	}
+}
@@ -0,0 +1,129 @@
+#ifndef _H_mapping_profile
+#define _H_mapping_profile
+
+/* This header provides the facility for a calibration run of an IT program to measure how much time its tasks spend
+   in the compute stages of individual LPSes and in individual communication dependencies. A mapping configuration
+   and the values of the partition parameters are otherwise chosen by trial and error over whole runs. With a profile
+   of a short run at hand, the mapping advisor of the compiler can evaluate alternative LPS to PPS mappings against
+   the PCubeS description of the hardware and recommend a mapping and partition parameters for the next compilation.
+
+   Profiling is switched on or off at compile time. Unless the generated program is compiled with the MAPPING_PROFILING
+   macro defined (for example, by adding -DMAPPING_PROFILING to the 'c.optimization.flags' deployment property), all
+   the profiling macros defined at the end of this header expand to nothing.
+
+   The profile is written in segment 0 at the end of the program as a plain text file that has a section for each
+   task of each segment in the following format.
+
+   	task "<task name>" segment <segment id> threads <PPU thread count> executions <number of task invocations>
+	argument <partition parameter name> <value in the last invocation>
+	lps <LPS name> pps <PPS id> lpus <LPUs per parent LPU> compute-sum <seconds> compute-max <seconds>
+	dependency <dependency name> communication <seconds>
+	end
+
+   The compute-sum of an LPS is the total time all PPU threads of the segment spent executing its compute stages; the
+   compute-max is the same for the busiest thread. The ratio between the two reveals the load imbalance of the LPS.
+*/
+
+#include <stdint.h>
+#include <fstream>
+
+#include "../../../../common-libs/utils/list.h"
+
+class CommStatistics;
+
+/* This class holds the measurements of a single task of the program, accumulated over all its invocations */
+class TaskCostProfile {
+  private:
+	const char *taskName;
+	int lpsCount;
+	int threadCount;
+	int executions;
+	const char **lpsNames;
+	int *ppsIds;
+	// The per-thread measurements are kept in separate rows so that threads can record their stage executions
+	// without any locking. Rows are padded to separate cache lines to avoid false sharing among threads.
+	int rowLength;
+	int64_t *computeTimes;
+	int *maxLpuIds;
+	// partition parameters and communication dependency names and times
+	List<const char*> *argumentNames;
+	List<int> *argumentValues;
+	List<const char*> *dependencyNames;
+	List<double> *communicationTimes;
+  public:
+	TaskCostProfile(const char *taskName, int lpsCount, int threadCount);
+	const char *getTaskName() { return taskName; }
+
+	// The LPS and thread counts of a task do not change, but the number of threads may grow if the same task is
+	// invoked later with more segments participating; so the per-thread rows are reallocated on such occasions.
+	void prepareForExecution(int threadCount);
+
+	void describeLps(int lpsId, const char *lpsName, int ppsId);
+	inline void recordStage(int threadNo, int lpsId, int lpuId, int64_t duration) {
+		computeTimes[threadNo * rowLength + lpsId] += duration;
+		int *maxLpuId = &maxLpuIds[threadNo * rowLength + lpsId];
+		if (lpuId > *maxLpuId) *maxLpuId = lpuId;
+	}
+	void recordArgument(const char *argName, int value);
+	void recordCommunication(CommStatistics *commStat);
+	void completeExecution() { executions++; }
+	void serialize(std::ostream &stream, int segmentId);
+};
+
+/* The static class that manages the cost profiles of all tasks of a segment and exports the program's profile */
+class MappingProfiler {
+  private:
+	static int segmentId;
+	static List<TaskCostProfile*> *taskProfiles;
+	// only one task executes at a time; this is the profile of the task that is currently executing
+	static TaskCostProfile *currentTask;
+  public:
+	static void initialize(int segmentId);
+
+	// This should be called by the task executor before it starts the PPU threads of the task.
+	static void beginTask(const char *taskName, int lpsCount, int threadCount);
+	static void describeLps(int lpsId, const char *lpsName, int ppsId) {
+		currentTask->describeLps(lpsId, lpsName, ppsId);
+	}
+
+	// returns the current time in nanoseconds
+	static int64_t now();
+	static inline void recordStage(int threadNo, int lpsId, int lpuId, int64_t start) {
+		currentTask->recordStage(threadNo, lpsId, lpuId, now() - start);
+	}
+
+	// This should be called by the task executor after the PPU threads have finished. The communication statistics
+	// argument may be NULL for tasks without communicators.
+	static void recordArgument(const char *argName, int value) {
+		currentTask->recordArgument(argName, value);
+	}
+	static void endTask(CommStatistics *commStat);
+
+	// This collective operation gathers the profiles of all segments in segment 0 that then writes them in the
+	// argument file. It should be called at the end of the program.
+	static void exportProfile(const char *fileName);
+};
+
+// Macros to be used for instrumentation.
+#ifdef MAPPING_PROFILING
+#define PROFILE_INITIALIZE(segmentId) MappingProfiler::initialize(segmentId)
+#define PROFILE_BEGIN_TASK(taskName, lpsCount, threadCount) MappingProfiler::beginTask(taskName, lpsCount, threadCount)
+#define PROFILE_DESCRIBE_LPS(lpsId, lpsName, ppsId) MappingProfiler::describeLps(lpsId, lpsName, ppsId)
+#define PROFILE_TIMESTAMP(variable) int64_t variable = MappingProfiler::now()
+#define PROFILE_RECORD_STAGE(threadNo, lpsId, lpuId, startVariable) \
+		MappingProfiler::recordStage(threadNo, lpsId, lpuId, startVariable)
+#define PROFILE_RECORD_ARGUMENT(argName, value) MappingProfiler::recordArgument(argName, value)
+#define PROFILE_END_TASK(commStat) MappingProfiler::endTask(commStat)
+#define PROFILE_EXPORT(fileName) MappingProfiler::exportProfile(fileName)
+#else
+#define PROFILE_INITIALIZE(segmentId)
+#define PROFILE_BEGIN_TASK(taskName, lpsCount, threadCount)
+#define PROFILE_DESCRIBE_LPS(lpsId, lpsName, ppsId)
+#define PROFILE_TIMESTAMP(variable)
+#define PROFILE_RECORD_STAGE(threadNo, lpsId, lpuId, startVariable)
+#define PROFILE_RECORD_ARGUMENT(argName, value)
+#define PROFILE_END_TASK(commStat)
+#define PROFILE_EXPORT(fileName)
+#endif
+
+#endif
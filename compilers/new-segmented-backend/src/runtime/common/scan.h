@@ -0,0 +1,264 @@
+#ifndef _H_scan
+#define _H_scan
+
+/* This header provides the runtime routines behind the scan, exclusive_scan, and histogram library functions of IT.
+   The routines operate on the contiguous memory of the data parts held by a single LPU; so the generated code passes
+   them pointers to the beginning of the LPU's parts and the lengths of those parts. Each routine returns the aggregate
+   of the part it processed.
+
+   A scan over a partitioned array is only complete when each part's results include the totals of all parts that
+   precede it in the array. So the scan routines register the parts they processed with a combiner that is shared by
+   the PPU controllers of a segment. After all LPUs of the top-level LPS enclosing the scan have been processed, the
+   controllers invoke the combiner that exchanges the part totals with other segments and adds to each local part
+   the total of the parts preceding it.
+*/
+
+#include "sync.h"
+#include "../communication/mpi_group.h"
+
+#include <mpi.h>
+#include <pthread.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+namespace prefixscan {
+
+	// the offsets of all parts of an array scanned during the iteration of the LPUs of an LPS are determined at once
+	// by this class after the iteration is over; an instance is shared by all PPU controllers of a segment
+	template <class Type> class ScanCombiner {
+	  protected:
+		// an output part is identified by the index of the first element of the corresponding input part
+		class ScanPart {
+		  public:
+			Type *output;
+			int length;
+			int rangeMin;
+			Type total;
+			Type offset;
+			static bool precedes(const ScanPart &part1, const ScanPart &part2) {
+				return part1.rangeMin < part2.rangeMin;
+			}
+		};
+
+		// number of PPU controllers that invoke the combine function
+		int participants;
+		// the group of segments executing the task; this is NULL if there is just one segment
+		SegmentGroup *segmentGroup;
+
+		std::vector<ScanPart> parts;
+		pthread_mutex_t partsLock;
+
+		// the last PPU controller to arrive computes the offsets and the controllers then add them to the parts
+		// in parallel
+		int arrivals;
+		int nextPart;
+		Barrier *offsetsReady;
+		Barrier *offsetsApplied;
+	  public:
+		ScanCombiner(int participants, SegmentGroup *segmentGroup) {
+			this->participants = participants;
+			this->segmentGroup = segmentGroup;
+			pthread_mutex_init(&partsLock, NULL);
+			arrivals = 0;
+			nextPart = 0;
+			offsetsReady = new Barrier(participants);
+			offsetsApplied = new Barrier(participants);
+		}
+		~ScanCombiner() {
+			pthread_mutex_destroy(&partsLock);
+			delete offsetsReady;
+			delete offsetsApplied;
+		}
+
+		// registers a part that has been scanned locally along with its total
+		void addPart(Type *output, int length, int rangeMin, Type total) {
+			ScanPart part;
+			part.output = output;
+			part.length = length;
+			part.rangeMin = rangeMin;
+			part.total = total;
+			part.offset = 0;
+			pthread_mutex_lock(&partsLock);
+			parts.push_back(part);
+			pthread_mutex_unlock(&partsLock);
+		}
+
+		// adds to each registered part the totals of all parts preceding it in the array; this must be invoked by
+		// all PPU controllers of the segment as it has barrier semantics
+		void combine() {
+			if (__sync_add_and_fetch(&arrivals, 1) == participants) {
+				arrivals = 0;
+				computeOffsets();
+			}
+			offsetsReady->wait();
+
+			int partCount = parts.size();
+			int partIndex;
+			while ((partIndex = __sync_fetch_and_add(&nextPart, 1)) < partCount) {
+				ScanPart &part = parts[partIndex];
+				if (part.offset == 0) continue;
+				Type *output = part.output;
+				for (int i = 0; i < part.length; i++) {
+					output[i] += part.offset;
+				}
+			}
+
+			if (__sync_add_and_fetch(&arrivals, 1) == participants) {
+				arrivals = 0;
+				nextPart = 0;
+				parts.clear();
+			}
+			offsetsApplied->wait();
+		}
+	  protected:
+		void computeOffsets() {
+
+			// the same output part may be registered more than once if the scan is repeated within an LPU; only
+			// the last registration is valid then
+			std::stable_sort(parts.begin(), parts.end(), ScanPart::precedes);
+			std::vector<ScanPart> uniqueParts;
+			for (unsigned int i = 0; i < parts.size(); i++) {
+				bool replaced = false;
+				for (int j = uniqueParts.size() - 1; j >= 0; j--) {
+					if (uniqueParts[j].rangeMin != parts[i].rangeMin) break;
+					if (uniqueParts[j].output == parts[i].output) {
+						uniqueParts[j] = parts[i];
+						replaced = true;
+						break;
+					}
+				}
+				if (!replaced) uniqueParts.push_back(parts[i]);
+			}
+			parts = uniqueParts;
+
+			// replicated parts have the same range; so only one total is contributed per range
+			std::vector<int> localKeys;
+			std::vector<Type> localTotals;
+			for (unsigned int i = 0; i < parts.size(); i++) {
+				if (localKeys.size() > 0 && localKeys.back() == parts[i].rangeMin) continue;
+				localKeys.push_back(parts[i].rangeMin);
+				localTotals.push_back(parts[i].total);
+			}
+
+			// the parts of different segments can interleave in the array; so all totals are gathered everywhere
+			// rather than doing a prefix reduction over segment ranks
+			std::vector<int> keys = localKeys;
+			std::vector<Type> totals = localTotals;
+			if (segmentGroup != NULL && segmentGroup->getParticipantsCount() > 1) {
+				MPI_Comm communicator = segmentGroup->getCommunicator();
+				int segmentCount = segmentGroup->getParticipantsCount();
+				int localCount = localKeys.size();
+				std::vector<int> counts(segmentCount);
+				MPI_Allgather(&localCount, 1, MPI_INT, &counts[0], 1, MPI_INT, communicator);
+
+				std::vector<int> displacements(segmentCount);
+				std::vector<int> byteCounts(segmentCount);
+				std::vector<int> byteDisplacements(segmentCount);
+				int totalCount = 0;
+				for (int i = 0; i < segmentCount; i++) {
+					displacements[i] = totalCount;
+					byteCounts[i] = counts[i] * sizeof(Type);
+					byteDisplacements[i] = totalCount * sizeof(Type);
+					totalCount += counts[i];
+				}
+				keys.resize(totalCount + 1);
+				totals.resize(totalCount + 1);
+				localKeys.resize(localCount + 1);
+				localTotals.resize(localCount + 1);
+				MPI_Allgatherv(&localKeys[0], localCount, MPI_INT,
+						&keys[0], &counts[0], &displacements[0], MPI_INT, communicator);
+				MPI_Allgatherv(&localTotals[0], localCount * sizeof(Type), MPI_BYTE,
+						&totals[0], &byteCounts[0], &byteDisplacements[0], MPI_BYTE, communicator);
+				keys.resize(totalCount);
+				totals.resize(totalCount);
+			}
+
+			// sort the totals by their range, drop the replicas, and turn them into exclusive prefixes
+			std::vector<std::pair<int, Type> > ranges;
+			for (unsigned int i = 0; i < keys.size(); i++) {
+				ranges.push_back(std::make_pair(keys[i], totals[i]));
+			}
+			std::sort(ranges.begin(), ranges.end());
+			std::vector<std::pair<int, Type> > offsets;
+			Type runningTotal = 0;
+			for (unsigned int i = 0; i < ranges.size(); i++) {
+				if (offsets.size() > 0 && offsets.back().first == ranges[i].first) continue;
+				offsets.push_back(std::make_pair(ranges[i].first, runningTotal));
+				runningTotal += ranges[i].second;
+			}
+
+			// both the local parts and the offsets are sorted by range; so a single sweep assigns the offsets
+			unsigned int offsetIndex = 0;
+			for (unsigned int i = 0; i < parts.size(); i++) {
+				while (offsets[offsetIndex].first != parts[i].rangeMin) offsetIndex++;
+				parts[i].offset = offsets[offsetIndex].second;
+			}
+		}
+	};
+
+	// a part of the output array shorter than the input part would be overrun by a scan
+	inline void checkScanLengths(int outputLength, int inputLength) {
+		if (outputLength < inputLength) {
+			std::cout << "scan output part of length " << outputLength;
+			std::cout << " cannot hold the input part of length " << inputLength << "\n";
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+	// writes the running totals of the input into the output, with the i'th output including the i'th input; returns
+	// the total of all the input elements. If a combiner is provided then the part is registered with it to get the
+	// totals of the preceding parts later.
+	template <class Type> inline Type inclusiveScan(ScanCombiner<Type> *combiner,
+			Type *output, int outputLength,
+			Type *input, int inputLength, int rangeMin) {
+		checkScanLengths(outputLength, inputLength);
+		Type runningTotal = 0;
+		for (int i = 0; i < inputLength; i++) {
+			runningTotal += input[i];
+			output[i] = runningTotal;
+		}
+		if (combiner != NULL) {
+			combiner->addPart(output, inputLength, rangeMin, runningTotal);
+		}
+		return runningTotal;
+	}
+
+	// writes the running totals of the input into the output, with the i'th output excluding the i'th input; returns
+	// the total of all the input elements. The input and output may be the same array. The combiner is used the same
+	// way as in the inclusive scan.
+	template <class Type> inline Type exclusiveScan(ScanCombiner<Type> *combiner,
+			Type *output, int outputLength,
+			Type *input, int inputLength, int rangeMin) {
+		checkScanLengths(outputLength, inputLength);
+		Type runningTotal = 0;
+		for (int i = 0; i < inputLength; i++) {
+			Type current = input[i];
+			output[i] = runningTotal;
+			runningTotal += current;
+		}
+		if (combiner != NULL) {
+			combiner->addPart(output, inputLength, rangeMin, runningTotal);
+		}
+		return runningTotal;
+	}
+
+	// increments the count of each key found in the range covered by the counts array, the first entry of the counts
+	// being the count of the key 'countsMin'; keys outside the range are ignored. The counts are not reset, so that
+	// multiple parts can be accumulated into the same counts. Returns the number of keys that have been counted.
+	inline int histogram(int *counts, int countsMin, int countsLength, int *keys, int keysLength) {
+		int counted = 0;
+		for (int i = 0; i < keysLength; i++) {
+			// an unsigned comparison tests both bounds of the range at once
+			unsigned int bucket = (unsigned int) (keys[i] - countsMin);
+			if (bucket < (unsigned int) countsLength) {
+				counts[bucket]++;
+				counted++;
+			}
+		}
+		return counted;
+	}
+}
+
+#endif
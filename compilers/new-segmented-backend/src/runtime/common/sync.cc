@@ -14,6 +14,7 @@ Copyright 2015 by Andrew Grimshaw
 #include <math.h>
 
 #include "sync.h"
+#include "trace.h"
 
 
 Barrier::Barrier(int size) {
@@ -25,6 +26,7 @@ Barrier::Barrier(int size) {
 }
 
 void Barrier::wait() {
+	TRACE_SCOPE(trace::SYNC_WAIT, "Barrier Wait", -1);
 	sem_wait(&mutex);	// Make sure only one in at a  time
 	_count--;
 	if (_count==0 ) {
@@ -58,10 +60,12 @@ RS::RS(int size): b(size) {
 
 
 void RS::signal(int iteration) {
+	TRACE_SCOPE(trace::SYNC_WAIT, "RS Signal", -1);
 	b.wait();return;
 } 
 
 void RS::wait(int iteration) {
+	TRACE_SCOPE(trace::SYNC_WAIT, "RS Wait", -1);
 	b.wait();return;
 }
 
@@ -0,0 +1,152 @@
+#include "timing.h"
+
+#include <new>
+#include <cstdlib>
+#include <string.h>
+#include <time.h>
+
+using namespace timing;
+
+// the cell of the calling thread in all accumulators; unregistered threads use the shared first cell
+static __thread int threadSlot = 0;
+
+int64_t timing::now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &time);
+	return ((int64_t) time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+void timing::registerThread(int threadNo) {
+	threadSlot = 1 + threadNo % (Thread_Slots - 1);
+}
+
+int timing::getBucketIndex(int64_t duration) {
+	if (duration < Sub_Buckets) return (duration < 0) ? 0 : duration;
+	int highestBit = 63 - __builtin_clzll(duration);
+	if (highestBit >= Max_Duration_Bits) return Histogram_Buckets - 1;
+	// the two bits below the highest set bit select the sub-bucket
+	int subBucket = (duration >> (highestBit - 2)) & (Sub_Buckets - 1);
+	return (highestBit - 1) * Sub_Buckets + subBucket;
+}
+
+int64_t timing::getBucketValue(int bucketIndex) {
+	if (bucketIndex < Sub_Buckets) return bucketIndex;
+	int highestBit = bucketIndex / Sub_Buckets + 1;
+	int subBucket = bucketIndex % Sub_Buckets;
+	int64_t width = ((int64_t) 1) << (highestBit - 2);
+	int64_t lowerBound = (Sub_Buckets + subBucket) * width;
+	return lowerBound + width / 2;
+}
+
+//----------------------------------------------------------- Accumulator Cell ----------------------------------------------------------/
+
+AccumulatorCell::AccumulatorCell(bool keepHistogram) {
+	total = 0;
+	count = 0;
+	max = 0;
+	buckets = NULL;
+	if (keepHistogram) {
+		buckets = new int64_t[Histogram_Buckets];
+		memset(buckets, 0, Histogram_Buckets * sizeof(int64_t));
+	}
+}
+
+AccumulatorCell::~AccumulatorCell() {
+	if (buckets != NULL) delete[] buckets;
+}
+
+//----------------------------------------------------------- Time Accumulator ----------------------------------------------------------/
+
+TimeAccumulator::TimeAccumulator(bool keepHistogram) {
+	this->keepHistogram = keepHistogram;
+	for (int i = 0; i < Thread_Slots; i++) cells[i] = NULL;
+}
+
+TimeAccumulator::~TimeAccumulator() {
+	for (int i = 0; i < Thread_Slots; i++) {
+		if (cells[i] != NULL) {
+			cells[i]->~AccumulatorCell();
+			free(cells[i]);
+		}
+	}
+}
+
+AccumulatorCell *TimeAccumulator::getCell() {
+	AccumulatorCell *cell = cells[threadSlot];
+	if (cell != NULL) return cell;
+
+	// cells are created on first use; if another thread sharing the slot installs its cell first, that is used
+	void *memory = NULL;
+	if (posix_memalign(&memory, 64, sizeof(AccumulatorCell)) != 0) std::abort();
+	AccumulatorCell *newCell = new (memory) AccumulatorCell(keepHistogram);
+	if (__sync_bool_compare_and_swap(&cells[threadSlot], (AccumulatorCell*) NULL, newCell)) {
+		return newCell;
+	}
+	newCell->~AccumulatorCell();
+	free(memory);
+	return cells[threadSlot];
+}
+
+void TimeAccumulator::record(int64_t duration) {
+	AccumulatorCell *cell = getCell();
+	__sync_fetch_and_add(&cell->total, duration);
+	__sync_fetch_and_add(&cell->count, 1);
+	int64_t max = cell->max;
+	while (duration > max) {
+		int64_t previous = __sync_val_compare_and_swap(&cell->max, max, duration);
+		if (previous == max) break;
+		max = previous;
+	}
+	if (keepHistogram) {
+		__sync_fetch_and_add(&cell->buckets[getBucketIndex(duration)], 1);
+	}
+}
+
+int64_t TimeAccumulator::getTotal() {
+	int64_t total = 0;
+	for (int i = 0; i < Thread_Slots; i++) {
+		if (cells[i] != NULL) total += cells[i]->total;
+	}
+	return total;
+}
+
+int64_t TimeAccumulator::getCount() {
+	int64_t count = 0;
+	for (int i = 0; i < Thread_Slots; i++) {
+		if (cells[i] != NULL) count += cells[i]->count;
+	}
+	return count;
+}
+
+double TimeAccumulator::getMaxSeconds() {
+	int64_t max = 0;
+	for (int i = 0; i < Thread_Slots; i++) {
+		if (cells[i] != NULL && cells[i]->max > max) max = cells[i]->max;
+	}
+	return toSeconds(max);
+}
+
+double TimeAccumulator::getPercentileSeconds(double fraction) {
+	if (!keepHistogram) return 0;
+	int64_t count = getCount();
+	if (count == 0) return 0;
+
+	// the rank of the duration at the fraction, counting from 1
+	int64_t rank = (int64_t) (fraction * count);
+	if (rank < fraction * count) rank++;
+	if (rank < 1) rank = 1;
+
+	int64_t seen = 0;
+	for (int b = 0; b < Histogram_Buckets; b++) {
+		for (int i = 0; i < Thread_Slots; i++) {
+			if (cells[i] != NULL) seen += cells[i]->buckets[b];
+		}
+		if (seen >= rank) {
+			// the midpoint of the last bucket can exceed the longest duration recorded
+			double value = toSeconds(getBucketValue(b));
+			double max = getMaxSeconds();
+			return (value < max) ? value : max;
+		}
+	}
+	return getMaxSeconds();
+}
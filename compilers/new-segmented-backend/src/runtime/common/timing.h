@@ -0,0 +1,82 @@
+#ifndef _H_timing
+#define _H_timing
+
+/* This header provides the clock and the time accumulators the runtime library and the generated code use to measure
+   how long their activities take. Times are taken as nanoseconds of the raw monotonic clock of the machine, which, in
+   contrast to the time of day, never jumps when the system time is adjusted and has a resolution finer than a micro-
+   second; so short activities such as the individual transfers of a communicator can be measured reliably.
+
+   An accumulator sums up the time spent on some activity. As many threads may record into the same accumulator at the
+   same time, e.g., the PPU controllers of a segment waiting on a communicator's barrier, the accumulator keeps a cell
+   for each thread slot and updates it with atomic instructions instead of a lock. The cells are only merged when the
+   accumulated time is reported. PPU controller threads should register their thread numbers to get a cell of their
+   own; other threads share a common cell. An accumulator can also keep a histogram of the recorded durations to report
+   their percentiles, which tell more about waits and message latencies than the sums do.
+*/
+
+#include <stdint.h>
+
+namespace timing {
+
+	// returns the current time in nanoseconds since some arbitrary point in the past
+	int64_t now();
+
+	inline double toSeconds(int64_t nanoseconds) { return nanoseconds / 1000000000.0; }
+	inline double elapsedSeconds(int64_t start, int64_t end) { return toSeconds(end - start); }
+
+	// the number of accumulator cells; thread numbers beyond that share cells with lower numbered threads
+	const int Thread_Slots = 64;
+
+	// PPU controller threads should call this function to record into accumulator cells of their own
+	void registerThread(int threadNo);
+
+	/* The histogram buckets are log-linear: each power of two range of nanoseconds is divided into four buckets; so
+	   a reported percentile is within 12.5% of the true value. Durations above 2^40 nanoseconds, about 18 minutes,
+	   fall in the last bucket. */
+	const int Sub_Buckets = 4;
+	const int Max_Duration_Bits = 40;
+	const int Histogram_Buckets = (Max_Duration_Bits - 1) * Sub_Buckets;
+
+	int getBucketIndex(int64_t duration);
+	// returns the midpoint of the range of durations that fall in a bucket
+	int64_t getBucketValue(int bucketIndex);
+
+	// a cell is padded to occupy whole cache lines so that threads recording in neighboring cells do not contend
+	class AccumulatorCell {
+	  public:
+		int64_t total;
+		int64_t count;
+		int64_t max;
+		int64_t *buckets;
+		char padding[64 - 3 * sizeof(int64_t) - sizeof(int64_t*)];
+		AccumulatorCell(bool keepHistogram);
+		~AccumulatorCell();
+	};
+
+	class TimeAccumulator {
+	  private:
+		bool keepHistogram;
+		AccumulatorCell *cells[Thread_Slots];
+	  public:
+		TimeAccumulator(bool keepHistogram = false);
+		~TimeAccumulator();
+
+		void add(int64_t start, int64_t end) { record(end - start); }
+		void record(int64_t duration);
+
+		// the functions below merge the cells; they should not be used while threads are still recording for
+		// exact results
+		int64_t getTotal();
+		double getTotalSeconds() { return toSeconds(getTotal()); }
+		int64_t getCount();
+		double getMaxSeconds();
+		bool hasHistogram() { return keepHistogram; }
+		// returns the duration at the argument fraction of the recorded durations, e.g., 0.99 for the 99th
+		// percentile; the result is 0 if there is no histogram or no durations have been recorded
+		double getPercentileSeconds(double fraction);
+	  private:
+		AccumulatorCell *getCell();
+	};
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include "topology.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <sched.h>
+
+// processor IDs cannot exceed the size of the CPU sets used to set thread affinity
+static const int Max_Processors = CPU_SETSIZE;
+
+bool ProcessorTopology::discoveryAttempted = false;
+bool ProcessorTopology::discovered = false;
+int ProcessorTopology::processorCount = 0;
+int ProcessorTopology::coreCount = 0;
+CoreInfo *ProcessorTopology::cores = NULL;
+
+bool ProcessorTopology::readIntFromFile(const char *fileName, int *value) {
+	std::ifstream file(fileName);
+	if (!file.is_open()) return false;
+	file >> *value;
+	bool success = !file.fail();
+	file.close();
+	return success;
+}
+
+int ProcessorTopology::parseCpuList(const char *fileName, int *ids, int capacity) {
+	std::ifstream file(fileName);
+	if (!file.is_open()) return 0;
+	std::string list;
+	std::getline(file, list);
+	file.close();
+
+	int count = 0;
+	std::istringstream ranges(list);
+	std::string range;
+	while (std::getline(ranges, range, ',')) {
+		if (range.empty()) continue;
+		int first = atoi(range.c_str());
+		int last = first;
+		size_t dash = range.find('-');
+		if (dash != std::string::npos) last = atoi(range.substr(dash + 1).c_str());
+		for (int id = first; id <= last && count < capacity; id++) {
+			ids[count++] = id;
+		}
+	}
+	return count;
+}
+
+bool ProcessorTopology::discover() {
+
+	if (discoveryAttempted) return discovered;
+	discoveryAttempted = true;
+
+	int *onlineIds = new int[Max_Processors];
+	int onlineCount = parseCpuList("/sys/devices/system/cpu/online", onlineIds, Max_Processors);
+	if (onlineCount == 0) {
+		delete[] onlineIds;
+		return false;
+	}
+
+	// determine the NUMA node of each processor; a kernel without NUMA support has no node directories and all
+	// processors are then regarded as parts of node 0
+	int *numaNodes = new int[Max_Processors];
+	for (int i = 0; i < Max_Processors; i++) numaNodes[i] = 0;
+	int *nodeMembers = new int[Max_Processors];
+	int *nodeIds = new int[Max_Processors];
+	int nodeCount = parseCpuList("/sys/devices/system/node/online", nodeIds, Max_Processors);
+	for (int i = 0; i < nodeCount; i++) {
+		std::ostringstream fileName;
+		fileName << "/sys/devices/system/node/node" << nodeIds[i] << "/cpulist";
+		int members = parseCpuList(fileName.str().c_str(), nodeMembers, Max_Processors);
+		for (int j = 0; j < members; j++) {
+			if (nodeMembers[j] < Max_Processors) numaNodes[nodeMembers[j]] = nodeIds[i];
+		}
+	}
+	delete[] nodeMembers;
+	delete[] nodeIds;
+
+	// group the processors into cores; processors are inserted in a sorted order of package, NUMA node, and core
+	// ID, and the hardware threads of a core are kept in the increasing order of their processor IDs
+	cores = new CoreInfo[onlineCount];
+	coreCount = 0;
+	processorCount = 0;
+	for (int i = 0; i < onlineCount; i++) {
+		int processorId = onlineIds[i];
+		if (processorId >= Max_Processors) continue;
+		std::ostringstream packageFile, coreFile;
+		packageFile << "/sys/devices/system/cpu/cpu" << processorId << "/topology/physical_package_id";
+		coreFile << "/sys/devices/system/cpu/cpu" << processorId << "/topology/core_id";
+		int packageId, coreId;
+		if (!readIntFromFile(packageFile.str().c_str(), &packageId)
+				|| !readIntFromFile(coreFile.str().c_str(), &coreId)) {
+			delete[] onlineIds;
+			delete[] numaNodes;
+			delete[] cores;
+			cores = NULL;
+			coreCount = 0;
+			processorCount = 0;
+			return false;
+		}
+		int numaNode = numaNodes[processorId];
+		processorCount++;
+
+		int position = 0;
+		bool existing = false;
+		for (; position < coreCount; position++) {
+			CoreInfo *core = &cores[position];
+			if (core->packageId == packageId && core->numaNode == numaNode && core->coreId == coreId) {
+				existing = true;
+				break;
+			}
+			if (core->packageId > packageId) break;
+			if (core->packageId == packageId && core->numaNode > numaNode) break;
+			if (core->packageId == packageId && core->numaNode == numaNode && core->coreId > coreId) break;
+		}
+		if (existing) {
+			CoreInfo *core = &cores[position];
+			core->processorIds[core->threadCount++] = processorId;
+			continue;
+		}
+		for (int j = coreCount; j > position; j--) {
+			cores[j] = cores[j - 1];
+		}
+		CoreInfo *core = &cores[position];
+		core->packageId = packageId;
+		core->numaNode = numaNode;
+		core->coreId = coreId;
+		core->threadCount = 1;
+		// the online list is sorted; so a core cannot have more hardware threads than the remaining processors
+		core->processorIds = new int[onlineCount - i];
+		core->processorIds[0] = processorId;
+		coreCount++;
+	}
+	delete[] onlineIds;
+	delete[] numaNodes;
+
+	discovered = (coreCount > 0);
+	return discovered;
+}
+
+int ProcessorTopology::getProcessorForThread(int threadNo,
+		int coreJump,
+		int threadsPerCore,
+		int processorsPerPhyUnit,
+		const int *fallbackOrder, int fallbackOrderSize) {
+
+	int coreSlot = (threadNo * coreJump / threadsPerCore) % processorsPerPhyUnit;
+	if (!discover()) {
+		return fallbackOrder[coreSlot % fallbackOrderSize];
+	}
+
+	// The baked processor order had an entry per hardware thread; here there is an entry per core. If the PCubeS
+	// description has no PPS below the core space but the hardware has multiple hardware threads per core, then
+	// the core slot counts hardware threads and consecutive slots are spread over the threads of each core.
+	int coreIndex = coreSlot;
+	int threadIndex = (threadNo * coreJump) % threadsPerCore;
+	if (threadsPerCore == 1 && processorsPerPhyUnit > coreCount) {
+		coreIndex = coreSlot % coreCount;
+		threadIndex = coreSlot / coreCount;
+	}
+	CoreInfo *core = &cores[coreIndex % coreCount];
+	return core->processorIds[threadIndex % core->threadCount];
+}
+
+void ProcessorTopology::describe(std::ostream &stream, int processorsPerPhyUnit, int threadsPerCore) {
+	if (!discover()) {
+		stream << "processor topology could not be discovered: using the compile time processor order\n";
+		return;
+	}
+	stream << "discovered " << processorCount << " processors in " << coreCount << " cores\n";
+	int expectedCores = processorsPerPhyUnit / threadsPerCore;
+	if (expectedCores > coreCount && processorsPerPhyUnit > processorCount) {
+		stream << "warning: the PCubeS description expects " << processorsPerPhyUnit;
+		stream << " processors in a physical unit but only " << processorCount << " are online; ";
+		stream << "multiple threads will share processors\n";
+	}
+}
@@ -0,0 +1,63 @@
+#ifndef _H_topology
+#define _H_topology
+
+/* This header provides the runtime discovery of the processor topology of the machine a segment is running on. The
+   compiler bakes a Processor_Order array into the generated code from the processor description file given at
+   compile time, and threads used to be pinned to the processors listed in that array. A binary built for one node
+   then places threads wrongly on another node of the same shape whose processors are numbered differently, e.g., a
+   node whose hardware threads of a core are numbered far apart instead of consecutively. Such misplacement goes
+   unnoticed and may put two PPU threads on the same core while leaving another core idle.
+
+   Instead, the topology is read from the Linux sysfs directories /sys/devices/system/cpu and /sys/devices/system/node
+   at program start. The online processors are grouped into cores and the cores are ordered by package, NUMA node,
+   and core ID, which is the order the PCubeS hierarchy descends in. Threads are then assigned to cores and to the
+   hardware threads within cores using the same hardware constants of the generated code that were used to index the
+   Processor_Order array. If the sysfs information is not available, the baked array is used as before.
+*/
+
+#include <iostream>
+
+/* a core of the machine along with the logical processor IDs of its hardware threads */
+class CoreInfo {
+  public:
+	int packageId;
+	int numaNode;
+	int coreId;
+	int threadCount;
+	int *processorIds;
+};
+
+class ProcessorTopology {
+  private:
+	static bool discoveryAttempted;
+	static bool discovered;
+	static int processorCount;
+	static int coreCount;
+	static CoreInfo *cores;
+  public:
+	// reads the topology from sysfs; this is done only once and the outcome is remembered
+	static bool discover();
+	static bool isDiscovered() { return discovered; }
+	static int getProcessorCount() { return processorCount; }
+	static int getCoreCount() { return coreCount; }
+
+	// Determines the logical processor a PPU controller thread should be pinned to. The thread's core is the one
+	// the Processor_Order array would have selected; its hardware thread within the core follows the position of
+	// the PPU among the PPUs below the core space of the PCubeS description. The fallback order is used when the
+	// topology could not be discovered.
+	static int getProcessorForThread(int threadNo,
+			int coreJump,
+			int threadsPerCore,
+			int processorsPerPhyUnit,
+			const int *fallbackOrder, int fallbackOrderSize);
+
+	// writes a description of the discovered topology and its mismatches with the PCubeS description, if any, in
+	// the argument stream
+	static void describe(std::ostream &stream, int processorsPerPhyUnit, int threadsPerCore);
+  private:
+	static bool readIntFromFile(const char *fileName, int *value);
+	// parses a sysfs CPU list such as '0-3,8,10-11'; returns the number of IDs written in the output array
+	static int parseCpuList(const char *fileName, int *ids, int capacity);
+};
+
+#endif
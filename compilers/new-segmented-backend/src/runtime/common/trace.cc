@@ -0,0 +1,221 @@
+#include "trace.h"
+#include "timing.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <mpi.h>
+
+using namespace trace;
+
+// IDs assigned to threads that never register themselves start from here to keep them apart from PPU thread numbers
+static const int Unnamed_Thread_Id_Base = 1000;
+
+const char *trace::getCategoryName(EventCategory category) {
+	switch (category) {
+		case TASK_EXECUTION: return "task";
+		case STAGE_EXECUTION: return "stage";
+		case SYNC_WAIT: return "sync";
+		case COMM_SETUP: return "comm-setup";
+		case BUFFER_READ: return "buffer-read";
+		case COMMUNICATION: return "communication";
+		case BUFFER_WRITE: return "buffer-write";
+		case REDUCTION: return "reduction";
+	}
+	return "unknown";
+}
+
+//------------------------------------------------------------ Trace Buffer -------------------------------------------------------------/
+
+TraceBuffer::TraceBuffer(int threadId, int capacity) {
+	this->threadId = threadId;
+	this->capacity = capacity;
+	this->events = new TraceEvent[capacity];
+	this->recorded = 0;
+}
+
+TraceBuffer::~TraceBuffer() {
+	delete[] events;
+}
+
+int TraceBuffer::getEventCount() {
+	return (recorded < capacity) ? recorded : capacity;
+}
+
+int64_t TraceBuffer::getDroppedEventCount() {
+	return (recorded < capacity) ? 0 : recorded - capacity;
+}
+
+TraceEvent *TraceBuffer::getEvent(int i) {
+	int64_t firstSurviving = getDroppedEventCount();
+	return &events[(firstSurviving + i) % capacity];
+}
+
+//---------------------------------------------------------------- Tracer ---------------------------------------------------------------/
+
+int Tracer::segmentId = 0;
+int64_t Tracer::timeOrigin = 0;
+int Tracer::bufferCapacity = Default_Buffer_Capacity;
+pthread_mutex_t Tracer::registryLock = PTHREAD_MUTEX_INITIALIZER;
+TraceBuffer **Tracer::bufferRegistry = NULL;
+int Tracer::registeredBuffers = 0;
+int Tracer::registryCapacity = 0;
+int Tracer::nextUnnamedThreadId = Unnamed_Thread_Id_Base;
+__thread TraceBuffer *Tracer::threadBuffer = NULL;
+
+void Tracer::initialize(int segmentId, int bufferCapacity) {
+	Tracer::segmentId = segmentId;
+	Tracer::bufferCapacity = bufferCapacity;
+
+	// the monotonic clocks of different nodes are unrelated; so all segments take their time origins right after a
+	// barrier to get an approximate alignment of their timelines
+	MPI_Barrier(MPI_COMM_WORLD);
+	timeOrigin = timing::now();
+}
+
+void Tracer::registerThread(int threadNo) {
+	if (threadBuffer == NULL) {
+		createThreadBuffer(threadNo);
+	} else {
+		threadBuffer->setThreadId(threadNo);
+	}
+}
+
+int64_t Tracer::now() {
+	return timing::now() - timeOrigin;
+}
+
+TraceBuffer *Tracer::createThreadBuffer(int threadId) {
+	pthread_mutex_lock(&registryLock);
+	if (threadId < 0) {
+		threadId = nextUnnamedThreadId++;
+	} else {
+		// PPU controller threads are recreated for each task; the buffer of the thread with the same number from an
+		// earlier task is reused as that thread must have finished already
+		for (int i = 0; i < registeredBuffers; i++) {
+			if (bufferRegistry[i]->getThreadId() == threadId) {
+				threadBuffer = bufferRegistry[i];
+				pthread_mutex_unlock(&registryLock);
+				return threadBuffer;
+			}
+		}
+	}
+	if (registeredBuffers == registryCapacity) {
+		int newCapacity = (registryCapacity == 0) ? 16 : registryCapacity * 2;
+		TraceBuffer **newRegistry = new TraceBuffer*[newCapacity];
+		for (int i = 0; i < registeredBuffers; i++) newRegistry[i] = bufferRegistry[i];
+		delete[] bufferRegistry;
+		bufferRegistry = newRegistry;
+		registryCapacity = newCapacity;
+	}
+	threadBuffer = new TraceBuffer(threadId, bufferCapacity);
+	bufferRegistry[registeredBuffers] = threadBuffer;
+	registeredBuffers++;
+	pthread_mutex_unlock(&registryLock);
+	return threadBuffer;
+}
+
+char *Tracer::serializeEvents(int *length) {
+
+	std::ostringstream stream;
+	bool first = true;
+	pthread_mutex_lock(&registryLock);
+	for (int i = 0; i < registeredBuffers; i++) {
+		TraceBuffer *buffer = bufferRegistry[i];
+		int threadId = buffer->getThreadId();
+		int eventCount = buffer->getEventCount();
+
+		// every thread gets a name entry so that the timeline viewer shows meaningful thread labels
+		if (!first) stream << ",\n";
+		first = false;
+		stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << segmentId;
+		stream << ",\"tid\":" << threadId << ",\"args\":{\"name\":\"";
+		if (threadId < Unnamed_Thread_Id_Base) stream << "PPU Thread " << threadId;
+		else stream << "Segment Thread " << (threadId - Unnamed_Thread_Id_Base);
+		stream << "\"}}";
+
+		int64_t dropped = buffer->getDroppedEventCount();
+		if (dropped > 0) {
+			std::cout << "Segment " << segmentId << ": trace buffer of thread " << threadId;
+			std::cout << " overflowed and lost its " << dropped << " oldest events\n";
+		}
+
+		// complete events are written with time stamps in microseconds as the trace format expects
+		for (int j = 0; j < eventCount; j++) {
+			TraceEvent *event = buffer->getEvent(j);
+			stream << ",\n{\"name\":\"" << event->name << "\"";
+			stream << ",\"cat\":\"" << getCategoryName(event->category) << "\"";
+			stream << ",\"ph\":\"X\"";
+			stream << ",\"ts\":" << event->start / 1000 << "." << (event->start % 1000) / 100;
+			stream << ",\"dur\":" << event->duration / 1000 << "." << (event->duration % 1000) / 100;
+			stream << ",\"pid\":" << segmentId << ",\"tid\":" << threadId;
+			if (event->arg >= 0) stream << ",\"args\":{\"lpu\":" << event->arg << "}";
+			stream << "}";
+		}
+	}
+	pthread_mutex_unlock(&registryLock);
+
+	// add a name entry for the process so that segments are labeled in the timeline
+	if (!first) stream << ",\n";
+	stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << segmentId;
+	stream << ",\"args\":{\"name\":\"Segment " << segmentId << "\"}}";
+
+	std::string content = stream.str();
+	*length = content.length();
+	char *serialized = new char[content.length() + 1];
+	strcpy(serialized, content.c_str());
+	return serialized;
+}
+
+void Tracer::exportTimeline(const char *fileName) {
+
+	int segmentCount;
+	MPI_Comm_size(MPI_COMM_WORLD, &segmentCount);
+
+	int length;
+	char *serialized = serializeEvents(&length);
+
+	// gather the sizes of the serialized events of the segments first then the events themselves in segment 0
+	int *lengths = NULL;
+	int *displacements = NULL;
+	char *gathered = NULL;
+	if (segmentId == 0) {
+		lengths = new int[segmentCount];
+	}
+	MPI_Gather(&length, 1, MPI_INT, lengths, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	if (segmentId == 0) {
+		displacements = new int[segmentCount];
+		int totalLength = 0;
+		for (int i = 0; i < segmentCount; i++) {
+			displacements[i] = totalLength;
+			totalLength += lengths[i];
+		}
+		gathered = new char[totalLength + 1];
+	}
+	MPI_Gatherv(serialized, length, MPI_CHAR, gathered, lengths, displacements, MPI_CHAR, 0, MPI_COMM_WORLD);
+	delete[] serialized;
+
+	if (segmentId == 0) {
+		std::ofstream timelineFile;
+		timelineFile.open(fileName, std::ofstream::out);
+		if (!timelineFile.is_open()) {
+			std::cout << "could not open the trace timeline file: " << fileName << "\n";
+		} else {
+			timelineFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+			for (int i = 0; i < segmentCount; i++) {
+				if (i > 0) timelineFile << ",\n";
+				timelineFile.write(gathered + displacements[i], lengths[i]);
+			}
+			timelineFile << "\n]}\n";
+			timelineFile.close();
+		}
+		delete[] lengths;
+		delete[] displacements;
+		delete[] gathered;
+	}
+}
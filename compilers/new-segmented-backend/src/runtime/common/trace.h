@@ -0,0 +1,154 @@
+#ifndef _H_trace
+#define _H_trace
+
+/* This header provides a low-overhead tracing facility for the runtime library and the generated code. The only
+   instrumentation otherwise available is the cumulative timing kept by the communication statistics and the ad hoc
+   log file entries of the generated code. Those totals cannot tell when a particular PPU was computing, waiting on a
+   synchronization primitive, or stuck inside some phase of a communicator. The tracer records each such activity as
+   a timestamped event in a fixed-capacity ring buffer owned by the recording thread, and at the end of the program,
+   merges the events of all threads of all segments into a single timeline file in the Chrome trace event format. The
+   file can be opened in chrome://tracing or in the Perfetto UI for offline analysis. In the timeline, each segment
+   appears as a process and each PPU controller thread as a thread of that process.
+
+   Tracing is switched on or off at compile time. Unless the generated program is compiled with the RUNTIME_TRACING
+   macro defined (for example, by adding -DRUNTIME_TRACING to the 'c.optimization.flags' deployment property), all
+   the tracing macros defined at the end of this header expand to nothing and the instrumentation costs nothing.
+*/
+
+#include <pthread.h>
+#include <stdint.h>
+
+namespace trace {
+
+	// categories of traced activities; each category becomes a separately filterable group in the timeline
+	enum EventCategory {	TASK_EXECUTION,
+				STAGE_EXECUTION,
+				SYNC_WAIT,
+				COMM_SETUP,
+				BUFFER_READ,
+				COMMUNICATION,
+				BUFFER_WRITE,
+				REDUCTION };
+
+	const char *getCategoryName(EventCategory category);
+
+	// the default number of events each thread's ring buffer can hold before it starts overwriting old events
+	const int Default_Buffer_Capacity = 1 << 16;
+
+	// Event names are not copied; so they should be string literals or strings that live till the end of the
+	// program such as communication dependency names. The argument field holds an optional integer such as the
+	// ID of the LPU being processed; a negative value means the event has no LPU argument.
+	class TraceEvent {
+	  public:
+		const char *name;
+		EventCategory category;
+		int64_t start;
+		int64_t duration;
+		int arg;
+	};
+
+	/* The buffer for a single thread. There is no locking in recording events as only the owner thread writes to
+	   it. When the buffer becomes full, new events overwrite the oldest ones so that tracing a long running program
+	   keeps the most recent part of its timeline without any unbounded memory growth.
+	*/
+	class TraceBuffer {
+	  private:
+		int threadId;
+		int capacity;
+		TraceEvent *events;
+		// total number of events ever recorded; the buffer holds the last min(recorded, capacity) of them
+		int64_t recorded;
+	  public:
+		TraceBuffer(int threadId, int capacity);
+		~TraceBuffer();
+		int getThreadId() { return threadId; }
+		void setThreadId(int threadId) { this->threadId = threadId; }
+		inline void record(EventCategory category, const char *name, int arg, int64_t start, int64_t end) {
+			TraceEvent &event = events[recorded % capacity];
+			event.name = name;
+			event.category = category;
+			event.start = start;
+			event.duration = end - start;
+			event.arg = arg;
+			recorded++;
+		}
+		int getEventCount();
+		int64_t getDroppedEventCount();
+		// returns the i-th surviving event in chronological order of recording
+		TraceEvent *getEvent(int i);
+	};
+
+	/* The static class that manages the trace buffers of all threads of a segment and exports the timeline. */
+	class Tracer {
+	  private:
+		static int segmentId;
+		static int64_t timeOrigin;
+		static int bufferCapacity;
+		static pthread_mutex_t registryLock;
+		static TraceBuffer **bufferRegistry;
+		static int registeredBuffers;
+		static int registryCapacity;
+		static int nextUnnamedThreadId;
+		static __thread TraceBuffer *threadBuffer;
+	  public:
+		// This should be called once by each segment after MPI has been initialized. It is a collective operation
+		// as segments synchronize their time origins with a barrier so that their timelines can be aligned.
+		static void initialize(int segmentId, int bufferCapacity = Default_Buffer_Capacity);
+
+		// PPU controller threads should call this function to record their events under their thread numbers.
+		// Events of threads that never register are recorded under IDs that do not conflict with thread numbers.
+		static void registerThread(int threadNo);
+
+		// returns the current time in nanoseconds since the time origin of the segment
+		static int64_t now();
+
+		static inline void record(EventCategory category, const char *name, int arg, int64_t start, int64_t end) {
+			if (threadBuffer == NULL) createThreadBuffer(-1);
+			threadBuffer->record(category, name, arg, start, end);
+		}
+
+		// This collective operation gathers the events of all segments in segment 0 that then writes them in the
+		// argument file. It should be called after all PPU controller threads have finished.
+		static void exportTimeline(const char *fileName);
+	  private:
+		static TraceBuffer *createThreadBuffer(int threadId);
+		static char *serializeEvents(int *length);
+	};
+
+	// a utility class to trace the activity of an entire code block
+	class TraceScope {
+	  private:
+		EventCategory category;
+		const char *name;
+		int arg;
+		int64_t start;
+	  public:
+		TraceScope(EventCategory category, const char *name, int arg = -1) {
+			this->category = category;
+			this->name = name;
+			this->arg = arg;
+			this->start = Tracer::now();
+		}
+		~TraceScope() { Tracer::record(category, name, arg, start, Tracer::now()); }
+	};
+}
+
+// Macros to be used for instrumentation. Each TRACE_SCOPE should be in its own code block as it declares a variable.
+#ifdef RUNTIME_TRACING
+#define TRACE_INITIALIZE(segmentId) trace::Tracer::initialize(segmentId)
+#define TRACE_REGISTER_THREAD(threadNo) trace::Tracer::registerThread(threadNo)
+#define TRACE_SCOPE(category, name, arg) trace::TraceScope traceScope(category, name, arg)
+#define TRACE_TIMESTAMP(variable) int64_t variable = trace::Tracer::now()
+#define TRACE_RECORD(category, name, arg, startVariable) \
+		trace::Tracer::record(category, name, arg, startVariable, trace::Tracer::now())
+#define TRACE_EXPORT_TIMELINE(fileName) trace::Tracer::exportTimeline(fileName)
+#else
+#define TRACE_INITIALIZE(segmentId)
+#define TRACE_REGISTER_THREAD(threadNo)
+#define TRACE_SCOPE(category, name, arg)
+#define TRACE_TIMESTAMP(variable)
+#define TRACE_RECORD(category, name, arg, startVariable)
+#define TRACE_EXPORT_TIMELINE(fileName)
+#endif
+
+#endif
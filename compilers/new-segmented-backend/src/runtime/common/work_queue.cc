@@ -0,0 +1,57 @@
+#include "work_queue.h"
+
+#include <pthread.h>
+#include <vector>
+
+WorkQueue::WorkQueue(int itemCount, WorkFunction function, void *argument) {
+	this->itemCount = itemCount;
+	this->nextItem = 0;
+	this->function = function;
+	this->argument = argument;
+	pthread_mutex_init(&mutex, NULL);
+}
+
+WorkQueue::~WorkQueue() {
+	pthread_mutex_destroy(&mutex);
+}
+
+void WorkQueue::process(int threadCount) {
+
+	// there is no point in having more threads than work items
+	if (threadCount > itemCount) threadCount = itemCount;
+
+	// if a thread cannot be created then the remaining threads do its share of the work
+	std::vector<pthread_t> workers;
+	for (int i = 1; i < threadCount; i++) {
+		pthread_t worker;
+		if (pthread_create(&worker, NULL, runWorker, (void*) this) != 0) break;
+		workers.push_back(worker);
+	}
+	processItems();
+	for (unsigned int i = 0; i < workers.size(); i++) {
+		pthread_join(workers[i], NULL);
+	}
+}
+
+int WorkQueue::getNextItem() {
+	pthread_mutex_lock(&mutex);
+	int itemNo = -1;
+	if (nextItem < itemCount) {
+		itemNo = nextItem;
+		nextItem++;
+	}
+	pthread_mutex_unlock(&mutex);
+	return itemNo;
+}
+
+void WorkQueue::processItems() {
+	int itemNo;
+	while ((itemNo = getNextItem()) != -1) {
+		function(itemNo, argument);
+	}
+}
+
+void *WorkQueue::runWorker(void *queue) {
+	((WorkQueue*) queue)->processItems();
+	return NULL;
+}
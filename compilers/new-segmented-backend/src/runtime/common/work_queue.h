@@ -0,0 +1,37 @@
+#ifndef _H_work_queue
+#define _H_work_queue
+
+/* This header provides a simple work queue for processing a fixed number of independent work items using a group of
+ * transient threads. It is meant for the setup activities a segment carries out on its main thread before the threads
+ * of a task are launched, the construction of communicators being the primary example, as the cores of the segment are
+ * idle at that time.
+ */
+
+#include <pthread.h>
+
+// a work function processes the work item of the argument number; the second argument is shared by all work items
+typedef void (*WorkFunction)(int itemNo, void *argument);
+
+class WorkQueue {
+  private:
+	int itemCount;
+	int nextItem;
+	WorkFunction function;
+	void *argument;
+	pthread_mutex_t mutex;
+  public:
+	WorkQueue(int itemCount, WorkFunction function, void *argument);
+	~WorkQueue();
+
+	// Processes all work items using at most the argument number of threads, the calling thread included. Items are
+	// handed out one at a time so that threads that get inexpensive items pick up more of them. The function returns
+	// after all items have been processed.
+	void process(int threadCount);
+  private:
+	// returns the number of the next item to be processed or -1 if all items have been handed out
+	int getNextItem();
+	void processItems();
+	static void *runWorker(void *queue);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include "confinement_mgmt.h"
 #include "communicator.h"
 #include "comm_buffer.h"
+#include "../common/timing.h"
 
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/utility.h"
@@ -27,6 +28,16 @@ ReplicationSyncCommunicator::ReplicationSyncCommunicator(int localSegmentTag,
 	Assert(bufferList->NumElements() == 1);
 
 	this->commBufferList = bufferList;
+	this->nodeSharedReplica = false;
+}
+
+void ReplicationSyncCommunicator::setupCommunicator(bool includeNonInteractingSegments) {
+	Communicator::setupCommunicator(includeNonInteractingSegments);
+
+	// a segment group reused from an earlier task invocation already has its node communicators
+	if (nodeSharedReplica && !segmentGroup->isNodeAware()) {
+		segmentGroup->setupNodeCommunicators(*logFile);
+	}
 }
 
 void ReplicationSyncCommunicator::sendData() {
@@ -47,6 +58,11 @@ void ReplicationSyncCommunicator::sendData() {
                 exit(EXIT_FAILURE);
         }
 
+	if (isNodeAware()) {
+		transferAmongNodes(myRank);
+		return;
+	}
+
 	CommBuffer *buffer = commBufferList->Nth(0);
 	long int bufferSize = buffer->getBufferSize();
 	char *data = buffer->getData();
@@ -86,6 +102,8 @@ void ReplicationSyncCommunicator::receiveData() {
         }
         if (broadcaster == -1) {
                 cout << "Segment " << localSegmentTag << ": none is making the broadcast\n";
+	} else if (isNodeAware()) {
+		transferAmongNodes(broadcaster);
 	} else {
 		CommBuffer *buffer = commBufferList->Nth(0);
 		long int bufferSize = buffer->getBufferSize();
@@ -102,6 +120,50 @@ void ReplicationSyncCommunicator::receiveData() {
 	//logFile->flush();
 }
 
+void ReplicationSyncCommunicator::transferAmongNodes(int broadcaster) {
+
+	int myRank = segmentGroup->getRank(localSegmentTag);
+	int myLeader = segmentGroup->getNodeLeader(myRank);
+	int sourceLeader = segmentGroup->getNodeLeader(broadcaster);
+	MPI_Comm leaderComm = segmentGroup->getLeaderCommunicator();
+	int leaderCount = 1;
+	if (leaderComm != MPI_COMM_NULL) MPI_Comm_size(leaderComm, &leaderCount);
+
+	CommBuffer *buffer = commBufferList->Nth(0);
+	long int bufferSize = buffer->getBufferSize();
+	char *data = buffer->getData();
+	int sourceLeaderRank = segmentGroup->getLeaderRank(broadcaster);
+
+	if (myLeader == sourceLeader) {
+		// the broadcaster has already updated the shared copy of the node
+		synchronizeNode();
+		if (myRank == myLeader && leaderCount > 1) {
+			if (myRank != broadcaster) buffer->readData(false, *logFile);
+			int status = MPI_Bcast(data, bufferSize, MPI_CHAR, sourceLeaderRank, leaderComm);
+			if (status != MPI_SUCCESS) {
+				cout << "Segment " << localSegmentTag << ": could not broadcast replicated update\n";
+				exit(EXIT_FAILURE);
+			}
+		}
+	} else {
+		if (myRank == myLeader) {
+			int status = MPI_Bcast(data, bufferSize, MPI_CHAR, sourceLeaderRank, leaderComm);
+			if (status != MPI_SUCCESS) {
+				cout << "Segment " << localSegmentTag << ": did not receive broadcast of replicated data\n";
+				exit(EXIT_FAILURE);
+			}
+			buffer->writeData(false, *logFile);
+		}
+		synchronizeNode();
+	}
+}
+
+void ReplicationSyncCommunicator::synchronizeNode() {
+	__sync_synchronize();
+	MPI_Barrier(segmentGroup->getNodeCommunicator());
+	__sync_synchronize();
+}
+
 
 //------------------------------------------------------ Ghost Region Sync Communicator -------------------------------------------------------/
 
@@ -202,6 +264,9 @@ void GhostRegionSyncCommunicator::performTransfer() {
 		int receiverSegment = receiverTags[0];
 		Assert(receiverSegment != localSegmentTag);
 		int receiverRank = segmentGroup->getRank(receiverSegment);	
+		if (buffer->isDeltaModeApplicable() && buffer->isContentUnchangedSinceLastSend()) {
+			bufferSize = 0;
+		}
 		int status = MPI_Isend(data, bufferSize, MPI_CHAR, receiverRank, 0, mpiComm, &sendRequests[i]);
                 if (status != MPI_SUCCESS) {
                 	cout << "Segment " << localSegmentTag << ": could not issue asynchronous send\n";
@@ -209,12 +274,23 @@ void GhostRegionSyncCommunicator::performTransfer() {
 		}
 	}
 
-	// wait for all receives to finish and write data back to operating memory from receive buffers
-	int status = MPI_Waitall(remoteRecvs, recvRequests, MPI_STATUSES_IGNORE);
+	// wait for all receives to finish; data will be written back to operating memory from receive buffers, except for
+	// those buffers the senders found unchanged, during post processing
+	MPI_Status *recvStatuses = new MPI_Status[remoteRecvs];
+	int status = MPI_Waitall(remoteRecvs, recvRequests, recvStatuses);
 	if (status != MPI_SUCCESS) {
 		cout << "Segment "<< localSegmentTag << ": some of the asynchronous receives failed\n";
 		exit(EXIT_FAILURE);
 	}
+	for (int i = 0; i < remoteRecvs; i++) {
+		CommBuffer *buffer = remoteReceiveBuffers->Nth(i);
+		int receivedBytes;
+		MPI_Get_count(&recvStatuses[i], MPI_CHAR, &receivedBytes);
+		if (receivedBytes == 0 && buffer->getBufferSize() > 0) {
+			buffer->setContentUnchanged(true);
+		}
+	}
+	delete[] recvStatuses;
 
 	// wait for all sends to finish
 	status = MPI_Waitall(remoteSends, sendRequests, MPI_STATUSES_IGNORE);
@@ -277,8 +353,7 @@ void UpSyncCommunicator::setupCommunicator(bool includeNonInteractingSegments) {
 	*logFile << "\tsetting up the mode for up-sync communicator for " << dependencyName << "\n";
 	logFile->flush();
 
-	struct timeval start;
-        gettimeofday(&start, NULL);
+	int64_t start = timing::now();
 
 	CommBuffer *buffer = commBufferList->Nth(0);
 	int receiverSegment = buffer->getExchange()->getReceiver()->getSegmentTags()[0]; 
@@ -310,8 +385,13 @@ void UpSyncCommunicator::setupCommunicator(bool includeNonInteractingSegments) {
 		commMode = (gather == 1) ? GATHER_V : SEND_RECEIVE;
 	}
 
-	struct timeval end;
-        gettimeofday(&end, NULL);
+	// compression needs the same segment at the two ends of all transfers as both keep the content last transferred
+	Participant *sender = buffer->getExchange()->getSender();
+	if (commMode != SEND_RECEIVE || sender->getSegmentTags().size() > 1) {
+		compressionEnabled = false;
+	}
+
+	int64_t end = timing::now();
         commStat->addCommResourcesSetupTime(dependencyName, start, end);
 	
 	*logFile << "\tmode setup done for up-sync communicator for " << dependencyName << "\n";
@@ -342,11 +422,23 @@ void UpSyncCommunicator::sendData() {
 		int receiver = segmentGroup->getRank(receiverSegment);
 
 		if (commMode == SEND_RECEIVE) {
-			int status = MPI_Send(data, bufferSize, MPI_CHAR, receiver, 0, mpiComm);
+			// a compressed message is shorter than the buffer; the receiver learns its length from the message status
+			char *message = data;
+			long int messageLength = bufferSize;
+			if (compressionEnabled) {
+				message = getCompressor(sendBuffer)->encode(data, &messageLength);
+			}
+			int64_t start = timing::now();
+			int status = MPI_Send(message, messageLength, MPI_CHAR, receiver, 0, mpiComm);
                 	if (status != MPI_SUCCESS) {
                         	cout << "Segment "  << localSegmentTag << ": could not send update to upper level\n";
                         	exit(EXIT_FAILURE);
                 	}
+			if (compressionEnabled) {
+				int64_t end = timing::now();
+				compressor->recordTransfer(messageLength, start, end);
+				commStat->addCompressionStat(dependencyName, bufferSize, messageLength);
+			}
 		} else {
 			int status = MPI_Gatherv(data, bufferSize, MPI_CHAR, 
 					NULL, NULL, NULL, MPI_CHAR, receiver, mpiComm);
@@ -374,11 +466,17 @@ void UpSyncCommunicator::receiveData() {
 		CommBuffer *buffer = commBufferList->Nth(0);
 		char *data = buffer->getData();
 		long int bufferSize = buffer->getBufferSize();
-		int status = MPI_Recv(data, bufferSize, MPI_CHAR, MPI_ANY_SOURCE, 0, mpiComm, MPI_STATUS_IGNORE);
+		MPI_Status mpiStatus;
+		int status = MPI_Recv(data, bufferSize, MPI_CHAR, MPI_ANY_SOURCE, 0, mpiComm, &mpiStatus);
                 if (status != MPI_SUCCESS) {
                         cout << "Segment " << localSegmentTag << "could not receive up-sync update from unknown source\n";
                         exit(EXIT_FAILURE);
                 }
+		if (compressionEnabled) {
+			int messageLength;
+			MPI_Get_count(&mpiStatus, MPI_CHAR, &messageLength);
+			getCompressor(buffer)->decode(data, messageLength);
+		}
 	} else {
 		char dummyBuffer;
 		int status = MPI_Gatherv(&dummyBuffer, 0, MPI_CHAR,
@@ -479,8 +577,7 @@ void DownSyncCommunicator::setupCommunicator(bool includeNonInteractingSegments)
 	*logFile << "\tsetting up the mode for down-sync communicator for " << dependencyName << "\n";
 	logFile->flush();
 	
-	struct timeval start;
-        gettimeofday(&start, NULL);
+	int64_t start = timing::now();
 
 	int senderTag = getFirstSenderInCommunicator();
 	if (senderTag == localSegmentTag) {
@@ -509,9 +606,13 @@ void DownSyncCommunicator::setupCommunicator(bool includeNonInteractingSegments)
 		}
 		commMode = (scatter == 1) ? SCATTER_V : BROADCAST;
 	}
+
+	// a compressed broadcast is decoded against the content last broadcast; so it needs a fixed broadcaster
+	if (commMode != BROADCAST || replicated) {
+		compressionEnabled = false;
+	}
 	
-	struct timeval end;
-        gettimeofday(&end, NULL);
+	int64_t end = timing::now();
         commStat->addCommResourcesSetupTime(dependencyName, start, end);
 	
 	*logFile << "\tmode setup done for down-sync communicator for " << dependencyName << "\n";
@@ -539,7 +640,22 @@ void DownSyncCommunicator::sendData() {
 		if (!exchange->isIntraSegmentExchange(localSegmentTag)) {
 			char *data = buffer->getData();
 			long int bufferSize = buffer->getBufferSize();
-			int status = MPI_Bcast(data, bufferSize, MPI_CHAR, myRank, mpiComm);
+			int status;
+			if (compressionEnabled) {
+				// the receivers need the message length before they can receive the message
+				long int messageLength;
+				char *message = getCompressor(buffer)->encode(data, &messageLength);
+				int64_t start = timing::now();
+				status = MPI_Bcast(&messageLength, 1, MPI_LONG, myRank, mpiComm);
+				if (status == MPI_SUCCESS) {
+					status = MPI_Bcast(message, messageLength, MPI_CHAR, myRank, mpiComm);
+				}
+				int64_t end = timing::now();
+				compressor->recordTransfer(messageLength, start, end);
+				commStat->addCompressionStat(dependencyName, bufferSize, messageLength);
+			} else {
+				status = MPI_Bcast(data, bufferSize, MPI_CHAR, myRank, mpiComm);
+			}
 			if (status != MPI_SUCCESS) {
 				cout << "Segment " << localSegmentTag;
 				cout << ": could not broadcast update to lower level LPS\n";
@@ -582,11 +698,21 @@ void DownSyncCommunicator::receiveData() {
 	}
 	
 	if (commMode == BROADCAST) {
-		int status = MPI_Bcast(data, bufferSize, MPI_CHAR, sender, mpiComm);
+		long int messageLength = bufferSize;
+		int status = MPI_SUCCESS;
+		if (compressionEnabled) {
+			status = MPI_Bcast(&messageLength, 1, MPI_LONG, sender, mpiComm);
+		}
+		if (status == MPI_SUCCESS) {
+			status = MPI_Bcast(data, messageLength, MPI_CHAR, sender, mpiComm);
+		}
 		if (status != MPI_SUCCESS) {
 			cout << "Segment " << localSegmentTag << ": did not receive broadcast update on down-sync\n";
 			exit(EXIT_FAILURE);
 		}
+		if (compressionEnabled) {
+			getCompressor(buffer)->decode(data, messageLength);
+		}
 	} else {
 		int status = MPI_Scatterv(NULL, NULL, NULL, MPI_CHAR, data, bufferSize, MPI_CHAR, sender, mpiComm);
                 if (status != MPI_SUCCESS) {
@@ -736,6 +862,9 @@ CrossSyncCommunicator::CrossSyncCommunicator(int localSegmentTag,
 			dependencyName, localSenderPpus, localReceiverPpus) {
 
 	this->commBufferList = bufferList;
+	List<CommBuffer*> *receiveBuffers = getFilteredList(true);
+	this->receiving = (receiveBuffers->NumElements() > 0);
+	delete receiveBuffers;
 }
 
 void CrossSyncCommunicator::setupCommunicator(bool includeNonInteractingSegments) {
@@ -21,16 +21,37 @@ enum CommMode {	BROADCAST,
 
 // communicator class for the scenario of synchronization a replicated data among the LPUs for a single LPS 
 class ReplicationSyncCommunicator : public Communicator {
+  private:
+	// when the replicated data is held in node shared memory, an update is transferred only among the nodes and the 
+	// segments of a node just synchronize to see the update in the shared copy
+	bool nodeSharedReplica;
   public:
 	ReplicationSyncCommunicator(int localSegmentTag, 
 		const char *dependencyName, 
 		int localSenderPpus, int localReceiverPpus, List<CommBuffer*> *bufferList);
 
+	void setNodeSharedReplica(bool nodeSharedReplica) { this->nodeSharedReplica = nodeSharedReplica; }
+	void setupCommunicator(bool includeNonInteractingSegments);
+
 	void sendData();
         void receiveData();
 	
 	// sender should not wait on receive; this override ensures that
 	void afterSend() { iterationNo++; }
+
+	// in the node-aware mode, the leader of a node that received the update writes it in the shared copy before the
+	// rest of the node proceeds; so there is nothing left to do after the transfer
+	void perfromRecvPostprocessing(int currentPpuOrder, int participantsCount) {
+		if (!isNodeAware()) processBuffersAfterReceive(currentPpuOrder, participantsCount);
+	}
+  private:
+	bool isNodeAware() { return nodeSharedReplica && segmentGroup->isNodeAware(); }
+	// Carries out the transfer of an update from the broadcaster in the node-aware mode. Segments on the node of the
+	// broadcaster only synchronize, apart from their leader that broadcasts the update to the leaders of other nodes.
+	// Those leaders write the update in the shared copies of their nodes before the rest of their nodes proceed. 
+	void transferAmongNodes(int broadcaster);
+	// makes the updates on the node shared copy of the data visible to all segments of the node
+	void synchronizeNode();
 };
 
 // communicator class for the scenario of synchronizing overlapping boundary regions among LPUs of a single LPS
@@ -61,6 +82,13 @@ class GhostRegionSyncCommunicator : public Communicator {
 	// any segment that sends ghost-region update to someone else receives updates back; so we can combine send-receive
 	// within a single function and let the later receive call to be non-halting 
 	void afterSend() { iterationNo++; }
+
+	// as the transfer is complete by the time the send barrier releases the PPUs, and the senders and receivers of a
+	// ghost region sync are the same PPUs, there is no need for the receiving PPUs to meet on the receive barrier
+	bool shouldWaitOnReceive(SignalType receiveSignal, int iteration) { return false; }
+
+	// Buffers whose content did not change since they were last sent are sent as empty messages in the delta mode;
+	// so the receivers skip writing them. This makes ghost regions that are rarely updated nearly free to keep in sync.
 	void performTransfer();
 };
 
@@ -152,11 +180,18 @@ class DownSyncCommunicator : public Communicator {
 // communicator class for the scenario where LPUs of two different LPSes that are not hierarchically related needs to be
 // synchronized after an update done on one LPS	 
 class CrossSyncCommunicator : public Communicator {
+  private:
+	// a flag indicating that the current segment receives data in some of the buffers of the communicator
+	bool receiving;
   public:
 	CrossSyncCommunicator(int localSegmentTag,
                 const char *dependencyName,
                 int localSenderPpus, int localReceiverPpus, List<CommBuffer*> *bufferList);
 
+	// reception involves neither communication nor buffer processing if the segment is not receiving any data; so the
+	// receiving PPUs can bypass the receive barrier in that case
+	bool shouldWaitOnReceive(SignalType receiveSignal, int iteration) { return receiving; }
+
 	// like ghost region sync, cross-sync does not need a new MPI communicator; so this override uses the default MPI
 	// communicator
 	void setupCommunicator(bool includeNonInteractingSegments);
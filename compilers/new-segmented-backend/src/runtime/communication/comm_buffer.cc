@@ -5,6 +5,7 @@
 
 #include "../memory-management/allocation.h"
 #include "../memory-management/part_tracking.h"
+#include "../common/work_queue.h"
 
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/binary_search.h"
@@ -37,6 +38,31 @@ CommBuffer::CommBuffer(DataExchange *exchange, SyncConfig *syncConfig) {
 	receiverDataConfig = confinementConfig->getReceiverConfig();
 
 	bufferTag = 0;
+	lastSentContent = NULL;
+	contentUnchanged = false;
+}
+
+CommBuffer::~CommBuffer() {
+	if (lastSentContent != NULL) delete[] lastSentContent;
+}
+
+bool CommBuffer::isDeltaModeApplicable() {
+	if (senderPartList != NULL && senderPartList->getEpochCount() > 1) return false;
+	if (receiverPartList != NULL && receiverPartList->getEpochCount() > 1) return false;
+	return true;
+}
+
+bool CommBuffer::isContentUnchangedSinceLastSend() {
+	char *data = getData();
+	long int bufferSize = getBufferSize();
+	if (lastSentContent == NULL) {
+		lastSentContent = new char[bufferSize];
+		memcpy(lastSentContent, data, bufferSize);
+		return false;
+	}
+	if (memcmp(lastSentContent, data, bufferSize) == 0) return true;
+	memcpy(lastSentContent, data, bufferSize);
+	return false;
 }
 
 bool CommBuffer::isSendActivated() {
@@ -87,6 +113,7 @@ void CommBuffer::setBufferTag(int prefix, int digitsForSegment) {
 PreprocessedCommBuffer::PreprocessedCommBuffer(DataExchange *ex, SyncConfig *sC) : CommBuffer(ex, sC) {
 	senderTransferMapping = NULL;
 	receiverTransferMapping = NULL;
+	transferKernels = NULL;
 	if (isSendActivated()) {
 		senderTransferMapping = new char*[elementCount];
 		setupMappingBuffer(senderTransferMapping, senderPartList, senderTree, senderDataConfig);
@@ -102,6 +129,53 @@ PreprocessedCommBuffer::~PreprocessedCommBuffer() {
 	if (receiverTransferMapping != NULL) delete[] receiverTransferMapping;
 }
 
+void PreprocessedCommBuffer::setTransferKernels(TransferKernels *transferKernels) {
+	this->transferKernels = transferKernels;
+	setupTransferRuns(transferKernels->contiguousRunsOnly);
+	if (senderTransferMapping != NULL) delete[] senderTransferMapping;
+	if (receiverTransferMapping != NULL) delete[] receiverTransferMapping;
+	senderTransferMapping = NULL;
+	receiverTransferMapping = NULL;
+}
+
+void PreprocessedCommBuffer::setupTransferRuns(bool contiguousOnly) {
+	if (senderTransferMapping != NULL) {
+		formRuns(senderTransferMapping, senderRuns, contiguousOnly);
+	}
+	if (receiverTransferMapping != NULL) {
+		formRuns(receiverTransferMapping, receiverRuns, contiguousOnly);
+	}
+}
+
+void PreprocessedCommBuffer::formRuns(char **locations, std::vector<StridedRun> &runs, bool contiguousOnly) {
+	long int i = 0;
+	while (i < elementCount) {
+		StridedRun run;
+		run.location = locations[i];
+		run.stride = elementSize;
+		run.bufferIndex = i;
+		run.length = 1;
+		if (i + 1 < elementCount) {
+			long int stride = locations[i + 1] - locations[i];
+			bool strideUsable = (stride == elementSize);
+			
+			// a non-unit stride is only taken when it repeats; otherwise a lone element before a contiguous 
+			// sequence would steal the sequence's first element
+			if (!strideUsable && !contiguousOnly && stride != 0 && stride % elementSize == 0) {
+				strideUsable = (i + 2 < elementCount && locations[i + 2] - locations[i + 1] == stride);
+			}
+			if (strideUsable) {
+				long int j = i + 1;
+				while (j < elementCount && locations[j] - locations[j - 1] == stride) j++;
+				run.stride = stride;
+				run.length = j - i;
+			}
+		}
+		runs.push_back(run);
+		i += run.length;
+	}
+}
+
 void PreprocessedCommBuffer::setupMappingBuffer(char **buffer,
 		DataPartsList *dataPartList,
 		PartIdContainer *partContainerTree,
@@ -117,13 +191,13 @@ void PreprocessedCommBuffer::setupMappingBuffer(char **buffer,
 	ExchangeIterator *iterator = getIterator();
 	long int elementIndex = 0;
 	TransferLocationSpec *transferSpec = new TransferLocationSpec(elementSize);
+	int runLength;
 	while (iterator->hasMoreElements()) {
-		vector<int> *dataItemIndex = iterator->getNextElement();
-		dataPartSpec->initPartTraversalReference(dataItemIndex, transformVector);
+		vector<int> *runStart = iterator->getNextRun(elementCount - elementIndex, &runLength);
 		transferSpec->setBufferLocation(&buffer[elementIndex]);
-		partContainerTree->transferData(transformVector, 
-				transferSpec, dataPartSpec, false, std::cout);
-		elementIndex++;
+		partContainerTree->transferRun(transformVector, 
+				transferSpec, dataPartSpec, runStart, runLength);
+		elementIndex += runLength;
 	}
 
 	delete dataPartSpec;
@@ -189,13 +263,13 @@ void IndexMappedCommBuffer::setupMappingBuffer(DataPartIndexList *indexMappingBu
 
 	ExchangeIterator *iterator = getIterator();
 	long int elementIndex = 0;
+	int runLength;
 	while (iterator->hasMoreElements()) {
-		vector<int> *dataItemIndex = iterator->getNextElement();
-		dataPartSpec->initPartTraversalReference(dataItemIndex, transformVector);
+		vector<int> *runStart = iterator->getNextRun(elementCount - elementIndex, &runLength);
 		transferSpec->setPartIndexListReference(&indexMappingBuffer[elementIndex]);
-		partContainerTree->transferData(transformVector, 
-				transferSpec, dataPartSpec, false, std::cout);
-		elementIndex++;
+		partContainerTree->transferRun(transformVector, 
+				transferSpec, dataPartSpec, runStart, runLength);
+		elementIndex += runLength;
 	}
 
 	delete dataPartSpec;
@@ -262,28 +336,27 @@ void PhysicalCommBuffer::transferData(TransferSpec *transferSpec,
 	long int elementIndex = 0;
 	long int transferRequests = 0;
 	long int transferCount = 0;
+	int runLength;
 	while (iterator->hasMoreElements()) {
-		vector<int> *dataItemIndex = iterator->getNextElement();
+		vector<int> *runStart = iterator->getNextRun(elementCount - elementIndex, &runLength);
 		if (loggingEnabled) {
 			logFile << "\t\tTransfer Request for: (";
-			for (int i = 0; i < dataItemIndex->size(); i++) {
+			for (int i = 0; i < runStart->size(); i++) {
 				if (i > 0) logFile << ',';
-				logFile << dataItemIndex->at(i);
+				logFile << runStart->at(i);
 			}
-			logFile << ")\n";
+			logFile << ") Run Length: " << runLength << "\n";
 		}
-		dataPartSpec->initPartTraversalReference(dataItemIndex, transformVector);
 		char *dataLocation = data + elementIndex * elementSize;
-		transferSpec->setBufferEntry(dataLocation, dataItemIndex);
-		int elementTransfers = partTree->transferData(transformVector, 
-				transferSpec, 
-				dataPartSpec, loggingEnabled, logFile, 3);
+		transferSpec->setBufferEntry(dataLocation, runStart);
+		int elementTransfers = partTree->transferRun(transformVector, 
+				transferSpec, dataPartSpec, runStart, runLength);
 		if (loggingEnabled) {
 			logFile << "\t\tData Transfers for Request: ";
 			logFile << elementTransfers << "\n";
 		}
-		elementIndex++;
-		transferRequests++;
+		elementIndex += runLength;
+		transferRequests += runLength;
 		transferCount += elementTransfers;
 	}
 	delete transformVector;
@@ -307,6 +380,10 @@ PreprocessedPhysicalCommBuffer::PreprocessedPhysicalCommBuffer(DataExchange *exc
 }
 
 void PreprocessedPhysicalCommBuffer::readData(bool loggingEnabled, std::ostream &logFile) {
+	if (transferKernels != NULL) {
+		if (!senderRuns.empty()) transferKernels->pack(&senderRuns[0], senderRuns.size(), data);
+		return;
+	}
 	for (long int i = 0; i < elementCount; i++) {
 		char *readLocation = senderTransferMapping[i];
 		char *writeLocation = data + i * elementSize;
@@ -315,6 +392,10 @@ void PreprocessedPhysicalCommBuffer::readData(bool loggingEnabled, std::ostream
 }
 
 void PreprocessedPhysicalCommBuffer::writeData(bool loggingEnabled, std::ostream &logFile) {
+	if (transferKernels != NULL) {
+		if (!receiverRuns.empty()) transferKernels->unpack(data, &receiverRuns[0], receiverRuns.size());
+		return;
+	}
 	for (long int i = 0; i < elementCount; i++) {
 		char *readLocation = data + i * elementSize;
 		char *writeLocation = receiverTransferMapping[i];
@@ -463,6 +544,9 @@ void SwiftIndexMappedPhysicalCommBuffer::setupSwiftIndexMapping(DataPartIndexLis
 
 //------------------------------------------------- Virtual Communication Buffer -------------------------------------------------/
 
+// the maximum number of consecutive elements moved from the sender to the receiver side at once through the data entry
+const int Virtual_Buffer_Run_Limit = 1024;
+
 void VirtualCommBuffer::readData(bool loggingEnabled, std::ostream &logFile) {
 	if (isReceiveActivated()) {
 		if (loggingEnabled) {
@@ -478,7 +562,7 @@ void VirtualCommBuffer::readData(bool loggingEnabled, std::ostream &logFile) {
 
 		Assert(senderDataConfig != receiverDataConfig);
 
-		char *dataEntry = new char[elementSize];
+		char *dataEntry = new char[Virtual_Buffer_Run_Limit * elementSize];
 
 		vector<XformedIndexInfo*> *transformVector = new vector<XformedIndexInfo*>;
 		transformVector->reserve(dataDimensions);
@@ -491,42 +575,39 @@ void VirtualCommBuffer::readData(bool loggingEnabled, std::ostream &logFile) {
 		long int writeCount = 0;
 
 		ExchangeIterator *iterator = getIterator();
+		int runLength;
 		while (iterator->hasMoreElements()) {
 
-			// get the next data item index from the iterator
-			vector<int> *dataItemIndex = iterator->getNextElement();
+			// get the next run of consecutive data item indexes from the iterator
+			vector<int> *runStart = iterator->getNextRun(Virtual_Buffer_Run_Limit, &runLength);
 			if (loggingEnabled) {
 				logFile << "\t\tTransfer Request for: (";
-				for (int i = 0; i < dataItemIndex->size(); i++) {
+				for (int i = 0; i < runStart->size(); i++) {
 					if (i > 0) logFile << ',';
-					logFile << dataItemIndex->at(i);
+					logFile << runStart->at(i);
 				}
-				logFile << ")\n";
+				logFile << ") Run Length: " << runLength << "\n";
 			}
 
-			// traverse the sender tree and copy data from appropriate location in the the data-entry
-			readTransferSpec->setBufferEntry(dataEntry, dataItemIndex);
-			readPartSpec->initPartTraversalReference(dataItemIndex, transformVector);
-			int elementsRead = senderTree->transferData(transformVector, 
-					readTransferSpec, 
-					readPartSpec, loggingEnabled, logFile, 3);
+			// traverse the sender tree and copy data from appropriate locations in the the data-entry
+			readTransferSpec->setBufferEntry(dataEntry, runStart);
+			int elementsRead = senderTree->transferRun(transformVector, 
+					readTransferSpec, readPartSpec, runStart, runLength);
 			if (loggingEnabled) {
 				logFile << "\t\tElements Read: " << elementsRead << "\n";
 			}
 			readCount += elementsRead;
 
-			// then write the data-entry in the appropriate location on the other side the same way
-			writeTransferSpec->setBufferEntry(dataEntry, dataItemIndex);
-			writePartSpec->initPartTraversalReference(dataItemIndex, transformVector);
-			int elementsWritten = receiverTree->transferData(transformVector, 
-					writeTransferSpec, 
-					writePartSpec, loggingEnabled, logFile, 3);
+			// then write the data-entry in the appropriate locations on the other side the same way
+			writeTransferSpec->setBufferEntry(dataEntry, runStart);
+			int elementsWritten = receiverTree->transferRun(transformVector, 
+					writeTransferSpec, writePartSpec, runStart, runLength);
 			if (loggingEnabled) {
 				logFile << "\t\tElements written: " << elementsWritten << "\n";
 			}
 			writeCount += elementsWritten;
 
-			transferRequests++;
+			transferRequests += runLength;
 		}
 		
 		if (loggingEnabled) {
@@ -541,13 +622,57 @@ void VirtualCommBuffer::readData(bool loggingEnabled, std::ostream &logFile) {
 		delete writePartSpec;
 		delete writeTransferSpec;
 		delete transformVector;
-		delete dataEntry;
+		delete[] dataEntry;
 	}
 }
 
 //------------------------------------------- Pre-processed Virtual Communication Buffer -----------------------------------------/
 
+void PreprocessedVirtualCommBuffer::setupTransferRuns(bool contiguousOnly) {
+	if (senderTransferMapping == NULL || receiverTransferMapping == NULL) return;
+	long int i = 0;
+	while (i < elementCount) {
+		StridedRunPair run;
+		run.source = senderTransferMapping[i];
+		run.sourceStride = elementSize;
+		run.destination = receiverTransferMapping[i];
+		run.destinationStride = elementSize;
+		run.length = 1;
+		if (i + 1 < elementCount) {
+			long int sourceStride = senderTransferMapping[i + 1] - senderTransferMapping[i];
+			long int destinationStride = receiverTransferMapping[i + 1] - receiverTransferMapping[i];
+			bool stridesUsable = (sourceStride == elementSize && destinationStride == elementSize);
+			if (!stridesUsable && !contiguousOnly 
+					&& sourceStride != 0 && sourceStride % elementSize == 0
+					&& destinationStride != 0 && destinationStride % elementSize == 0) {
+				stridesUsable = (i + 2 < elementCount
+						&& senderTransferMapping[i + 2] - senderTransferMapping[i + 1] == sourceStride
+						&& receiverTransferMapping[i + 2] - receiverTransferMapping[i + 1] 
+								== destinationStride);
+			}
+			if (stridesUsable) {
+				long int j = i + 1;
+				while (j < elementCount 
+						&& senderTransferMapping[j] - senderTransferMapping[j - 1] == sourceStride
+						&& receiverTransferMapping[j] - receiverTransferMapping[j - 1] 
+								== destinationStride) {
+					j++;
+				}
+				run.sourceStride = sourceStride;
+				run.destinationStride = destinationStride;
+				run.length = j - i;
+			}
+		}
+		copyRuns.push_back(run);
+		i += run.length;
+	}
+}
+
 void PreprocessedVirtualCommBuffer::readData(bool loggingEnabled, std::ostream &logFile) {
+	if (transferKernels != NULL) {
+		if (!copyRuns.empty()) transferKernels->copy(&copyRuns[0], copyRuns.size());
+		return;
+	}
 	for (long int i = 0; i < elementCount; i++) {
 		char *readLocation = senderTransferMapping[i];
 		char *writeLocation = receiverTransferMapping[i];
@@ -740,6 +865,61 @@ void SwiftIndexMappedVirtualCommBuffer::generateSwiftIndexMappings() {
 	}
 }
 
+//------------------------------------------------ Communication Buffer Constructor ----------------------------------------------/
+
+CommBufferConstructor::CommBufferConstructor(List<DataExchange*> *exchangeList, 
+		SyncConfig *syncConfig, int localSegmentTag, bool indexMapped) {
+	this->exchangeList = exchangeList;
+	this->syncConfig = syncConfig;
+	this->localSegmentTag = localSegmentTag;
+	this->indexMapped = indexMapped;
+	this->transferKernels = NULL;
+	this->buffers = NULL;
+}
+
+List<CommBuffer*> *CommBufferConstructor::constructBuffers(int threadCount) {
+	
+	int bufferCount = exchangeList->NumElements();
+	buffers = new CommBuffer*[bufferCount];
+	WorkQueue workQueue(bufferCount, constructBuffer, (void*) this);
+	workQueue.process(threadCount);
+
+	List<CommBuffer*> *bufferList = new List<CommBuffer*>;
+	Assert(bufferList != NULL);
+	for (int i = 0; i < bufferCount; i++) {
+		bufferList->Append(buffers[i]);
+	}
+	delete[] buffers;
+	buffers = NULL;
+	return bufferList;
+}
+
+void CommBufferConstructor::constructBuffer(int exchangeNo, void *constructor) {
+	
+	CommBufferConstructor *self = (CommBufferConstructor*) constructor;
+	DataExchange *exchange = self->exchangeList->Nth(exchangeNo);
+	SyncConfig *syncConfig = self->syncConfig;
+	CommBuffer *buffer = NULL;
+	if (exchange->isIntraSegmentExchange(self->localSegmentTag)) {
+		if (self->indexMapped) {
+			buffer = new SwiftIndexMappedVirtualCommBuffer(exchange, syncConfig);
+		} else {
+			buffer = new PreprocessedVirtualCommBuffer(exchange, syncConfig);
+		}
+	} else {
+		if (self->indexMapped) {
+			buffer = new SwiftIndexMappedPhysicalCommBuffer(exchange, syncConfig);
+		} else {
+			buffer = new PreprocessedPhysicalCommBuffer(exchange, syncConfig);
+		}
+	}
+	Assert(buffer != NULL);
+	if (!self->indexMapped && self->transferKernels != NULL) {
+		((PreprocessedCommBuffer*) buffer)->setTransferKernels(self->transferKernels);
+	}
+	self->buffers[exchangeNo] = buffer;
+}
+
 //-------------------------------------------------- Communication Buffer Manager ------------------------------------------------/
 
 CommBufferManager::CommBufferManager(const char *dependencyName) {
@@ -51,6 +51,61 @@ class SyncConfig {
 	int getElementSize() { return elementSize; }
 };
 
+/* The memory locations of the elements of a data exchange are not scattered arbitrarily in the operating memory: the
+ * elements along the innermost dimension of a data part are adjacent and those along an outer dimension are a fixed
+ * number of bytes apart. So a pre-processed communication buffer groups the locations of its consecutive elements into
+ * runs, each being a sequence of elements having a fixed stride in the operating memory.
+ * */
+class StridedRun {
+  public:
+	// operating memory location of the first element of the run and the distance in bytes between two elements 
+	char *location;
+	long int stride;
+	// index of the first element of the run in the communication buffer
+	long int bufferIndex;
+	long int length;
+};
+
+/* A run of elements to be copied directly from one operating memory location to another; the two sides of the run
+ * can have different strides
+ * */
+class StridedRunPair {
+  public:
+	char *source;
+	long int sourceStride;
+	char *destination;
+	long int destinationStride;
+	long int length;
+};
+
+/* The compiler knows the element type and the dimensionality of the data structure being synchronized for a dependency.
+ * So it generates data transfer kernels for the dependency that move runs of elements between the operating memory and
+ * a communication buffer, or between two operating memory locations, using typed assignments with the element size
+ * known at compile time instead of calls to memcpy per element. If the data structure is one dimensional then all runs
+ * are contiguous and the generated kernels only handle contiguous runs; otherwise, the kernels handle strided runs with
+ * a fast path for the contiguous ones. The runs are formed from memory locations that have been identified beforehand;
+ * so communication buffers with pre-processing enabled use the kernels when they are available and the generic transfer
+ * logic otherwise. 
+ * */
+typedef void (*PackKernel)(StridedRun *runs, long int runCount, char *buffer);
+typedef void (*UnpackKernel)(char *buffer, StridedRun *runs, long int runCount);
+typedef void (*CopyKernel)(StridedRunPair *runs, long int runCount);
+
+class TransferKernels {
+  public:
+	PackKernel pack;
+	UnpackKernel unpack;
+	CopyKernel copy;
+	// indicates that the kernels can only process runs of adjacent elements
+	bool contiguousRunsOnly;
+	TransferKernels(PackKernel pack, UnpackKernel unpack, CopyKernel copy, bool contiguousRunsOnly) {
+		this->pack = pack;
+		this->unpack = unpack;
+		this->copy = copy;
+		this->contiguousRunsOnly = contiguousRunsOnly;
+	}
+};
+
 /* The base class for a communication buffer for a data exchange; remember that a data exchange is the configuration
  * of data need to be exchanges between two participating branch of a confinement for the sake of a synchronization.
  * Check the confinement_mgmt.h library for more detail.
@@ -84,12 +139,18 @@ class CommBuffer {
 	
 	// a buffer identifier to be used as tag for communications if needed
 	int bufferTag;
+
+	// In the delta mode, a sender keeps a copy of the content it last sent to skip sending the content again if it has
+	// not changed, and a receiver notes that it has been told the content did not change to skip writing it. 
+	char *lastSentContent;
+	bool contentUnchanged;
   public:
 	CommBuffer(DataExchange *exchange, SyncConfig *syncConfig);
-	virtual ~CommBuffer() {}
+	virtual ~CommBuffer();
 	DataExchange *getExchange() { return dataExchange; }
 	long int getBufferSize() { return elementCount * elementSize; }
 	long int getElementCount() { return elementCount; }
+	int getElementSize() { return elementSize; }
 	int compareTo(CommBuffer *other, bool forReceive);
 	int getBufferTag() { return bufferTag; }
 	void describe(std::ostream &stream, int indentation);
@@ -114,6 +175,14 @@ class CommBuffer {
 	// function to setup the buffer tag
 	void setBufferTag(int prefix, int digitsForSegment);
 
+	// The delta mode is only applicable to data having a single version, as the operating memory written on the
+	// receiver side otherwise changes from one epoch to the next. The first function compares the current content with
+	// the content it was last invoked with and saves the current content for the next comparison. 
+	bool isDeltaModeApplicable();
+	bool isContentUnchangedSinceLastSend();
+	void setContentUnchanged(bool contentUnchanged) { this->contentUnchanged = contentUnchanged; }
+	bool isContentUnchanged() { return contentUnchanged; }
+
 	// subclasses should return true or false depending on the type of data communication they are intended for
 	virtual bool intraSegmentBufferType() = 0;
   protected:
@@ -135,12 +204,26 @@ class PreprocessedCommBuffer : public CommBuffer {
   protected:
 	char **senderTransferMapping;
 	char **receiverTransferMapping;
+	// compiler generated transfer kernels for the dependency; this is NULL if no kernel has been provided
+	TransferKernels *transferKernels;
+	// runs of elements formed from the transfer mappings for the kernels to process
+	std::vector<StridedRun> senderRuns;
+	std::vector<StridedRun> receiverRuns;
   public:
 	PreprocessedCommBuffer(DataExchange *exchange, SyncConfig *syncConfig);
 	~PreprocessedCommBuffer();
+	
+	// setting the transfer kernels groups the memory locations of the transfer mappings into runs; the mappings are 
+	// not needed afterwards and get released
+	void setTransferKernels(TransferKernels *transferKernels);
 
 	virtual void readData(bool loggingEnabled, std::ostream &logFile) = 0;
 	virtual void writeData(bool loggingEnabled, std::ostream &logFile) = 0;
+  protected:
+	virtual void setupTransferRuns(bool contiguousOnly);
+	// a helper function to group memory locations of consecutive elements into strided runs; if contiguousOnly is set
+	// then the elements of a run must be adjacent in memory  
+	void formRuns(char **locations, std::vector<StridedRun> &runs, bool contiguousOnly);
   private:
 	// a helper function to traverse a part container tree and get all memory locations for data items that are part
 	// of the data-exchange a communication-buffer has been created for
@@ -283,12 +366,17 @@ class VirtualCommBuffer : public CommBuffer {
 /* This is the virtual communication buffer extension with pre-processing enabled
  * */
 class PreprocessedVirtualCommBuffer : public PreprocessedCommBuffer {
+  protected:
+	// elements are copied directly between operating memory locations; so runs are formed over both mappings
+	std::vector<StridedRunPair> copyRuns;
   public:
 	PreprocessedVirtualCommBuffer(DataExchange *exchange,
 			SyncConfig *syncConfig) : PreprocessedCommBuffer(exchange, syncConfig) {}
 	void readData(bool loggingEnabled, std::ostream &logFile);
 	void writeData(bool loggingEnabled, std::ostream &logFile) {}
 	virtual bool intraSegmentBufferType() { return true; }
+  protected:
+	void setupTransferRuns(bool contiguousOnly);
 };
 
 /* This is the virtual communication buffer extension with index-mapping enabled
@@ -323,6 +411,33 @@ class SwiftIndexMappedVirtualCommBuffer : public IndexMappedVirtualCommBuffer {
 	void generateSwiftIndexMappings();  
 };
 
+/* Creation of a communication buffer with pre-processing involves locating the operating memory addresses of all its
+ * elements. For large data exchanges, this is the most time consuming part of communicator setup. So this class has been
+ * provided to construct the buffers of a synchronization for its data exchanges involving the local segment in parallel.
+ * */
+class CommBufferConstructor {
+  private:
+	List<DataExchange*> *exchangeList;
+	SyncConfig *syncConfig;
+	int localSegmentTag;
+	// indicates that buffers should be mapped to data part indexes rather than to memory addresses, which is needed
+	// for data structures having multiple versions
+	bool indexMapped;
+	// the transfer kernels to be used by pre-processed buffers, if available
+	TransferKernels *transferKernels;
+	CommBuffer **buffers;
+  public:
+	CommBufferConstructor(List<DataExchange*> *exchangeList, 
+			SyncConfig *syncConfig, int localSegmentTag, bool indexMapped);
+	void setTransferKernels(TransferKernels *transferKernels) { this->transferKernels = transferKernels; }
+
+	// returns the buffers of the data exchanges in the order of the exchanges in the list using at most the argument
+	// number of threads
+	List<CommBuffer*> *constructBuffers(int threadCount);
+  private:
+	static void constructBuffer(int exchangeNo, void *constructor);
+};
+
 /* This class contains all communication buffers related to a particular data synchronization and does the buffer read
    write as part of the communication. Subclasses should provide implementation for the send() and receive() functions
    to do the actual data transfer.
@@ -0,0 +1,125 @@
+#include "comm_compression.h"
+#include "../file-io/chunked_format.h"
+#include "../common/timing.h"
+
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <stdint.h>
+
+// the tags identifying how the content of an encoded message has been transformed before encoding
+static const char Plain_Content_Tag = 1;
+static const char Xor_Delta_Tag = 2;
+
+// weight of the latest measurement in the moving averages
+static const double Measurement_Weight = 0.25;
+
+BufferCompressor::BufferCompressor(long int bufferSize, int elementSize) {
+	this->bufferSize = bufferSize;
+	this->elementSize = elementSize;
+	this->reference = NULL;
+	this->referenceValid = false;
+	this->linkSecondsPerByte = 0.0;
+	this->codingSecondsPerByte = 0.0;
+	this->compressionRatio = 1.0;
+	// start by compressing to get a measure of the compression ratio
+	this->compressing = true;
+	this->iterationsSinceProbe = 0;
+}
+
+BufferCompressor::~BufferCompressor() {
+	if (reference != NULL) delete[] reference;
+}
+
+char *BufferCompressor::encode(char *content, long int *messageLength) {
+
+	iterationsSinceProbe++;
+	if (!compressing && iterationsSinceProbe < Probe_Interval) {
+		updateReference(content);
+		*messageLength = bufferSize;
+		return content;
+	}
+	iterationsSinceProbe = 0;
+
+	int64_t start = timing::now();
+
+	const char *source = content;
+	char tag = Plain_Content_Tag;
+	if (referenceValid) {
+		delta.resize(bufferSize);
+		for (long int i = 0; i < bufferSize; i++) {
+			delta[i] = content[i] ^ reference[i];
+		}
+		source = &delta[0];
+		tag = Xor_Delta_Tag;
+	}
+	chunkedio::encodeShuffleRle(source, bufferSize, elementSize, encoded);
+	long int encodedLength = 1 + encoded.size();
+	updateReference(content);
+
+	double codingTime = timing::elapsedSeconds(start, timing::now());
+	codingSecondsPerByte = (1 - Measurement_Weight) * codingSecondsPerByte 
+			+ Measurement_Weight * codingTime / bufferSize;
+	double ratio = ((double) encodedLength) / bufferSize;
+	compressionRatio = (1 - Measurement_Weight) * compressionRatio + Measurement_Weight * ratio;
+
+	// the content is sent raw if it does not compress at all
+	if (encodedLength >= bufferSize) {
+		compressing = false;
+		*messageLength = bufferSize;
+		return content;
+	}
+
+	// keep compressing only if the transfer time saved pays for encoding and decoding, decoding being about as costly
+	// as encoding; without a measure of the link speed yet, compressing is assumed to be worthwhile
+	if (linkSecondsPerByte > 0) {
+		double savedTime = (bufferSize - encodedLength) * linkSecondsPerByte;
+		compressing = savedTime > 2 * codingTime;
+	}
+
+	message.resize(encodedLength);
+	message[0] = tag;
+	memcpy(&message[1], &encoded[0], encoded.size());
+	*messageLength = encodedLength;
+	return &message[0];
+}
+
+void BufferCompressor::decode(char *content, long int messageLength) {
+
+	if (messageLength == bufferSize) {
+		updateReference(content);
+		return;
+	}
+
+	// the message is at the beginning of the content; so it should be moved aside before decoding
+	char tag = content[0];
+	message.assign(content + 1, content + messageLength);
+	if (!chunkedio::decodeShuffleRle(&message[0], messageLength - 1, elementSize, content, bufferSize)) {
+		std::cout << "could not decode compressed communication buffer content\n";
+		std::exit(EXIT_FAILURE);
+	}
+	if (tag == Xor_Delta_Tag) {
+		for (long int i = 0; i < bufferSize; i++) {
+			content[i] ^= reference[i];
+		}
+	}
+	updateReference(content);
+}
+
+void BufferCompressor::recordTransfer(long int messageLength, int64_t start, int64_t end) {
+	if (messageLength <= 0) return;
+	double secondsPerByte = timing::elapsedSeconds(start, end) / messageLength;
+	if (linkSecondsPerByte == 0.0) {
+		linkSecondsPerByte = secondsPerByte;
+	} else {
+		linkSecondsPerByte = (1 - Measurement_Weight) * linkSecondsPerByte 
+				+ Measurement_Weight * secondsPerByte;
+	}
+}
+
+void BufferCompressor::updateReference(char *content) {
+	if (reference == NULL) reference = new char[bufferSize];
+	memcpy(reference, content, bufferSize);
+	referenceValid = true;
+}
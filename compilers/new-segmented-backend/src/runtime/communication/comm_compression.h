@@ -0,0 +1,61 @@
+#ifndef _H_comm_compression
+#define _H_comm_compression
+
+/* This header provides an optional lossless compression stage for the content of communication buffers that are sent
+ * across segments. It is meant for large transfers over bandwidth-bound links, e.g., the up-sync and down-sync of the
+ * plates of a stencil computation whose values change slowly from one iteration to the next.
+ *
+ * Both ends of a transfer keep the content last transferred through the buffer. The sender encodes the XOR of the new
+ * content with that, which is mostly zero bytes for slowly changing data, using the byte-shuffle and run-length codec
+ * of the chunked file format. A message shorter than the buffer is an encoded message that starts with a codec tag; a
+ * message as long as the buffer is the raw content. So a receiver always receives a message in the buffer itself and
+ * then decodes it in place if needed.
+ *
+ * The sender decides adaptively whether to compress: it compresses as long as the estimated transfer time saved by the
+ * smaller message exceeds the time spent on encoding and decoding, and otherwise sends the raw content and tries again
+ * after some iterations to see if the data has become more compressible.
+ */
+
+#include <vector>
+#include <stdint.h>
+
+class BufferCompressor {
+  private:
+	long int bufferSize;
+	int elementSize;
+	// the content last transferred through the buffer
+	char *reference;
+	bool referenceValid;
+	// scratch spaces for the XOR-delta, the encoded content, and the message
+	std::vector<char> delta;
+	std::vector<char> encoded;
+	std::vector<char> message;
+
+	// moving averages of measured link and codec performance and the compression ratio achieved
+	double linkSecondsPerByte;
+	double codingSecondsPerByte;
+	double compressionRatio;
+	bool compressing;
+	int iterationsSinceProbe;
+  public:
+	// the number of iterations after which a sender that stopped compressing tries compressing again
+	static const int Probe_Interval = 16;
+
+	BufferCompressor(long int bufferSize, int elementSize);
+	~BufferCompressor();
+
+	// Returns the message to be sent for the argument content and its length in the second argument. The returned
+	// message is the content itself when the content is sent raw.
+	char *encode(char *content, long int *messageLength);
+
+	// reconstructs the content, in place, from a message of the argument length received at its beginning
+	void decode(char *content, long int messageLength);
+
+	// senders should report the time spent transferring each message for the link bandwidth estimate
+	void recordTransfer(long int messageLength, int64_t start, int64_t end);
+	double getCompressionRatio() { return compressionRatio; }
+  private:
+	void updateReference(char *content);
+};
+
+#endif
@@ -4,11 +4,11 @@
 #include <string>
 #include <cstdlib>
 #include <stdio.h>
-#include <time.h>
-#include <sys/time.h>
+#include <stdint.h>
 #include <pthread.h>
 
 #include "comm_statistics.h"
+#include "../common/timing.h"
 
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/utility.h"
@@ -16,16 +16,26 @@
 
 CommStatistics::CommStatistics() {
 	commDependencyNames = new List<const char*>;
-        confinementConstrTimeMap = new Hashtable<double*>;
-        bufferSetupTimeMap = new Hashtable<double*>;
-        commResourcesSetupTimeMap = new Hashtable<double*>;
-        bufferReadTimeMap = new Hashtable<double*>;
-        communicationTimeMap = new Hashtable<double*>;
-        bufferWriteTimeMap = new Hashtable<double*>;
+        confinementConstrTimeMap = new Hashtable<timing::TimeAccumulator*>;
+        bufferSetupTimeMap = new Hashtable<timing::TimeAccumulator*>;
+        commResourcesSetupTimeMap = new Hashtable<timing::TimeAccumulator*>;
+        bufferReadTimeMap = new Hashtable<timing::TimeAccumulator*>;
+        communicationTimeMap = new Hashtable<timing::TimeAccumulator*>;
+        bufferWriteTimeMap = new Hashtable<timing::TimeAccumulator*>;
+	barrierWaitTimeMap = new Hashtable<timing::TimeAccumulator*>;
+	rawBytesMap = new Hashtable<int64_t*>;
+	wireBytesMap = new Hashtable<int64_t*>;
 	pthread_mutex_init(&mutex, NULL);
 }
 
 CommStatistics::~CommStatistics() {
+	deleteAccumulators(confinementConstrTimeMap);
+	deleteAccumulators(bufferSetupTimeMap);
+	deleteAccumulators(commResourcesSetupTimeMap);
+	deleteAccumulators(bufferReadTimeMap);
+	deleteAccumulators(communicationTimeMap);
+	deleteAccumulators(bufferWriteTimeMap);
+	deleteAccumulators(barrierWaitTimeMap);
 	delete commDependencyNames;
         delete confinementConstrTimeMap;
         delete bufferSetupTimeMap;
@@ -33,116 +43,156 @@ CommStatistics::~CommStatistics() {
 	delete bufferReadTimeMap;
         delete communicationTimeMap;
 	delete bufferWriteTimeMap;
+	delete barrierWaitTimeMap;
+	delete rawBytesMap;
+	delete wireBytesMap;
 	pthread_mutex_destroy(&mutex);
 }
 
 void CommStatistics::enlistDependency(const char *dependency) {
-	
+
 	pthread_mutex_lock(&mutex);
-	
+
 	commDependencyNames->Append(dependency);
-	double *cCTime = new double;
-	*cCTime = 0.0;
-        confinementConstrTimeMap->Enter(dependency, cCTime);
-	double *bSTime = new double;
-	*bSTime = 0.0;
-        bufferSetupTimeMap->Enter(dependency, bSTime);
-	double *cRSTime = new double;
-	*cRSTime = 0.0;
-        commResourcesSetupTimeMap->Enter(dependency, cRSTime);
-	double *bRTime = new double;
-	*bRTime = 0.0;
-        bufferReadTimeMap->Enter(dependency, bRTime);
-	double *cTime = new double;
-	*cTime = 0.0;
-        communicationTimeMap->Enter(dependency, cTime);
-	double *bWTime = new double;
-	*bWTime = 0.0;
-        bufferWriteTimeMap->Enter(dependency, bWTime);
+        confinementConstrTimeMap->Enter(dependency, new timing::TimeAccumulator());
+        bufferSetupTimeMap->Enter(dependency, new timing::TimeAccumulator());
+        commResourcesSetupTimeMap->Enter(dependency, new timing::TimeAccumulator());
+        bufferReadTimeMap->Enter(dependency, new timing::TimeAccumulator());
+        communicationTimeMap->Enter(dependency, new timing::TimeAccumulator(true));
+        bufferWriteTimeMap->Enter(dependency, new timing::TimeAccumulator());
+	barrierWaitTimeMap->Enter(dependency, new timing::TimeAccumulator(true));
+	int64_t *rBytes = new int64_t;
+	*rBytes = 0;
+	rawBytesMap->Enter(dependency, rBytes);
+	int64_t *wBytes = new int64_t;
+	*wBytes = 0;
+	wireBytesMap->Enter(dependency, wBytes);
 
 	pthread_mutex_unlock(&mutex);
 }
 
-void CommStatistics::addConfinementConstrTime(const char *dependency, struct timeval &start, struct timeval &end) {
+void CommStatistics::addConfinementConstrTime(const char *dependency, int64_t start, int64_t end) {
 	recordTiming(confinementConstrTimeMap, dependency, start, end);
 }
-        
-void CommStatistics:: addBufferSetupTime(const char *dependency, struct timeval &start, struct timeval &end) {
+
+void CommStatistics:: addBufferSetupTime(const char *dependency, int64_t start, int64_t end) {
 	recordTiming(bufferSetupTimeMap, dependency, start, end);
 }
-        
-void CommStatistics::addCommResourcesSetupTime(const char *dependency, struct timeval &start, struct timeval &end) {
+
+void CommStatistics::addCommResourcesSetupTime(const char *dependency, int64_t start, int64_t end) {
 	recordTiming(commResourcesSetupTimeMap, dependency, start, end);
 }
-        
-void CommStatistics::addBufferReadTime(const char *dependency, struct timeval &start, struct timeval &end) {
+
+void CommStatistics::addBufferReadTime(const char *dependency, int64_t start, int64_t end) {
 	recordTiming(bufferReadTimeMap, dependency, start, end);
 }
 
-void CommStatistics::addCommunicationTime(const char *dependency, struct timeval &start, struct timeval &end) {
+void CommStatistics::addCommunicationTime(const char *dependency, int64_t start, int64_t end) {
 	recordTiming(communicationTimeMap, dependency, start, end);
 }
 
-void CommStatistics::addBufferWriteTime(const char *dependency, struct timeval &start, struct timeval &end) {
+void CommStatistics::addBufferWriteTime(const char *dependency, int64_t start, int64_t end) {
 	recordTiming(bufferWriteTimeMap, dependency, start, end);
 }
 
+void CommStatistics::addBarrierWaitTime(const char *dependency, int64_t start, int64_t end) {
+	recordTiming(barrierWaitTimeMap, dependency, start, end);
+}
+
+void CommStatistics::addCompressionStat(const char *dependency, long int rawBytes, long int wireBytes) {
+	__sync_fetch_and_add(rawBytesMap->Lookup(dependency), rawBytes);
+	__sync_fetch_and_add(wireBytesMap->Lookup(dependency), wireBytes);
+}
+
 void CommStatistics::logStatistics(int indentation, std::ofstream &logFile) {
 	std::ostringstream indent;
 	for (int i = 0; i < indentation; i++) indent << '\t';
 	for (int i = 0; i < commDependencyNames->NumElements(); i++) {
 		const char *dependency = commDependencyNames->Nth(i);
-		
+
 		// setup times
 		logFile << indent.str() << "Dependency: " << dependency << ":\n";
 		logFile << indent.str() << '\t' << "Confinements processing time: ";
-		logFile << *(confinementConstrTimeMap->Lookup(dependency)) << "\n";
+		logFile << confinementConstrTimeMap->Lookup(dependency)->getTotalSeconds() << "\n";
 		logFile << indent.str() << '\t' << "Buffer setup time: ";
-		logFile << *(bufferSetupTimeMap->Lookup(dependency)) << "\n";
+		logFile << bufferSetupTimeMap->Lookup(dependency)->getTotalSeconds() << "\n";
 		logFile << indent.str() << '\t' << "Communication resources setup time: ";
-		logFile << *(commResourcesSetupTimeMap->Lookup(dependency)) << "\n";
+		logFile << commResourcesSetupTimeMap->Lookup(dependency)->getTotalSeconds() << "\n";
 
 		// different parts of communication
 		logFile << indent.str() << '\t' << "Communication time: \n";
 		logFile << indent.str() << "\t\t" << "Buffer reading: ";
-		double reading = *(bufferReadTimeMap->Lookup(dependency));
+		double reading = bufferReadTimeMap->Lookup(dependency)->getTotalSeconds();
 		logFile << reading << "\n";
 		logFile << indent.str() << "\t\t" << "MPI transfer: ";
-		double communication = *(communicationTimeMap->Lookup(dependency));
+		timing::TimeAccumulator *transfers = communicationTimeMap->Lookup(dependency);
+		double communication = transfers->getTotalSeconds();
 		logFile << communication << "\n";
 		logFile << indent.str() << "\t\t" << "Buffer writing: ";
-		double writing = *(bufferWriteTimeMap->Lookup(dependency));
+		double writing = bufferWriteTimeMap->Lookup(dependency)->getTotalSeconds();
 		logFile << writing << "\n";
 		logFile << indent.str() << "\t\t" << "Total: ";
 		logFile << (reading + communication + writing) << "\n";
-	}	
+
+		// the distributions of individual transfer and barrier wait times
+		if (transfers->getCount() > 0) {
+			logFile << indent.str() << '\t' << "MPI transfers: " << transfers->getCount();
+			logFile << " p50: " << transfers->getPercentileSeconds(0.5);
+			logFile << " p99: " << transfers->getPercentileSeconds(0.99);
+			logFile << " max: " << transfers->getMaxSeconds() << "\n";
+		}
+		timing::TimeAccumulator *waits = barrierWaitTimeMap->Lookup(dependency);
+		if (waits->getCount() > 0) {
+			logFile << indent.str() << '\t' << "Barrier waits: " << waits->getCount();
+			logFile << " total: " << waits->getTotalSeconds();
+			logFile << " p50: " << waits->getPercentileSeconds(0.5);
+			logFile << " p99: " << waits->getPercentileSeconds(0.99);
+			logFile << " max: " << waits->getMaxSeconds() << "\n";
+		}
+
+		// compression is optional; so its statistics are only logged for dependencies that used it
+		double rawBytes = *(rawBytesMap->Lookup(dependency));
+		if (rawBytes > 0) {
+			double wireBytes = *(wireBytesMap->Lookup(dependency));
+			logFile << indent.str() << '\t' << "Compression: \n";
+			logFile << indent.str() << "\t\t" << "Buffer bytes: " << rawBytes << "\n";
+			logFile << indent.str() << "\t\t" << "Bytes sent: " << wireBytes << "\n";
+			logFile << indent.str() << "\t\t" << "Ratio: " << (rawBytes / wireBytes) << "\n";
+		}
+	}
 }
 
 double CommStatistics::getTotalCommunicationTime() {
-	
+
 	double bufferReadTime = 0.0;
 	double communicationTime = 0.0;
 	double bufferWriteTime = 0.0;
-	
+
 	for (int i = 0; i < commDependencyNames->NumElements(); i++) {
 		const char *dependency = commDependencyNames->Nth(i);
-		bufferReadTime += *(bufferReadTimeMap->Lookup(dependency));
-		communicationTime += *(communicationTimeMap->Lookup(dependency));
-		bufferWriteTime += *(bufferWriteTimeMap->Lookup(dependency));
+		bufferReadTime += bufferReadTimeMap->Lookup(dependency)->getTotalSeconds();
+		communicationTime += communicationTimeMap->Lookup(dependency)->getTotalSeconds();
+		bufferWriteTime += bufferWriteTimeMap->Lookup(dependency)->getTotalSeconds();
 	}
-	
+
 	return bufferReadTime + communicationTime + bufferWriteTime;
 }
 
-void CommStatistics::recordTiming(Hashtable<double*> *map, const char *dependency, 
-                struct timeval &start, 
-		struct timeval &end) {
+double CommStatistics::getCommunicationTime(const char *dependency) {
+	return bufferReadTimeMap->Lookup(dependency)->getTotalSeconds()
+			+ communicationTimeMap->Lookup(dependency)->getTotalSeconds()
+			+ bufferWriteTimeMap->Lookup(dependency)->getTotalSeconds();
+}
 
-	pthread_mutex_lock(&mutex);
-	double timeSpent = ((end.tv_sec + end.tv_usec / 1000000.0)
-                        - (start.tv_sec + start.tv_usec / 1000000.0));
-	double *timer = map->Lookup(dependency);
-	Assert(time != NULL);
-	*timer = *timer + timeSpent;
-	pthread_mutex_unlock(&mutex);
+void CommStatistics::recordTiming(Hashtable<timing::TimeAccumulator*> *map, const char *dependency,
+		int64_t start, int64_t end) {
+	timing::TimeAccumulator *accumulator = map->Lookup(dependency);
+	Assert(accumulator != NULL);
+	accumulator->add(start, end);
+}
+
+void CommStatistics::deleteAccumulators(Hashtable<timing::TimeAccumulator*> *map) {
+	for (int i = 0; i < commDependencyNames->NumElements(); i++) {
+		delete map->Lookup(commDependencyNames->Nth(i));
+	}
 }
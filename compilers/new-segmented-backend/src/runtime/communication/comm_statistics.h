@@ -6,55 +6,70 @@
 #include <string>
 #include <cstdlib>
 #include <stdio.h>
-#include <time.h>
-#include <sys/time.h>
+#include <stdint.h>
 #include <pthread.h>
 
+#include "../common/timing.h"
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/hashtable.h"
 
-// This class has been provided to track how much time different aspects of communications take at runtime. IT 
-// communicator setup includes a lot of data processing and computations. Furthermore, the actual transfer of 
+// This class has been provided to track how much time different aspects of communications take at runtime. IT
+// communicator setup includes a lot of data processing and computations. Furthermore, the actual transfer of
 // data can be more or less costly depending on the data volume and the communication mechanism. All these costs
 // needs to be analyzed to determine what aspects can be optimized or overhauled for better performance. This
-// class gathers all the statistics for such analyses.    
+// class gathers all the statistics for such analyses.
 class CommStatistics {
   protected:
-	// maps for gathering different types of timing statistic
+	// maps for gathering different types of timing statistic; the transfer times and the times PPUs wait for their
+	// peers on communicators' barriers are also kept in histograms
 	List<const char*> *commDependencyNames;
-	Hashtable<double*> *confinementConstrTimeMap;
-	Hashtable<double*> *bufferSetupTimeMap;
-	Hashtable<double*> *commResourcesSetupTimeMap;
-	Hashtable<double*> *bufferReadTimeMap;
-	Hashtable<double*> *communicationTimeMap;
-	Hashtable<double*> *bufferWriteTimeMap;
-
-	// a mutex to protect the stat object from being corrupted if multiple threads try to enter timing data 
-	//into it at the same time
+	Hashtable<timing::TimeAccumulator*> *confinementConstrTimeMap;
+	Hashtable<timing::TimeAccumulator*> *bufferSetupTimeMap;
+	Hashtable<timing::TimeAccumulator*> *commResourcesSetupTimeMap;
+	Hashtable<timing::TimeAccumulator*> *bufferReadTimeMap;
+	Hashtable<timing::TimeAccumulator*> *communicationTimeMap;
+	Hashtable<timing::TimeAccumulator*> *bufferWriteTimeMap;
+	Hashtable<timing::TimeAccumulator*> *barrierWaitTimeMap;
+	// maps for the bytes of buffer content given to compression and the bytes actually sent for them
+	Hashtable<int64_t*> *rawBytesMap;
+	Hashtable<int64_t*> *wireBytesMap;
+
+	// Recording is lock free as the accumulators can take updates from multiple threads at the same time. This mutex
+	// only protects the maps while dependencies are being enlisted.
 	pthread_mutex_t mutex;
   public:
 	CommStatistics();
 	~CommStatistics();
-	
+
 	// function to initiate entries in different maps for a particular communication dependency
 	void enlistDependency(const char *dependency);
-	
-	// functions for recording time spent on different aspects of a specific communication dependency
-	void addConfinementConstrTime(const char *dependency, struct timeval &start, struct timeval &end);	
-	void addBufferSetupTime(const char *dependency, struct timeval &start, struct timeval &end);	
-	void addCommResourcesSetupTime(const char *dependency, struct timeval &start, struct timeval &end);	
-	void addBufferReadTime(const char *dependency, struct timeval &start, struct timeval &end);
-	void addCommunicationTime(const char *dependency, struct timeval &start, struct timeval &end);
-	void addBufferWriteTime(const char *dependency, struct timeval &start, struct timeval &end);
-	
+
+	// functions for recording time spent on different aspects of a specific communication dependency; the start and
+	// end times are those returned by timing::now()
+	void addConfinementConstrTime(const char *dependency, int64_t start, int64_t end);
+	void addBufferSetupTime(const char *dependency, int64_t start, int64_t end);
+	void addCommResourcesSetupTime(const char *dependency, int64_t start, int64_t end);
+	void addBufferReadTime(const char *dependency, int64_t start, int64_t end);
+	void addCommunicationTime(const char *dependency, int64_t start, int64_t end);
+	void addBufferWriteTime(const char *dependency, int64_t start, int64_t end);
+	void addBarrierWaitTime(const char *dependency, int64_t start, int64_t end);
+
+	// function for recording the size of a buffer content sent with compression and the size of the message sent
+	void addCompressionStat(const char *dependency, long int rawBytes, long int wireBytes);
+
 	// function to be used at program's end to log the total time spent on different communication dependencies
 	void logStatistics(int indentation, std::ofstream &logFile);
 
-	// function to find the overall time the task spent on communication 
+	// function to find the overall time the task spent on communication
 	double getTotalCommunicationTime();
+
+	// functions to retrieve the time spent on the buffer read, transfer, and buffer write phases of the communica-
+	// tions of individual dependencies
+	List<const char*> *getDependencyNames() { return commDependencyNames; }
+	double getCommunicationTime(const char *dependency);
   private:
-	void recordTiming(Hashtable<double*> *map, const char *dependency, 
-			struct timeval &start, struct timeval &end);	
+	void recordTiming(Hashtable<timing::TimeAccumulator*> *map, const char *dependency, int64_t start, int64_t end);
+	void deleteAccumulators(Hashtable<timing::TimeAccumulator*> *map);
 };
 
 #endif
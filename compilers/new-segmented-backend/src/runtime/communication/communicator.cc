@@ -2,14 +2,16 @@
 #include "comm_statistics.h"
 #include "communicator.h"
 #include "comm_barrier.h"
+#include "../common/trace.h"
+#include "../common/hw_counters.h"
+#include "../common/timing.h"
 
 #include "../../../../common-libs/utils/list.h"
 
 #include <iostream>
 #include <cstdlib>
 #include <sstream>
-#include <time.h>
-#include <sys/time.h>
+#include <stdint.h>
 
 //-------------------------------------------------------------- Send Barrier ------------------------------------------------------------/
 
@@ -27,19 +29,25 @@ bool SendBarrier::shouldPerformTransfer(int activeSignalsCount, int callerIterat
 }
 
 void SendBarrier::beforeTransfer(int order, int participants) {
+	TRACE_SCOPE(trace::BUFFER_READ, communicator->getName(), -1);
+	COUNTERS_SCOPE(hwcounters::BUFFER_READ, communicator->getName(), "");
 	communicator->performSendPreprocessing(order, participants);
 }
 
 void SendBarrier::transferFunction() {
+	TRACE_SCOPE(trace::COMMUNICATION, communicator->getName(), -1);
+	COUNTERS_SCOPE(hwcounters::COMMUNICATION, communicator->getName(), "");
 	communicator->sendData();
 	communicator->afterSend();
 }
         
 void SendBarrier::afterTransfer(int order, int participants) {
+	TRACE_SCOPE(trace::BUFFER_WRITE, communicator->getName(), -1);
+	COUNTERS_SCOPE(hwcounters::BUFFER_WRITE, communicator->getName(), "");
 	communicator->performSendPostprocessing(order, participants);
 }
 
-void SendBarrier::recordTimingLog(TimingLogType logType, struct timeval &start, struct timeval &end) {
+void SendBarrier::recordTimingLog(TimingLogType logType, int64_t start, int64_t end) {
 	CommStatistics *commStat = communicator->getCommStat();
 	if (logType == BEFORE_TRANSFER_TIMING) {
 		commStat->addBufferReadTime(communicator->getName(), start, end);
@@ -47,17 +55,19 @@ void SendBarrier::recordTimingLog(TimingLogType logType, struct timeval &start,
 		commStat->addCommunicationTime(communicator->getName(), start, end);
 	} else if (logType == AFTER_TRANSFER_TIMING) {
 		commStat->addBufferWriteTime(communicator->getName(), start, end);
+	} else if (logType == BARRIER_WAIT_TIMING) {
+		commStat->addBarrierWaitTime(communicator->getName(), start, end);
 	}
 }
 
 void SendBarrier::executeSend() {
-	struct timeval start;
-        gettimeofday(&start, NULL);
+	TRACE_SCOPE(trace::COMMUNICATION, communicator->getName(), -1);
+	COUNTERS_SCOPE(hwcounters::COMMUNICATION, communicator->getName(), "");
+	int64_t start = timing::now();
 	communicator->prepareBuffersForSend();
 	communicator->sendData();
 	communicator->afterSend();
-	struct timeval end;
-        gettimeofday(&end, NULL);
+	int64_t end = timing::now();
 	CommStatistics *commStat = communicator->getCommStat();
 	commStat->addCommunicationTime(communicator->getName(), start, end);
 }
@@ -78,19 +88,25 @@ bool ReceiveBarrier::shouldPerformTransfer(int activeSignalsCount, int callerIte
 }
 
 void ReceiveBarrier::beforeTransfer(int order, int participants) {
+	TRACE_SCOPE(trace::BUFFER_READ, communicator->getName(), -1);
+	COUNTERS_SCOPE(hwcounters::BUFFER_READ, communicator->getName(), "");
 	communicator->perfromRecvPreprocessing(order, participants);
 }
 
 void ReceiveBarrier::transferFunction() {
+	TRACE_SCOPE(trace::COMMUNICATION, communicator->getName(), -1);
+	COUNTERS_SCOPE(hwcounters::COMMUNICATION, communicator->getName(), "");
 	communicator->receiveData();
 	communicator->afterReceive();
 }
 
 void ReceiveBarrier::afterTransfer(int order, int participants) {
+	TRACE_SCOPE(trace::BUFFER_WRITE, communicator->getName(), -1);
+	COUNTERS_SCOPE(hwcounters::BUFFER_WRITE, communicator->getName(), "");
 	communicator->perfromRecvPostprocessing(order, participants);
 }
 
-void ReceiveBarrier::recordTimingLog(TimingLogType logType, struct timeval &start, struct timeval &end) {
+void ReceiveBarrier::recordTimingLog(TimingLogType logType, int64_t start, int64_t end) {
 	CommStatistics *commStat = communicator->getCommStat();
 	if (logType == BEFORE_TRANSFER_TIMING) {
 		commStat->addBufferReadTime(communicator->getName(), start, end);
@@ -98,17 +114,19 @@ void ReceiveBarrier::recordTimingLog(TimingLogType logType, struct timeval &star
 		commStat->addCommunicationTime(communicator->getName(), start, end);
 	} else if (logType == AFTER_TRANSFER_TIMING) {
 		commStat->addBufferWriteTime(communicator->getName(), start, end);
+	} else if (logType == BARRIER_WAIT_TIMING) {
+		commStat->addBarrierWaitTime(communicator->getName(), start, end);
 	}
 }
 
 void ReceiveBarrier::executeReceive() {
-	struct timeval start;
-        gettimeofday(&start, NULL);
+	TRACE_SCOPE(trace::COMMUNICATION, communicator->getName(), -1);
+	COUNTERS_SCOPE(hwcounters::COMMUNICATION, communicator->getName(), "");
+	int64_t start = timing::now();
 	communicator->receiveData();
 	communicator->processBuffersAfterReceive();
 	communicator->afterReceive();
-	struct timeval end;
-        gettimeofday(&end, NULL);
+	int64_t end = timing::now();
 	CommStatistics *commStat = communicator->getCommStat();
 	commStat->addCommunicationTime(communicator->getName(), start, end);
 }
@@ -134,6 +152,10 @@ Communicator::Communicator(int localSegmentTag,
 	iterationNo = 0;
 	communicatorId = 0;
 	commStat = NULL;
+	segmentGroup = NULL;
+	participantSegments = NULL;
+	compressionEnabled = false;
+	compressor = NULL;
 }
 
 void Communicator::describe(int indentation) {
@@ -160,7 +182,12 @@ void Communicator::prepareBuffersForSend() {
 void Communicator::processBuffersAfterReceive() {
         List<CommBuffer*> *receiveBufferList = getSortedList(true);
         for (int i = 0; i < receiveBufferList->NumElements(); i++) {
-                receiveBufferList->Nth(i)->writeData(false, *logFile);
+		CommBuffer *buffer = receiveBufferList->Nth(i);
+		if (buffer->isContentUnchanged()) {
+			buffer->setContentUnchanged(false);
+			continue;
+		}
+                buffer->writeData(false, *logFile);
         }
         delete receiveBufferList;
 }
@@ -176,7 +203,13 @@ void Communicator::prepareBuffersForSend(int currentPpuOrder, int participantsCo
 void Communicator::processBuffersAfterReceive(int currentPpuOrder, int participantsCount) {
 	List<CommBuffer*> *receiveBufferList = getFilteredList(true);
         for (int i = currentPpuOrder; i < receiveBufferList->NumElements(); i += participantsCount) {
-                receiveBufferList->Nth(i)->writeData(false, *logFile);
+		// the operating memory already has the content of a buffer the sender reported as unchanged
+		CommBuffer *buffer = receiveBufferList->Nth(i);
+		if (buffer->isContentUnchanged()) {
+			buffer->setContentUnchanged(false);
+			continue;
+		}
+                buffer->writeData(false, *logFile);
         }
         delete receiveBufferList;
 }
@@ -197,24 +230,34 @@ void Communicator::setupCommunicator(bool includeNonInteractingSegments) {
 	*logFile << "\tSetting up communicator for " << dependencyName << "\n";
 	logFile->flush();
 	
-	struct timeval start;
-        gettimeofday(&start, NULL);
-	if (includeNonInteractingSegments) {
+	TRACE_TIMESTAMP(traceStart);
+	int64_t start = timing::now();
+	if (segmentGroup != NULL) {
+		*logFile << "\tReusing the segment group of an earlier invocation\n";
+	} else if (includeNonInteractingSegments) {
         	segmentGroup = new SegmentGroup(*participantSegments);
+        	segmentGroup->setupCommunicator(*logFile);
 	} else {
 		std::vector<int> *interactingParticipants = getParticipantsTags();
         	segmentGroup = new SegmentGroup(*interactingParticipants);
 		delete interactingParticipants;
+        	segmentGroup->setupCommunicator(*logFile);
 	}
-        segmentGroup->setupCommunicator(*logFile);
-	struct timeval end;
-        gettimeofday(&end, NULL);
+	int64_t end = timing::now();
 	commStat->addCommResourcesSetupTime(dependencyName, start, end);
+	TRACE_RECORD(trace::COMM_SETUP, dependencyName, -1, traceStart);
 
 	*logFile << "\tSetup done for communicator for " << dependencyName << "\n";
 	logFile->flush();
 }
 
+BufferCompressor *Communicator::getCompressor(CommBuffer *buffer) {
+	if (compressor == NULL) {
+		compressor = new BufferCompressor(buffer->getBufferSize(), buffer->getElementSize());
+	}
+	return compressor;
+}
+
 void Communicator::excludeOwnselfFromCommunication(const char *dependencyName, 
 		int localSegmentTag, std::ofstream &logFile) {
 	logFile << "\tExcluding myself from dependency " << dependencyName << "\n";
@@ -17,14 +17,14 @@
 #include "parallel_comm_barrier.h"
 #include "comm_buffer.h"
 #include "comm_statistics.h"
+#include "comm_compression.h"
 #include "mpi_group.h"
 
 #include "../../../../common-libs/utils/list.h"
 
 #include <iostream>
 #include <fstream>
-#include <time.h>
-#include <sys/time.h>
+#include <stdint.h>
 
 class Communicator;
 
@@ -42,7 +42,7 @@ class SendBarrier : public ParallelCommBarrier {
 	void beforeTransfer(int order, int participants);
         void transferFunction();
         void afterTransfer(int order, int participants);
-	void recordTimingLog(TimingLogType logType, struct timeval &start, struct timeval &end);
+	void recordTimingLog(TimingLogType logType, int64_t start, int64_t end);
 
 	// @depricated old send barrier function when communication activities were not divided into sequential and parallel parts	
 	void executeSend();
@@ -62,7 +62,7 @@ class ReceiveBarrier : public ParallelCommBarrier {
         void beforeTransfer(int order, int participants);
         void transferFunction();
         void afterTransfer(int order, int participants);	
-	void recordTimingLog(TimingLogType logType, struct timeval &start, struct timeval &end);
+	void recordTimingLog(TimingLogType logType, int64_t start, int64_t end);
 
 	// @depricated old recv barrier function when communication activities were not divided into sequential and parallel parts	
 	void executeReceive();
@@ -91,12 +91,22 @@ class Communicator : public CommBufferManager {
 	int communicatorId;
 	// a reference to the communication-statistics gatherer object to log time spent on this communicator
 	CommStatistics *commStat;
+	// communicators that transfer large buffers over slow links may compress them; the compressor is created on the first
+	// transfer as it keeps a copy of the buffer content
+	bool compressionEnabled;
+	BufferCompressor *compressor;
   public:
 	Communicator(int localSegmentTag, const char *dependencyName, int localSenderPpus, int localReceiverPpus);
 	void setLogFile(std::ofstream *logFile) { this->logFile = logFile; }
 	void setParticipants(std::vector<int> *participants) { this->participantSegments = participants; }
 	void setCommStat(CommStatistics *commStat) { this->commStat = commStat; }
 	CommStatistics *getCommStat() { return commStat; }
+	// a segment group formed in an earlier invocation of the task can be handed over to the communicator before it is set
+	// up; then setupCommunicator() uses that group instead of forming a new one
+	void setSegmentGroup(SegmentGroup *segmentGroup) { this->segmentGroup = segmentGroup; }
+	SegmentGroup *getSegmentGroup() { return segmentGroup; }
+	// only some communicator types support compression, and only in some modes; they ignore this setting otherwise
+	void setCompressionEnabled(bool compressionEnabled) { this->compressionEnabled = compressionEnabled; }
 	virtual void describe(int indentation);
 
 	// two functions to pre and post process communication buffers before a send and after a receive respectively these basically 
@@ -169,6 +179,8 @@ class Communicator : public CommBufferManager {
 	// function.
 	static void excludeOwnselfFromCommunication(const char *dependencyName, 
 		int localSegmentTag, std::ofstream &logFile);
+  protected:
+	BufferCompressor *getCompressor(CommBuffer *buffer);
 };
 
 
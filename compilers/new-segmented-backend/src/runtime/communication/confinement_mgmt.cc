@@ -892,6 +892,23 @@ vector<int> *ExchangeIterator::getNextElement() {
 	return iterator->getNextElement();
 }
 
+vector<int> *ExchangeIterator::getNextRun(long int maxLength, int *runLength) {
+	if (!iterator->hasMoreElements()) {
+		delete iterator;
+		currentSequence++;
+		if (currentSequence < sequences->NumElements()) {
+			iterator = new SequenceIterator(sequences->Nth(currentSequence));
+		} else {
+			iterator = NULL;
+			*runLength = 0;
+			return NULL;
+		}
+	}
+	vector<int> *runStart = iterator->getNextRun(maxLength, runLength);
+	currentElement += *runLength;
+	return runStart;
+}
+
 void ExchangeIterator::printNextElement(std::ostream &stream) {
 	vector<int> *element = getNextElement();
 	int dimensionality = sequences->Nth(0)->getDimensionality();
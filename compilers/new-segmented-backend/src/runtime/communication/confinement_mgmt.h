@@ -352,6 +352,10 @@ class ExchangeIterator {
 	// returns the next index point in the data exchange; returns NULL if it reaches the end of the exchange
 	std::vector<int> *getNextElement();
 
+	// returns the first index point of the next run of index points that are consecutive along the last dimension and
+	// sets the run length, which never exceeds the first argument, in the second; returns NULL at the end
+	std::vector<int> *getNextRun(long int maxLength, int *runLength);
+
 	void printNextElement(std::ostream &stream);
 };
 
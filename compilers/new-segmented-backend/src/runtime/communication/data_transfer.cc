@@ -117,6 +117,15 @@ void TransferSpec::performTransfer(DataPartIndex dataPartIndex) {
 	}
 }
 
+void TransferSpec::performRunTransfer(DataPartIndex dataPartIndex, int runLength) {
+	char *dataPartLocation = dataPartIndex.getLocation();
+	if (direction == COMM_BUFFER_TO_DATA_PART) {
+		memcpy(dataPartLocation, bufferEntry, elementSize * runLength);
+	} else {
+		memcpy(bufferEntry, dataPartLocation, elementSize * runLength);
+	}
+}
+
 bool TransferSpec::isIncludedInTransfer(int partNo, int idDimension, int partNoIdLevel, int indexInLevel) {
 	if (confinementContainerId == NULL) return true;
 	int vectorSize = confinementContainerId->size();
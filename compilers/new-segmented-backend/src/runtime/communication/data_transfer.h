@@ -142,13 +142,22 @@ class TransferSpec {
 	TransferDirection getDirection() { return direction; }
 	virtual ~TransferSpec() {}
 	void setConfinementContainerId(std::vector<int*> *containerId) { confinementContainerId = containerId; }
+	std::vector<int*> *getConfinementContainerId() { return confinementContainerId; }
 	void setBufferEntry(char *bufferEntry, std::vector<int> *dataIndex);
+	inline char *getBufferEntry() { return bufferEntry; }
 	inline std::vector<int> *getDataIndex() { return dataIndex; }
 	inline int getStepSize() { return elementSize; }
 
 	// function to be used to do the data transfer once the participating location in the operating memory has been
 	// identified
 	virtual void performTransfer(DataPartIndex dataPartIndex);
+	
+	// function to be used to do the data transfer for a run of consecutive buffer entries that correspond to as many
+	// consecutive locations in a data part beginning at the argument location 
+	virtual void performRunTransfer(DataPartIndex dataPartIndex, int runLength);
+
+	// moves the buffer reference of the transfer spec forward or backward by the argument number of elements
+	virtual void shiftBufferReference(int elements) { bufferEntry += elements * elementSize; }
 
 	// function to be used to determine if a data part in the part-container tree is made accessible for the current
 	// transfer specification
@@ -174,6 +183,14 @@ class TransferLocationSpec : public TransferSpec {
 		char *dataPartLocation = dataPartIndex.getLocation();
 		*bufferLocation = dataPartLocation;
 	}
+	// the buffer location should be the first of as many consecutive location pointers as the run length
+	void performRunTransfer(DataPartIndex dataPartIndex, int runLength) {
+		char *dataPartLocation = dataPartIndex.getLocation();
+		for (int i = 0; i < runLength; i++) {
+			bufferLocation[i] = dataPartLocation + i * elementSize;
+		}
+	}
+	void shiftBufferReference(int elements) { bufferLocation += elements; }
 };
 
 /* This subclass of transfer specification serve the purpose similar to Transfer-Location-Spec class of the above but 
@@ -198,6 +215,15 @@ class TransferIndexSpec : public TransferSpec {
 	void performTransfer(DataPartIndex dataPartIndex) {
 		partIndexListRef->addPartIndex(dataPartIndex);
 	}
+	// the part index list reference should be the first of as many consecutive lists as the run length
+	void performRunTransfer(DataPartIndex dataPartIndex, int runLength) {
+		DataPart *dataPart = dataPartIndex.getDataPart();
+		long int index = dataPartIndex.getIndex();
+		for (int i = 0; i < runLength; i++) {
+			partIndexListRef[i].addPartIndex(DataPartIndex(dataPart, index + i * elementSize));
+		}
+	}
+	void shiftBufferReference(int elements) { partIndexListRef += elements; }
 };
 
 /* class holding information that is needed to traverse the part-container hierarchy and identify the location of a data 
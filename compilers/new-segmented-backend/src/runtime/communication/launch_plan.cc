@@ -0,0 +1,103 @@
+#include "launch_plan.h"
+#include "part_distribution.h"
+#include "confinement_mgmt.h"
+#include "mpi_group.h"
+#include "../../../../common-libs/domain-obj/structure.h"
+#include "../../../../common-libs/utils/list.h"
+#include "../../../../common-libs/utils/hashtable.h"
+
+#include <vector>
+#include <fstream>
+
+//------------------------------------------------------------ Launch Plan Key ----------------------------------------------------------/
+
+void LaunchPlanKey::addDimension(Dimension dimension) {
+	components.push_back(dimension.range.min);
+	components.push_back(dimension.range.max);
+}
+
+bool LaunchPlanKey::isEqual(LaunchPlanKey *other) {
+	if (other == NULL) return false;
+	return components == other->components;
+}
+
+//-------------------------------------------------------------- Launch Plan ------------------------------------------------------------/
+
+LaunchPlan::LaunchPlan(LaunchPlanKey *key) {
+	this->key = key;
+	this->reused = false;
+	this->distributionMap = NULL;
+	this->dataExchangeListMap = new Hashtable<List<DataExchange*>*>;
+	this->segmentGroupMap = new Hashtable<SegmentGroup*>;
+	pthread_mutex_init(&mutex, NULL);
+}
+
+LaunchPlan::~LaunchPlan() {
+	delete key;
+	delete dataExchangeListMap;
+	delete segmentGroupMap;
+	pthread_mutex_destroy(&mutex);
+}
+
+bool LaunchPlan::hasDataExchangeList(const char *dependencyName) {
+	pthread_mutex_lock(&mutex);
+	bool listFound = (dataExchangeListMap->Lookup(dependencyName) != NULL);
+	pthread_mutex_unlock(&mutex);
+	return listFound;
+}
+
+List<DataExchange*> *LaunchPlan::getDataExchangeList(const char *dependencyName) {
+	pthread_mutex_lock(&mutex);
+	List<DataExchange*> *dataExchangeList = dataExchangeListMap->Lookup(dependencyName);
+	pthread_mutex_unlock(&mutex);
+	if (dataExchangeList == NULL || dataExchangeList->NumElements() == 0) return NULL;
+	return dataExchangeList;
+}
+
+void LaunchPlan::setDataExchangeList(const char *dependencyName, List<DataExchange*> *dataExchangeList) {
+	// an empty list is stored in place of NULL to remember that the dependency has been processed
+	if (dataExchangeList == NULL) {
+		dataExchangeList = new List<DataExchange*>;
+	}
+	pthread_mutex_lock(&mutex);
+	dataExchangeListMap->Enter(dependencyName, dataExchangeList);
+	pthread_mutex_unlock(&mutex);
+}
+
+SegmentGroup *LaunchPlan::getSegmentGroup(const char *dependencyName) {
+	pthread_mutex_lock(&mutex);
+	SegmentGroup *segmentGroup = segmentGroupMap->Lookup(dependencyName);
+	pthread_mutex_unlock(&mutex);
+	return segmentGroup;
+}
+
+void LaunchPlan::setSegmentGroup(const char *dependencyName, SegmentGroup *segmentGroup) {
+	if (segmentGroup != NULL) {
+		pthread_mutex_lock(&mutex);
+		segmentGroupMap->Enter(dependencyName, segmentGroup);
+		pthread_mutex_unlock(&mutex);
+	}
+}
+
+//----------------------------------------------------------- Launch Plan Cache ---------------------------------------------------------/
+
+LaunchPlan *LaunchPlanCache::getPlan(LaunchPlanKey *key, bool reuseAllowed, std::ofstream &logFile) {
+
+	if (reuseAllowed && plan != NULL && plan->getKey()->isEqual(key)) {
+		logFile << "\treusing the launch plan of the previous invocation\n";
+		logFile.flush();
+		plan->markReused();
+		delete key;
+		return plan;
+	}
+
+	// The MPI groups and data exchanges of the discarded plan may still be referred to by the communicators of the
+	// earlier invocation, which are never deallocated. So only the plan's own containers are released here.
+	if (plan != NULL) {
+		delete plan;
+	}
+	logFile << "\tconstructing a new launch plan\n";
+	logFile.flush();
+	plan = new LaunchPlan(key);
+	return plan;
+}
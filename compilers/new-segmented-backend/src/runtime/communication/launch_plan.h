@@ -0,0 +1,80 @@
+#ifndef _H_launch_plan
+#define _H_launch_plan
+
+/* A program often invokes the same task many times with the same partition arguments over arrays of unchanging dimensions.
+ * For example, the conjugate gradient program executes its matrix-vector multiplication task in every iteration of the
+ * solver loop. Yet each invocation of the task builds the part distribution trees of all shared arrays, generates the
+ * confinements to determine the data exchanges of each communicator, and forms the MPI groups of the communicators using
+ * collective MPI_Comm_split calls all over again. The results of those activities only depend on the partition arguments,
+ * the array dimensions, and the number of segments participating in the task. So this header provides a launch plan that
+ * retains those results for reuse in subsequent invocations and a cache that hands the plan back as long as the key made
+ * of the aforementioned components does not change.
+ *
+ * Note that communication buffers and communicators are not part of the plan as they refer to the memory of data parts,
+ * which is allocated afresh in each invocation of the task.
+ */
+
+#include "part_distribution.h"
+#include "confinement_mgmt.h"
+#include "mpi_group.h"
+#include "../../../../common-libs/domain-obj/structure.h"
+#include "../../../../common-libs/utils/list.h"
+#include "../../../../common-libs/utils/hashtable.h"
+
+#include <vector>
+#include <fstream>
+#include <pthread.h>
+
+/* The key is a simple sequence of integers; it should be constructed identically in all segments for a task invocation */
+class LaunchPlanKey {
+  private:
+	std::vector<int> components;
+  public:
+	LaunchPlanKey() {}
+	void addComponent(int value) { components.push_back(value); }
+	void addDimension(Dimension dimension);
+	bool isEqual(LaunchPlanKey *other);
+};
+
+class LaunchPlan {
+  private:
+	LaunchPlanKey *key;
+	// tells if the plan has been constructed by an earlier invocation of the task
+	bool reused;
+	PartDistributionMap *distributionMap;
+	// data exchanges of the local segment and MPI groups of communicators indexed by dependency names
+	Hashtable<List<DataExchange*>*> *dataExchangeListMap;
+	Hashtable<SegmentGroup*> *segmentGroupMap;
+	// communicators of different dependencies are constructed in parallel; so access to the maps needs protection
+	pthread_mutex_t mutex;
+  public:
+	LaunchPlan(LaunchPlanKey *key);
+	~LaunchPlan();
+	LaunchPlanKey *getKey() { return key; }
+	void markReused() { reused = true; }
+	bool isReused() { return reused; }
+	PartDistributionMap *getDistributionMap() { return distributionMap; }
+	void setDistributionMap(PartDistributionMap *distributionMap) { this->distributionMap = distributionMap; }
+
+	// A segment may have no data exchange for a dependency. So the first function should be used to determine if the
+	// data exchanges for the dependency have been computed already; the second returns NULL for an empty exchange list.
+	bool hasDataExchangeList(const char *dependencyName);
+	List<DataExchange*> *getDataExchangeList(const char *dependencyName);
+	void setDataExchangeList(const char *dependencyName, List<DataExchange*> *dataExchangeList);
+
+	SegmentGroup *getSegmentGroup(const char *dependencyName);
+	void setSegmentGroup(const char *dependencyName, SegmentGroup *segmentGroup);
+};
+
+/* The cache holds the plan of the last invocation of a task. A plan must not be reused when some MPI processes are left
+ * out of the task's execution, as those processes still take part in the MPI group formation on every invocation.
+ */
+class LaunchPlanCache {
+  private:
+	LaunchPlan *plan;
+  public:
+	LaunchPlanCache() { plan = NULL; }
+	LaunchPlan *getPlan(LaunchPlanKey *key, bool reuseAllowed, std::ofstream &logFile);
+};
+
+#endif
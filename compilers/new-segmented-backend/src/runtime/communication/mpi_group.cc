@@ -11,6 +11,9 @@ using namespace std;
 
 SegmentGroup::SegmentGroup() {
         mpiCommunicator = MPI_COMM_NULL;
+	nodeAware = false;
+	nodeCommunicator = MPI_COMM_NULL;
+	leaderCommunicator = MPI_COMM_NULL;
 }
 
 void SegmentGroup::discoverGroupAndSetupCommunicator(std::ofstream &log) {
@@ -53,6 +56,9 @@ SegmentGroup::SegmentGroup(vector<int> segments) {
         this->segments = vector<int>(segments);
         this->segmentRanks = vector<int>(segments);
         mpiCommunicator = MPI_COMM_WORLD;
+	nodeAware = false;
+	nodeCommunicator = MPI_COMM_NULL;
+	leaderCommunicator = MPI_COMM_NULL;
 }
 
 void SegmentGroup::setupCommunicator(std::ofstream &log) {
@@ -123,3 +129,50 @@ void SegmentGroup::excludeSegmentFromGroupSetup(int segmentId, std::ofstream &lo
 		exit(EXIT_FAILURE);
 	}
 }
+
+void SegmentGroup::setupNodeCommunicators(std::ofstream &log) {
+#if MPI_VERSION >= 3
+	int groupRank, groupSize;
+	MPI_Comm_rank(mpiCommunicator, &groupRank);
+	MPI_Comm_size(mpiCommunicator, &groupSize);
+
+	int status = MPI_Comm_split_type(mpiCommunicator, 
+			MPI_COMM_TYPE_SHARED, groupRank, MPI_INFO_NULL, &nodeCommunicator);
+	if (status != MPI_SUCCESS) {
+		log << "\tcould not create a communicator for the segments of the node\n";
+		log.flush();
+		exit(EXIT_FAILURE);
+	}
+	int nodeRank;
+	MPI_Comm_rank(nodeCommunicator, &nodeRank);
+	int leader = groupRank;
+	MPI_Bcast(&leader, 1, MPI_INT, 0, nodeCommunicator);
+
+	int color = (nodeRank == 0) ? 0 : MPI_UNDEFINED;
+	status = MPI_Comm_split(mpiCommunicator, color, groupRank, &leaderCommunicator);
+	if (status != MPI_SUCCESS) {
+		log << "\tcould not create a communicator for the leaders of the nodes\n";
+		log.flush();
+		exit(EXIT_FAILURE);
+	}
+
+	nodeLeaders.resize(groupSize);
+	status = MPI_Allgather(&leader, 1, MPI_INT, &nodeLeaders[0], 1, MPI_INT, mpiCommunicator);
+	if (status != MPI_SUCCESS) {
+		log << "\tcould not gather the node leaders of the segments of the group\n";
+		log.flush();
+		exit(EXIT_FAILURE);
+	}
+	nodeAware = true;
+#endif
+}
+
+int SegmentGroup::getLeaderRank(int rank) {
+	// leaders are ordered by their group ranks in the leader communicator
+	int leader = nodeLeaders.at(rank);
+	int leaderRank = 0;
+	for (int i = 0; i < leader; i++) {
+		if (nodeLeaders.at(i) == i) leaderRank++;
+	}
+	return leaderRank;
+}
@@ -14,6 +14,13 @@ class SegmentGroup {
         std::vector<int> segments;
         std::vector<int> segmentRanks;
         MPI_Comm mpiCommunicator;
+	// communicators among the segments of the group sharing the current node and among the leaders of the nodes; the 
+	// latter is MPI_COMM_NULL in non-leader segments. These are set up only for node-aware communications.
+	bool nodeAware;
+	MPI_Comm nodeCommunicator;
+	MPI_Comm leaderCommunicator;
+	// group rank of the leader of the node of each segment of the group
+	std::vector<int> nodeLeaders;
   public:
 	// constructor and setup function to be used when the current segment is unaware who else will be interacting with it
 	SegmentGroup();
@@ -30,6 +37,17 @@ class SegmentGroup {
         void describe(std::ostream &stream);
 	int getParticipantsCount() { return segments.size(); }
 	static void excludeSegmentFromGroupSetup(int segmentId, std::ofstream &log);
+
+	// Divides the group into segments sharing the same node, with the lowest ranked segment of each node being its 
+	// leader. This is a collective operation on the group communicator that needs MPI-3; the group is not node-aware
+	// if the MPI library is older.
+	void setupNodeCommunicators(std::ofstream &log);
+	bool isNodeAware() { return nodeAware; }
+	MPI_Comm getNodeCommunicator() { return nodeCommunicator; }
+	MPI_Comm getLeaderCommunicator() { return leaderCommunicator; }
+	int getNodeLeader(int rank) { return nodeLeaders.at(rank); }
+	// returns the rank of the leader of the node of the argument group rank within the leader communicator
+	int getLeaderRank(int rank);
 };
 
 #endif
@@ -1,10 +1,10 @@
 #include "comm_barrier.h"
 #include "parallel_comm_barrier.h"
+#include "../common/timing.h"
 
 #include <pthread.h>
 #include <semaphore.h>
-#include <time.h>
-#include <sys/time.h>
+#include <stdint.h>
 #include <iostream>
 	
 ParallelCommBarrier::ParallelCommBarrier(int size) {
@@ -24,6 +24,7 @@ ParallelCommBarrier::~ParallelCommBarrier() {
 
 void ParallelCommBarrier::wait(SignalType signal, int callerIterationNo) {
 
+	int64_t arrival = timing::now();
 	sem_wait(&_mutex);                                       	// Make sure only one is in at a time
 
 	// If there is no reason to wait then release the mutex and return
@@ -56,31 +57,29 @@ void ParallelCommBarrier::wait(SignalType signal, int callerIterationNo) {
 		if (shouldPerformTransfer(_activeSignals, callerIterationNo)) {
 			
 			// kick off the before-transfer parallel processing
-			struct timeval start;
-			gettimeofday(&start, NULL);
+			int64_t start = timing::now();
 			beforeTransfer(order, _size);
 
 			// wait on the barrier for all threads to finish before-transfer processing
 			pthread_barrier_wait(&_barrier);
-			struct timeval end;
-			gettimeofday(&end, NULL);
+			int64_t end = timing::now();
 			recordTimingLog(BEFORE_TRANSFER_TIMING, start, end);
 
 			// perform data transfer
-			gettimeofday(&start, NULL);
+			start = timing::now();
 			transferFunction();
-			gettimeofday(&end, NULL);
+			end = timing::now();
 			recordTimingLog(TRANSFER_TIMING, start, end);
 									 
 			// join the barrier again and kick of after-transfer parallel processing
-			gettimeofday(&start, NULL);
+			start = timing::now();
 			pthread_barrier_wait(&_barrier);
 			afterTransfer(order, _size);
 
 			reset();                                        // Reset the barrier
 			pthread_barrier_wait(&_barrier);		// release others by joining the barrier
 			
-			gettimeofday(&end, NULL);
+			end = timing::now();
 			recordTimingLog(AFTER_TRANSFER_TIMING, start, end);
 			sem_post(&_mutex);                              // Release the mutex
 		} else {
@@ -96,6 +95,7 @@ void ParallelCommBarrier::wait(SignalType signal, int callerIterationNo) {
 		// wait on the barrier for the last thread to count active signals to check the need of a 
 		// data transfer
 		pthread_barrier_wait(&_barrier);
+		recordTimingLog(BARRIER_WAIT_TIMING, arrival, timing::now());
 		if (shouldPerformTransfer(_activeSignals, callerIterationNo)) {
 
 			// participate in the parallel before-transfer processing activity
@@ -137,7 +137,6 @@ void ParallelCommBarrier::beforeTransfer(int order, int participants) {}
 void ParallelCommBarrier::afterTransfer(int order, int participants) {}
 
 // By default timing log is not kept
-void ParallelCommBarrier::recordTimingLog(TimingLogType logType, 
-		struct timeval &start, struct timeval &end) {}
+void ParallelCommBarrier::recordTimingLog(TimingLogType logType, int64_t start, int64_t end) {}
 
 
@@ -15,11 +15,11 @@
 
 #include <pthread.h>
 #include <semaphore.h>
-#include <time.h>
-#include <sys/time.h>
+#include <stdint.h>
 
-// an type list to allow recording of time spent on specific communication related activity on the barrier
-enum TimingLogType { BEFORE_TRANSFER_TIMING, TRANSFER_TIMING, AFTER_TRANSFER_TIMING };
+// an type list to allow recording of time spent on specific communication related activity on the barrier; the
+// barrier wait timing is the time a participant spends waiting for the others to arrive
+enum TimingLogType { BEFORE_TRANSFER_TIMING, TRANSFER_TIMING, AFTER_TRANSFER_TIMING, BARRIER_WAIT_TIMING };
 
 class ParallelCommBarrier {
   protected:
@@ -61,8 +61,9 @@ class ParallelCommBarrier {
 	// function to be extended by subclasses to distribute any parallelizable post processing step
 	virtual void afterTransfer(int order, int participants);
 
-	// logging function to be utilized by subclasses to record communication performance
-	virtual void recordTimingLog(TimingLogType logType, struct timeval &start, struct timeval &end);
+	// logging function to be utilized by subclasses to record communication performance; the barrier wait time is
+	// recorded by multiple participants at the same time
+	virtual void recordTimingLog(TimingLogType logType, int64_t start, int64_t end);
 };
 
 #endif
@@ -1,5 +1,6 @@
 #include "scalar_communicator.h"
 #include "communicator.h"
+#include "../common/timing.h"
 
 #include "../../../../common-libs/utils/utility.h"
 #include "../../../../common-libs/utils/binary_search.h"
@@ -31,8 +32,7 @@ void ScalarCommunicator::setupCommunicator(bool includeNonInteractingSegments) {
 	*logFile << "\tSetting up scalar communicator for " << dependencyName << "\n";
 	logFile->flush();
 
-	struct timeval start;
-        gettimeofday(&start, NULL);
+	int64_t start = timing::now();
 
 	segmentGroup = new SegmentGroup();
 	segmentGroup->discoverGroupAndSetupCommunicator(*logFile);
@@ -65,8 +65,7 @@ void ScalarCommunicator::setupCommunicator(bool includeNonInteractingSegments) {
 		}
 	}
 
-	struct timeval end;
-        gettimeofday(&end, NULL);
+	int64_t end = timing::now();
         commStat->addCommResourcesSetupTime(dependencyName, start, end);
 	
 	*logFile << "\tSetup done for scalar communicator " << dependencyName << "\n";
@@ -0,0 +1,403 @@
+#include "checkpoint.h"
+#include "environment.h"
+
+#include "../memory-management/allocation.h"
+#include "../file-io/data_handler.h"
+#include "../common/timing.h"
+
+#include "../../../../common-libs/utils/list.h"
+#include "../../../../common-libs/utils/hashtable.h"
+
+#include <mpi.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <stdint.h>
+
+int CheckpointManager::segmentId = 0;
+int CheckpointManager::interval = 0;
+std::string CheckpointManager::directory = ".";
+int CheckpointManager::checkpointsTaken = 0;
+std::vector<TaskEnvironment*> CheckpointManager::environments;
+std::vector<ScalarSnapshot> CheckpointManager::scalarLog;
+int CheckpointManager::journalEntries = 0;
+long int CheckpointManager::journalLength = 0;
+bool CheckpointManager::restartRequested = false;
+bool CheckpointManager::replaying = false;
+int CheckpointManager::resumeInvocation = -1;
+std::string CheckpointManager::restoreDataFile;
+unsigned int CheckpointManager::restoreCursor = 0;
+std::vector<PartsListEntry> CheckpointManager::restoreEntries;
+
+static const char *hexDigits = "0123456789abcdef";
+
+static std::string encodeHex(const std::string &content) {
+	std::string encoded;
+	for (unsigned int i = 0; i < content.length(); i++) {
+		unsigned char byte = content[i];
+		encoded += hexDigits[byte >> 4];
+		encoded += hexDigits[byte & 0x0f];
+	}
+	return encoded;
+}
+
+static std::string decodeHex(const std::string &encoded) {
+	std::string content;
+	for (unsigned int i = 0; i + 1 < encoded.length(); i += 2) {
+		int high = strchr(hexDigits, encoded[i]) - hexDigits;
+		int low = strchr(hexDigits, encoded[i + 1]) - hexDigits;
+		content += (char) ((high << 4) | low);
+	}
+	return content;
+}
+
+void CheckpointManager::configure(int segmentId, int interval, const char *directory) {
+	CheckpointManager::segmentId = segmentId;
+	CheckpointManager::interval = interval;
+	CheckpointManager::directory = std::string(directory);
+	if (interval > 0) {
+		// all segments may try to create the directory; so failure due to its existence is not an error
+		mkdir(directory, 0755);
+	}
+}
+
+std::string CheckpointManager::getFileName(int slot, const char *extension) {
+	std::ostringstream fileName;
+	fileName << directory << "/segment_" << segmentId << "_slot_" << slot << "." << extension;
+	return fileName.str();
+}
+
+std::string CheckpointManager::getJournalFileName() {
+	std::ostringstream fileName;
+	fileName << directory << "/segment_" << segmentId << ".scalars";
+	return fileName.str();
+}
+
+void CheckpointManager::prepareRestart(std::ofstream &logFile) {
+
+	if (!restartRequested) return;
+
+	int latest = -1;
+	int latestSlot = -1;
+	for (int slot = 0; slot < 2; slot++) {
+		int invocation = readManifest(slot, false);
+		if (invocation > latest) {
+			latest = invocation;
+			latestSlot = slot;
+		}
+	}
+
+	// a segment may have failed after completing a checkpoint others have not; so the segments agree on the oldest
+	// among their latest checkpoints, which each segment still has as checkpoints are taken at the same invocations
+	int agreed;
+	MPI_Allreduce(&latest, &agreed, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+	if (agreed < 0) {
+		logFile << "no checkpoint is available in all segments: starting from the beginning\n";
+		logFile.flush();
+		return;
+	}
+
+	// only a segment that is ahead of the others needs to look for its older checkpoint
+	int restoreSlot = (agreed == latest) ? latestSlot : -1;
+	for (int slot = 0; restoreSlot == -1 && slot < 2; slot++) {
+		if (readManifest(slot, false) == agreed) restoreSlot = slot;
+	}
+	if (restoreSlot == -1) {
+		std::cout << "Segment " << segmentId << ": checkpoint of task invocation " << agreed << " is missing\n";
+		std::exit(EXIT_FAILURE);
+	}
+	readManifest(restoreSlot, true);
+	restoreDataFile = getFileName(restoreSlot, "data");
+	replaying = true;
+	resumeInvocation = agreed;
+
+	// the next checkpoint goes to the other slot so that the one being restored remains intact until then
+	checkpointsTaken = restoreSlot + 1;
+
+	logFile << "restarting from the checkpoint taken after task invocation " << agreed << "\n";
+	logFile.flush();
+}
+
+void CheckpointManager::completeInvocation(TaskEnvironment *environment, std::ofstream &logFile) {
+
+	int taskId = environment->getTaskId();
+	if (isReplaying(taskId)) {
+		restoreScalars(taskId);
+		if (taskId == resumeInvocation) {
+			restoreParts(environment->getProgramEnvironment(), logFile);
+			replaying = false;
+			// the restored snapshots are already in the journal
+			scalarLog.clear();
+		}
+		return;
+	}
+
+	if (interval <= 0) return;
+	recordScalars(environment);
+	if ((taskId + 1) % interval == 0) {
+		takeCheckpoint(environment->getProgramEnvironment(), taskId, logFile);
+	}
+}
+
+void CheckpointManager::recordScalars(TaskEnvironment *environment) {
+	std::ostringstream content;
+	environment->writeScalarProperties(content);
+	ScalarSnapshot snapshot;
+	snapshot.taskId = environment->getTaskId();
+	snapshot.envId = environment->getEnvId();
+	snapshot.content = content.str();
+	scalarLog.push_back(snapshot);
+}
+
+void CheckpointManager::restoreScalars(int taskId) {
+	// the snapshots are in the order of the invocations; an invocation with no snapshot has nothing to restore
+	while (restoreCursor < scalarLog.size() && scalarLog[restoreCursor].taskId < taskId) restoreCursor++;
+	if (restoreCursor == scalarLog.size() || scalarLog[restoreCursor].taskId != taskId) return;
+	ScalarSnapshot &snapshot = scalarLog[restoreCursor];
+	for (unsigned int j = 0; j < environments.size(); j++) {
+		if (environments[j]->getEnvId() != snapshot.envId) continue;
+		std::istringstream content(snapshot.content);
+		environments[j]->readScalarProperties(content);
+		break;
+	}
+}
+
+void CheckpointManager::takeCheckpoint(ProgramEnvironment *programEnv, int taskId, std::ofstream &logFile) {
+
+	int64_t start = timing::now();
+
+	int slot = checkpointsTaken % 2;
+	checkpointsTaken++;
+	std::string dataFile = getFileName(slot, "data");
+	std::string manifestFile = getFileName(slot, "manifest");
+
+	// wait for the earlier checkpoint in the slot to be written then invalidate it before overwriting its data
+	AsyncPartWriteQueue::waitForFile(dataFile.c_str());
+	AsyncPartWriteQueue::waitForFile(manifestFile.c_str());
+	unlink(manifestFile.c_str());
+
+	// the journal is rewritten from the beginning in a fresh run; so a manifest of an earlier run in the other slot
+	// must not remain to refer to it
+	if (checkpointsTaken == 1) unlink(getFileName(1, "manifest").c_str());
+
+	// copy the contents of the fresh parts lists of all data items into the staging buffer; parts lists shared by
+	// multiple fresh versions are saved once
+	StagedPartWrite *dataWrite = new StagedPartWrite();
+	dataWrite->fileName = dataFile;
+	dataWrite->writeHeader = true;
+	std::vector<char> &buffer = dataWrite->buffer;
+	std::vector<PartsListEntry> entries;
+	Iterator<ObjectVersionManager*> iterator = programEnv->getVersionManagers();
+	ObjectVersionManager *manager = NULL;
+	while ((manager = iterator.GetNextValue()) != NULL) {
+		char *dataItemKey = manager->getIdentifier()->generateKey();
+		List<PartsListReference*> *freshVersions = manager->getFreshVersions();
+		std::vector<PartsList*> savedLists;
+		for (int i = 0; i < freshVersions->NumElements(); i++) {
+			PartsListReference *version = freshVersions->Nth(i);
+			PartsList *partsList = version->getPartsList();
+			List<DataPart*> *dataParts = partsList->getDataParts();
+			if (dataParts == NULL) continue;
+			bool saved = false;
+			for (unsigned int j = 0; j < savedLists.size(); j++) {
+				if (savedLists[j] == partsList) saved = true;
+			}
+			if (saved) continue;
+			savedLists.push_back(partsList);
+
+			PartsListEntry entry;
+			char *versionKey = version->getKey()->generateKey();
+			entry.dataItemKey = std::string(dataItemKey);
+			entry.versionKey = std::string(versionKey);
+			free(versionKey);
+			entry.partCount = dataParts->NumElements();
+			entry.fileOffset = buffer.size();
+			for (int j = 0; j < dataParts->NumElements(); j++) {
+				DataPart *part = dataParts->Nth(j);
+				long int partSize = part->getMetadata()->getSize() * part->getElementSize();
+				char *data = (char *) part->getData();
+				buffer.insert(buffer.end(), data, data + partSize);
+			}
+			entry.length = buffer.size() - entry.fileOffset;
+			entries.push_back(entry);
+		}
+		delete freshVersions;
+		free(dataItemKey);
+	}
+	dataWrite->fileLength = buffer.size();
+	if (buffer.size() > 0) {
+		OutputRun run;
+		run.fileOffset = 0;
+		run.bufferOffset = 0;
+		run.length = buffer.size();
+		dataWrite->runs.push_back(run);
+	}
+
+	// the scalar snapshots recorded since the last checkpoint are appended to the journal; whatever lies beyond the
+	// covered part of the journal belongs to a checkpoint that has been abandoned and is overwritten
+	std::ostringstream journal;
+	for (unsigned int i = 0; i < scalarLog.size(); i++) {
+		ScalarSnapshot &snapshot = scalarLog[i];
+		journal << snapshot.taskId << " " << snapshot.envId << " ";
+		journal << encodeHex(snapshot.content) << " .\n";
+	}
+	StagedPartWrite *journalWrite = new StagedPartWrite();
+	journalWrite->fileName = getJournalFileName();
+	journalWrite->writeHeader = false;
+	std::string journalContent = journal.str();
+	journalWrite->buffer.assign(journalContent.begin(), journalContent.end());
+	if (journalContent.length() > 0) {
+		OutputRun run;
+		run.fileOffset = journalLength;
+		run.bufferOffset = 0;
+		run.length = journalContent.length();
+		journalWrite->runs.push_back(run);
+	}
+	journalEntries += scalarLog.size();
+	journalLength += journalContent.length();
+	scalarLog.clear();
+
+	// the manifest is queued after the data file and the journal; the background writer handles its queue in order
+	std::ostringstream manifest;
+	manifest << "invocation " << taskId << "\n";
+	manifest << "scalars " << journalEntries << " " << journalLength << "\n";
+	manifest << "lists " << entries.size() << "\n";
+	for (unsigned int i = 0; i < entries.size(); i++) {
+		PartsListEntry &entry = entries[i];
+		manifest << entry.dataItemKey << " " << entry.versionKey << " " << entry.partCount << " ";
+		manifest << entry.fileOffset << " " << entry.length << "\n";
+	}
+	manifest << "end\n";
+	StagedPartWrite *manifestWrite = new StagedPartWrite();
+	manifestWrite->fileName = manifestFile;
+	manifestWrite->writeHeader = true;
+	manifestWrite->header = manifest.str();
+	manifestWrite->fileLength = manifestWrite->header.length();
+
+	AsyncPartWriteQueue::submit(dataWrite);
+	AsyncPartWriteQueue::submit(journalWrite);
+	AsyncPartWriteQueue::submit(manifestWrite);
+
+	double stagingTime = timing::elapsedSeconds(start, timing::now());
+	logFile << "\tstaged checkpoint of task invocation " << taskId << " in " << stagingTime << " Seconds\n";
+	logFile.flush();
+}
+
+int CheckpointManager::readManifest(int slot, bool loadContent) {
+
+	std::string manifestFile = getFileName(slot, "manifest");
+	std::ifstream stream(manifestFile.c_str());
+	if (!stream.is_open()) return -1;
+
+	std::string label;
+	int invocation = -1;
+	stream >> label >> invocation;
+	if (stream.fail() || label.compare("invocation") != 0) return -1;
+
+	int scalarCount;
+	long int scalarLength;
+	stream >> label >> scalarCount >> scalarLength;
+	if (stream.fail() || label.compare("scalars") != 0) return -1;
+
+	std::vector<PartsListEntry> entries;
+	int listCount;
+	stream >> label >> listCount;
+	if (stream.fail() || label.compare("lists") != 0) return -1;
+	for (int i = 0; i < listCount; i++) {
+		PartsListEntry entry;
+		stream >> entry.dataItemKey >> entry.versionKey >> entry.partCount >> entry.fileOffset >> entry.length;
+		entries.push_back(entry);
+	}
+
+	// a manifest without the end marker has not been written completely
+	stream >> label;
+	if (stream.fail() || label.compare("end") != 0) return -1;
+	stream.close();
+
+	if (loadContent) {
+		readJournal(scalarCount, scalarLength);
+		restoreEntries = entries;
+	}
+	return invocation;
+}
+
+void CheckpointManager::readJournal(int entries, long int length) {
+
+	std::string journalFile = getJournalFileName();
+	std::ifstream stream(journalFile.c_str());
+	if (!stream.is_open() && entries > 0) {
+		std::cout << "Segment " << segmentId << ": could not open checkpoint journal: " << journalFile << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	scalarLog.clear();
+	for (int i = 0; i < entries; i++) {
+		ScalarSnapshot snapshot;
+		std::string encoded;
+		stream >> snapshot.taskId >> snapshot.envId >> encoded;
+		// an empty snapshot is recorded as a lone terminator
+		if (encoded.compare(".") != 0) {
+			snapshot.content = decodeHex(encoded);
+			stream >> encoded;
+		}
+		if (stream.fail()) {
+			std::cout << "Segment " << segmentId << ": corrupted checkpoint journal: " << journalFile << "\n";
+			std::exit(EXIT_FAILURE);
+		}
+		scalarLog.push_back(snapshot);
+	}
+
+	// new snapshots are appended right after the part of the journal the restored checkpoint covers
+	journalEntries = entries;
+	journalLength = length;
+	restoreCursor = 0;
+}
+
+void CheckpointManager::restoreParts(ProgramEnvironment *programEnv, std::ofstream &logFile) {
+
+	std::ifstream stream(restoreDataFile.c_str(), std::ios_base::binary);
+	if (!stream.is_open()) {
+		std::cout << "Segment " << segmentId << ": could not open checkpoint file: " << restoreDataFile << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	for (unsigned int i = 0; i < restoreEntries.size(); i++) {
+		PartsListEntry &entry = restoreEntries[i];
+		char *dataItemKey = strdup(entry.dataItemKey.c_str());
+		char *versionKey = strdup(entry.versionKey.c_str());
+		ObjectVersionManager *manager = programEnv->getVersionManager(dataItemKey);
+		PartsListReference *version = (manager != NULL) ? manager->getVersion(versionKey) : NULL;
+		List<DataPart*> *dataParts = (version != NULL) ? version->getPartsList()->getDataParts() : NULL;
+		if (dataParts == NULL || dataParts->NumElements() != entry.partCount) {
+			std::cout << "Segment " << segmentId << ": the program environment does not match the checkpoint ";
+			std::cout << "for " << dataItemKey << " " << versionKey << "\n";
+			std::exit(EXIT_FAILURE);
+		}
+		free(dataItemKey);
+		free(versionKey);
+
+		stream.seekg(entry.fileOffset, std::ios_base::beg);
+		long int restored = 0;
+		for (int j = 0; j < dataParts->NumElements(); j++) {
+			DataPart *part = dataParts->Nth(j);
+			long int partSize = part->getMetadata()->getSize() * part->getElementSize();
+			stream.read((char *) part->getData(), partSize);
+			part->synchronizeAllVersions();
+			restored += partSize;
+		}
+		if (stream.fail() || restored != entry.length) {
+			std::cout << "Segment " << segmentId << ": corrupted checkpoint file: " << restoreDataFile << "\n";
+			std::exit(EXIT_FAILURE);
+		}
+	}
+	stream.close();
+	restoreEntries.clear();
+
+	logFile << "\trestored the program environment from the checkpoint\n";
+	logFile.flush();
+}
@@ -0,0 +1,105 @@
+#ifndef _H_checkpoint
+#define _H_checkpoint
+
+/* This header provides coordinated checkpointing of the program environment at task invocation boundaries and the
+ * restart of a program from the last checkpoint all segments have completed.
+ *
+ * After every N-th task invocation, each segment takes a snapshot of the fresh parts lists of all data items of the
+ * program environment and of the non-array variables of all task environments, and hands the snapshot over to the
+ * background writer thread of the file I/O library; so writing the checkpoint overlaps with the next task's execution.
+ * A segment keeps its last two checkpoints in alternating slots, each being a data file holding the parts contents
+ * followed by a manifest describing them. The manifest is removed before a slot is overwritten and written only after
+ * the data file; so a segment that fails in the middle of a checkpoint still has its previous checkpoint intact.
+ *
+ * The non-array variables of the task environments are needed for every task invocation a restarted program skips;
+ * so they are kept in an append-only journal file per segment rather than in the checkpoint slots. Each checkpoint
+ * appends the snapshots recorded since the previous one to the journal and its manifest records how much of the
+ * journal it covers. Hence, memory holds only the snapshots of the invocations since the last checkpoint and each
+ * checkpoint writes only those.
+ *
+ * The coordinator program is deterministic given the values of the non-array environment variables it can observe.
+ * So a restarted program runs the coordinator from the beginning but does not execute the task invocations covered by
+ * the checkpoint: environment instructions are processed as usual to rebuild the program environment, except that no
+ * input file is read and no output file is written, and the non-array variables of each task environment are set to
+ * the values they had after the original invocation. At the end of the last covered invocation, the contents of the
+ * parts lists are loaded from the checkpoint and the program continues normally from there on.
+ */
+
+#include "environment.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+
+/* the non-array environment variables of a task environment as they were at the end of a task invocation */
+class ScalarSnapshot {
+  public:
+	int taskId;
+	int envId;
+	std::string content;
+};
+
+/* the location of the contents of a parts list in a checkpoint data file */
+class PartsListEntry {
+  public:
+	std::string dataItemKey;
+	std::string versionKey;
+	int partCount;
+	long int fileOffset;
+	long int length;
+};
+
+class CheckpointManager {
+  private:
+	static int segmentId;
+	// the number of task invocations between two consecutive checkpoints; checkpointing is disabled if this is zero
+	static int interval;
+	static std::string directory;
+	static int checkpointsTaken;
+	static std::vector<TaskEnvironment*> environments;
+	// the snapshots recorded since the last checkpoint in normal execution; all the snapshots covered by the restored
+	// checkpoint during a restart
+	static std::vector<ScalarSnapshot> scalarLog;
+	// the number of snapshots and bytes in the journal that the checkpoints so far cover
+	static int journalEntries;
+	static long int journalLength;
+
+	// restart related state
+	static bool restartRequested;
+	static bool replaying;
+	static int resumeInvocation;
+	static std::string restoreDataFile;
+	// the index of the next snapshot in the scalar log to restore; invocations are replayed in order
+	static unsigned int restoreCursor;
+	static std::vector<PartsListEntry> restoreEntries;
+  public:
+	static void configure(int segmentId, int interval, const char *directory);
+	static void registerEnvironment(TaskEnvironment *environment) { environments.push_back(environment); }
+	static void requestRestart() { restartRequested = true; }
+
+	// If a restart has been requested, this function determines the latest checkpoint all segments have completed
+	// and loads its manifest. This is a collective operation on MPI_COMM_WORLD that must be done before the first
+	// task invocation.
+	static void prepareRestart(std::ofstream &logFile);
+
+	// tells if the task invocation with the argument ID is covered by the checkpoint the program is restarting from
+	static bool isReplaying(int taskId) { return replaying && taskId <= resumeInvocation; }
+
+	// This should be invoked at the end of each task invocation after the environment instructions have been
+	// processed. It takes a checkpoint when one is due in normal execution and restores the state of the environment
+	// during a restart.
+	static void completeInvocation(TaskEnvironment *environment, std::ofstream &logFile);
+  private:
+	static std::string getFileName(int slot, const char *extension);
+	static std::string getJournalFileName();
+	// reads the argument number of snapshots from the beginning of the journal into the scalar log
+	static void readJournal(int entries, long int length);
+	static void recordScalars(TaskEnvironment *environment);
+	static void restoreScalars(int taskId);
+	static void takeCheckpoint(ProgramEnvironment *programEnv, int taskId, std::ofstream &logFile);
+	static void restoreParts(ProgramEnvironment *programEnv, std::ofstream &logFile);
+	// reads the manifest of a slot; returns the invocation the checkpoint was taken at or -1 if there is no valid one
+	static int readManifest(int slot, bool loadContent);
+};
+
+#endif
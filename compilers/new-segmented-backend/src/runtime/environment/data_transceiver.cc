@@ -15,6 +15,7 @@
 
 #include <mpi.h>
 #include <vector>
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
@@ -211,18 +212,19 @@ void LocalTransferrer::transferData(std::ofstream &logFile) {
 		transformVector->push_back(new XformedIndexInfo());
 	}
 
-	char *dataEntry = new char[elementSize];
+	// runs of consecutive elements are moved through the data entry; so it should be large enough to hold a run
+	const int runLimit = 1024;
+	char *dataEntry = new char[runLimit * elementSize];
+	int runLength;
 	while (iterator->hasMoreElements()) {
 
-		vector<int> *dataItemIndex = iterator->getNextElement();
+		vector<int> *runStart = iterator->getNextRun(runLimit, &runLength);
 
-		readTransferSpec->setBufferEntry(dataEntry, dataItemIndex);
-		readPartSpec->initPartTraversalReference(dataItemIndex, transformVector);
-		sourcePartsTree->transferData(transformVector, readTransferSpec, readPartSpec, false, cout);
+		readTransferSpec->setBufferEntry(dataEntry, runStart);
+		sourcePartsTree->transferRun(transformVector, readTransferSpec, readPartSpec, runStart, runLength);
 
-		writeTransferSpec->setBufferEntry(dataEntry, dataItemIndex);
-                writePartSpec->initPartTraversalReference(dataItemIndex, transformVector);
-                targetPartsTree->transferData(transformVector, writeTransferSpec, writePartSpec, false, cout);
+		writeTransferSpec->setBufferEntry(dataEntry, runStart);
+                targetPartsTree->transferRun(transformVector, writeTransferSpec, writePartSpec, runStart, runLength);
 	}
 
 	delete exchange;
@@ -249,27 +251,33 @@ TransferBuffer::TransferBuffer(int sender, int receiver,
 	this->partListSpec = partListSpec;
 	this->transferSpec = transferSpec;
 	this->partContainerTree = partContainerTree;
+	
+	// divide the data into chunks; there is always at least one chunk, possibly an empty one, so that the sender and the 
+	// receiver agree on the number of messages
 	int elementSize = transferSpec->getStepSize();
-	this->data = new char[exchange->getTotalElementsCount() * elementSize];
+	this->elementCount = exchange->getTotalElementsCount();
+	this->chunkElements = max(Transfer_Chunk_Size / elementSize, 1l);
+	if (chunkElements > elementCount) chunkElements = max(elementCount, 1l);
+	this->chunkCount = max((elementCount + chunkElements - 1) / chunkElements, 1l);
+	int slots = (chunkCount > 1) ? 2 : 1;
+	this->data = new char[slots * chunkElements * elementSize];
+	this->chunksPosted = 0;
+	this->chunksCompleted = 0;
+
+	this->elementIterator = NULL;
+	this->transformVector = NULL;
 }
 
 TransferBuffer::~TransferBuffer() {
 	delete[] data;
 	delete exchange;
 	delete transferSpec;
-}
-
-void TransferBuffer::preprocessBuffer(std::ofstream &logFile) {
-	TransferDirection direction = transferSpec->getDirection();
-	if (direction == DATA_PART_TO_COMM_BUFFER) {
-		processBuffer(logFile);
-	}
-}
-
-void TransferBuffer::postProcessBuffer(std::ofstream &logFile) {
-	TransferDirection direction = transferSpec->getDirection();
-	if (direction == COMM_BUFFER_TO_DATA_PART) {
-		processBuffer(logFile);
+	delete elementIterator;
+	if (transformVector != NULL) {
+		for (int i = 0; i < transformVector->size(); i++) {
+			delete transformVector->at(i);
+		}
+		delete transformVector;
 	}
 }
 
@@ -279,35 +287,93 @@ int TransferBuffer::compareTo(TransferBuffer *other) {
 	return 0;
 }
 
-void TransferBuffer::processBuffer(std::ofstream &logFile) {
-	
-	int dataDimensions = partListSpec->getDimensionality();
+long int TransferBuffer::getSize() {
 	int elementSize = transferSpec->getStepSize();
+        return exchange->getTotalElementsCount() * elementSize;
+}
 
-	vector<XformedIndexInfo*> *transformVector = new vector<XformedIndexInfo*>;
-        transformVector->reserve(dataDimensions);
-        for (int i = 0; i < dataDimensions; i++) {
-                transformVector->push_back(new XformedIndexInfo());
-        }
+void TransferBuffer::startTransfer(bool sendMode) {
+	while (chunksPosted < chunkCount && chunksPosted < 2) {
+		postChunk(sendMode, chunksPosted);
+	}
+}
 
-	ExchangeIterator iterator = ExchangeIterator(exchange);
-        long int elementIndex = 0;
-        long int transferRequests = 0;
-        long int transferCount = 0;
-        while (iterator.hasMoreElements()) {
-                vector<int> *dataItemIndex = iterator.getNextElement();
-               	partListSpec->initPartTraversalReference(dataItemIndex, transformVector);
-                char *dataLocation = data + elementIndex * elementSize;
-                transferSpec->setBufferEntry(dataLocation, dataItemIndex);
-                partContainerTree->transferData(transformVector, transferSpec, partListSpec, false, cout);
-                elementIndex++;
-        }
-        delete transformVector;
+bool TransferBuffer::progressTransfer(bool sendMode) {
+	while (chunksCompleted < chunksPosted) {
+		int slot = chunksCompleted % 2;
+		int done = 0;
+		int status = MPI_Test(&chunkRequests[slot], &done, MPI_STATUS_IGNORE);
+        	if (status != MPI_SUCCESS) {
+                	cout << "a chunk transfer request failed to finish\n";
+                	exit(EXIT_FAILURE);
+        	}
+		if (!done) return false;
+		if (!sendMode) {
+			int elementSize = transferSpec->getStepSize();
+			char *chunk = data + slot * chunkElements * elementSize;
+			processChunk(chunk, getChunkElementCount(chunksCompleted));
+		}
+		chunksCompleted++;
+		if (chunksPosted < chunkCount) {
+			postChunk(sendMode, chunksPosted);
+		}
+	}
+	return true;
 }
 
-long int TransferBuffer::getSize() {
+long int TransferBuffer::getChunkElementCount(long int chunkNo) {
+	if (chunkNo < chunkCount - 1) return chunkElements;
+	return elementCount - chunkNo * chunkElements;
+}
+
+void TransferBuffer::postChunk(bool sendMode, long int chunkNo) {
+	
+	int slot = chunkNo % 2;
 	int elementSize = transferSpec->getStepSize();
-        return exchange->getTotalElementsCount() * elementSize;
+	char *chunk = data + slot * chunkElements * elementSize;
+	long int chunkElementCount = getChunkElementCount(chunkNo);
+	int chunkSize = chunkElementCount * elementSize;
+	
+	int status;
+	if (sendMode) {
+		processChunk(chunk, chunkElementCount);
+		status = MPI_Isend(chunk, chunkSize, MPI_CHAR, receiver, bufferTag, MPI_COMM_WORLD, &chunkRequests[slot]);
+	} else {
+		status = MPI_Irecv(chunk, chunkSize, MPI_CHAR, sender, bufferTag, MPI_COMM_WORLD, &chunkRequests[slot]);
+	}
+	if (status != MPI_SUCCESS) {
+		int rank;
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+		cout << "Segment " << rank << ": could not issue asynchronous ";
+		cout << (sendMode ? "send" : "receive") << " for a data chunk\n";
+		exit(EXIT_FAILURE);
+	}
+	chunksPosted++;
+}
+
+void TransferBuffer::processChunk(char *chunk, long int chunkElementCount) {
+	
+	if (chunkElementCount == 0) return;
+	int elementSize = transferSpec->getStepSize();
+	if (elementIterator == NULL) {
+		int dataDimensions = partListSpec->getDimensionality();
+		transformVector = new vector<XformedIndexInfo*>;
+		transformVector->reserve(dataDimensions);
+		for (int i = 0; i < dataDimensions; i++) {
+			transformVector->push_back(new XformedIndexInfo());
+		}
+		elementIterator = new ExchangeIterator(exchange);
+	}
+
+	// the direction set in the transfer specification determines if elements are copied from the data parts to the chunk
+	// or the other way around
+	int runLength;
+	for (long int elementIndex = 0; elementIndex < chunkElementCount; elementIndex += runLength) {
+                vector<int> *runStart = elementIterator->getNextRun(chunkElementCount - elementIndex, &runLength);
+                char *dataLocation = chunk + elementIndex * elementSize;
+                transferSpec->setBufferEntry(dataLocation, runStart);
+                partContainerTree->transferRun(transformVector, transferSpec, partListSpec, runStart, runLength);
+        }
 }	
 
 //--------------------------------------------------- Transfer Buffers Preparer -------------------------------------------------------
@@ -408,13 +474,6 @@ List<TransferBuffer*> *TransferBuffersPreparer::createBuffersForIncomingTransfer
 BufferTransferrer::BufferTransferrer(bool mode, List<TransferBuffer*> *bufferList) {
 	this->sendMode = mode;
 	this->bufferList = bufferList;
-	this->transferRequests = NULL;
-}
-
-BufferTransferrer::~BufferTransferrer() {
-	if (transferRequests != NULL) {
-		delete[] transferRequests;
-	}
 }
 
 void BufferTransferrer::sendDataAsync(std::ofstream &logFile) {
@@ -425,22 +484,9 @@ void BufferTransferrer::sendDataAsync(std::ofstream &logFile) {
 	}
 	if (bufferList == NULL || bufferList->NumElements() == 0) return;
 	
-	int rank;
-	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-	transferRequests = new MPI_Request[bufferList->NumElements()];
-
 	for (int i = 0; i < bufferList->NumElements(); i++) {
 		TransferBuffer *buffer = bufferList->Nth(i);
-		buffer->preprocessBuffer(logFile);
-		long int size = buffer->getSize();
-		char *data = buffer->getData();
-		int receiver = buffer->getReceiver();
-		int tag = buffer->getBufferTag();
-		int status = MPI_Isend(data, size, MPI_CHAR, receiver, tag, MPI_COMM_WORLD, &transferRequests[i]);
-		if (status != MPI_SUCCESS) {
-			cout << "Segment " << rank << ": could not issue asynchronous send\n";
-			exit(EXIT_FAILURE);
-		}
+		buffer->startTransfer(true);
 	}
 }
         
@@ -452,40 +498,34 @@ void BufferTransferrer::receiveDataAsync(std::ofstream &logFile) {
 	}
 	if (bufferList == NULL || bufferList->NumElements() == 0) return;
 	
-	int rank;
-	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-	transferRequests = new MPI_Request[bufferList->NumElements()];
-
 	for (int i = 0; i < bufferList->NumElements(); i++) {
 		TransferBuffer *buffer = bufferList->Nth(i);
-		long int size = buffer->getSize();
-		char *data = buffer->getData();
-		int sender = buffer->getSender();
-		int tag = buffer->getBufferTag();
-		int status = MPI_Irecv(data, size, MPI_CHAR, sender, tag, MPI_COMM_WORLD, &transferRequests[i]);
-		if (status != MPI_SUCCESS) {
-			cout << "Segment " << rank << ": could not issue asynchronous receive\n";
-			exit(EXIT_FAILURE);
+		buffer->startTransfer(false);
+	}
+}
+
+bool BufferTransferrer::progressTransfers() {
+	bool allComplete = true;
+	if (bufferList != NULL) {
+		for (int i = 0; i < bufferList->NumElements(); i++) {
+			TransferBuffer *buffer = bufferList->Nth(i);
+			allComplete = buffer->progressTransfer(sendMode) && allComplete;
 		}
 	}
+	return allComplete;
 }
 
 void BufferTransferrer::waitForTransferComplete(std::ofstream &logFile) {
+	while (!progressTransfers());
+}
 
-	if (bufferList != NULL && bufferList->NumElements() > 0) {
-		
-		int transferCount = bufferList->NumElements();
-		int status = MPI_Waitall(transferCount, transferRequests, MPI_STATUSES_IGNORE);
-        	if (status != MPI_SUCCESS) {
-                	cout << "some of the transfer requests failed to finish\n";
-                	exit(EXIT_FAILURE);
-        	}
-		if (!sendMode) {
-			for (int i = 0; i < bufferList->NumElements(); i++) {
-				TransferBuffer *buffer = bufferList->Nth(i);
-				buffer->postProcessBuffer(logFile);
-			}
-		}
+void BufferTransferrer::completeTransfers(BufferTransferrer *receiver, 
+		BufferTransferrer *sender, std::ofstream &logFile) {
+	bool receiveComplete = false;
+	bool sendComplete = false;
+	while (!(receiveComplete && sendComplete)) {
+		if (!receiveComplete) receiveComplete = receiver->progressTransfers();
+		if (!sendComplete) sendComplete = sender->progressTransfers();
 	}
 }	
 
@@ -563,13 +603,12 @@ void DataTransferManager::handleTransfer() {
 					targetContentMap, *logFile);
 
 	// then first issue asynchronous receives for all incoming buffers then issue asynchronous sends for all outgoing
-	// buffers; then wait for all transfers to finish
+	// buffers; then keep both going chunk by chunk till all transfers finish
 	BufferTransferrer *buffReceiver = new BufferTransferrer(false, incomingBuffers);
 	buffReceiver->receiveDataAsync(*logFile);
 	BufferTransferrer *buffSender = new BufferTransferrer(true, outgoingBuffers);
 	buffSender->sendDataAsync(*logFile);
-	buffSender->waitForTransferComplete(*logFile);
-	buffReceiver->waitForTransferComplete(*logFile);
+	BufferTransferrer::completeTransfers(buffReceiver, buffSender, *logFile);
 
 	// delete all the transfer buffers
 	if (incomingBuffers != NULL) {
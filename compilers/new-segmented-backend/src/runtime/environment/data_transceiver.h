@@ -19,8 +19,17 @@
 
 #include <mpi.h>
 #include <fstream>
+#include <vector>
 
 class DataExchange;
+class ExchangeIterator;
+class XformedIndexInfo;
+
+/* Data between two segments is transferred in chunks of at most this many bytes with up to two chunks of a transfer buffer 
+ * in flight at a time. This bounds the staging memory a transfer needs regardless of the amount of data being exchanged and
+ * lets packing or unpacking of one chunk overlap with the communication of the other. It also keeps the element count of 
+ * every MPI call within the range of an int for transfers of any size. */
+const long int Transfer_Chunk_Size = 4 * 1024 * 1024;
 
 /* After undertaking all steps before it can be discovered that data movement is needed due to an environment instruction, the
  * problem gets reduced to transferring data from a particular version reference in the program environment of the underlying 
@@ -111,7 +120,8 @@ class LocalTransferrer {
 
 /* This class holds a communication data buffer for a data transfer between the local segment and a remote segment. It also
  * retrieves data from the local source parts list (in case of an outgoing transfer) and populate data into the local target
- * parts list (in case of an incoming transfer) */
+ * parts list (in case of an incoming transfer). The data is transferred chunk by chunk through a staging area that can hold
+ * two chunks. */
 class TransferBuffer {
   private:
 	char *data;
@@ -122,23 +132,43 @@ class TransferBuffer {
 	DataPartSpec *partListSpec;
 	TransferSpec *transferSpec;
 	PartIdContainer *partContainerTree;
+
+	// chunking of the data; the last chunk may have fewer elements than the others
+	long int elementCount;
+	long int chunkElements;
+	long int chunkCount;
+	// chunk N is staged in slot (N mod 2) of the staging area
+	MPI_Request chunkRequests[2];
+	long int chunksPosted;
+	long int chunksCompleted;
+
+	// the traversal of data elements continues from one chunk to the next 
+	ExchangeIterator *elementIterator;
+	std::vector<XformedIndexInfo*> *transformVector;
   public:
 	TransferBuffer(int sender, int receiver, 
 			DataExchange *exchange, 
 			DataPartSpec *partListSpec, TransferSpec *transferSpec, 
 			PartIdContainer *partContainerTree);
 	~TransferBuffer();
-	void preprocessBuffer(std::ofstream &logFile);
 	int getSender() { return sender; }
 	int getReceiver() { return receiver; }
 	void setBufferTag(int bufferTag) { this->bufferTag = bufferTag; }
 	int getBufferTag() { return bufferTag; }
-	char *getData() { return data; }
-	void postProcessBuffer(std::ofstream &logFile);
 	int compareTo(TransferBuffer *other);
 	long int getSize();
+	long int getChunkCount() { return chunkCount; }
+
+	// initiates the transfers of the first chunks; for an outgoing transfer, chunks are filled from the data parts first
+	void startTransfer(bool sendMode);
+	// Checks if the earliest chunk in flight has been transferred and, if it has, posts the transfer of the next chunk in 
+	// its place; for an incoming transfer, the received chunk is copied into the data parts before its slot is reused. This
+	// is repeated until a chunk in flight is found incomplete. The function returns true when all chunks are done.
+	bool progressTransfer(bool sendMode);
   private:
-	void processBuffer(std::ofstream &logFile);
+	long int getChunkElementCount(long int chunkNo);
+	void postChunk(bool sendMode, long int chunkNo);
+	void processChunk(char *chunk, long int chunkElementCount);
 };
 
 /* This class prepare data transfer buffers for both incoming and outgoing communications */
@@ -168,13 +198,18 @@ class BufferTransferrer {
   private:
 	bool sendMode;
 	List<TransferBuffer*> *bufferList;
-	MPI_Request *transferRequests;
   public:
 	BufferTransferrer(bool mode, List<TransferBuffer*> *bufferList);
-	~BufferTransferrer();
 	void sendDataAsync(std::ofstream &logFile);
 	void receiveDataAsync(std::ofstream &logFile);
+	// advances the chunked transfers of all buffers without blocking; returns true when all of them are complete
+	bool progressTransfers();
 	void waitForTransferComplete(std::ofstream &logFile);	
+
+	// Drives the transfers of a receiving and a sending transferrer till both are complete. The two should progress 
+	// together, as a segment may not be able to send its next chunk to a peer before that peer receives a chunk from it. 
+	static void completeTransfers(BufferTransferrer *receiver, 
+			BufferTransferrer *sender, std::ofstream &logFile);
 };
 
 /* This class handles all aspects of data transfer from a parts list in the environment to one of its alternatives in the
@@ -2,6 +2,7 @@
 #include "environment.h"
 #include "data_transceiver.h"
 #include "array_transfer.h"
+#include "checkpoint.h"
 
 #include "../memory-management/allocation.h"
 #include "../memory-management/part_generation.h"
@@ -384,7 +385,12 @@ void ReadFromFileInstruction::setupDimensions() {
 	TaskEnvironment *environment = itemToUpdate->getEnvironment();
 	EnvironmentLinkKey *envKey = itemToUpdate->getEnvLinkKey();
 	const char *itemName = envKey->getVarName();
-	TypedInputStream<char> *stream = new TypedInputStream<char>(fileName);
+
+	// the file may have been written by an earlier task and its content may still be in the output queues of the
+	// segments
+	AsyncPartWriteQueue::waitForFileInAllSegments(fileName);
+	// only the dimension header of the file is read here; so the element type of the stream does not matter
+	TypedInputStream<char> *stream = new TypedInputStream<char>(fileName, false);
 	List<Dimension*> *dimensionList = stream->getDimensionList();
 	for (int i = 0; i < dimensionList->NumElements(); i++) {
 		Dimension *dimension = dimensionList->Nth(i);
@@ -411,6 +417,9 @@ void ReadFromFileInstruction::setupPartsList() {
 		List<DataPart*> *dataParts = partsList->getDataParts();
 		if (dataParts == NULL) return;
 
+		// the content of the file is overwritten from the checkpoint when a program is being restarted
+		if (CheckpointManager::isReplaying(taskEnv->getTaskId())) continue;
+
 		PartReader *partReader = taskEnv->getPartReader(itemName, lpsId);		
 		partReader->setFileName(fileName);
 		partReader->processParts();
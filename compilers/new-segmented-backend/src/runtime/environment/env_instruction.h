@@ -136,6 +136,7 @@ class ReadFromFileInstruction : public TaskInitEnvInstruction {
 		this->fileName = NULL;
 	}
 	void setFileName(const char *fileName) { this->fileName = fileName; }
+	const char *getFileName() { return fileName; }
 	
 	// read the dimension metadata that appears at the beginning of the data file and copy back that information in the
 	// dimension properties of the task-item
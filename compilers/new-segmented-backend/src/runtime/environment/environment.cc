@@ -1,5 +1,6 @@
 #include "environment.h"
 #include "env_instruction.h"
+#include "checkpoint.h"
 
 #include "../memory-management/allocation.h"
 #include "../memory-management/part_generation.h"
@@ -525,6 +526,10 @@ TaskEnvironment::TaskEnvironment() {
 	this->readersMap = NULL;
 	this->writersMap = NULL;
 	this->progEnv = NULL;
+	this->taskId = -1;
+
+	// the values of the non-array variables of all environments are saved in checkpoints
+	CheckpointManager::registerEnvironment(this);
 }
 
 PartReader *TaskEnvironment::getPartReader(const char *itemName, const char *lpsId) {
@@ -556,6 +561,9 @@ void TaskEnvironment::setDefaultEnvInitInstrs() {
 
 void TaskEnvironment::writeItemToFile(const char *itemName, const char *filePath) {
 	
+	// the output of a task that is not executed again during a restart has been written by the earlier run
+	if (CheckpointManager::isReplaying(taskId)) return;
+
 	TaskItem *item = envItems->Lookup(itemName);
 	const char *allocatorLps = item->getFirstAllocationsLpsId();
 	if (allocatorLps == NULL) return;
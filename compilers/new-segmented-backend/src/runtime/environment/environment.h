@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <fstream>
+#include <iostream>
 
 /* This library holds all the data structure definitionss related to enviornment managements of a multi-tasked IT program. 
  * The first set of classes are for program environment related data structures and the seconds are for task environment
@@ -216,6 +217,7 @@ class ObjectVersionManager {
   public:
 	ObjectVersionManager(ObjectIdentifier *objectIdentifier, PartsListReference* sourceReference);
 	~ObjectVersionManager();
+	ObjectIdentifier *getIdentifier() { return objectIdentifier; }
 	void addNewVersion(PartsListReference *versionReference);
 	void removeVersion(ListReferenceKey *versionKey);
 	PartsListReference *getVersion(char *versionKey);
@@ -237,6 +239,7 @@ class ProgramEnvironment {
 	void addNewDataItem(ObjectIdentifier *identifier, PartsListReference* sourceReference);
 	ObjectVersionManager *getVersionManager(char *dataItemKey);
 	void cleanupPossiblyEmptyVersionManager(char *dataItemKey);	
+	Iterator<ObjectVersionManager*> getVersionManagers() { return envObjects->GetIterator(); }
 };
 
 /*------------------------------------------------------------------------------------------------------------------------
@@ -376,6 +379,11 @@ class TaskEnvironment {
 	virtual void prepareItemsMap() = 0;
 	virtual void setDefaultTaskCompletionInstrs() = 0;
 
+	// task specific environment subclasses having non-array variables override these two functions to save and 
+	// restore the values of those variables in checkpoints
+	virtual void writeScalarProperties(std::ostream &stream) {}
+	virtual void readScalarProperties(std::istream &stream) {}
+
 	// functions to register an environment object manipulation instruction
 	void addInitEnvInstruction(TaskInitEnvInstruction *instr);
 	void addEndEnvInstruction(TaskEndEnvInstruction *instr);
@@ -0,0 +1,444 @@
+#include "chunked_format.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <map>
+
+using namespace chunkedio;
+
+static const char Magic[8] = { 'I', 'T', 'C', 'H', 'U', 'N', 'K', '\0' };
+
+// the size of the fixed part of the header that precedes the dimension lengths
+static const int Fixed_Header_Size = 24;
+
+// the size of an entry of the chunk index in the file
+static const int Index_Entry_Size = 32;
+
+//----------------------------------------------------------- Utility Functions ----------------------------------------------------------/
+
+bool chunkedio::isChunkedFile(const char *fileName) {
+	std::ifstream file(fileName, std::ios_base::binary);
+	if (!file.is_open()) return false;
+	char magic[8];
+	file.read(magic, 8);
+	bool chunked = (file.gcount() == 8 && memcmp(magic, Magic, 8) == 0);
+	file.close();
+	return chunked;
+}
+
+uint32_t chunkedio::adler32(const char *data, int64_t length) {
+	const uint32_t modulus = 65521;
+	uint32_t a = 1, b = 0;
+	const unsigned char *bytes = (const unsigned char *) data;
+	while (length > 0) {
+		// the sums can be accumulated over this many bytes before they need to be reduced
+		int64_t block = (length < 5552) ? length : 5552;
+		length -= block;
+		while (block-- > 0) {
+			a += *bytes++;
+			b += a;
+		}
+		a %= modulus;
+		b %= modulus;
+	}
+	return (b << 16) | a;
+}
+
+// In the run-length encoding, a control byte below 128 is followed by that many plus one literal bytes and a control
+// byte of 128 or more is followed by a single byte that is repeated (control - 128 + Min_Run) times.
+static const int Min_Run = 3;
+static const int Max_Run = 127 + Min_Run;
+static const int Max_Literals = 128;
+
+void chunkedio::encodeShuffleRle(const char *raw, int64_t length, int elementSize, std::vector<char> &encoded) {
+
+	// gather the bytes of the same significance of all elements together
+	int64_t elements = length / elementSize;
+	std::vector<char> shuffled(length);
+	for (int64_t i = 0; i < elements; i++) {
+		for (int b = 0; b < elementSize; b++) {
+			shuffled[b * elements + i] = raw[i * elementSize + b];
+		}
+	}
+	// any trailing bytes that do not make a whole element are kept as they are
+	for (int64_t i = elements * elementSize; i < length; i++) shuffled[i] = raw[i];
+
+	encoded.clear();
+	int64_t i = 0;
+	int64_t literalStart = 0;
+	while (i < length) {
+		int64_t run = 1;
+		while (i + run < length && run < Max_Run && shuffled[i + run] == shuffled[i]) run++;
+		if (run < Min_Run) {
+			i += run;
+			if (i - literalStart >= Max_Literals) {
+				encoded.push_back((char) (Max_Literals - 1));
+				encoded.insert(encoded.end(), &shuffled[literalStart], &shuffled[literalStart] + Max_Literals);
+				literalStart += Max_Literals;
+			}
+			continue;
+		}
+		while (literalStart < i) {
+			int64_t literals = i - literalStart;
+			if (literals > Max_Literals) literals = Max_Literals;
+			encoded.push_back((char) (literals - 1));
+			encoded.insert(encoded.end(), &shuffled[literalStart], &shuffled[literalStart] + literals);
+			literalStart += literals;
+		}
+		encoded.push_back((char) (128 + run - Min_Run));
+		encoded.push_back(shuffled[i]);
+		i += run;
+		literalStart = i;
+	}
+	while (literalStart < length) {
+		int64_t literals = length - literalStart;
+		if (literals > Max_Literals) literals = Max_Literals;
+		encoded.push_back((char) (literals - 1));
+		encoded.insert(encoded.end(), &shuffled[literalStart], &shuffled[literalStart] + literals);
+		literalStart += literals;
+	}
+}
+
+bool chunkedio::decodeShuffleRle(const char *encoded, int64_t encodedLength,
+		int elementSize, char *raw, int64_t rawLength) {
+
+	std::vector<char> shuffled(rawLength);
+	int64_t in = 0, out = 0;
+	while (in < encodedLength) {
+		int control = (unsigned char) encoded[in++];
+		if (control < 128) {
+			int64_t literals = control + 1;
+			if (in + literals > encodedLength || out + literals > rawLength) return false;
+			memcpy(&shuffled[out], encoded + in, literals);
+			in += literals;
+			out += literals;
+		} else {
+			int64_t run = control - 128 + Min_Run;
+			if (in >= encodedLength || out + run > rawLength) return false;
+			memset(&shuffled[out], encoded[in++], run);
+			out += run;
+		}
+	}
+	if (out != rawLength) return false;
+
+	int64_t elements = rawLength / elementSize;
+	for (int64_t i = 0; i < elements; i++) {
+		for (int b = 0; b < elementSize; b++) {
+			raw[i * elementSize + b] = shuffled[b * elements + i];
+		}
+	}
+	for (int64_t i = elements * elementSize; i < rawLength; i++) raw[i] = shuffled[i];
+	return true;
+}
+
+//------------------------------------------------------------- Chunk Layout -------------------------------------------------------------/
+
+ChunkLayout::ChunkLayout() {
+	elementSize = 0;
+	dimensionality = 0;
+	chunkCount = 0;
+}
+
+void ChunkLayout::setup(int elementSize, int dimensionality, const int64_t *dimensions, const int64_t *chunkShape) {
+	this->elementSize = elementSize;
+	this->dimensionality = dimensionality;
+	this->dimensions.assign(dimensions, dimensions + dimensionality);
+	this->chunkShape.assign(chunkShape, chunkShape + dimensionality);
+	chunkGrid.resize(dimensionality);
+	chunkCount = 1;
+	for (int i = 0; i < dimensionality; i++) {
+		chunkGrid[i] = (dimensions[i] + chunkShape[i] - 1) / chunkShape[i];
+		chunkCount *= chunkGrid[i];
+	}
+}
+
+int64_t ChunkLayout::getChunkNo(const int *index) {
+	int64_t chunkNo = 0;
+	for (int i = 0; i < dimensionality; i++) {
+		chunkNo = chunkNo * chunkGrid[i] + index[i] / chunkShape[i];
+	}
+	return chunkNo;
+}
+
+int64_t ChunkLayout::getPositionInChunk(const int *index) {
+	int64_t position = 0;
+	for (int i = 0; i < dimensionality; i++) {
+		int64_t chunkStart = (index[i] / chunkShape[i]) * chunkShape[i];
+		int64_t extent = dimensions[i] - chunkStart;
+		if (extent > chunkShape[i]) extent = chunkShape[i];
+		position = position * extent + (index[i] - chunkStart);
+	}
+	return position;
+}
+
+void ChunkLayout::getChunkRange(int64_t chunkNo, int64_t *first, int64_t *last) {
+	for (int i = dimensionality - 1; i >= 0; i--) {
+		int64_t gridIndex = chunkNo % chunkGrid[i];
+		chunkNo /= chunkGrid[i];
+		first[i] = gridIndex * chunkShape[i];
+		last[i] = first[i] + chunkShape[i] - 1;
+		if (last[i] >= dimensions[i]) last[i] = dimensions[i] - 1;
+	}
+}
+
+void ChunkLayout::suggestChunkShape(int elementSize, int dimensionality,
+		const int64_t *dimensions, int64_t chunkBytes, int64_t *chunkShape) {
+	int64_t budget = chunkBytes / elementSize;
+	if (budget < 1) budget = 1;
+	for (int i = dimensionality - 1; i >= 0; i--) {
+		int64_t extent = (dimensions[i] < budget) ? dimensions[i] : budget;
+		if (extent < 1) extent = 1;
+		chunkShape[i] = extent;
+		budget /= extent;
+	}
+}
+
+//--------------------------------------------------------- Chunked Array Writer ---------------------------------------------------------/
+
+ChunkedArrayWriter::ChunkedArrayWriter(const char *fileName, int elementSize, int dimensionality,
+		const int64_t *dimensions, const int64_t *chunkShape, Codec codec) : ChunkLayout() {
+	this->fileName = fileName;
+	this->codec = codec;
+	if (chunkShape != NULL) {
+		setup(elementSize, dimensionality, dimensions, chunkShape);
+	} else {
+		std::vector<int64_t> suggestedShape(dimensionality);
+		suggestChunkShape(elementSize, dimensionality, dimensions, Default_Chunk_Bytes, &suggestedShape[0]);
+		setup(elementSize, dimensionality, dimensions, &suggestedShape[0]);
+	}
+}
+
+void ChunkedArrayWriter::writeArray(const char *data) {
+
+	std::ofstream stream(fileName, std::ios_base::binary | std::ios_base::trunc);
+	if (!stream.is_open()) {
+		std::cout << "could not open output file: " << fileName << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	// write the fixed part of the header and reserve space for the chunk index that is filled in at the end
+	stream.write(Magic, 8);
+	int32_t fields[4] = { Format_Version, elementSize, dimensionality, 0 };
+	stream.write((char *) fields, sizeof(fields));
+	stream.write((char *) &dimensions[0], dimensionality * sizeof(int64_t));
+	stream.write((char *) &chunkShape[0], dimensionality * sizeof(int64_t));
+	stream.write((char *) &chunkCount, sizeof(int64_t));
+	int64_t indexPosition = stream.tellp();
+	std::vector<char> emptyIndex(chunkCount * Index_Entry_Size, 0);
+	stream.write(&emptyIndex[0], emptyIndex.size());
+
+	std::vector<int64_t> first(dimensionality), last(dimensionality), index(dimensionality);
+	std::vector<ChunkEntry> chunkIndex(chunkCount);
+	std::vector<char> raw;
+	std::vector<char> encoded;
+	for (int64_t chunkNo = 0; chunkNo < chunkCount; chunkNo++) {
+
+		// gather the elements of the chunk in row-major order
+		getChunkRange(chunkNo, &first[0], &last[0]);
+		int64_t rowLength = last[dimensionality - 1] - first[dimensionality - 1] + 1;
+		raw.clear();
+		for (int i = 0; i < dimensionality; i++) index[i] = first[i];
+		bool done = false;
+		while (!done) {
+			int64_t position = 0;
+			for (int i = 0; i < dimensionality; i++) position = position * dimensions[i] + index[i];
+			const char *row = data + position * elementSize;
+			raw.insert(raw.end(), row, row + rowLength * elementSize);
+
+			// advance to the next row of the chunk
+			done = true;
+			for (int i = dimensionality - 2; i >= 0; i--) {
+				if (index[i] < last[i]) {
+					index[i]++;
+					done = false;
+					break;
+				}
+				index[i] = first[i];
+			}
+		}
+
+		ChunkEntry &entry = chunkIndex[chunkNo];
+		entry.offset = stream.tellp();
+		entry.rawLength = raw.size();
+		entry.checksum = adler32(&raw[0], raw.size());
+		entry.codec = RAW;
+		if (codec == SHUFFLE_RLE) {
+			encodeShuffleRle(&raw[0], raw.size(), elementSize, encoded);
+			if (encoded.size() < raw.size()) entry.codec = SHUFFLE_RLE;
+		}
+		if (entry.codec == SHUFFLE_RLE) {
+			entry.storedLength = encoded.size();
+			stream.write(&encoded[0], encoded.size());
+		} else {
+			entry.storedLength = raw.size();
+			stream.write(&raw[0], raw.size());
+		}
+	}
+
+	// fill in the chunk index
+	stream.seekp(indexPosition, std::ios_base::beg);
+	for (int64_t chunkNo = 0; chunkNo < chunkCount; chunkNo++) {
+		ChunkEntry &entry = chunkIndex[chunkNo];
+		stream.write((char *) &entry.offset, sizeof(int64_t));
+		stream.write((char *) &entry.storedLength, sizeof(int64_t));
+		stream.write((char *) &entry.rawLength, sizeof(int64_t));
+		stream.write((char *) &entry.codec, sizeof(uint32_t));
+		stream.write((char *) &entry.checksum, sizeof(uint32_t));
+	}
+	if (stream.fail()) {
+		std::cout << "could not write output file: " << fileName << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	stream.close();
+}
+
+//--------------------------------------------------------- Chunked Array Reader ---------------------------------------------------------/
+
+ChunkedArrayReader::ChunkedArrayReader(const char *fileName, int cacheCapacity) : ChunkLayout() {
+	this->fileName = fileName;
+	this->cacheCapacity = (cacheCapacity > 0) ? cacheCapacity : 1;
+	readHeader();
+}
+
+ChunkedArrayReader::~ChunkedArrayReader() {
+	std::map<int64_t, std::vector<char>*>::iterator it;
+	for (it = chunkCache.begin(); it != chunkCache.end(); ++it) delete it->second;
+	if (stream.is_open()) stream.close();
+}
+
+void ChunkedArrayReader::readHeader() {
+	open();
+	char magic[8];
+	stream.read(magic, 8);
+	if (stream.gcount() != 8 || memcmp(magic, Magic, 8) != 0) {
+		std::cout << "not a chunked array file: " << fileName << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	int32_t fields[4];
+	stream.read((char *) fields, sizeof(fields));
+	if (fields[0] != Format_Version) {
+		std::cout << "unsupported chunked array file version " << fields[0] << " in: " << fileName << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	int elementSize = fields[1];
+	int dimensionality = fields[2];
+	std::vector<int64_t> dimensions(dimensionality), chunkShape(dimensionality);
+	stream.read((char *) &dimensions[0], dimensionality * sizeof(int64_t));
+	stream.read((char *) &chunkShape[0], dimensionality * sizeof(int64_t));
+	setup(elementSize, dimensionality, &dimensions[0], &chunkShape[0]);
+
+	int64_t storedChunkCount;
+	stream.read((char *) &storedChunkCount, sizeof(int64_t));
+	if (storedChunkCount != chunkCount) {
+		std::cout << "corrupted chunk index in: " << fileName << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	chunkIndex.resize(chunkCount);
+	for (int64_t chunkNo = 0; chunkNo < chunkCount; chunkNo++) {
+		ChunkEntry &entry = chunkIndex[chunkNo];
+		stream.read((char *) &entry.offset, sizeof(int64_t));
+		stream.read((char *) &entry.storedLength, sizeof(int64_t));
+		stream.read((char *) &entry.rawLength, sizeof(int64_t));
+		stream.read((char *) &entry.codec, sizeof(uint32_t));
+		stream.read((char *) &entry.checksum, sizeof(uint32_t));
+	}
+	if (stream.fail()) {
+		std::cout << "could not read the header of: " << fileName << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	close();
+}
+
+void ChunkedArrayReader::open() {
+	if (stream.is_open()) return;
+	stream.open(fileName, std::ios_base::binary);
+	if (!stream.is_open()) {
+		std::cout << "could not open input file: " << fileName << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+}
+
+void ChunkedArrayReader::close() {
+	if (stream.is_open()) stream.close();
+}
+
+std::vector<char> *ChunkedArrayReader::loadChunk(int64_t chunkNo) {
+
+	ChunkEntry &entry = chunkIndex[chunkNo];
+	std::vector<char> stored(entry.storedLength);
+	open();
+	stream.seekg(entry.offset, std::ios_base::beg);
+	stream.read(&stored[0], entry.storedLength);
+	if (stream.gcount() != entry.storedLength) {
+		std::cout << "could not read chunk " << chunkNo << " of: " << fileName << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::vector<char> *raw = new std::vector<char>(entry.rawLength);
+	bool decoded = true;
+	if (entry.codec == SHUFFLE_RLE) {
+		decoded = decodeShuffleRle(&stored[0], entry.storedLength, elementSize, &(*raw)[0], entry.rawLength);
+	} else if (entry.codec == RAW && entry.storedLength == entry.rawLength) {
+		raw->swap(stored);
+	} else {
+		decoded = false;
+	}
+	if (!decoded || adler32(&(*raw)[0], entry.rawLength) != entry.checksum) {
+		std::cout << "chunk " << chunkNo << " of " << fileName << " is corrupted\n";
+		std::exit(EXIT_FAILURE);
+	}
+	return raw;
+}
+
+const char *ChunkedArrayReader::getChunk(int64_t chunkNo) {
+	std::map<int64_t, std::vector<char>*>::iterator it = chunkCache.find(chunkNo);
+	if (it != chunkCache.end()) return &(*it->second)[0];
+
+	// evict the chunk that has been loaded earliest if the cache is full
+	if ((int) cacheOrder.size() >= cacheCapacity) {
+		int64_t evicted = cacheOrder.front();
+		cacheOrder.pop_front();
+		delete chunkCache[evicted];
+		chunkCache.erase(evicted);
+	}
+	std::vector<char> *chunk = loadChunk(chunkNo);
+	chunkCache[chunkNo] = chunk;
+	cacheOrder.push_back(chunkNo);
+	return &(*chunk)[0];
+}
+
+void ChunkedArrayReader::readElement(const int *index, void *element) {
+	const char *chunk = getChunk(getChunkNo(index));
+	memcpy(element, chunk + getPositionInChunk(index) * elementSize, elementSize);
+}
+
+void ChunkedArrayReader::prefetchRegion(const int *first, const int *last) {
+
+	// determine the range of chunks along each dimension that overlap the region
+	std::vector<int64_t> firstChunk(dimensionality), lastChunk(dimensionality), current(dimensionality);
+	int64_t overlapping = 1;
+	for (int i = 0; i < dimensionality; i++) {
+		firstChunk[i] = first[i] / chunkShape[i];
+		lastChunk[i] = last[i] / chunkShape[i];
+		overlapping *= lastChunk[i] - firstChunk[i] + 1;
+		current[i] = firstChunk[i];
+	}
+	if (overlapping > cacheCapacity) return;
+
+	for (int64_t n = 0; n < overlapping; n++) {
+		int64_t chunkNo = 0;
+		for (int i = 0; i < dimensionality; i++) chunkNo = chunkNo * chunkGrid[i] + current[i];
+		getChunk(chunkNo);
+		for (int i = dimensionality - 1; i >= 0; i--) {
+			if (current[i] < lastChunk[i]) {
+				current[i]++;
+				break;
+			}
+			current[i] = firstChunk[i];
+		}
+	}
+}
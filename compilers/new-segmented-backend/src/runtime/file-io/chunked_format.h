@@ -0,0 +1,142 @@
+#ifndef _H_chunked_format
+#define _H_chunked_format
+
+/* This header defines a chunked binary container format for arrays as an alternative to the plain format of a text
+   'dim*dim*...' header followed by raw elements. In the chunked format, the array is divided into regular
+   multidimensional tiles, called chunks, that are stored independently. Each chunk can be compressed and carries a
+   checksum of its content. A reader only needs to fetch the chunks that hold the elements it needs, so reading a
+   single data part of a large array, or of a reordered partition, does not scan the entire file.
+
+   The file layout is as follows; all integers are stored in the byte order of the machine that wrote the file.
+
+	magic 'ITCHUNK\0'		8 bytes
+	version				4 bytes
+	element size			4 bytes
+	dimensionality (d)		4 bytes
+	reserved			4 bytes
+	dimension lengths		d x 8 bytes
+	chunk shape			d x 8 bytes
+	chunk count (c)			8 bytes
+	chunk index			c x 32 bytes: file offset, stored length, raw length (8 bytes each), codec and
+					checksum (4 bytes each)
+	chunk contents
+
+   Chunks are ordered in the row-major order of the grid of chunks and elements within a chunk are in the row-major
+   order of the chunk, with chunks at the upper boundaries of the array being clipped to the array. The codec of a
+   chunk is recorded in the index so that chunks that do not compress well are simply stored raw. The only codec
+   other than raw storage shuffles the bytes of the elements so that bytes of the same significance come together,
+   then run-length encodes them; this is fast and effective for sparse arrays and arrays of slowly varying values.
+   Checksums are Adler-32 checksums of the raw content of the chunks.
+
+   This header does not depend on any other part of the runtime library so that standalone conversion tools can use
+   it too.
+*/
+
+#include <stdint.h>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <map>
+
+namespace chunkedio {
+
+	enum Codec { RAW = 0, SHUFFLE_RLE = 1 };
+
+	const int Format_Version = 1;
+
+	// by default a chunk is made to hold about this many bytes of raw content
+	const int64_t Default_Chunk_Bytes = 1 << 20;
+
+	// returns true if the file starts with the magic string of the chunked format
+	bool isChunkedFile(const char *fileName);
+
+	uint32_t adler32(const char *data, int64_t length);
+
+	// the encoding and decoding routines of the shuffle and run-length codec
+	void encodeShuffleRle(const char *raw, int64_t length, int elementSize, std::vector<char> &encoded);
+	bool decodeShuffleRle(const char *encoded, int64_t encodedLength,
+			int elementSize, char *raw, int64_t rawLength);
+
+	class ChunkEntry {
+	  public:
+		int64_t offset;
+		int64_t storedLength;
+		int64_t rawLength;
+		uint32_t codec;
+		uint32_t checksum;
+	};
+
+	/* the geometry of an array and its chunks that both the reader and writer need */
+	class ChunkLayout {
+	  protected:
+		int elementSize;
+		int dimensionality;
+		std::vector<int64_t> dimensions;
+		std::vector<int64_t> chunkShape;
+		std::vector<int64_t> chunkGrid;
+		int64_t chunkCount;
+	  public:
+		ChunkLayout();
+		void setup(int elementSize, int dimensionality, const int64_t *dimensions, const int64_t *chunkShape);
+		int getElementSize() { return elementSize; }
+		int getDimensionality() { return dimensionality; }
+		int64_t getDimensionLength(int dimension) { return dimensions[dimension]; }
+		int64_t getChunkCount() { return chunkCount; }
+
+		// determines the chunk holding an element and the position of the element within that chunk
+		int64_t getChunkNo(const int *index);
+		int64_t getPositionInChunk(const int *index);
+
+		// determines the index range of the elements of a chunk
+		void getChunkRange(int64_t chunkNo, int64_t *first, int64_t *last);
+
+		// returns a chunk shape that holds about the argument number of bytes with chunks spanning the trailing
+		// dimensions of the array as far as possible
+		static void suggestChunkShape(int elementSize, int dimensionality,
+				const int64_t *dimensions, int64_t chunkBytes, int64_t *chunkShape);
+	};
+
+	/* writes an entire array held in row-major order in memory in a chunked file */
+	class ChunkedArrayWriter : public ChunkLayout {
+	  private:
+		const char *fileName;
+		Codec codec;
+	  public:
+		// if the chunk shape is NULL, a suggested chunk shape is used
+		ChunkedArrayWriter(const char *fileName, int elementSize, int dimensionality,
+				const int64_t *dimensions, const int64_t *chunkShape, Codec codec);
+		void writeArray(const char *data);
+	};
+
+	/* reads individual elements or chunks of a chunked file; decoded chunks are cached */
+	class ChunkedArrayReader : public ChunkLayout {
+	  private:
+		const char *fileName;
+		std::ifstream stream;
+		std::vector<ChunkEntry> chunkIndex;
+		int cacheCapacity;
+		std::map<int64_t, std::vector<char>*> chunkCache;
+		std::deque<int64_t> cacheOrder;
+	  public:
+		// reads the header and chunk index of the file
+		ChunkedArrayReader(const char *fileName, int cacheCapacity = 64);
+		~ChunkedArrayReader();
+		void open();
+		void close();
+
+		// copies an element into the argument memory location
+		void readElement(const int *index, void *element);
+
+		// loads all the chunks overlapping the argument index range in the cache, if they fit; this is useful to
+		// fetch the content of a data part in a few large reads before accessing its elements one by one
+		void prefetchRegion(const int *first, const int *last);
+
+		// returns the decoded content of a chunk; the content remains valid until the chunk leaves the cache
+		const char *getChunk(int64_t chunkNo);
+	  private:
+		void readHeader();
+		std::vector<char> *loadChunk(int64_t chunkNo);
+	};
+}
+
+#endif
@@ -11,6 +11,15 @@
 #include "../../../../common-libs/domain-obj/structure.h"
 
 #include <mpi.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sstream>
+#include <deque>
+#include <vector>
+#include <string>
+#include <set>
 
 //--------------------------------------------------------------- Part Info --------------------------------------------------------------/
 
@@ -155,6 +164,11 @@ List<int> *PartHandler::getDataIndex(List<int> *partIndex) {
 
 void PartHandler::processParts() {
 	begin();
+	processAllParts();
+	terminate();
+}
+
+void PartHandler::processAllParts() {
 	currentPartInfo = new PartInfo();
 	for (int i = 0; i < dataParts->NumElements(); i++) {
 		
@@ -172,7 +186,6 @@ void PartHandler::processParts() {
 		postProcessPart(dataPart);
 	}
 	delete currentPartInfo;
-	terminate();
 }
 
 void PartHandler::calculateCurrentPartInfo() {
@@ -237,6 +250,11 @@ long int PartHandler::getStorageIndex(List<int> *partIndex, Dimension *partDimen
 
 void PartWriter::processParts() {
 
+	if (asynchronous && elementSize > 0) {
+		processPartsAsynchronously();
+		return;
+	}
+
 	// wait for the previous writer to complete
 	if (writerId != 0) {
                 int predecessorDone = 0;
@@ -254,3 +272,195 @@ void PartWriter::processParts() {
 		MPI_Isend(&writingDone, 1, MPI_INT, writerId + 1, 0, MPI_COMM_WORLD, &sendRequest);
 	}
 }
+
+void PartWriter::processPartsAsynchronously() {
+
+	// an earlier write of the same file must not land after this one
+	AsyncPartWriteQueue::waitForFile(fileName);
+
+	// prepare the dimension header the same way the typed output stream does
+	stagedWrite = new StagedPartWrite();
+	stagedWrite->fileName = std::string(fileName);
+	stagedWrite->writeHeader = (writerId == 0);
+	std::ostringstream header;
+	long int totalElements = 1;
+	for (int i = 0; i < dataDimensionality; i++) {
+		if (i > 0) header << "*";
+		header << dataDimensions[i].length;
+		totalElements *= dataDimensions[i].length;
+	}
+	header << '\n';
+	stagedWrite->header = header.str();
+	stagedWrite->fileLength = stagedWrite->header.length() + ((off_t) totalElements) * elementSize;
+
+	// take the snapshot of the parts
+	long int stagedElements = 0;
+	for (int i = 0; i < dataParts->NumElements(); i++) {
+		stagedElements += dataParts->Nth(i)->getMetadata()->getSize();
+	}
+	stagedWrite->buffer.reserve(stagedElements * elementSize);
+	processAllParts();
+
+	// the parts of the file are written by all segments
+	AsyncPartWriteQueue::submit(stagedWrite, true);
+	stagedWrite = NULL;
+}
+
+void PartWriter::stageElement(List<int> *dataIndex, long int storeIndex, void *partStore) {
+	long int position = 0;
+	for (int i = 0; i < dataDimensionality; i++) {
+		position = position * dataDimensions[i].length + dataIndex->Nth(i);
+	}
+	off_t fileOffset = stagedWrite->header.length() + ((off_t) position) * elementSize;
+	char *element = ((char *) partStore) + storeIndex * elementSize;
+	stagedWrite->stageElement(fileOffset, element, elementSize);
+}
+
+//---------------------------------------------------------- Staged Part Write -----------------------------------------------------------/
+
+void StagedPartWrite::stageElement(off_t fileOffset, void *element, int elementSize) {
+	long int bufferOffset = buffer.size();
+	char *bytes = (char *) element;
+	buffer.insert(buffer.end(), bytes, bytes + elementSize);
+	if (!runs.empty()) {
+		OutputRun &lastRun = runs.back();
+		if (lastRun.fileOffset + lastRun.length == fileOffset) {
+			lastRun.length += elementSize;
+			return;
+		}
+	}
+	OutputRun run;
+	run.fileOffset = fileOffset;
+	run.bufferOffset = bufferOffset;
+	run.length = elementSize;
+	runs.push_back(run);
+}
+
+static void writeFully(int fileDescriptor, const char *data, long int length, off_t offset, const char *fileName) {
+	while (length > 0) {
+		ssize_t written = pwrite(fileDescriptor, data, length, offset);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			cout << "could not write output file: " << fileName << "\n";
+			exit(EXIT_FAILURE);
+		}
+		data += written;
+		length -= written;
+		offset += written;
+	}
+}
+
+void StagedPartWrite::writeToFile() {
+
+	// The file is never truncated to zero length as writers of other segments may have already written their parts
+	// in it. Instead, the first writer sets the length of the file; a stale longer file is cut short and a new file
+	// is zero filled up to its full length this way.
+	int fileDescriptor = open(fileName.c_str(), O_WRONLY | O_CREAT, 0644);
+	if (fileDescriptor < 0) {
+		cout << "could not open output file: " << fileName << "\n";
+		exit(EXIT_FAILURE);
+	}
+	if (writeHeader) {
+		writeFully(fileDescriptor, header.c_str(), header.length(), 0, fileName.c_str());
+		if (ftruncate(fileDescriptor, fileLength) != 0) {
+			cout << "could not set the length of output file: " << fileName << "\n";
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (unsigned int i = 0; i < runs.size(); i++) {
+		OutputRun &run = runs[i];
+		writeFully(fileDescriptor, &buffer[run.bufferOffset], run.length, run.fileOffset, fileName.c_str());
+	}
+	close(fileDescriptor);
+}
+
+//------------------------------------------------------- Asynchronous Write Queue -------------------------------------------------------/
+
+bool AsyncPartWriteQueue::started = false;
+pthread_t AsyncPartWriteQueue::ioThread;
+pthread_mutex_t AsyncPartWriteQueue::queueLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t AsyncPartWriteQueue::queueCondition = PTHREAD_COND_INITIALIZER;
+std::deque<StagedPartWrite*> AsyncPartWriteQueue::pendingWrites;
+StagedPartWrite *AsyncPartWriteQueue::activeWrite = NULL;
+std::set<std::string> AsyncPartWriteQueue::sharedFilesWritten;
+
+void AsyncPartWriteQueue::submit(StagedPartWrite *stagedWrite, bool sharedFile) {
+	pthread_mutex_lock(&queueLock);
+	if (sharedFile) sharedFilesWritten.insert(stagedWrite->fileName);
+	if (!started) {
+		// the I/O thread lives till the end of the program; so it is detached and never joined
+		if (pthread_create(&ioThread, NULL, drainQueue, NULL) != 0) {
+			pthread_mutex_unlock(&queueLock);
+			cout << "could not start the output writer thread\n";
+			exit(EXIT_FAILURE);
+		}
+		pthread_detach(ioThread);
+		started = true;
+	}
+	while (pendingWrites.size() + (activeWrite != NULL ? 1 : 0) >= Max_Staged_Writes) {
+		pthread_cond_wait(&queueCondition, &queueLock);
+	}
+	pendingWrites.push_back(stagedWrite);
+	pthread_cond_broadcast(&queueCondition);
+	pthread_mutex_unlock(&queueLock);
+}
+
+bool AsyncPartWriteQueue::hasWriteForFile(const char *fileName) {
+	if (activeWrite != NULL && activeWrite->fileName.compare(fileName) == 0) return true;
+	for (unsigned int i = 0; i < pendingWrites.size(); i++) {
+		if (pendingWrites[i]->fileName.compare(fileName) == 0) return true;
+	}
+	return false;
+}
+
+void AsyncPartWriteQueue::waitForFile(const char *fileName) {
+	if (fileName == NULL) return;
+	pthread_mutex_lock(&queueLock);
+	while (hasWriteForFile(fileName)) {
+		pthread_cond_wait(&queueCondition, &queueLock);
+	}
+	pthread_mutex_unlock(&queueLock);
+}
+
+void AsyncPartWriteQueue::waitForFileInAllSegments(const char *fileName) {
+	if (fileName == NULL) return;
+	waitForFile(fileName);
+
+	pthread_mutex_lock(&queueLock);
+	bool written = (sharedFilesWritten.erase(std::string(fileName)) > 0);
+	pthread_mutex_unlock(&queueLock);
+
+	// the parts written by other segments are in the file only after they have drained their queues too
+	if (written) {
+		MPI_Barrier(MPI_COMM_WORLD);
+	}
+}
+
+void AsyncPartWriteQueue::flush() {
+	pthread_mutex_lock(&queueLock);
+	while (!pendingWrites.empty() || activeWrite != NULL) {
+		pthread_cond_wait(&queueCondition, &queueLock);
+	}
+	pthread_mutex_unlock(&queueLock);
+}
+
+void *AsyncPartWriteQueue::drainQueue(void *arg) {
+	while (true) {
+		pthread_mutex_lock(&queueLock);
+		while (pendingWrites.empty()) {
+			pthread_cond_wait(&queueCondition, &queueLock);
+		}
+		activeWrite = pendingWrites.front();
+		pendingWrites.pop_front();
+		pthread_mutex_unlock(&queueLock);
+
+		activeWrite->writeToFile();
+
+		pthread_mutex_lock(&queueLock);
+		delete activeWrite;
+		activeWrite = NULL;
+		pthread_cond_broadcast(&queueCondition);
+		pthread_mutex_unlock(&queueLock);
+	}
+	return NULL;
+}
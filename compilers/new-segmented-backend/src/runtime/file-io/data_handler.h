@@ -11,6 +11,13 @@
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/interval.h"
 #include "../../../../common-libs/domain-obj/structure.h"
+
+#include <pthread.h>
+#include <sys/types.h>
+#include <deque>
+#include <vector>
+#include <string>
+#include <set>
 	
 /* This is just a helper class to retain hierarchical information about a data part while IO is ongoing. Every element
    here is a list of list because hierarchical information for individual dimensions is stored separately. Information
@@ -73,6 +80,8 @@ class PartHandler {
 	
 	// this routine iterates the data section of all parts one-by-one for reading/writing   
 	virtual void processParts();
+	// the iteration of the above without the begin() and terminate() calls
+	void processAllParts();
 	// function to be called immediately after a new part has been selected for processing and before anything else 
 	// has been done with it
 	void calculateCurrentPartInfo();
@@ -119,6 +128,70 @@ class PartReader : public PartHandler {
 	virtual void readElement(List<int> *dataIndex, long int storeIndex, void *partStore) = 0;	
 };
 
+/* A contiguous range of bytes in an output file whose content is in a staging buffer */
+class OutputRun {
+  public:
+	off_t fileOffset;
+	long int bufferOffset;
+	long int length;
+};
+
+/* This holds a snapshot of the data parts a writer is supposed to write in a file. Once the snapshot is taken the 
+   parts can be updated by subsequent tasks while the snapshot is being written in the background. The elements are
+   copied into the staging buffer in the order the writer visits them and consecutive elements that are also 
+   consecutive in the file are coalesced into runs so that the file is updated with few large writes.
+*/
+class StagedPartWrite {
+  public:
+	std::string fileName;
+	// the dimension header and the total length of the file; only the first writer writes the header 
+	bool writeHeader;
+	std::string header;
+	off_t fileLength;
+	std::vector<char> buffer;
+	std::vector<OutputRun> runs;
+
+	void stageElement(off_t fileOffset, void *element, int elementSize);
+	// writes the staged content in the file using positional writes; so writers of different segments can update
+	// the same file simultaneously without any coordination
+	void writeToFile();
+};
+
+/* This static class manages the background thread that drains the staged writes of a segment. There can be at most
+   two staged writes in flight at a time -- one being written while the next one is being staged -- to bound the 
+   memory used for the snapshots.
+*/
+class AsyncPartWriteQueue {
+  private:
+	static const int Max_Staged_Writes = 2;
+	static bool started;
+	static pthread_t ioThread;
+	static pthread_mutex_t queueLock;
+	static pthread_cond_t queueCondition;
+	static std::deque<StagedPartWrite*> pendingWrites;
+	// the write the background thread is currently working on, if any
+	static StagedPartWrite *activeWrite;
+	// files that all segments have written parts of asynchronously since they last synchronized on them
+	static std::set<std::string> sharedFilesWritten;
+  public:
+	// blocks the caller if there are already too many staged writes in flight; a write to a file that all segments
+	// write parts of at the same point of the program should be marked as shared
+	static void submit(StagedPartWrite *stagedWrite, bool sharedFile = false);
+	// waits until no staged write for the argument file is pending in this segment; this should be done before 
+	// reading a file or writing it again
+	static void waitForFile(const char *fileName);
+	// Waits until no staged write for the argument file is pending in any segment; this should be done before reading
+	// a file other segments may have written. If the file has been written as a shared file since the last such wait
+	// then this is a collective operation over all segments; all of them read the file at the same point of the 
+	// program in that case as they have also written it at the same point.
+	static void waitForFileInAllSegments(const char *fileName);
+	// waits until all staged writes have been completed; this should be done before the program exits
+	static void flush();
+  private:
+	static bool hasWriteForFile(const char *fileName);
+	static void *drainQueue(void *arg);
+};
+
 /* base class to be extended for the writing process */
 class PartWriter : public PartHandler {
   protected:
@@ -129,25 +202,45 @@ class PartWriter : public PartHandler {
 	int writerId;
 	// for the same reason there is a count variable that keep tracks of the number of participating writers
 	int writersCount;
+
+	// An asynchronous writer stages the content of its parts in memory and lets a background thread write them in
+	// the file. This needs the element size to be known; an asynchronous writer with unknown element size falls 
+	// back to synchronous writing.
+	bool asynchronous;
+	int elementSize;
+	StagedPartWrite *stagedWrite;
   public:
 	PartWriter(int writerId, DataPartsList *partsList, DataPartitionConfig *partConfig) 
 			: PartHandler(partsList, partConfig) {
 		this->writerId = writerId;
+		this->asynchronous = false;
+		this->elementSize = 0;
+		this->stagedWrite = NULL;
 	}
 	void setWritersCount(int writersCount) { this->writersCount = writersCount; }
+	void setAsynchronous(bool asynchronous) { this->asynchronous = asynchronous; }
+	void setElementSize(int elementSize) { this->elementSize = elementSize; }
 
-	// Currently file writing happens sequentially. The first segment writes then notifies the second, then the 
-	// second segment writes and notifies the third, and so on. There needs to be signals that indicate when a 
-	// segment can start writing and when it is done. To send/receive these signals, part-writer overrides the
-	// base clase function.
+	// In synchronous mode, file writing happens sequentially. The first segment writes then notifies the second, 
+	// then the second segment writes and notifies the third, and so on. There needs to be signals that indicate when
+	// a segment can start writing and when it is done. To send/receive these signals, part-writer overrides the
+	// base clase function. In asynchronous mode, no signals are needed as the segments write at disjoint file 
+	// offsets.
 	void processParts();
 
 	// like the PartReader, this class also override the processElement() method to make writing process explicit
 	// for task specific subclasses  
 	void processElement(List<int> *dataIndex, long int storeIndex, void *partStore) {
-		writeElement(dataIndex, storeIndex, partStore);
+		if (stagedWrite != NULL) {
+			stageElement(dataIndex, storeIndex, partStore);
+		} else {
+			writeElement(dataIndex, storeIndex, partStore);
+		}
 	}
 	virtual void writeElement(List<int> *dataIndex, long int storeIndex, void *partStore) = 0;	
+  private:
+	void stageElement(List<int> *dataIndex, long int storeIndex, void *partStore);
+	void processPartsAsynchronously();
 };
 
 #endif
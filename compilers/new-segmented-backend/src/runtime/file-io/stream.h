@@ -5,6 +5,11 @@
    classes are templated; so any primitive type for elements of an array is supported naturally. To support 
    arrays of objects, minor changes be required (date: Jun-15-2015). In particular, regarding zero filling the 
    output stream at the beginning. 
+
+   The input stream also reads arrays stored in the chunked container format of chunked_format.h. The format of a 
+   file is detected from its first bytes and in the chunked format elements are served from decoded chunks; so only
+   the chunks overlapping the data parts being read are fetched from the file. Output streams always write the plain
+   format as segments update disjoint parts of the same file in parallel.  
 */
 
 #include <iostream>
@@ -18,6 +23,7 @@
 #include "../../../../common-libs/utils/list.h"
 #include "../../../../common-libs/utils/string_utils.h"
 #include "../../../../common-libs/domain-obj/structure.h"
+#include "chunked_format.h"
 
 using namespace std;
 
@@ -29,14 +35,30 @@ template <class Type> class TypedInputStream {
 	int dataBegins;
 	int seekStepSize;
 	ifstream stream;
+	// the reader is NULL unless the file is in the chunked format
+	chunkedio::ChunkedArrayReader *chunkedReader;
+	// the row-major position of the next element for sequential reads from a chunked file
+	long int nextPosition;
+	int *indexBuffer;
   public:
-	TypedInputStream(const char *fileName) {
+	// this is the maximum number of decoded chunks a stream keeps in memory at a time  
+	static const int Chunk_Cache_Size = 16;
+
+	// A stream that is only used to find the dimensions of the array stored in a file, without reading any element,
+	// can be created with element type checking disabled; then it can be instantiated with any type.
+	TypedInputStream(const char *fileName, bool checkElementSize = true) {
 		this->fileName = fileName;
 		seekStepSize = sizeof(Type);
-		initialize();
+		chunkedReader = NULL;
+		indexBuffer = NULL;
+		if (chunkedio::isChunkedFile(fileName)) {
+			initializeChunked(checkElementSize);
+		} else initialize();
 		
 	}
 	~TypedInputStream() {
+		delete chunkedReader;
+		delete[] indexBuffer;
 		while (dimLengths->NumElements() > 0) {
 			Dimension *dimension = dimLengths->Nth(0);
 			dimLengths->RemoveAt(0);
@@ -47,6 +69,11 @@ template <class Type> class TypedInputStream {
 	}
 
 	void open() {
+		if (chunkedReader != NULL) {
+			chunkedReader->open();
+			nextPosition = 0;
+			return;
+		}
 		stream.open(fileName, ios_base::binary);
 		if (!stream.is_open()) {
 			cout << "could not open input file: " << fileName << "\n";
@@ -54,14 +81,26 @@ template <class Type> class TypedInputStream {
 		}
 		stream.seekg(dataBegins, ios_base::beg);
 	}
-	void close() { stream.close(); }
+	void close() { 
+		if (chunkedReader != NULL) {
+			chunkedReader->close();
+		} else stream.close(); 
+	}
 	List<Dimension*> *getDimensionList() { return dimLengths; }
+	bool isChunked() { return chunkedReader != NULL; }
 
 	// read an element at a specific index of the array 
 	Type readElement(List<int> *index) {
+		Type element;
+		if (chunkedReader != NULL) {
+			for (int i = 0; i < index->NumElements(); i++) {
+				indexBuffer[i] = index->Nth(i);
+			}
+			chunkedReader->readElement(indexBuffer, &element);
+			return element;
+		}
 		long int seekPosition = getSeekPosition(index);
 		stream.seekg(seekPosition, ios_base::beg);
-		Type element;
 		stream.read(reinterpret_cast<char*>(&element), seekStepSize);
 		return element;
 	}
@@ -69,6 +108,16 @@ template <class Type> class TypedInputStream {
 	// read the element from current file read pointer location; use this with care 
 	Type readNextElement() {
 		Type element;
+		if (chunkedReader != NULL) {
+			long int position = nextPosition++;
+			for (int i = dimLengths->NumElements() - 1; i >= 0; i--) {
+				int length = dimLengths->Nth(i)->length;
+				indexBuffer[i] = position % length;
+				position /= length;
+			}
+			chunkedReader->readElement(indexBuffer, &element);
+			return element;
+		}
 		stream.read(reinterpret_cast<char*>(&element), seekStepSize);
 		return element;
 	}
@@ -86,6 +135,30 @@ template <class Type> class TypedInputStream {
 	}
 
   private:
+	void initializeChunked(bool checkElementSize) {
+		chunkedReader = new chunkedio::ChunkedArrayReader(fileName, Chunk_Cache_Size);
+		if (checkElementSize && chunkedReader->getElementSize() != seekStepSize) {
+			cout << "element size mismatch in chunked input file: " << fileName << "\n";
+			exit(EXIT_FAILURE);
+		}
+		int dimensionality = chunkedReader->getDimensionality();
+		dimLengths = new List<Dimension*>;
+		dimMultiplier = new List<int>;
+		int currentMultiplier = 1;
+		for (int i = dimensionality - 1; i >= 0; i--) {
+			Dimension *dim = new Dimension;
+			dim->range.min = 0;
+			dim->range.max = chunkedReader->getDimensionLength(i) - 1;
+			dim->setLength();
+			dimLengths->InsertAt(dim, 0);
+			dimMultiplier->InsertAt(currentMultiplier, 0);
+			currentMultiplier *= dim->length;
+		}
+		indexBuffer = new int[dimensionality];
+		dataBegins = 0;
+		nextPosition = 0;
+	}
+
 	void initialize() {
 
 		// try to open the file and if failed exit with an error
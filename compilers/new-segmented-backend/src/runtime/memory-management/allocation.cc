@@ -1,5 +1,6 @@
 #include "allocation.h"
 #include "part_tracking.h"
+#include "node_shared_memory.h"
 
 #include "../../../../common-libs/utils/utility.h"
 #include "../../../../common-libs/utils/list.h"
@@ -7,6 +8,8 @@
 
 #include <vector>
 #include <cstring>
+#include <string>
+#include <sstream>
 
 //---------------------------------------------------------------- Part Metadata ---------------------------------------------------------------/
 
@@ -82,17 +85,24 @@ DataPart::DataPart(PartMetadata *metadata, int epochCount, int elementSize) {
 	this->epochCount = epochCount;
 	this->dataVersions = new std::vector<void*>;
 	dataVersions->reserve(epochCount);
-	this->epochHead = 0;
+	this->epochGeneration = 0;
 	this->elementSize = elementSize;
+	this->sharingKey = NULL;
 }
 
 DataPart::~DataPart() {
 	delete metadata;
 	for (int i = 0; i < epochCount; i++) {
 		void *version = dataVersions->at(i);
-		free(version);
+		if (!NodeSharedMemory::release(version)) free(version);
 	}
 	delete dataVersions;
+	free(sharingKey);
+}
+
+void DataPart::shareOnNode(const char *key) {
+	free(sharingKey);
+	sharingKey = strdup(key);
 }
 
 void DataPart::allocate(int versionThreshold) {
@@ -101,6 +111,12 @@ void DataPart::allocate(int versionThreshold) {
 	long int allocationSize = elementSize * size;
 
 	for (int i = versionThreshold; i < epochCount; i++) {
+		if (sharingKey != NULL && NodeSharedMemory::isInitialized()) {
+			std::ostringstream versionKey;
+			versionKey << sharingKey << "-v" << i;
+			dataVersions->push_back(NodeSharedMemory::allocate(versionKey.str(), allocationSize));
+			continue;
+		}
 		void *allocation = malloc(sizeof(char) * allocationSize);
 		Assert(allocation != NULL);
 		char *data = (char *) allocation;
@@ -112,22 +128,21 @@ void DataPart::allocate(int versionThreshold) {
 }
 
 void *DataPart::getData() {
-	return dataVersions->at(epochHead);
+	return dataVersions->at(getVersionIndex(0));
 }
 
 void *DataPart::getData(int epoch) {
-	int versionIndex = (epochHead + epoch) % epochCount;
-	return dataVersions->at(versionIndex);
+	return dataVersions->at(getVersionIndex(epoch));
 }
 
 void DataPart::synchronizeAllVersions() {
 	
-	void *updatedData = dataVersions->at(epochHead);
+	void *updatedData = dataVersions->at(getVersionIndex(0));
 	long int partSize = metadata->getSize() * elementSize;
 	
 	int epoch = 1;
 	while (epoch < epochCount) {
-		int versionIndex = (epochHead + epoch) % epochCount;
+		int versionIndex = getVersionIndex(epoch);
 		void *staleData = dataVersions->at(versionIndex);
 		memcpy(staleData, updatedData, partSize);
 		epoch++;
@@ -139,9 +154,11 @@ void DataPart::clone(DataPart *other) {
 	while (dataVersions->size() > 0) {
 		void *data = dataVersions->back(); 
 		dataVersions->pop_back();
-		free(data);
+		if (!NodeSharedMemory::release(data)) free(data);
 	}	
 	
+	// versions are copied in epoch order; so the generation counter should restart from the beginning
+	epochGeneration = 0;
 	int currentEpoch = 0;
 	while (currentEpoch < other->epochCount) {
 		dataVersions->push_back(other->getData(currentEpoch));	
@@ -219,6 +236,32 @@ void DataPartsList::allocateParts() {
 }
 
 
+void DataPartsList::shareOnNode(const char *listName) {
+
+	// the key must advance in all segments regardless of their having any part in the list to remain in agreement
+	std::string listKey = NodeSharedMemory::generateListKey(listName);
+	if (invalid) return;
+
+	// a part is identified by its part Id within the list
+	for (int i = 0; i < partList->NumElements(); i++) {
+		DataPart *dataPart = partList->Nth(i);
+		PartMetadata *partMetadata = dataPart->getMetadata();
+		List<int*> *idList = partMetadata->getIdList();
+		int dimensions = partMetadata->getDimensions();
+		std::ostringstream partKey;
+		partKey << listKey;
+		for (int j = 0; j < idList->NumElements(); j++) {
+			int *partId = idList->Nth(j);
+			partKey << (j == 0 ? ':' : '|');
+			for (int d = 0; d < dimensions; d++) {
+				if (d > 0) partKey << ',';
+				partKey << partId[d];
+			}
+		}
+		dataPart->shareOnNode(partKey.str().c_str());
+	}
+}
+
 DataPart *DataPartsList::getPart(List<int*> *partId, PartIterator *iterator) {
 	SuperPart *part = partContainer->getPart(partId, iterator, metadata->getDimensions());	
 	PartLocator *partLocator = reinterpret_cast<PartLocator*>(part);
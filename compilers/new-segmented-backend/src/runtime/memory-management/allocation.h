@@ -78,28 +78,42 @@ class DataPart {
 	// Epoch dependent data structures will have multiple copies, one per epoch, of each part stored within a 
 	// PPU. So the epoch count is needed, which is by default set to 1.
 	int epochCount;
-	// a variable to keep track of the head of the circular array 
-	int epochHead;
+	// a generation counter, modulo the epoch count, that is incremented each time the epoch advances; the
+	// allocation unit holding a particular epoch version is resolved through this counter so that an epoch
+	// advancement is a single increment regardless of the number of versions
+	int epochGeneration;
 	// a circular array of allocation units, one for each epoch version
 	std::vector<void*> *dataVersions;
 	// size of each element of the data part in terms of the number of characters
 	int elementSize;
+	// if set, the versions of the data part are allocated in node shared memory under keys derived from this
+	char *sharingKey;
   public:
 	DataPart(PartMetadata *metadata, int epochCount, int elementSize);
 	~DataPart();
 
+	// makes the data part share its versions with the same part in other segments of the node; this should be done
+	// before the memory for the versions has been allocated
+	void shareOnNode(const char *key);
+
 	// allocate memories for the data part; the version threshold dictates what versions should be allocated;
 	// version numbers that are below the threshold are ignored 	
 	void allocate(int versionThreshold = 0);
 	
 	inline PartMetadata *getMetadata() { return metadata; }
+	inline int getElementSize() { return elementSize; }
 
 	// returns the memory reference of the allocation unit at the current epoch-head
 	void *getData();
 	// returns the memory reference of the allocation unit for a specific epoch version
 	void *getData(int epoch);
-	// moves the head of the circular array one step ahead
-        inline void advanceEpoch() { epochHead = (epochHead + 1) % epochCount; }
+	// turns the current version into the version of the previous epoch, the latter into the version before
+	// that, and so on; the oldest version's allocation unit is reused for the current version
+        inline void advanceEpoch() { epochGeneration = (epochGeneration + 1) % epochCount; }
+	// returns the index of the allocation unit holding the argument epoch version in the circular array
+	inline int getVersionIndex(int epoch) { 
+		return (epoch + epochCount - epochGeneration) % epochCount; 
+	}
 
 	// This function is used by multi-versioned data parts to copy values from one allocation to all other
 	// allocations. This operation is typically needed when the data part is read from some external file.
@@ -169,6 +183,12 @@ class DataPartsList {
 	inline bool isInvalid() { return invalid; }
 	DataPart *getPart(List<int*> *partId, PartIterator *iterator);
 
+	// Makes the parts of the list share their memory with the same parts held by other segments of the node. The
+	// argument name should identify the data structure and the LPS the list is for. This must be invoked, if at all,
+	// after the list has been initialized and by all segments that run the code creating the list, whether or not
+	// they have any part in it.
+	void shareOnNode(const char *listName);
+
 	// each PPU-controller within a segment should get an iterator for each data part list that to be used later 
 	// for part searching
 	PartIterator *createIterator();
@@ -0,0 +1,132 @@
+#include "node_shared_memory.h"
+
+#include <mpi.h>
+#include <map>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <time.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+std::string NodeSharedMemory::jobToken = "";
+std::map<std::string, int> NodeSharedMemory::listGenerations;
+MPI_Comm NodeSharedMemory::nodeComm = MPI_COMM_WORLD;
+std::map<void*, NodeSharedMemory::Region> NodeSharedMemory::regions;
+std::vector<std::string> NodeSharedMemory::createdNames;
+
+void NodeSharedMemory::initialize() {
+
+	// the first segment picks the token from its process ID and the start time, then lets others know about it
+	const int tokenLength = 32;
+	char token[tokenLength];
+	int segmentRank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &segmentRank);
+	if (segmentRank == 0) {
+		snprintf(token, tokenLength, "%lx-%lx", (long) getpid(), (long) time(NULL));
+	}
+	int status = MPI_Bcast(token, tokenLength, MPI_CHAR, 0, MPI_COMM_WORLD);
+	if (status != MPI_SUCCESS) {
+		std::cout << "Segment " << segmentRank << ": could not agree on a name for node shared memory\n";
+		std::exit(EXIT_FAILURE);
+	}
+	jobToken = std::string(token);
+
+	// without MPI-3 the node of a segment is unknown; then all segments synchronize to remove object names
+#if MPI_VERSION >= 3
+	MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, segmentRank, MPI_INFO_NULL, &nodeComm);
+#endif
+}
+
+std::string NodeSharedMemory::generateListKey(const char *listName) {
+	std::string name = std::string(listName);
+	int generation = listGenerations[name];
+	listGenerations[name] = generation + 1;
+	std::ostringstream key;
+	key << name << '#' << generation;
+	return key.str();
+}
+
+void *NodeSharedMemory::allocate(const std::string &key, long int size) {
+
+	// a memory mapping cannot be empty
+	if (size == 0) size = 1;
+
+	std::string name = getObjectName(key);
+	bool creator = true;
+	int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+	if (descriptor != -1) {
+		// extending the object fills it with zeros; so no explicit initialization is needed
+		if (ftruncate(descriptor, size) != 0) {
+			std::cout << "could not size node shared memory for " << key << "\n";
+			std::exit(EXIT_FAILURE);
+		}
+	} else if (errno == EEXIST) {
+		creator = false;
+		descriptor = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+		if (descriptor == -1) {
+			std::cout << "could not open node shared memory for " << key << "\n";
+			std::exit(EXIT_FAILURE);
+		}
+		// the creator may not have sized the object yet
+		struct stat objectStat;
+		do {
+			sched_yield();
+			fstat(descriptor, &objectStat);
+		} while (objectStat.st_size < size);
+	} else {
+		std::cout << "could not create node shared memory for " << key << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	void *address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (address == MAP_FAILED) {
+		std::cout << "could not map node shared memory for " << key << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+
+	Region region;
+	region.name = name;
+	region.size = size;
+	regions[address] = region;
+	if (creator) createdNames.push_back(name);
+	return address;
+}
+
+bool NodeSharedMemory::release(void *address) {
+	std::map<void*, Region>::iterator entry = regions.find(address);
+	if (entry == regions.end()) return false;
+	Region &region = entry->second;
+	munmap(address, region.size);
+	regions.erase(entry);
+	return true;
+}
+
+void NodeSharedMemory::unlinkCreatedObjects() {
+	MPI_Barrier(nodeComm);
+	for (unsigned int i = 0; i < createdNames.size(); i++) {
+		shm_unlink(createdNames[i].c_str());
+	}
+	createdNames.clear();
+}
+
+std::string NodeSharedMemory::getObjectName(const std::string &key) {
+
+	// keys of deeply partitioned data can get longer than a shared memory object name may be; so the name is formed
+	// from a 64 bit FNV-1a hash of the key instead of the key itself
+	unsigned long long hash = 14695981039346656037ULL;
+	for (unsigned int i = 0; i < key.length(); i++) {
+		hash ^= (unsigned char) key[i];
+		hash *= 1099511628211ULL;
+	}
+	std::ostringstream name;
+	name << "/it-" << jobToken << '-' << std::hex << hash;
+	return name.str();
+}
@@ -0,0 +1,65 @@
+#ifndef _H_node_shared_memory
+#define _H_node_shared_memory
+
+/* This header provides node level shared memory allocations for the data parts of read-mostly replicated arrays. When
+ * several segments of a program run on the same machine, each would otherwise hold a private copy of every replicated
+ * data part. Instead, a shared data part is allocated in a named POSIX shared memory object that every segment of the
+ * node holding the same part maps in its address space. The name is derived from a key that identifies the part, and
+ * its version, in the program; so co-located segments find the same object without any coordination beyond agreeing
+ * on a job wide token at program startup.
+ *
+ * Sharing is only safe for data that a single segment updates at a time and that others do not read while it is being
+ * updated; the replication sync communicator of such data then only needs to make the update visible within the node
+ * and transfer it to the other nodes.
+ */
+
+#include <mpi.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class NodeSharedMemory {
+  private:
+	// a token unique to the current run of the program to keep its shared memory objects apart from other runs'
+	static std::string jobToken;
+	// number of times parts lists with a particular name have been shared so far
+	static std::map<std::string, int> listGenerations;
+	// the segments running on the same node as the current segment
+	static MPI_Comm nodeComm;
+
+	class Region {
+	  public:
+		std::string name;
+		long int size;
+	};
+	static std::map<void*, Region> regions;
+	// names of the shared memory objects the current segment created that have not been removed yet
+	static std::vector<std::string> createdNames;
+  public:
+	// This is a collective operation on MPI_COMM_WORLD that must be done before any shared allocation.
+	static void initialize();
+	static bool isInitialized() { return !jobToken.empty(); }
+
+	// The parts lists of a data structure are created anew in each task invocation. This returns a key that identifies
+	// the current incarnation of the parts lists having the argument name; as all segments execute the same sequence
+	// of task invocations, the key is the same in all co-located segments holding the list.
+	static std::string generateListKey(const char *listName);
+
+	// Returns a zero initialized shared allocation of the argument size for the argument key. The first segment of the
+	// node to ask for a key creates the allocation; the rest get the same memory mapped into their address spaces.
+	static void *allocate(const std::string &key, long int size);
+
+	// Unmaps the argument memory if it is a shared allocation and returns true; returns false otherwise so that the
+	// caller can release the memory by other means.
+	static bool release(void *address);
+
+	// This is a collective operation on the segments of the node that every segment, participating in the current 
+	// task or not, must do once the memory of the task has been allocated. When all of them have opened the objects
+	// they share, the segments that created the objects remove the objects' names. Then a segment lagging behind 
+	// cannot create a fresh object under an old name, and no name outlives the program should it crash. 
+	static void unlinkCreatedObjects();
+  private:
+	static std::string getObjectName(const std::string &key);
+};
+
+#endif
@@ -401,6 +401,100 @@ List<PartIntervalPattern*> *BlockCountConfig::getPartIntervalPatterns(Dimension
 	return patternList;	
 }
 
+//---------------------------------------------------------- NNZ Balanced Config ---------------------------------------------------------/
+
+int NnzBalancedConfig::getPartsCount(Dimension parentDimension) {
+	int count = partitionArgs[0];
+	int length = parentDimension.length;
+	return std::max(1, std::min(count, length));
+}
+
+Range NnzBalancedConfig::getPartRange(int partId, Dimension parentDimension) {
+	int count = getPartsCount(parentDimension);
+	if (split != NULL && split->appliesTo(parentDimension, count)) {
+		return split->getPartDimension(partId).range;
+	}
+	// fall back to an even division for dimensions the split has not been computed for
+	int size = parentDimension.length / count;
+	Range range;
+	range.min = parentDimension.range.min + partId * size;
+	range.max = (partId < count - 1) ? range.min + size - 1 : parentDimension.range.max;
+	return range;
+}
+
+Dimension NnzBalancedConfig::getPartDimension(int partId, Dimension parentDimension) {
+	
+	Range range = getPartRange(partId, parentDimension);
+	int begin = range.min;
+	int length = range.max - range.min + 1;
+
+	if (paddings[0] > 0) {
+		int frontPadding = getEffectiveFrontPadding(partId, parentDimension);
+		begin -= frontPadding;
+		length += frontPadding;
+	}
+	if (paddings[1] > 0) {
+		length += getEffectiveRearPadding(partId, parentDimension);
+	}
+
+	Dimension partDimension;
+	partDimension.range.min = begin;
+	partDimension.range.max = begin + length - 1;
+	partDimension.setLength();
+	return partDimension;
+}
+
+int NnzBalancedConfig::getEffectiveFrontPadding(int partId, Dimension parentDimension) {
+	if (paddings[0] == 0) return 0;
+	int begin = getPartRange(partId, parentDimension).min;
+	int paddedBegin = std::max(parentDimension.range.min, begin - paddings[0]);
+	return begin - paddedBegin;
+}
+
+int NnzBalancedConfig::getEffectiveRearPadding(int partId, Dimension parentDimension) {
+	if (paddings[1] == 0) return 0;
+	int end = getPartRange(partId, parentDimension).max;
+	int paddedEnd = std::min(parentDimension.range.max, end + paddings[1]);
+	return paddedEnd - end;
+}
+
+PartitionInstr *NnzBalancedConfig::getPartitionInstr() {
+	int count = partitionArgs[0];
+	NnzBalancedInstr *instr = new NnzBalancedInstr(count, split);
+	Assert(instr != NULL);
+	instr->setPadding(paddings[0], paddings[1]);
+	return instr;
+}
+
+bool NnzBalancedConfig::isEqual(DimPartitionConfig *otherConfig) {
+	NnzBalancedConfig *other = dynamic_cast<NnzBalancedConfig*>(otherConfig);
+	if (other == NULL) return false;
+	bool sameSplit = (split == other->split) || (split != NULL && split->isEqual(other->split));
+	return (partitionArgs[0] == other->partitionArgs[0])
+			&& (paddings[0] == other->paddings[0])
+			&& (paddings[1] == other->paddings[1])
+			&& sameSplit;
+}
+
+// Parts of an nnz-balanced dimension rarely share a length; so rather than generating a pattern for a group of parts as the
+// block-count configuration does, this generates a separate pattern for each part with its actual beginning index.
+List<PartIntervalPattern*> *NnzBalancedConfig::getPartIntervalPatterns(Dimension origDimension) {
+	
+	int partsCount = getPartsCount(origDimension);
+	if (partsCount == 1) return DimPartitionConfig::getPartIntervalPatterns(origDimension);
+
+	List<PartIntervalPattern*> *patternList = new List<PartIntervalPattern*>;
+	for (int i = 0; i < partsCount; i++) {
+		Dimension partDim = getPartDimension(i, origDimension);
+		PartIntervalPattern *pattern = new PartIntervalPattern(1, partDim.length, partDim.length, 0, 1);
+		std::ostringstream stream;
+		stream << partDim.range.min;
+		pattern->beginExpr = strdup(stream.str().c_str());
+		patternList->Append(pattern);
+	}
+	return patternList;	
+}
+
 //-------------------------------------------------------------- Stride Config ------------------------------------------------------------/
 
 int StrideConfig::getPartsCount(Dimension parentDimension) {
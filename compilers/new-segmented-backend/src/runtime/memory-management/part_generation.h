@@ -20,6 +20,7 @@
 #include "../../../../common-libs/domain-obj/structure.h"
 
 #include "../partition-lib/partition.h"
+#include "../partition-lib/nnz_balance.h"
 
 class DimConfig;
 class PartMetadata;
@@ -245,6 +246,32 @@ class BlockCountConfig : public DimPartitionConfig {
 	List<PartIntervalPattern*> *getPartIntervalPatterns(Dimension origDimension);
 };
 
+/* configuration subclass corresponding to the 'nnz_balanced' partition function; it takes a 'count' parameter like the 
+   block-count configuration but gets the split points of the dimension from the row pointers of a CSR structure at task
+   launch (check nnz_balance.h in the partition library) */
+class NnzBalancedConfig : public DimPartitionConfig {
+  protected:
+	NnzSplit *split;
+	int getEffectiveFrontPadding(int partId, Dimension parentDimension); 		
+	int getEffectiveRearPadding(int partId,  Dimension parentDimension);
+	// returns the part range excluding the paddings
+	Range getPartRange(int partId, Dimension parentDimension);
+  public:
+	NnzBalancedConfig(Dimension dimension, int *partitionArgs, int paddings[2], 
+			NnzSplit *split, int ppuCount, int lpsAlignment) : DimPartitionConfig(dimension, 
+			partitionArgs, paddings, ppuCount, lpsAlignment) {
+		this->split = split;
+	}
+	
+	int getPartsCount(Dimension parentDimension);
+	Dimension getPartDimension(int partId, Dimension parentDimension);
+	PartitionInstr *getPartitionInstr();
+	bool isDegenerativeCase() { return partitionArgs[0] == 1; }
+	bool doesReorderIndices() { return false; }
+	bool isEqual(DimPartitionConfig *otherConfig);
+	List<PartIntervalPattern*> *getPartIntervalPatterns(Dimension origDimension);
+};
+
 /* configuration subclass for parameter-less 'stride' partition function */
 class StrideConfig : public DimPartitionConfig {
   public:
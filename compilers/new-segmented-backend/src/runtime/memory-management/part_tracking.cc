@@ -118,6 +118,63 @@ void PartIdContainer::print(int indentLevel, std::ostream &stream) {
 	}
 }
 
+int PartIdContainer::transferRun(vector<XformedIndexInfo*> *xformVector,
+		TransferSpec *transferSpec,
+		DataPartSpec *dataPartSpec, 
+		vector<int> *runStart, int runLength) {
+
+	if (runLength == 1) {
+		dataPartSpec->initPartTraversalReference(runStart, xformVector);
+		return transferData(xformVector, transferSpec, dataPartSpec, false, std::cout);
+	}
+
+	// locate the first and the last elements of the run respecting the confinement of the actual transfer
+	int elementSize = transferSpec->getStepSize();
+	TransferIndexSpec *probeSpec = new TransferIndexSpec(elementSize);
+	probeSpec->setConfinementContainerId(transferSpec->getConfinementContainerId());
+	DataPartIndexList firstLocations;
+	probeSpec->setPartIndexListReference(&firstLocations);
+	dataPartSpec->initPartTraversalReference(runStart, xformVector);
+	transferData(xformVector, probeSpec, dataPartSpec, false, std::cout);
+	
+	vector<int> elementIndex(*runStart);
+	int lastDimension = elementIndex.size() - 1;
+	elementIndex[lastDimension] += runLength - 1;
+	DataPartIndexList lastLocations;
+	probeSpec->setPartIndexListReference(&lastLocations);
+	dataPartSpec->initPartTraversalReference(&elementIndex, xformVector);
+	transferData(xformVector, probeSpec, dataPartSpec, false, std::cout);
+	delete probeSpec;
+
+	List<DataPartIndex> *firstList = firstLocations.getPartIndexList();
+	List<DataPartIndex> *lastList = lastLocations.getPartIndexList();
+	bool contiguous = (firstList->NumElements() > 0 && firstList->NumElements() == lastList->NumElements());
+	long int runSpan = ((long int) runLength - 1) * elementSize;
+	for (int i = 0; contiguous && i < firstList->NumElements(); i++) {
+		DataPartIndex first = firstList->Nth(i);
+		DataPartIndex last = lastList->Nth(i);
+		contiguous = (first.getDataPart() == last.getDataPart() 
+				&& last.getIndex() - first.getIndex() == runSpan);
+	}
+	if (contiguous) {
+		for (int i = 0; i < firstList->NumElements(); i++) {
+			transferSpec->performRunTransfer(firstList->Nth(i), runLength);
+		}
+		return firstList->NumElements() * runLength;
+	}
+
+	// the run is broken within the data parts, for example, by a strided partition function or a part boundary 
+	int transferCount = 0;
+	for (int i = 0; i < runLength; i++) {
+		elementIndex[lastDimension] = runStart->at(lastDimension) + i;
+		dataPartSpec->initPartTraversalReference(&elementIndex, xformVector);
+		transferCount += transferData(xformVector, transferSpec, dataPartSpec, false, std::cout);
+		transferSpec->shiftBufferReference(1);
+	}
+	transferSpec->shiftBufferReference(-runLength);
+	return transferCount;
+}
+
 List<List<int*>*> *PartIdContainer::getAllPartIdsAtLevel(int levelNo,
 		int dataDimensions, List<int*> *partIdUnderConstruct, int previousLevel) {
 
@@ -117,6 +117,17 @@ class PartIdContainer {
 			TransferSpec *transferSpec,
 			DataPartSpec *dataPartSpec,
 			bool loggingEnabled, std::ostream &logFile, int indentLevel = 0) = 0;
+
+	// This is the bulk version of the previous function for a run of elements that are consecutive along the last
+	// dimension, beginning at the argument index and at the buffer reference currently set in the transfer spec.
+	// Only the first and the last element of the run are located by the recursive process. If both are found in the 
+	// same data parts at storage positions that are as far apart as the elements are in the run then the whole run 
+	// lies contiguously in each of those parts and is transferred at once; otherwise, the elements are transferred 
+	// one by one. The return value is the number of element transfers done.
+	int transferRun(std::vector<XformedIndexInfo*> *xformVector,
+			TransferSpec *transferSpec,
+			DataPartSpec *dataPartSpec, 
+			std::vector<int> *runStart, int runLength);
 };
 
 // this is the leaf level container that holds the actual parts of a data structure
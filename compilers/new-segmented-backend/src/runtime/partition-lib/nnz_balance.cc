@@ -0,0 +1,184 @@
+#include "nnz_balance.h"
+#include "../file-io/stream.h"
+#include "../file-io/data_handler.h"
+
+#include "../../../../common-libs/utils/hashtable.h"
+#include "../../../../common-libs/domain-obj/structure.h"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+#include <cstdlib>
+
+//--------------------------------------------------------------- NNZ Split -------------------------------------------------------------/
+
+NnzSplit::NnzSplit(Dimension dimension, int partsCount) {
+	this->dimension = dimension;
+	this->partsCount = std::max(1, std::min(partsCount, dimension.length));
+	this->partBegins = new int[this->partsCount + 1];
+	computeEvenSplit();
+}
+
+NnzSplit::NnzSplit(Dimension dimension, int partsCount, int *rowPointers) {
+
+	this->dimension = dimension;
+	this->partsCount = std::max(1, std::min(partsCount, dimension.length));
+	this->partBegins = new int[this->partsCount + 1];
+	int rows = dimension.length;
+	partBegins[0] = dimension.range.min;
+	partBegins[this->partsCount] = dimension.range.max + 1;
+
+	// as the first row starts at index 0, the number of non-zero entries up to and including a row is one more than
+	// its row pointer
+	long int total = (long int) rowPointers[rows - 1] + 1;
+	for (int k = 1; k < this->partsCount; k++) {
+		long int target = total * k / this->partsCount;
+
+		// row pointers are non-decreasing; so a binary search finds the first row with which the cumulative count of
+		// non-zero entries reaches the target
+		int *position = std::lower_bound(rowPointers, rowPointers + rows, (int) (target - 1));
+		int row = position - rowPointers;
+
+		// end the preceding part either just before or just after that row, whichever brings it closer to the target
+		long int countWithRow = (row < rows) ? (long int) rowPointers[row] + 1 : total;
+		long int countWithoutRow = (row > 0) ? (long int) rowPointers[row - 1] + 1 : 0;
+		int splitRow = (countWithRow - target <= target - countWithoutRow) ? row + 1 : row;
+
+		// each part must get at least one row
+		int lowest = partBegins[k - 1] - dimension.range.min + 1;
+		int highest = rows - (this->partsCount - k);
+		splitRow = std::max(lowest, std::min(splitRow, highest));
+		partBegins[k] = dimension.range.min + splitRow;
+	}
+}
+
+NnzSplit::~NnzSplit() {
+	delete[] partBegins;
+}
+
+bool NnzSplit::appliesTo(Dimension parentDimension, int partsCount) {
+	int count = std::max(1, std::min(partsCount, parentDimension.length));
+	return this->partsCount == count
+			&& dimension.range.min == parentDimension.range.min
+			&& dimension.range.max == parentDimension.range.max;
+}
+
+Dimension NnzSplit::getPartDimension(int partId) {
+	Dimension partDimension;
+	partDimension.range.min = partBegins[partId];
+	partDimension.range.max = partBegins[partId + 1] - 1;
+	partDimension.setLength();
+	return partDimension;
+}
+
+int NnzSplit::getPartNo(int index) {
+	int *position = std::upper_bound(partBegins, partBegins + partsCount + 1, index);
+	int partNo = (position - partBegins) - 1;
+	return std::max(0, std::min(partNo, partsCount - 1));
+}
+
+bool NnzSplit::isEqual(NnzSplit *other) {
+	if (other == NULL) return false;
+	if (partsCount != other->partsCount) return false;
+	for (int i = 0; i <= partsCount; i++) {
+		if (partBegins[i] != other->partBegins[i]) return false;
+	}
+	return true;
+}
+
+int *NnzSplit::readRowPointers(const char *fileName, Dimension *dimension) {
+	// the row pointers may have been written by an earlier task and still be in the output queues of the segments
+	AsyncPartWriteQueue::waitForFileInAllSegments(fileName);
+	TypedInputStream<int> *stream = new TypedInputStream<int>(fileName);
+	Dimension *fileDimension = stream->getDimensionList()->Nth(0);
+	*dimension = *fileDimension;
+	int length = fileDimension->length;
+	int *rowPointers = new int[length];
+	stream->open();
+	for (int i = 0; i < length; i++) {
+		rowPointers[i] = stream->readNextElement();
+	}
+	stream->close();
+	delete stream;
+	return rowPointers;
+}
+
+void NnzSplit::computeEvenSplit() {
+	int size = dimension.length / partsCount;
+	for (int i = 0; i < partsCount; i++) {
+		partBegins[i] = dimension.range.min + i * size;
+	}
+	partBegins[partsCount] = dimension.range.max + 1;
+}
+
+//------------------------------------------------------------- NNZ Split Cache ---------------------------------------------------------/
+
+NnzSplitCache::NnzSplitCache() {
+	splitMap = new Hashtable<NnzSplit*>;
+	sourceFileMap = new Hashtable<const char*>;
+}
+
+void NnzSplitCache::prepareSplit(const char *lpsName,
+		int lpsDimension,
+		Dimension rowDimension,
+		int partsCount,
+		const char *rowPointersFile,
+		std::ofstream &logFile) {
+
+	const char *key = getKey(lpsName, lpsDimension);
+	NnzSplit *currentSplit = splitMap->Lookup(key);
+	const char *currentSource = sourceFileMap->Lookup(key);
+	bool splitUsable = currentSplit != NULL && currentSplit->appliesTo(rowDimension, partsCount);
+
+	// Note that a replaced split is never deleted as the partition configurations of data parts residing in the program
+	// environment may still refer to it.
+	NnzSplit *split = NULL;
+	if (rowPointersFile == NULL) {
+		if (splitUsable) {
+			logFile << "\tretaining the non-zero balanced split of Space " << lpsName << "\n";
+			logFile.flush();
+			return;
+		}
+		logFile << "\trow pointers are not available for Space " << lpsName;
+		logFile << ": dividing rows evenly\n";
+		split = new NnzSplit(rowDimension, partsCount);
+		if (currentSource != NULL) {
+			sourceFileMap->Remove(key, currentSource);
+		}
+	} else {
+		if (splitUsable && currentSource != NULL && strcmp(currentSource, rowPointersFile) == 0) {
+			logFile << "\tretaining the non-zero balanced split of Space " << lpsName << "\n";
+			logFile.flush();
+			return;
+		}
+		Dimension fileDimension;
+		int *rowPointers = NnzSplit::readRowPointers(rowPointersFile, &fileDimension);
+		if (fileDimension.length != rowDimension.length) {
+			logFile << "\trow pointers file length mismatch for Space " << lpsName;
+			logFile << ": dividing rows evenly\n";
+			split = new NnzSplit(rowDimension, partsCount);
+		} else {
+			split = new NnzSplit(rowDimension, partsCount, rowPointers);
+			logFile << "\tcomputed a non-zero balanced split of Space " << lpsName << " from ";
+			logFile << rowPointersFile << "\n";
+		}
+		delete[] rowPointers;
+		sourceFileMap->Enter(key, strdup(rowPointersFile));
+	}
+	logFile.flush();
+	splitMap->Enter(key, split);
+}
+
+NnzSplit *NnzSplitCache::getSplit(const char *lpsName, int lpsDimension) {
+	const char *key = getKey(lpsName, lpsDimension);
+	NnzSplit *split = splitMap->Lookup(key);
+	free((void*) key);
+	return split;
+}
+
+const char *NnzSplitCache::getKey(const char *lpsName, int lpsDimension) {
+	std::ostringstream stream;
+	stream << lpsName << "_" << lpsDimension;
+	return strdup(stream.str().c_str());
+}
@@ -0,0 +1,76 @@
+#ifndef _H_nnz_balance
+#define _H_nnz_balance
+
+/* A block_count or block_size partitioning of the row pointer array of a compressed sparse row (CSR) structure gives each
+ * part the same number of rows but not necessarily the same number of non-zero entries. When row lengths are skewed, the
+ * LPUs holding the longest rows dictate the completion time of the whole task. The nnz_balanced partition function rather
+ * splits the row dimension at the points that give each part about the same number of non-zero entries. Since the split
+ * points depend on the content of the row pointer array, they are computed at task launch and stored in the classes of
+ * this header; the partition configuration and partition instruction classes for the function then consult them.
+ */
+
+#include "../../../../common-libs/utils/hashtable.h"
+#include "../../../../common-libs/domain-obj/structure.h"
+
+#include <fstream>
+
+/* This class holds the split points of a dimension that has been divided by the nnz_balanced partition function */
+class NnzSplit {
+  private:
+	// the dimension the split points have been computed for
+	Dimension dimension;
+	int partsCount;
+	// beginning indices of the parts; there is an additional entry at the end holding the index past the last part
+	int *partBegins;
+  public:
+	// creates an even split of the dimension; this is used when the row pointers are not available
+	NnzSplit(Dimension dimension, int partsCount);
+	// creates a split from the row pointers; following the CSR convention of IT sample programs, the i'th entry of the
+	// array should hold the index of the last non-zero entry of row 'dimension.range.min + i'
+	NnzSplit(Dimension dimension, int partsCount, int *rowPointers);
+	~NnzSplit();
+	Dimension getDimension() { return dimension; }
+	int getPartsCount() { return partsCount; }
+
+	// The split points are only valid for dividing the dimension they have been computed for into the same number of
+	// parts. The partition configuration and instruction classes resort to an even division otherwise.
+	bool appliesTo(Dimension parentDimension, int partsCount);
+
+	Dimension getPartDimension(int partId);
+	// returns the ID of the part the index falls in
+	int getPartNo(int index);
+	bool isEqual(NnzSplit *other);
+
+	// reads the entire row pointer array from a data file; the dimension argument is updated to reflect the length of
+	// the array found in the file
+	static int *readRowPointers(const char *fileName, Dimension *dimension);
+  private:
+	void computeEvenSplit();
+};
+
+/* A task having nnz_balanced partitions keeps an instance of this class to hold the split of each LPS dimension divided by
+ * the function across its invocations. A split is recomputed only when the row pointer array is read afresh from a file
+ * or the dimension length or the parts count has changed. Otherwise the split of the earlier invocation is retained so that
+ * the data parts left in the program environment by that invocation remain usable as they are.
+ */
+class NnzSplitCache {
+  private:
+	Hashtable<NnzSplit*> *splitMap;
+	// the files the row pointers of the current splits have been read from
+	Hashtable<const char*> *sourceFileMap;
+  public:
+	NnzSplitCache();
+	// This should be called at the beginning of each task invocation for each LPS dimension divided by the function.
+	// The file name should be NULL if the row pointer array is already in the program environment.
+	void prepareSplit(const char *lpsName,
+			int lpsDimension,
+			Dimension rowDimension,
+			int partsCount,
+			const char *rowPointersFile,
+			std::ofstream &logFile);
+	NnzSplit *getSplit(const char *lpsName, int lpsDimension);
+  private:
+	static const char *getKey(const char *lpsName, int lpsDimension);
+};
+
+#endif
@@ -538,6 +538,186 @@ XformedIndexInfo *BlockCountInstr::transformIndex(XformedIndexInfo *indexToXform
 	return NULL;
 }
 
+//----------------------------------------------------- NNZ Balanced -----------------------------------------------------
+
+NnzBalancedInstr::NnzBalancedInstr(int count, NnzSplit *split) : PartitionInstr("NNZ-Balanced", false) {
+	this->count = count;
+	this->split = split;
+	frontPadding = 0;
+	rearPadding = 0;
+}
+
+void NnzBalancedInstr::setPadding(int frontPadding, int rearPadding) {
+	this->frontPadding = frontPadding;
+	this->rearPadding = rearPadding;
+	if (frontPadding > 0 || rearPadding > 0) {
+		hasPadding = true;
+	}
+}
+
+Dimension NnzBalancedInstr::getDimension(bool includePadding) {
+	return getDimension(parentDim, partId, partsCount, includePadding);
+}
+
+Dimension NnzBalancedInstr::getDimension(Dimension parentDim, int partId, int partsCount, bool includePadding) {
+	int begin, end;
+	if (split != NULL && split->appliesTo(parentDim, partsCount)) {
+		Dimension splitDim = split->getPartDimension(partId);
+		begin = splitDim.range.min;
+		end = splitDim.range.max;
+	} else {
+		int size = parentDim.length / partsCount;
+		begin = parentDim.range.min + partId * size;
+		end = (partId < partsCount - 1) ? begin + size - 1 : parentDim.range.max;
+	}
+	Dimension partDimension;
+	if (includePadding) {
+		partDimension.range.min = max(begin - frontPadding, parentDim.range.min);
+		partDimension.range.max = min(end + rearPadding, parentDim.range.max);
+	} else {
+		partDimension.range.min = begin;
+		partDimension.range.max = end;
+	}
+	partDimension.setLength();
+	return partDimension;
+}
+
+List<IntervalSeq*> *NnzBalancedInstr::getIntervalDesc() {
+	List<IntervalSeq*> *list = new List<IntervalSeq*>;
+	Dimension partDim = getDimension();
+	int begin = partDim.range.min;
+	int length = partDim.length;
+	IntervalSeq *interval = new IntervalSeq(begin, length, length, 1);
+	list->Append(interval);
+	return list;
+}
+
+int NnzBalancedInstr::calculatePartsCount(Dimension dimension, bool updateProperties) {
+	int count = max(1, min(this->count, dimension.length));
+	if (updateProperties) {
+		this->parentDim = dimension;
+		this->partsCount = count;
+	}
+	return count;
+}
+
+List<IntervalSeq*> *NnzBalancedInstr::getIntervalDescForRange(Range idRange) {
+	List<IntervalSeq*> *list = new List<IntervalSeq*>;
+	Dimension startDim = getDimension(parentDim, idRange.min, partsCount, true);
+	Dimension endDim = getDimension(parentDim, idRange.max, partsCount, true);
+	int length = endDim.range.max - startDim.range.min + 1;
+	IntervalSeq *interval = new IntervalSeq(startDim.range.min, length, length, 1);
+	list->Append(interval);
+	return list;
+}
+
+IntervalSeq *NnzBalancedInstr::getPaddinglessIntervalForRange(Range idRange) {
+	Dimension startDim = getDimension(parentDim, idRange.min, partsCount, false);
+	Dimension endDim = getDimension(parentDim, idRange.max, partsCount, false);
+	int length = endDim.range.max - startDim.range.min + 1;
+	return new IntervalSeq(startDim.range.min, length, length, 1);
+}
+
+void NnzBalancedInstr::getIntervalDescForRangeHierarchy(List<Range> *rangeList, List<IntervalSeq*> *descInConstruct) {
+	Range idRange = rangeList->Nth(rangeList->NumElements() - 1);
+	if (descInConstruct->NumElements() == 0) {
+		if (excludePaddingInIntervalCalculation) {
+			descInConstruct->Append(getPaddinglessIntervalForRange(idRange));
+		} else {
+			List<IntervalSeq*> *myIntervalList = getIntervalDescForRange(idRange);
+			descInConstruct->AppendAll(myIntervalList);
+			delete myIntervalList;
+		}
+	} else {
+		// padding exclusion works the same way as it does for the block-count instruction
+		if (hasPadding && excludePaddingInIntervalCalculation) {
+			IntervalSeq *myInterval = getPaddinglessIntervalForRange(Range(idRange.min));
+			List<IntervalSeq*> *originalList = new List<IntervalSeq*>;
+			originalList->AppendAll(descInConstruct);
+			descInConstruct->clear();
+			for (int i = 0; i < originalList->NumElements(); i++) {
+				IntervalSeq *seq = originalList->Nth(i);
+				List<IntervalSeq*> *intersect = myInterval->computeIntersection(seq);
+				if (intersect != NULL) {
+					descInConstruct->AppendAll(intersect);
+				}
+			}
+		}
+
+		// Parts generated by this instruction do not have a fixed length; so the lower level description cannot be
+		// made periodic as it is done for the block-count instruction. Rather a copy of the description, shifted by
+		// the distance between the beginnings of the parts, is generated for each subsequent part in the range.
+		if (idRange.max > idRange.min) {
+			List<IntervalSeq*> *updatedList = new List<IntervalSeq*>;
+			int firstBegin = getDimension(parentDim, idRange.min, partsCount, false).range.min;
+			for (int partNo = idRange.min; partNo <= idRange.max; partNo++) {
+				int shift = getDimension(parentDim, partNo, partsCount, false).range.min - firstBegin;
+				for (int i = 0; i < descInConstruct->NumElements(); i++) {
+					IntervalSeq *subInterval = descInConstruct->Nth(i);
+					if (shift == 0) {
+						updatedList->Append(subInterval);
+					} else {
+						IntervalSeq *newInterval = new IntervalSeq(subInterval->begin + shift,
+								subInterval->length, subInterval->period, subInterval->count);
+						updatedList->Append(newInterval);
+					}
+				}
+			}
+			descInConstruct->clear();
+			descInConstruct->AppendAll(updatedList);
+			delete updatedList;
+		}
+	}
+
+	if (descInConstruct->NumElements() > 0) {
+		rangeList->RemoveAt(rangeList->NumElements() - 1);
+		if (prevInstr != NULL) prevInstr->getIntervalDescForRangeHierarchy(rangeList, descInConstruct);
+	}
+}
+
+XformedIndexInfo *NnzBalancedInstr::transformIndex(XformedIndexInfo *indexToXform) {
+
+	Dimension dimension = indexToXform->partDimension;
+	int index = indexToXform->index;
+	int count = calculatePartsCount(dimension, false);
+	int partNo = getPartNo(dimension, index, count);
+
+	bool includePadding = hasPadding && !excludePaddingInIntervalCalculation;
+	Dimension newDimension = getDimension(dimension, partNo, count, hasPadding);
+
+	indexToXform->partDimension = newDimension;
+	indexToXform->index = index;
+	indexToXform->partNo = partNo;
+
+	// an index in the overlapping padding region of a neighbor is reported following the logic of the block-count
+	// instruction
+	if (includePadding) {
+		Dimension paddinglessDim = getDimension(dimension, partNo, count, false);
+		int indexForwardDrift = index - paddinglessDim.range.min;
+		int indexBackwardDrift = paddinglessDim.range.max - index;
+		if (indexForwardDrift >= 0 && indexForwardDrift < frontPadding && partNo > 0) {
+			XformedIndexInfo *paddingPart = new XformedIndexInfo(index,
+					partNo - 1, getDimension(dimension, partNo - 1, count, true));
+			return paddingPart;
+		} else if (indexBackwardDrift >= 0 && indexBackwardDrift < rearPadding && partNo < count - 1) {
+			XformedIndexInfo *paddingPart = new XformedIndexInfo(index,
+					partNo + 1, getDimension(dimension, partNo + 1, count, true));
+			return paddingPart;
+		}
+	}
+
+	return NULL;
+}
+
+int NnzBalancedInstr::getPartNo(Dimension parentDimension, int index, int partsCount) {
+	if (split != NULL && split->appliesTo(parentDimension, partsCount)) {
+		return split->getPartNo(index);
+	}
+	int partSize = parentDimension.length / partsCount;
+	int partNo = (index - parentDimension.range.min) / partSize;
+	return min(partNo, partsCount - 1);
+}
+
 //-------------------------------------------------------- Stride --------------------------------------------------------
 
 StrideInstr::StrideInstr(int ppuCount) : PartitionInstr("Stride", true) {
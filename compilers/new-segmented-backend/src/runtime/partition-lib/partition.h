@@ -10,6 +10,8 @@
 #include "../../../../common-libs/utils/interval.h"
 #include "../../../../common-libs/domain-obj/structure.h"
 
+#include "nnz_balance.h"
+
 /* This is an auxiliary data structure definition to be used during transferring data in between communication buffer
  * and the operating memory data-parts. The data parts are stored as a part-hierarchy (see the part-tracking library)
  * and multiple parts may contribute to a single communication buffer and/or receive updated data points from it. We
@@ -166,6 +168,31 @@ public:
 	XformedIndexInfo *transformIndex(XformedIndexInfo *indexToXform);
 };
 
+/* The partition instruction for the nnz_balanced function. It behaves like the block-count instruction except that the parts
+ * are delimited by the split points computed from the row pointers at task launch (see nnz_balance.h). If the split is not
+ * applicable for a dimension then the instruction divides that dimension evenly.
+ * */
+class NnzBalancedInstr : public PartitionInstr {
+protected:
+	int count;
+	int frontPadding;
+	int rearPadding;
+	NnzSplit *split;
+public:
+	NnzBalancedInstr(int count, NnzSplit *split);
+	Dimension getDimension(bool includePadding=true);
+	Dimension getDimension(Dimension parentDimension, int partId, int partsCount, bool includePadding);
+	List<IntervalSeq*> *getIntervalDesc();
+	void setPadding(int frontPadding, int rearPadding);
+	int calculatePartsCount(Dimension dimension, bool updateProperties);
+	List<IntervalSeq*> *getIntervalDescForRange(Range idRange);
+	IntervalSeq *getPaddinglessIntervalForRange(Range idRange);
+	void getIntervalDescForRangeHierarchy(List<Range> *rangeList, List<IntervalSeq*> *descInConstruct);
+	XformedIndexInfo *transformIndex(XformedIndexInfo *indexToXform);
+private:
+	int getPartNo(Dimension parentDimension, int index, int partsCount);
+};
+
 class StrideInstr : public PartitionInstr {
 private:
 	int ppuCount;
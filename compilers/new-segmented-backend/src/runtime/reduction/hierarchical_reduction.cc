@@ -0,0 +1,129 @@
+#include <mpi.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "hierarchical_reduction.h"
+
+HierarchicalReducer::HierarchicalReducer(MPI_Comm groupComm) {
+
+	this->groupComm = groupComm;
+	this->nodeComm = MPI_COMM_NULL;
+	this->leaderComm = MPI_COMM_NULL;
+	this->nodeRank = 0;
+	this->nodeSize = 1;
+	this->leaderCount = 1;
+	this->hierarchical = false;
+	this->slots = NULL;
+
+#if MPI_VERSION >= 3
+	int groupRank, groupSize;
+	MPI_Comm_rank(groupComm, &groupRank);
+	MPI_Comm_size(groupComm, &groupSize);
+
+	// find the segments of the group that are sharing the current node
+	MPI_Comm_split_type(groupComm, MPI_COMM_TYPE_SHARED, groupRank, MPI_INFO_NULL, &nodeComm);
+	MPI_Comm_rank(nodeComm, &nodeRank);
+	MPI_Comm_size(nodeComm, &nodeSize);
+
+	// the lowest ranked segment of each node becomes its leader; the rest do not participate in inter-node step
+	int color = (nodeRank == 0) ? 0 : MPI_UNDEFINED;
+	MPI_Comm_split(groupComm, color, groupRank, &leaderComm);
+	if (nodeRank == 0) {
+		MPI_Comm_size(leaderComm, &leaderCount);
+	}
+	MPI_Bcast(&leaderCount, 1, MPI_INT, 0, nodeComm);
+
+	// if no two segments share a node then there is nothing to gain from the hierarchical scheme; the decision must
+	// be the same in all segments as the two schemes use different collectives, so a segment alone on its node still
+	// follows the hierarchical scheme as its own node leader if any other node has multiple segments
+	int maxNodeSize;
+	MPI_Allreduce(&nodeSize, &maxNodeSize, 1, MPI_INT, MPI_MAX, groupComm);
+	if (maxNodeSize == 1) {
+		if (leaderComm != MPI_COMM_NULL) MPI_Comm_free(&leaderComm);
+		MPI_Comm_free(&nodeComm);
+		leaderComm = MPI_COMM_NULL;
+		nodeComm = MPI_COMM_NULL;
+		return;
+	}
+
+	// the leader allocates the entire window so that the slots are contiguous
+	MPI_Aint windowSize = (nodeRank == 0) ? (MPI_Aint) (nodeSize + 1) * Slot_Size : 0;
+	char *base;
+	int status = MPI_Win_allocate_shared(windowSize, 1, MPI_INFO_NULL, nodeComm, &base, &window);
+	if (status != MPI_SUCCESS) {
+		std::cout << "could not allocate shared memory window for node level reductions\n";
+		std::exit(EXIT_FAILURE);
+	}
+	MPI_Aint leaderWindowSize;
+	int displacementUnit;
+	MPI_Win_shared_query(window, 0, &leaderWindowSize, &displacementUnit, &slots);
+
+	// a passive target epoch lasts for the lifetime of the reducer; the window is then accessed by load and store
+	// operations separated by memory synchronizations
+	MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+	hierarchical = true;
+#endif
+}
+
+HierarchicalReducer::~HierarchicalReducer() {
+#if MPI_VERSION >= 3
+	if (hierarchical) {
+		MPI_Win_unlock_all(window);
+		MPI_Win_free(&window);
+		slots = NULL;
+	}
+	if (leaderComm != MPI_COMM_NULL) MPI_Comm_free(&leaderComm);
+	if (nodeComm != MPI_COMM_NULL) MPI_Comm_free(&nodeComm);
+#endif
+}
+
+void HierarchicalReducer::synchronizeNode() {
+#if MPI_VERSION >= 3
+	MPI_Win_sync(window);
+	MPI_Barrier(nodeComm);
+	MPI_Win_sync(window);
+#endif
+}
+
+int HierarchicalReducer::allreduce(void *sendBuffer,
+		void *receiveBuffer, int count, MPI_Datatype type, MPI_Op op) {
+
+	if (!hierarchical) {
+		return MPI_Allreduce(sendBuffer, receiveBuffer, count, type, op, groupComm);
+	}
+
+	MPI_Aint lowerBound, extent;
+	MPI_Type_get_extent(type, &lowerBound, &extent);
+	int dataSize = count * extent;
+	if (dataSize > Slot_Size) {
+		return MPI_Allreduce(sendBuffer, receiveBuffer, count, type, op, groupComm);
+	}
+
+	// deposit the local partial result in the segment's own slot then wait for the other segments of the node
+	memcpy(getSlot(nodeRank), sendBuffer, dataSize);
+	synchronizeNode();
+
+	// the leader combines the results of the node and, if there are other nodes, exchanges the combined result
+	// with their leaders
+	int status = MPI_SUCCESS;
+	if (nodeRank == 0) {
+		char *result = getSlot(nodeSize);
+		memcpy(result, getSlot(0), dataSize);
+		for (int i = 1; i < nodeSize; i++) {
+			MPI_Reduce_local(getSlot(i), result, count, type, op);
+		}
+		if (leaderCount > 1) {
+			status = MPI_Allreduce(MPI_IN_PLACE, result, count, type, op, leaderComm);
+		}
+	}
+
+	// Wait for the leader to publish the final result. The slots can be overwritten by a subsequent reduction
+	// only after this synchronization; so the leader never reads a slot while its owner is updating it.
+	synchronizeNode();
+	memcpy(receiveBuffer, getSlot(nodeSize), dataSize);
+
+	// only the leader knows the status of the inter-node reduction; as MPI errors abort the program by default, the
+	// status is not broadcast to the rest of the node to avoid another synchronization
+	return status;
+}
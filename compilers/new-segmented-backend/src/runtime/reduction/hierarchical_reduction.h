@@ -0,0 +1,55 @@
+#ifndef _H_hierarchical_reduction
+#define _H_hierarchical_reduction
+
+/* This header provides a node-aware implementation of the all-reduce operation used in the final step of cross-
+ * segment reductions. When many segments of a program run on the same machine, a plain MPI_Allreduce over all of
+ * them makes a latency-bound reduction such as the dot product of a CG iteration pay for a collective among all
+ * the processes. Instead, the segments of a node deposit their partial results in cache-line-separated slots of a
+ * shared memory window, a single leader segment of the node combines them, only the leaders participate in an
+ * MPI_Allreduce across the nodes, and the leader publishes the result back in the shared window.
+ *
+ * The shared memory window needs MPI-3. With an older MPI library, or if all segments are on separate nodes, the
+ * reducer falls back to a plain MPI_Allreduce on the original communicator. The choice is made collectively; so a
+ * segment that is alone on its node acts as the leader of that node when other nodes host multiple segments.
+ */
+
+#include <mpi.h>
+
+class HierarchicalReducer {
+  private:
+	MPI_Comm groupComm;
+	// communicator among the segments of the group that share the current node
+	MPI_Comm nodeComm;
+	// communicator among the leaders of the nodes; this is MPI_COMM_NULL in non-leader segments
+	MPI_Comm leaderComm;
+	int nodeRank;
+	int nodeSize;
+	int leaderCount;
+	bool hierarchical;
+#if MPI_VERSION >= 3
+	MPI_Win window;
+#endif
+	// the shared memory has a slot per segment of the node followed by a slot for the final result
+	char *slots;
+  public:
+	// The slot size is sufficient for the reduction buffers of the reduction primitives while being a multiple of
+	// a typical cache line size.
+	static const int Slot_Size = 64;
+
+	// This is a collective operation over the argument communicator.
+	HierarchicalReducer(MPI_Comm groupComm);
+	// Ends the access epoch and frees the shared window and the node and leader communicators. This is a collective
+	// operation over the segments of the node; the group communicator is not freed as the reducer does not own it.
+	~HierarchicalReducer();
+	bool isHierarchical() { return hierarchical; }
+
+	// Has the semantics of MPI_Allreduce on the group communicator; the data being reduced must fit in a slot. The
+	// operator must be commutative, which all predefined MPI reduction operators are.
+	int allreduce(void *sendBuffer, void *receiveBuffer, int count, MPI_Datatype type, MPI_Op op);
+  private:
+	char *getSlot(int index) { return slots + index * Slot_Size; }
+	// makes the updates of the shared window by the segments of the node visible to each other
+	void synchronizeNode();
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "reduction_barrier.h"
 #include "non_task_global_reduction.h"
 #include "../communication/mpi_group.h"
+#include "hierarchical_reduction.h"
 
 //-------------------------------------------------- Reduction Primitive -------------------------------------------------------
 
@@ -46,6 +47,18 @@ NonTaskGlobalMpiReductionPrimitive::NonTaskGlobalMpiReductionPrimitive(int eleme
 	// exactly as long as the data-type's size 
 	sendBuffer = (char *) malloc(sizeof(char) * 50);
 	receiveBuffer = (char *) malloc(sizeof(char) * 50);
+	crossSegmentReducer = NULL;
+}
+
+void NonTaskGlobalMpiReductionPrimitive::setupHierarchicalReduction() {
+	if (segmentGroup != NULL) {
+		crossSegmentReducer = new HierarchicalReducer(segmentGroup->getCommunicator());
+	}
+}
+
+void NonTaskGlobalMpiReductionPrimitive::releaseHierarchicalReduction() {
+	delete crossSegmentReducer;
+	crossSegmentReducer = NULL;
 }
 
 void NonTaskGlobalMpiReductionPrimitive::releaseFunction() {
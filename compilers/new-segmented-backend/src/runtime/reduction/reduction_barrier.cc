@@ -7,6 +7,7 @@
 #include <fstream>
 
 #include "reduction_barrier.h"
+#include "../common/trace.h"
 #include "../../../../common-libs/utils/list.h"
 
 //---------------------------------------------- Task Global Reduction Barrier -------------------------------------------------
@@ -21,6 +22,8 @@ TaskGlobalReductionBarrier::TaskGlobalReductionBarrier(int size) {
 
 void TaskGlobalReductionBarrier::reduce(reduction::Result *localPartialResult, void *target) {
 
+	TRACE_SCOPE(trace::REDUCTION, "Task Global Reduction", -1);
+
 	sem_wait(&mutex);					// Make sure only one in at a  time
 	if (_count == _size) {
 		initFunction(localPartialResult, target);	// Do any initialization needed at the first PPU controller's 
@@ -66,6 +69,7 @@ void NonTaskGlobalReductionBarrier::reduce(reduction::Result *localPartialResult
 		void *localTarget,
 		reduction::Result *toBeStoredFinalResult) {
 	
+	TRACE_SCOPE(trace::REDUCTION, "Non Task Global Reduction", -1);
 	sem_wait(&mutex);					// Make sure only one in at a  time
 	if (_count == _size) {
 		initFunction(localPartialResult, 		// Do any initialization needed at the first PPU controller's
@@ -9,6 +9,7 @@
 #include "reduction_barrier.h"
 #include "task_global_reduction.h"
 #include "../communication/mpi_group.h"
+#include "hierarchical_reduction.h"
 
 //-------------------------------------------------- Reduction Primitive -------------------------------------------------------
 
@@ -55,6 +56,18 @@ TaskGlobalMpiReductionPrimitive::TaskGlobalMpiReductionPrimitive(int elementSize
 	// exactly as long as the data-type's size 
 	sendBuffer = (char *) malloc(sizeof(char) * 50);
 	receiveBuffer = (char *) malloc(sizeof(char) * 50);
+	crossSegmentReducer = NULL;
+}
+
+void TaskGlobalMpiReductionPrimitive::setupHierarchicalReduction() {
+	if (segmentGroup != NULL) {
+		crossSegmentReducer = new HierarchicalReducer(segmentGroup->getCommunicator());
+	}
+}
+
+void TaskGlobalMpiReductionPrimitive::releaseHierarchicalReduction() {
+	delete crossSegmentReducer;
+	crossSegmentReducer = NULL;
 }
 
 void TaskGlobalMpiReductionPrimitive::releaseFunction() {
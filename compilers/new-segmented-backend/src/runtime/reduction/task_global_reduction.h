@@ -12,6 +12,7 @@
 
 // forward declaration of the class that creates and holds MPI communicators
 class SegmentGroup;
+class HierarchicalReducer;
 
 /* This extension of the Reduction-Barrier embodies the logic for doing reduction of partial results computed by 
  * PPU controllers local to the current segment. If the final reduction is localized to individual segments then
@@ -59,11 +60,21 @@ class TaskGlobalMpiReductionPrimitive : public TaskGlobalReductionPrimitive {
 	// function to avoid mistakes.
 	char *sendBuffer;
 	char *receiveBuffer;
+
+	// the node-aware reducer to be used in the cross-segment reduction, if enabled
+	HierarchicalReducer *crossSegmentReducer;
   public:
 	TaskGlobalMpiReductionPrimitive(int elementSize,
 			ReductionOperator op, 
 			int localParticipants, 
 			SegmentGroup *segmentGroup);
+
+	// This is a collective operation over the segments of the group that sets up the communicators and shared
+	// memory of the node-aware reducer. It does nothing in a segment that is not part of any group.
+	void setupHierarchicalReduction();
+	// This releases the communicators and shared memory of the node-aware reducer; so it should be called by all
+	// segments of the group at the end of the task that set it up.
+	void releaseHierarchicalReduction();
   protected:
 	void releaseFunction();
 
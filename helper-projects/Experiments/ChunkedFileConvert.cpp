@@ -0,0 +1,137 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include "utils.h"
+#include "../../compilers/new-segmented-backend/src/runtime/file-io/chunked_format.h"
+
+using namespace std;
+
+/* converts binary array files between the plain format of a 'dim*dim*...' header followed by raw elements that the
+   text-to-binary tool generates and the chunked, compressed format of the runtime's chunked_format.h */
+
+int getElementSize(const char *dataType) {
+	if (strcmp("double", dataType) == 0) return sizeof(double);
+	if (strcmp("float", dataType) == 0) return sizeof(float);
+	if (strcmp("int", dataType) == 0) return sizeof(int);
+	if (strcmp("char", dataType) == 0) return sizeof(char);
+	cout << "unknown data type " << dataType << ": supported types are char, int, float, and double\n";
+	exit(EXIT_FAILURE);
+}
+
+char *readPlainFile(const char *fileName, int elementSize, vector<int64_t> &dimensions) {
+
+	ifstream file(fileName, ios_base::binary);
+	if (!file.is_open()) {
+		cout << "could not open input file: " << fileName << "\n";
+		exit(EXIT_FAILURE);
+	}
+
+	string header;
+	getline(file, header);
+	string delim = "*";
+	std::deque<string> tokenList = tokenizeString(header, delim);
+	int64_t elementsCount = 1;
+	while (!tokenList.empty()) {
+		string token = tokenList.front();
+		tokenList.pop_front();
+		trim(token);
+		int64_t length = atol(token.c_str());
+		dimensions.push_back(length);
+		elementsCount *= length;
+	}
+
+	char *array = new char[elementsCount * elementSize];
+	file.read(array, elementsCount * elementSize);
+	if (file.gcount() != elementsCount * elementSize) {
+		cout << "specified file does not have enough data elements: ";
+		cout << "read only " << file.gcount() / elementSize << " values\n";
+		exit(EXIT_FAILURE);
+	}
+	file.close();
+	return array;
+}
+
+void writePlainFile(const char *fileName, chunkedio::ChunkedArrayReader *reader) {
+
+	ofstream stream(fileName, ios_base::binary);
+	if (!stream.is_open()) {
+		cout << "could not open output file: " << fileName << "\n";
+		exit(EXIT_FAILURE);
+	}
+
+	int dimensionality = reader->getDimensionality();
+	int elementSize = reader->getElementSize();
+	int64_t totalElements = 1;
+	for (int i = 0; i < dimensionality; i++) {
+		if (i > 0) stream << "*";
+		stream << reader->getDimensionLength(i);
+		totalElements *= reader->getDimensionLength(i);
+	}
+	stream << "\n";
+
+	vector<int> index(dimensionality, 0);
+	vector<char> element(elementSize);
+	for (int64_t n = 0; n < totalElements; n++) {
+		reader->readElement(&index[0], &element[0]);
+		stream.write(&element[0], elementSize);
+		for (int i = dimensionality - 1; i >= 0; i--) {
+			index[i]++;
+			if (index[i] < reader->getDimensionLength(i)) break;
+			index[i] = 0;
+		}
+	}
+	stream.close();
+}
+
+int mainChunkedConvert(int argc, char *argv[]) {
+
+	const char *usage = "sequence is to-chunked|to-plain input-file data-type output-file [chunk-size-in-KB]";
+	if (argc < 5) {
+		cout << "insufficient arguments: " << usage << "\n";
+		exit(EXIT_FAILURE);
+	}
+	const char *mode = argv[1];
+	const char *inputFileName = argv[2];
+	int elementSize = getElementSize(argv[3]);
+	const char *outputFileName = argv[4];
+
+	if (strcmp("to-chunked", mode) == 0) {
+		vector<int64_t> dimensions;
+		char *array = readPlainFile(inputFileName, elementSize, dimensions);
+		cout << "read input file: " << inputFileName << "\n";
+
+		int64_t chunkBytes = chunkedio::Default_Chunk_Bytes;
+		if (argc > 5) chunkBytes = atol(argv[5]) * 1024;
+		vector<int64_t> chunkShape(dimensions.size());
+		chunkedio::ChunkLayout::suggestChunkShape(elementSize,
+				dimensions.size(), &dimensions[0], chunkBytes, &chunkShape[0]);
+		chunkedio::ChunkedArrayWriter *writer = new chunkedio::ChunkedArrayWriter(outputFileName,
+				elementSize, dimensions.size(), &dimensions[0], &chunkShape[0], chunkedio::SHUFFLE_RLE);
+		writer->writeArray(array);
+		cout << "wrote " << writer->getChunkCount() << " chunks to output file: " << outputFileName << "\n";
+		delete writer;
+		delete[] array;
+	} else if (strcmp("to-plain", mode) == 0) {
+		chunkedio::ChunkedArrayReader *reader = new chunkedio::ChunkedArrayReader(inputFileName);
+		if (reader->getElementSize() != elementSize) {
+			cout << "data type does not match the element size of the input file\n";
+			exit(EXIT_FAILURE);
+		}
+		reader->open();
+		writePlainFile(outputFileName, reader);
+		reader->close();
+		cout << "wrote to output file: " << outputFileName << "\n";
+		delete reader;
+	} else {
+		cout << "unknown conversion " << mode << ": " << usage << "\n";
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
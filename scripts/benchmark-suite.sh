@@ -0,0 +1,454 @@
+#!/bin/bash
+
+# This script runs a benchmark suite built from the sample IT programs of the segmented-memory backend compiler
+# and the reference implementations of the same algorithms found in the helper-projects/Validation directory. For
+# each selected benchmark, it generates the input files, compiles the IT program and its references, runs strong
+# and/or weak scaling sweeps using the local 'mpirun', validates the IT outputs using the matching validator, and
+# appends one line per run to a comma separated results table that can be compared across revisions to detect
+# performance regressions in the runtime library. The script should be executed from the project's root directory.
+
+usage() {
+	echo "usage: scripts/benchmark-suite.sh [options]"
+	echo "options:"
+	echo "  -b 'list'  benchmarks to run from: mmm stencil block-luf monte-carlo cg (default: all)"
+	echo "  -m name    sample machine whose PCubeS model, processor, and mapping files should be used (default: hermes)"
+	echo "  -p 'list'  MPI process (i.e., segment) counts for the sweeps (default: '1 2 4')"
+	echo "  -t 'list'  thread counts for the Pthread and OpenMP references (default: '1 2 4')"
+	echo "  -s mode    scaling sweep to run: strong, weak, or both (default: both)"
+	echo "  -n scale   multiplier for the base problem sizes of the benchmarks (default: 1)"
+	echo "  -r count   number of repetitions of each run (default: 3)"
+	echo "  -o file    results table to append to (default: benchmark-results.csv)"
+	echo "  -w dir     working directory for inputs, executables, and outputs (default: a temporary directory)"
+	echo "  -k         keep the working directory after the suite finishes"
+	echo "Note that the number of threads an IT program uses in each segment is determined by the machine model and"
+	echo "the mapping file; so use different sample machines (-m) to vary the thread count of IT executables."
+	exit 1
+}
+
+# keep track of the project directory and the directories the suite draws upon
+project_dir=`pwd`
+backend_dir=$project_dir/compilers/new-segmented-backend
+sample_dir=$backend_dir/sample
+validation_dir=$project_dir/helper-projects/Validation
+array_generator=$project_dir/tools/array-generator
+
+# default settings of the suite
+benchmarks="mmm stencil block-luf monte-carlo cg"
+machine=hermes
+process_counts="1 2 4"
+thread_counts="1 2 4"
+scaling=both
+size_scale=1
+repetitions=3
+results_file=$project_dir/benchmark-results.csv
+work_dir=""
+keep_work_dir=false
+
+while getopts "b:m:p:t:s:n:r:o:w:kh" option; do
+	case $option in
+		b) benchmarks=$OPTARG ;;
+		m) machine=$OPTARG ;;
+		p) process_counts=$OPTARG ;;
+		t) thread_counts=$OPTARG ;;
+		s) scaling=$OPTARG ;;
+		n) size_scale=$OPTARG ;;
+		r) repetitions=$OPTARG ;;
+		o) results_file=`readlink -f $OPTARG` ;;
+		w) work_dir=$OPTARG ;;
+		k) keep_work_dir=true ;;
+		*) usage ;;
+	esac
+done
+
+if [ ! -x "$array_generator" ]; then
+	echo "array generator '$array_generator' not found; execute the script from the project's root directory"
+	exit 1
+fi
+if [ "$scaling" != "strong" ] && [ "$scaling" != "weak" ] && [ "$scaling" != "both" ]; then
+	echo "invalid scaling mode '$scaling'"
+	usage
+fi
+
+# locate the hardware description and mapping files of the selected sample machine
+pcubes_file=`ls $sample_dir/pcubes/${machine}*.ml 2> /dev/null | head -1`
+core_numbering_file=`ls $sample_dir/cpuinfo/${machine}*processors 2> /dev/null | head -1`
+mapping_dir=$sample_dir/mapping/$machine
+if [ ! -f "$pcubes_file" ] || [ ! -f "$core_numbering_file" ] || [ ! -d "$mapping_dir" ]; then
+	echo "could not find the PCubeS model, processor file, and mapping directory for machine '$machine'"
+	exit 1
+fi
+
+# set up the working directory
+if [ -z "$work_dir" ]; then
+	work_dir=`mktemp -d /tmp/it_benchmarks_XXXX`
+else
+	mkdir -p $work_dir
+	work_dir=`readlink -f $work_dir`
+fi
+mkdir -p $work_dir/inputs $work_dir/bin $work_dir/runs
+echo "benchmark working directory: $work_dir"
+
+# write the header of the results table if the table is new
+if [ ! -f "$results_file" ]; then
+	echo "date,revision,benchmark,implementation,scaling,processes,threads,problem_size,repetition,seconds,validation" \
+			> $results_file
+fi
+revision=`git -C $project_dir rev-parse --short HEAD 2> /dev/null`
+run_date=`date +%Y-%m-%dT%H:%M:%S`
+
+#----------------------------------------------------------------------------------------------- Build Utilities
+
+# make sure the IT compiler is available; it reads its deployment properties from its own configuration directory
+build_it_compiler() {
+	if [ -x "$backend_dir/sicc" ]; then return 0; fi
+	echo "generating the IT compiler for the segmented-memory back-end"
+	cd $backend_dir
+	grep -v '^#' $project_dir/config/compiler.properties | grep -v '^$' > config/deployment.properties
+	grep -v '^#' $project_dir/config/executable.properties | grep -v '^$' >> config/deployment.properties
+	make -f MakeFile-Compiler > $work_dir/compiler-build.log 2>&1
+	local status=$?
+	cd $project_dir
+	if [ $status -ne 0 ]; then
+		echo "could not build the IT compiler; see $work_dir/compiler-build.log"
+		exit 1
+	fi
+}
+
+# compile an IT source code into an executable: arguments are the source file, mapping file, and executable name
+compile_it_program() {
+	local source=$1
+	local mapping=$2
+	local executable=$work_dir/bin/$3
+	if [ -x "$executable" ]; then return 0; fi
+	if [ ! -f "$mapping" ]; then
+		echo "mapping file '$mapping' not found"
+		return 1
+	fi
+	local build_dir=benchmark_`date +%s`_$3
+	local c_compiler=`cat $project_dir/config/compiler.properties | grep 'segmented.memory.backend.c.compiler' | cut -d '=' -f2`
+	local c_opt_flags=`cat $project_dir/config/executable.properties | grep 'c.optimization.flags' | cut -d '=' -f2`
+	echo "compiling IT program: $source"
+	cd $backend_dir
+	./sicc $source $pcubes_file $core_numbering_file $mapping $build_dir > $work_dir/bin/$3.build.log 2>&1 && \
+	make -f MakeFile-Executable C_COMPILER=$c_compiler EXECUTABLE=$executable BUILD_SUBDIR=$build_dir \
+			C_OPT_FLAGS="$c_opt_flags" >> $work_dir/bin/$3.build.log 2>&1
+	local status=$?
+	make -f MakeFile-Executable BUILD_SUBDIR=$build_dir clean > /dev/null 2>&1
+	cd $project_dir
+	if [ $status -ne 0 ]; then
+		echo "could not compile '$source'; see $work_dir/bin/$3.build.log"
+		rm -f $executable
+		return 1
+	fi
+}
+
+# Build a reference program from the validation project. The reference programs have their main functions renamed
+# to allow many of them to coexist in the project. So the program is built in a private copy of the project after
+# its main function has been restored. Arguments are the reference type (seq, mpi, pthread, openmp, or validator),
+# the source file relative to the validation project, the renamed main function, and the executable name.
+build_reference() {
+	local type=$1
+	local source=$2
+	local main_function=$3
+	local executable=$work_dir/bin/$4
+	if [ -x "$executable" ]; then return 0; fi
+	local makefile
+	case $type in
+		seq) makefile=Seq-Makefile ;;
+		mpi) makefile=MPI-Makefile ;;
+		pthread) makefile=Pthread-Makefile ;;
+		openmp) makefile=OpenMP-Makefile ;;
+		validator) makefile=Validator-Makefile ;;
+	esac
+	local copy_dir=$work_dir/bin/$4.src
+	rm -rf $copy_dir
+	cp -r $validation_dir $copy_dir
+	sed -i -e "s/int ${main_function}(/int main(/" $copy_dir/$source
+	echo "building reference program: $source"
+	cd $copy_dir
+	make -f $makefile > $work_dir/bin/$4.build.log 2>&1
+	local status=$?
+	if [ $status -eq 0 ]; then
+		mv $type-ref $executable
+	fi
+	cd $project_dir
+	rm -rf $copy_dir
+	if [ $status -ne 0 ]; then
+		echo "could not build reference '$source'; see $work_dir/bin/$4.build.log"
+		return 1
+	fi
+}
+
+#------------------------------------------------------------------------------------------------ Run Utilities
+
+# generate an array input file using the array generator: arguments are dimensions, type, min, max, and file name
+generate_array() {
+	if [ -f "$5" ]; then return 0; fi
+	$array_generator $1 $2 $3 $4 $5 > /dev/null
+}
+
+# scales a dimension length for weak scaling so that the total data volume grows linearly with the process count;
+# arguments are the base length, the process count, and the dimensionality of the data
+weak_length() {
+	awk -v base=$1 -v procs=$2 -v dims=$3 'BEGIN { printf "%d\n", base * procs ^ (1 / dims) + 0.5 }'
+}
+
+# extract the execution time an IT program or a reference program printed on its console output
+extract_time() {
+	grep -i -o '\(execution\|computation\) time: [0-9.e+-]*' $1 | tail -1 | awk '{print $NF}'
+}
+
+# Run a command in a fresh run directory and record its timing. Arguments are the benchmark, implementation,
+# scaling mode, process count, thread count, problem size, validation function (or 'none'), and the command. The
+# validation function is invoked with the run directory as its argument and should print 'passed' or 'failed'.
+run_and_record() {
+	local benchmark=$1
+	local implementation=$2
+	local mode=$3
+	local processes=$4
+	local threads=$5
+	local size=$6
+	local validation_fn=$7
+	shift 7
+	for repetition in `seq 1 $repetitions`; do
+		local run_dir=$work_dir/runs/${benchmark}_${implementation}_${mode}_p${processes}_t${threads}_$repetition
+		rm -rf $run_dir
+		mkdir -p $run_dir
+		cd $run_dir
+		eval "$@" > console.log 2>&1
+		local status=$?
+		cd $project_dir
+		local seconds=`extract_time $run_dir/console.log`
+		local validation=none
+		if [ $status -ne 0 ] || [ -z "$seconds" ]; then
+			validation=crashed
+			seconds=NA
+		elif [ "$validation_fn" != "none" ]; then
+			validation=`$validation_fn $run_dir`
+		fi
+		echo "$run_date,$revision,$benchmark,$implementation,$mode,$processes,$threads,$size,$repetition,$seconds,$validation" \
+				>> $results_file
+		echo "  $implementation ($mode, $processes processes, $threads threads, size $size) run $repetition: $seconds seconds, validation $validation"
+	done
+}
+
+# run a validator with the newline separated answers it asks for on its standard input
+run_validator() {
+	local validator=$work_dir/bin/$1
+	local run_dir=$2
+	shift 2
+	printf '%s\n' "$@" | $validator > $run_dir/validation.log 2>&1
+	if grep -q 'validation successful' $run_dir/validation.log; then
+		echo passed
+	else
+		echo failed
+	fi
+}
+
+# return the process counts of the requested scaling modes as 'mode:count' pairs
+sweep_points() {
+	for mode in strong weak; do
+		if [ "$scaling" != "both" ] && [ "$scaling" != "$mode" ]; then continue; fi
+		for processes in $process_counts; do
+			echo "$mode:$processes"
+		done
+	done
+}
+
+#--------------------------------------------------------------------------------------------------- Benchmarks
+
+# Each benchmark function below generates its inputs for every sweep point, then runs the IT program and the
+# reference programs. The base problem sizes are deliberately modest so that the full suite finishes in minutes
+# on a workstation; use the size scale option for more realistic runs.
+
+benchmark_mmm() {
+	local base_length=$((512 * size_scale))
+	compile_it_program $sample_dir/code/MM-Multiply.it $mapping_dir/mmm.map it-mmm || return
+	build_reference seq seq-implementation/seqMatrixMatrixMult.cpp mainSMMM seq-mmm
+	build_reference openmp openmp/openmpMMM.cpp mainOmpMMM openmp-mmm
+	build_reference validator validator/matrixMatrixMultValidator.cpp mainMMMV validator-mmm
+	for point in `sweep_points`; do
+		local mode=${point%%:*}
+		local processes=${point##*:}
+		local length=$base_length
+		if [ "$mode" == "weak" ]; then length=`weak_length $base_length $processes 2`; fi
+		local a=$work_dir/inputs/mmm_a_$length.txt
+		local b=$work_dir/inputs/mmm_b_$length.txt
+		generate_array "$length*$length" double 1 100 $a
+		generate_array "$length*$length" double 1 100 $b
+		validate_mmm() { run_validator validator-mmm $1 $a $b $1/c.txt; }
+		run_and_record mmm it $mode $processes NA $length validate_mmm \
+				mpirun -np $processes $work_dir/bin/it-mmm input_file_1=$a input_file_2=$b \
+				output_file=c.txt k=32 l=32 q=32
+		# the shared memory references are only meaningful for the strong scaling with a single process
+		if [ "$processes" -ne 1 ]; then continue; fi
+		[ -x $work_dir/bin/seq-mmm ] && run_and_record mmm seq $mode 1 1 $length none \
+				"printf '%s\n' $a $b | $work_dir/bin/seq-mmm"
+		for threads in $thread_counts; do
+			[ -x $work_dir/bin/openmp-mmm ] && run_and_record mmm openmp $mode 1 $threads $length none \
+					"printf '%s\n' $a $b | OMP_NUM_THREADS=$threads $work_dir/bin/openmp-mmm"
+		done
+	done
+}
+
+benchmark_stencil() {
+	local base_length=$((1024 * size_scale))
+	local iterations=10
+	compile_it_program $sample_dir/code/Stencil.it $mapping_dir/stencil.map it-stencil || return
+	build_reference validator validator/stencilValidator.cpp mainSV validator-stencil
+	for point in `sweep_points`; do
+		local mode=${point%%:*}
+		local processes=${point##*:}
+		local length=$base_length
+		if [ "$mode" == "weak" ]; then length=`weak_length $base_length $processes 2`; fi
+		local plate=$work_dir/inputs/stencil_plate_$length.txt
+		generate_array "$length*$length" double 0 100 $plate
+		validate_stencil() { run_validator validator-stencil $1 $plate $1/plate.txt $iterations; }
+		run_and_record stencil it $mode $processes NA $length validate_stencil \
+				mpirun -np $processes $work_dir/bin/it-stencil input_file=$plate output_file=plate.txt \
+				iterations=$iterations k=2 l=2 m=4 n=4 p1=2 p2=1
+	done
+}
+
+benchmark_block-luf() {
+	local base_length=$((512 * size_scale))
+	local block_size=16
+	compile_it_program $sample_dir/code/Block-LUF.it $mapping_dir/block-luf.map it-block-luf || return
+	build_reference mpi mpi/mpiBLUF.cpp mainMBLUF mpi-block-luf
+	build_reference pthread pthread/threadedBLUF.cpp mainTBLUF pthread-block-luf
+	build_reference validator validator/ProgramLUValidator.cpp mainPLUFV validator-block-luf
+	for point in `sweep_points`; do
+		local mode=${point%%:*}
+		local processes=${point##*:}
+		local length=$base_length
+		if [ "$mode" == "weak" ]; then length=`weak_length $base_length $processes 2`; fi
+		# the factorized matrix dimension must be a multiple of the block size
+		length=$(( (length + block_size - 1) / block_size * block_size ))
+		local a=$work_dir/inputs/luf_a_$length.txt
+		generate_array "$length*$length" double 1 100 $a
+		validate_luf() { run_validator validator-block-luf $1 $a $1/u.txt $1/l.txt $1/p.txt; }
+		run_and_record block-luf it $mode $processes NA $length validate_luf \
+				mpirun -np $processes $work_dir/bin/it-block-luf input_matrix_file=$a \
+				upper_matrix_file=u.txt lower_matrix_file=l.txt pivot_matrix_file=p.txt block_size=$block_size
+		[ -x $work_dir/bin/mpi-block-luf ] && run_and_record block-luf mpi $mode $processes 1 $length none \
+				mpirun -np $processes $work_dir/bin/mpi-block-luf $block_size 0 $a
+		if [ "$processes" -ne 1 ]; then continue; fi
+		for threads in $thread_counts; do
+			[ -x $work_dir/bin/pthread-block-luf ] && run_and_record block-luf pthread $mode 1 $threads \
+					$length none $work_dir/bin/pthread-block-luf $block_size $threads $length
+		done
+	done
+}
+
+benchmark_monte-carlo() {
+	local base_grid=$((100 * size_scale))
+	local cell_length=10
+	local points_per_cell=1000
+	compile_it_program $sample_dir/code/Monte-Carlo-Simple.it $mapping_dir/monte-simple.map it-monte-carlo || return
+	build_reference seq seq-implementation/monteCarlo.cpp mainMonteCarlo seq-monte-carlo
+	build_reference mpi mpi/mpiMonteCarlo.cpp mainMMonte mpi-monte-carlo
+	build_reference pthread pthread/threadedMonteCarlo.cpp mainPMonte pthread-monte-carlo
+	for point in `sweep_points`; do
+		local mode=${point%%:*}
+		local processes=${point##*:}
+		local grid=$base_grid
+		if [ "$mode" == "weak" ]; then grid=`weak_length $base_grid $processes 2`; fi
+		# the estimated area is random; so there is nothing to validate except the successful completion
+		run_and_record monte-carlo it $mode $processes NA $grid none \
+				mpirun -np $processes $work_dir/bin/it-monte-carlo cell_length=$cell_length grid_dim=$grid \
+				points_per_cell=$points_per_cell b=$((processes * 4))
+		[ -x $work_dir/bin/mpi-monte-carlo ] && run_and_record monte-carlo mpi $mode $processes 1 $grid none \
+				mpirun -np $processes $work_dir/bin/mpi-monte-carlo $cell_length $grid $points_per_cell
+		if [ "$processes" -ne 1 ]; then continue; fi
+		[ -x $work_dir/bin/seq-monte-carlo ] && run_and_record monte-carlo seq $mode 1 1 $grid none \
+				$work_dir/bin/seq-monte-carlo $cell_length $grid $points_per_cell
+		for threads in $thread_counts; do
+			[ -x $work_dir/bin/pthread-monte-carlo ] && run_and_record monte-carlo pthread $mode 1 $threads \
+					$grid none $work_dir/bin/pthread-monte-carlo $cell_length $grid $points_per_cell $threads
+		done
+	done
+}
+
+# The array generator cannot produce a sparse matrix; so the conjugate gradient input is a symmetric, diagonally
+# dominant tri-diagonal matrix in the compressed row format the IT program expects: rows[i] holds the index of the
+# last element of row i in the columns and values arrays.
+generate_csr_matrix() {
+	local length=$1
+	local prefix=$2
+	if [ -f "${prefix}_values.txt" ]; then return 0; fi
+	awk -v n=$length -v prefix=$prefix 'BEGIN {
+		count = 0
+		for (i = 0; i < n; i++) {
+			for (j = i - 1; j <= i + 1; j++) {
+				if (j < 0 || j >= n) continue
+				columns[count] = j
+				values[count] = (i == j) ? 4.0 : -1.0
+				count++
+			}
+			rows[i] = count - 1
+		}
+		print count > (prefix "_columns.txt")
+		print count > (prefix "_values.txt")
+		print n > (prefix "_rows.txt")
+		for (k = 0; k < count; k++) {
+			print columns[k] > (prefix "_columns.txt")
+			print values[k] > (prefix "_values.txt")
+		}
+		for (i = 0; i < n; i++) print rows[i] > (prefix "_rows.txt")
+	}'
+}
+
+benchmark_cg() {
+	local base_length=$((100000 * size_scale))
+	# these match the iteration limit and the precision hard-coded in the conjugate gradient validator
+	local max_iterations=10
+	local precision=1
+	compile_it_program $sample_dir/code/Conjugate-Gradient.it $mapping_dir/cg.map it-cg || return
+	build_reference seq seq-implementation/conjugateGradient.cpp mainCG seq-cg
+	build_reference validator validator/ConjugateGradientValidator.cpp mainCGV validator-cg
+	for point in `sweep_points`; do
+		local mode=${point%%:*}
+		local processes=${point##*:}
+		local length=$base_length
+		if [ "$mode" == "weak" ]; then length=$((base_length * processes)); fi
+		local matrix=$work_dir/inputs/cg_matrix_$length
+		local known=$work_dir/inputs/cg_b_$length.txt
+		local prediction=$work_dir/inputs/cg_x0_$length.txt
+		generate_csr_matrix $length $matrix
+		generate_array "$length" double 1 100 $known
+		generate_array "$length" double 1 100 $prediction
+		validate_cg() {
+			run_validator validator-cg $1 ${matrix}_columns.txt ${matrix}_rows.txt ${matrix}_values.txt \
+					$known $prediction $1/x.txt
+		}
+		local block=$(( (length + processes * 8 - 1) / (processes * 8) ))
+		run_and_record cg it $mode $processes NA $length validate_cg \
+				mpirun -np $processes $work_dir/bin/it-cg arg_matrix_cols=${matrix}_columns.txt \
+				arg_matrix_rows=${matrix}_rows.txt arg_matrix_values=${matrix}_values.txt \
+				known_vector=$known prediction_vector=$prediction solution_vector=x.txt \
+				maxIterations=$max_iterations precision=$precision r=$block b=$block
+		if [ "$processes" -ne 1 ]; then continue; fi
+		[ -x $work_dir/bin/seq-cg ] && run_and_record cg seq $mode 1 1 $length none \
+				"printf '%s\n' ${matrix}_columns.txt ${matrix}_rows.txt ${matrix}_values.txt $known $prediction \
+				| $work_dir/bin/seq-cg $max_iterations $precision"
+	done
+}
+
+#-------------------------------------------------------------------------------------------------- Suite Driver
+
+build_it_compiler
+for benchmark in $benchmarks; do
+	if ! type benchmark_$benchmark > /dev/null 2>&1; then
+		echo "unknown benchmark '$benchmark'"
+		continue
+	fi
+	echo "running benchmark: $benchmark"
+	benchmark_$benchmark
+done
+
+echo "results have been appended to: $results_file"
+if [ "$keep_work_dir" == "false" ]; then
+	rm -rf $work_dir
+else
+	echo "inputs, executables, and outputs are kept in: $work_dir"
+fi